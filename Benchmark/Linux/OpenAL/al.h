@@ -0,0 +1,8 @@
+/*
+ *  al.h
+ *  ObjectAL Benchmark
+ *
+ *  ObjectAL imports <OpenAL/al.h> as on Apple platforms. Elsewhere the header lives in AL/.
+ */
+
+#include <AL/al.h>
@@ -0,0 +1,8 @@
+/*
+ *  alc.h
+ *  ObjectAL Benchmark
+ *
+ *  ObjectAL imports <OpenAL/alc.h> as on Apple platforms. Elsewhere the header lives in AL/.
+ */
+
+#include <AL/alc.h>
@@ -0,0 +1,175 @@
+//
+//  OALBenchmark.h
+//  ObjectAL
+//
+
+#import <Foundation/Foundation.h>
+
+
+#pragma mark OALBenchmarkResult
+
+/**
+ * The timings of one benchmark case.
+ */
+@interface OALBenchmarkResult : NSObject
+{
+	NSString* name;
+	NSUInteger samples;
+	double medianSeconds;
+	double p99Seconds;
+	double meanSeconds;
+	NSUInteger bytesPerOperation;
+	double alCallsPerOperation;
+	NSString* note;
+}
+
+/** The case's name, such as "getFreeSource/32". */
+@property(readonly) NSString* name;
+
+/** The number of timed samples (0 if the case was skipped). */
+@property(readonly) NSUInteger samples;
+
+/** Median time per operation, in seconds. */
+@property(readonly) double medianSeconds;
+
+/** 99th percentile time per operation, in seconds. */
+@property(readonly) double p99Seconds;
+
+/** Mean time per operation, in seconds. */
+@property(readonly) double meanSeconds;
+
+/** Bytes processed per operation, for throughput cases (0 otherwise). */
+@property(readonly) NSUInteger bytesPerOperation;
+
+/** OpenAL calls made per operation, as counted by the mock OpenAL, or -1 if not counted. */
+@property(readwrite,assign) double alCallsPerOperation;
+
+/** Why the case was skipped or what it ran against, or nil. */
+@property(readonly) NSString* note;
+
+/** Make a result from a set of timings.
+ *
+ * @param name The case's name.
+ * @param timings Time per operation of each sample, in seconds. These get sorted in place.
+ * @param numTimings The number of timings.
+ * @param bytesPerOperation Bytes processed per operation, or 0.
+ * @param note Optional note.
+ * @return A new result.
+ */
++ (id) resultWithName:(NSString*) name
+			  timings:(double*) timings
+		   numTimings:(NSUInteger) numTimings
+	bytesPerOperation:(NSUInteger) bytesPerOperation
+				 note:(NSString*) note;
+
+/** Initialize a result from a set of timings.
+ *
+ * @param name The case's name.
+ * @param timings Time per operation of each sample, in seconds. These get sorted in place.
+ * @param numTimings The number of timings.
+ * @param bytesPerOperation Bytes processed per operation, or 0.
+ * @param note Optional note.
+ * @return The initialized result.
+ */
+- (id) initWithName:(NSString*) name
+			timings:(double*) timings
+		 numTimings:(NSUInteger) numTimings
+  bytesPerOperation:(NSUInteger) bytesPerOperation
+			   note:(NSString*) note;
+
+/** Get this result as a JSON object. Times are in microseconds, throughput in MB/s.
+ *
+ * @return The JSON text.
+ */
+- (NSString*) JSONRepresentation;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALBenchmark
+
+/**
+ * Times ObjectAL's hot paths and reports median and 99th percentile costs:
+ * - ALChannelSource play:, which is what OALSimpleAudio playEffect: does once it has a buffer
+ * - Sustained bursts of plays into a full channel, as a busy game would fire them
+ * - Bursts of one effect fired over a set of loops, unlimited and limited to 4 instances the way
+ *   an OALEffectPolicy limits it, counting the plays that reach OpenAL and the loops cut off
+ * - ALSoundSourcePool getFreeSource: from the ready queue, and with 8, 32, and 256 busy voices
+ * - ALChannelSource property changes fanning out to its sources
+ * - Frames of repeated ALChannelSource property changes, applied immediately and deferred
+ *   (deferUpdates and flushUpdates), counting the OpenAL calls each frame makes
+ * - Muting and ducking an ALMixerBus with 32 and 1024 sources attached and 8 of them playing,
+ *   counting the OpenAL calls each change makes
+ * - Starting a 4 layer sound source by source and through an ALSourceGroup, counting the
+ *   OpenAL calls each start makes
+ * - A ChannelsDemo style frame, polling source and buffer properties with and without
+ *   ALContext refreshSourceStates, counting the OpenAL calls each frame makes
+ * - 4 threads playing and changing properties on their own sources at once, which contend on
+ *   ALWrapper's lock (or on the audio command queue when OBJECTAL_CFG_AUDIO_COMMAND_THREAD is
+ *   enabled)
+ * - 1,000,000 ALWrapper calls under the OBJECTAL_CFG_AL_ERROR_CHECKING policy it was built
+ *   with, counting the alGetError() calls (make error-checking builds one per policy)
+ * - Frames of a 4096 source channel with most sources playing, checking the channel's idea of
+ *   which sources are playing against the mock OpenAL's
+ * - Recording OpenAL call statistics (see OALStats) from 1 and 4 threads at once
+ * - OALActionManager stepping 10, 100, and 1000 running actions
+ * - A linear gain ramp with the calling thread kept busy each frame, reporting how far the
+ *   source's gain strays from the ideal ramp and how much the step interval jitters
+ *   (make ACTION_THREAD=1 builds it with OBJECTAL_CFG_ACTION_SCHEDULER_THREAD for comparison)
+ * - Buffer loading (decode and upload), in MB/s
+ * - Loading 200 short effects by decoding them, on a cold OALDecodedAudioCache, and mapped
+ *   from a warm one
+ * - Preloading 200 short effects one after the other, and decoded in parallel with one worker
+ *   per core as OALSimpleAudio preloadEffects: does, reporting the speedup
+ * - Loading every sound in a sound bank, against loading the same sounds from separate files
+ *
+ * It is built as the oalbenchmark command line tool (see the Makefile next to it), which links
+ * Mock/oal_mock_al.c in place of a real OpenAL. That takes OpenAL itself out of the numbers,
+ * lets it run headless on Linux, and means OALSimpleAudio and OALAudioSupport (which need iOS)
+ * aren't available to it. The pool and channel cases run on a loopback device
+ * (see ALLoopbackDevice) so they get a context of their own.
+ *
+ * The benchmark runs synchronously on the calling thread. It expects OpenALManager to have a
+ * current context.
+ */
+@interface OALBenchmark : NSObject
+{
+	NSUInteger iterations;
+	NSString* loadFile;
+	NSString* bankFile;
+	NSMutableArray* results;
+}
+
+/** The number of timed samples per case (default 200). */
+@property(readwrite,assign) NSUInteger iterations;
+
+/** The WAVE file to load in the buffer loading case, or nil to skip it (default nil). */
+@property(readwrite,retain) NSString* loadFile;
+
+/** The sound bank to load in the sound bank cases, or nil to skip them (default nil).
+ * The sounds it contains must also be available as separate files in the same directory
+ * (see OALSoundBank).
+ */
+@property(readwrite,retain) NSString* bankFile;
+
+/** The results of the last run (OALBenchmarkResult). */
+@property(readonly) NSArray* results;
+
+/** Make a new benchmark.
+ *
+ * @return A new benchmark.
+ */
++ (id) benchmark;
+
+/** Run every case, replacing any previous results.
+ */
+- (void) run;
+
+/** Get the results as a JSON object, for tracking between builds.
+ *
+ * @return The JSON text.
+ */
+- (NSString*) JSONRepresentation;
+
+@end
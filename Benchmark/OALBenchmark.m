@@ -0,0 +1,2645 @@
+//
+//  OALBenchmark.m
+//  ObjectAL
+//
+
+#import "OALBenchmark.h"
+#import <dispatch/dispatch.h>
+#import "OpenALManager.h"
+#import "ALLoopbackDevice.h"
+#import "ALChannelSource.h"
+#import "ALSoundSourcePool.h"
+#import "ALListener.h"
+#import "ALMixerBus.h"
+#import "ALSourceGroup.h"
+#import "ALWrapper.h"
+#import "OALActionManager.h"
+#import "OALFunction.h"
+#import "OALAudioActions.h"
+#import "OALAudioDecoder.h"
+#import "OALDecodedAudioCache.h"
+#import "OALSoundBank.h"
+#import "ObjectALMacros.h"
+#import "mach_timing.h"
+#import "oal_mock_al.h"
+#import "oal_stats.h"
+
+
+/** Number of operations timed together as one sample, for operations too fast to time singly. */
+#define kOperationsPerSample 32
+
+/** Sample rate of the loopback device and the silent test buffers. */
+#define kBenchmarkFrequency 44100
+
+/** Frame rate simulated by the cases that let playback time pass. */
+#define kBenchmarkFrameRate 60
+
+/** Number of threads making calls at once in the contention case. */
+#define kNumContendingThreads 4
+
+/** Number of sources in the mock stress case. */
+#define kNumStressSources 4096
+
+/** Number of plays per frame in the mock stress case. */
+#define kStressPlaysPerFrame 64
+
+/** Number of plays of one effect per frame in the instance limiting cases. */
+#define kBurstPlaysPerFrame 16
+
+/** Number of looping sounds left playing under the bursts in the instance limiting cases. */
+#define kNumBurstLoops 8
+
+/** Number of times each channel property is changed per frame in the channel update cases. */
+#define kChangesPerFrame 4
+
+/** Number of ALWrapper calls made by the error checking case. */
+#define kNumWrappedCalls 1000000
+
+/** Number of ALWrapper calls per simulated frame in the error checking case. */
+#define kWrappedCallsPerFrame 1000
+
+/** Number of distinct function names recorded by the statistics cases. */
+#define kNumStatsFunctions 16
+
+/** Length of the gain ramp in the action ramp case, in seconds. */
+#define kRampSeconds 2.0f
+
+/** Time per frame that the action ramp case keeps the calling thread busy, as a game's
+ * update and rendering would, in seconds.
+ */
+#define kRampGameWorkSeconds 0.010
+
+/** Number of effect files loaded by the decoded audio cache cases. */
+#define kNumCacheEffects 200
+
+/** Length of each effect file, in seconds. */
+#define kCacheEffectSeconds 0.25f
+
+
+#pragma mark OALBenchmarkResult
+
+/** (INTERNAL USE) Escape a string for use in JSON.
+ */
+static NSString* jsonString(NSString* string)
+{
+	NSMutableString* result = [NSMutableString stringWithString:string];
+	[result replaceOccurrencesOfString:@"\\" withString:@"\\\\" options:0 range:NSMakeRange(0, [result length])];
+	[result replaceOccurrencesOfString:@"\"" withString:@"\\\"" options:0 range:NSMakeRange(0, [result length])];
+	return result;
+}
+
+/** (INTERNAL USE) Make the contents of a 16 bit mono WAV file holding a tone.
+ *
+ * @param numFrames The number of frames of audio.
+ * @param period The period of the tone, in frames.
+ * @return The file contents.
+ */
+static NSData* wavData(uint32_t numFrames, uint32_t period)
+{
+	uint32_t dataSize = numFrames * sizeof(int16_t);
+	NSMutableData* data = [NSMutableData dataWithCapacity:44 + dataSize];
+	uint32_t value32;
+	uint16_t value16;
+
+#define APPEND_32(VALUE) value32 = NSSwapHostIntToLittle(VALUE); [data appendBytes:&value32 length:4]
+#define APPEND_16(VALUE) value16 = NSSwapHostShortToLittle(VALUE); [data appendBytes:&value16 length:2]
+	[data appendBytes:"RIFF" length:4];
+	APPEND_32(36 + dataSize);
+	[data appendBytes:"WAVEfmt " length:8];
+	APPEND_32(16);
+	APPEND_16(1);
+	APPEND_16(1);
+	APPEND_32(kBenchmarkFrequency);
+	APPEND_32(kBenchmarkFrequency * sizeof(int16_t));
+	APPEND_16(sizeof(int16_t));
+	APPEND_16(16);
+	[data appendBytes:"data" length:4];
+	APPEND_32(dataSize);
+	for(uint32_t i = 0; i < numFrames; i++)
+	{
+		// A sawtooth is as good as anything for audio that nobody listens to.
+		APPEND_16((uint16_t)(int16_t)((int32_t)(i % period) * 16000 / (int32_t)period - 8000));
+	}
+#undef APPEND_16
+#undef APPEND_32
+
+	return data;
+}
+
+/** (INTERNAL USE) Ordering for qsort().
+ */
+static int compareDoubles(const void* a, const void* b)
+{
+	double first = *(const double*)a;
+	double second = *(const double*)b;
+	return first < second ? -1 : (first > second ? 1 : 0);
+}
+
+@implementation OALBenchmarkResult
+
+#pragma mark Object Management
+
++ (id) resultWithName:(NSString*) name
+			  timings:(double*) timings
+		   numTimings:(NSUInteger) numTimings
+	bytesPerOperation:(NSUInteger) bytesPerOperation
+				 note:(NSString*) note
+{
+	return [[[self alloc] initWithName:name
+							   timings:timings
+							numTimings:numTimings
+					 bytesPerOperation:bytesPerOperation
+								  note:note] autorelease];
+}
+
+- (id) initWithName:(NSString*) nameIn
+			timings:(double*) timings
+		 numTimings:(NSUInteger) numTimings
+  bytesPerOperation:(NSUInteger) bytesPerOperationIn
+			   note:(NSString*) noteIn
+{
+	if(nil != (self = [super init]))
+	{
+		name = [nameIn copy];
+		note = [noteIn copy];
+		samples = numTimings;
+		bytesPerOperation = bytesPerOperationIn;
+		alCallsPerOperation = -1;
+
+		if(numTimings > 0)
+		{
+			qsort(timings, numTimings, sizeof(*timings), compareDoubles);
+
+			double total = 0;
+			for(NSUInteger i = 0; i < numTimings; i++)
+			{
+				total += timings[i];
+			}
+			meanSeconds = total / numTimings;
+
+			if(numTimings % 2)
+			{
+				medianSeconds = timings[numTimings / 2];
+			}
+			else
+			{
+				medianSeconds = (timings[numTimings / 2 - 1] + timings[numTimings / 2]) / 2;
+			}
+
+			// Nearest rank
+			NSUInteger rank = (NSUInteger)ceil(numTimings * 0.99);
+			p99Seconds = timings[(rank > 0 ? rank : 1) - 1];
+		}
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[name release];
+	[note release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize name;
+@synthesize samples;
+@synthesize medianSeconds;
+@synthesize p99Seconds;
+@synthesize meanSeconds;
+@synthesize bytesPerOperation;
+@synthesize alCallsPerOperation;
+@synthesize note;
+
+- (NSString*) description
+{
+	if(0 == samples)
+	{
+		return [NSString stringWithFormat:@"%@: skipped (%@)", name, note];
+	}
+	NSString* alCalls = @"";
+	if(alCallsPerOperation >= 0)
+	{
+		alCalls = [NSString stringWithFormat:@", %.2f AL calls", alCallsPerOperation];
+	}
+	if(bytesPerOperation > 0)
+	{
+		return [NSString stringWithFormat:@"%@: median %.2f MB/s, p99 %.2f MB/s%@",
+				name,
+				bytesPerOperation / medianSeconds / 1000000.0,
+				bytesPerOperation / p99Seconds / 1000000.0,
+				alCalls];
+	}
+	return [NSString stringWithFormat:@"%@: median %.3f us, p99 %.3f us%@",
+			name, medianSeconds * 1000000.0, p99Seconds * 1000000.0, alCalls];
+}
+
+- (NSString*) JSONRepresentation
+{
+	NSMutableString* json = [NSMutableString stringWithCapacity:256];
+	[json appendFormat:@"{\"name\":\"%@\",\"samples\":%lu", jsonString(name), (unsigned long)samples];
+	if(samples > 0)
+	{
+		[json appendFormat:@",\"medianMicroseconds\":%.3f,\"p99Microseconds\":%.3f,\"meanMicroseconds\":%.3f",
+		 medianSeconds * 1000000.0, p99Seconds * 1000000.0, meanSeconds * 1000000.0];
+		if(bytesPerOperation > 0)
+		{
+			// The 99th percentile time gives the low end of the throughput.
+			[json appendFormat:@",\"bytes\":%lu,\"medianMBps\":%.3f,\"p99MBps\":%.3f",
+			 (unsigned long)bytesPerOperation,
+			 bytesPerOperation / medianSeconds / 1000000.0,
+			 bytesPerOperation / p99Seconds / 1000000.0];
+		}
+	}
+	if(alCallsPerOperation >= 0)
+	{
+		[json appendFormat:@",\"alCallsPerOperation\":%.3f", alCallsPerOperation];
+	}
+	if(nil != note)
+	{
+		[json appendFormat:@",\"note\":\"%@\"", jsonString(note)];
+	}
+	[json appendString:@"}"];
+	return json;
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALBenchmarkTarget
+
+/**
+ * (INTERNAL USE) An action target with no OpenAL behind it, so that the action manager
+ * case measures only the action machinery.
+ */
+@interface OALBenchmarkTarget : NSObject
+{
+	float gain;
+}
+
+@property(readwrite,assign) float gain;
+
+@end
+
+@implementation OALBenchmarkTarget
+
+@synthesize gain;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALBenchmarkGate
+
+/**
+ * (INTERNAL USE) Starts a set of worker threads together, and waits for them all to finish.
+ */
+@interface OALBenchmarkGate : NSObject
+{
+	NSCondition* condition;
+	unsigned int numWaiting;
+	unsigned int numFinished;
+	bool open;
+}
+
+/** (Worker thread) Wait until the gate opens.
+ */
+- (void) waitToStart;
+
+/** (Worker thread) Report that this worker is done.
+ */
+- (void) finish;
+
+/** Wait until the workers are all waiting, then open the gate.
+ *
+ * @param numWorkers The number of workers.
+ */
+- (void) openWhenWaiting:(unsigned int) numWorkers;
+
+/** Wait until the workers have all finished.
+ *
+ * @param numWorkers The number of workers.
+ */
+- (void) waitUntilFinished:(unsigned int) numWorkers;
+
+@end
+
+@implementation OALBenchmarkGate
+
+- (id) init
+{
+	if(nil != (self = [super init]))
+	{
+		condition = [[NSCondition alloc] init];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[condition release];
+	[super dealloc];
+}
+
+- (void) waitToStart
+{
+	[condition lock];
+	numWaiting++;
+	[condition broadcast];
+	while(!open)
+	{
+		[condition wait];
+	}
+	[condition unlock];
+}
+
+- (void) finish
+{
+	[condition lock];
+	numFinished++;
+	[condition broadcast];
+	[condition unlock];
+}
+
+- (void) openWhenWaiting:(unsigned int) numWorkers
+{
+	[condition lock];
+	while(numWaiting < numWorkers)
+	{
+		[condition wait];
+	}
+	open = YES;
+	[condition broadcast];
+	[condition unlock];
+}
+
+- (void) waitUntilFinished:(unsigned int) numWorkers
+{
+	[condition lock];
+	while(numFinished < numWorkers)
+	{
+		[condition wait];
+	}
+	[condition unlock];
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALBenchmarkContentionWorker
+
+/**
+ * (INTERNAL USE) A game thread for the contention case, which plays a buffer on its own
+ * source and changes the source's properties as fast as it can.
+ */
+@interface OALBenchmarkContentionWorker : NSObject
+{
+	OALBenchmarkGate* gate;
+	ALSource* source;
+	ALBuffer* buffer;
+	/** Receives the time per call of each sample (not owned). */
+	double* timings;
+	NSUInteger numSamples;
+}
+
+/** Initialize a worker.
+ *
+ * @param gate The gate to start and finish at.
+ * @param source The source to play on.
+ * @param buffer The buffer to play.
+ * @param timings Receives the time per call of each sample.
+ * @param numSamples The number of samples to take.
+ * @return The initialized worker.
+ */
+- (id) initWithGate:(OALBenchmarkGate*) gate
+			 source:(ALSource*) source
+			 buffer:(ALBuffer*) buffer
+			timings:(double*) timings
+		 numSamples:(NSUInteger) numSamples;
+
+/** Thread entry point.
+ *
+ * @param object Unused.
+ */
+- (void) run:(id) object;
+
+@end
+
+@implementation OALBenchmarkContentionWorker
+
+- (id) initWithGate:(OALBenchmarkGate*) gateIn
+			 source:(ALSource*) sourceIn
+			 buffer:(ALBuffer*) bufferIn
+			timings:(double*) timingsIn
+		 numSamples:(NSUInteger) numSamplesIn
+{
+	if(nil != (self = [super init]))
+	{
+		gate = [gateIn retain];
+		source = [sourceIn retain];
+		buffer = [bufferIn retain];
+		timings = timingsIn;
+		numSamples = numSamplesIn;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[gate release];
+	[source release];
+	[buffer release];
+	[super dealloc];
+}
+
+- (void) run:(id) object
+{
+	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+	[gate waitToStart];
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		uint64_t startTime = mach_absolute_time();
+		for(int j = 0; j < kOperationsPerSample; j += 4)
+		{
+			source.gain = 0.5f;
+			[source play:buffer];
+			source.pitch = 1.5f;
+			[source stop];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / kOperationsPerSample;
+	}
+
+	// Let go of the OpenAL objects before finishing, so that they're freed on the benchmark's thread.
+	[source release];
+	source = nil;
+	[buffer release];
+	buffer = nil;
+	[gate finish];
+	[pool release];
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALBenchmarkStatsWorker
+
+/** (INTERNAL USE) Function names for the statistics cases, as ALWrapper would record them. */
+static const char* statsFunctionNames[kNumStatsFunctions] =
+{
+	"sourcePlay", "sourceStop", "sourcePause", "sourceRewind",
+	"sourcef", "source3f", "sourcei", "getSourcef",
+	"getSourcei", "listenerf", "listener3f", "bufferData",
+	"genSources", "deleteSources", "genBuffers", "deleteBuffers",
+};
+
+/**
+ * (INTERNAL USE) A thread for the statistics cases, which records calls as fast as it can.
+ */
+@interface OALBenchmarkStatsWorker : NSObject
+{
+	OALBenchmarkGate* gate;
+	/** Receives the time per call of each sample (not owned). */
+	double* timings;
+	NSUInteger numSamples;
+}
+
+/** Initialize a worker.
+ *
+ * @param gate The gate to start and finish at.
+ * @param timings Receives the time per call of each sample.
+ * @param numSamples The number of samples to take.
+ * @return The initialized worker.
+ */
+- (id) initWithGate:(OALBenchmarkGate*) gate
+			timings:(double*) timings
+		 numSamples:(NSUInteger) numSamples;
+
+/** Thread entry point.
+ *
+ * @param object Unused.
+ */
+- (void) run:(id) object;
+
+@end
+
+@implementation OALBenchmarkStatsWorker
+
+- (id) initWithGate:(OALBenchmarkGate*) gateIn
+			timings:(double*) timingsIn
+		 numSamples:(NSUInteger) numSamplesIn
+{
+	if(nil != (self = [super init]))
+	{
+		gate = [gateIn retain];
+		timings = timingsIn;
+		numSamples = numSamplesIn;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[gate release];
+	[super dealloc];
+}
+
+- (void) run:(id) object
+{
+	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+	[gate waitToStart];
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		uint64_t startTime = mach_absolute_time();
+		for(int j = 0; j < kOperationsPerSample; j++)
+		{
+			oal_stats_record(statsFunctionNames[(i + j) % kNumStatsFunctions], 100);
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / kOperationsPerSample;
+	}
+	[gate finish];
+	[pool release];
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALBenchmarkRampSource
+
+/**
+ * (INTERNAL USE) A source that records when each gain change reaches it, so that the action
+ * ramp case can compare what the action manager delivers against the ideal ramp.
+ */
+@interface OALBenchmarkRampSource : ALSource
+{
+	/** When each gain change was made (mach absolute time). */
+	uint64_t* gainTimes;
+	/** The gain set by each change. */
+	float* gainValues;
+	NSUInteger maxGainChanges;
+	NSUInteger numGainChanges;
+}
+
+/** The number of gain changes recorded. */
+@property(readonly) NSUInteger numGainChanges;
+
+/** Start recording gain changes, discarding any recorded so far.
+ *
+ * @param maxChanges The most changes to record.
+ */
+- (void) recordGainChanges:(NSUInteger) maxChanges;
+
+/** Get a recorded gain change.
+ *
+ * @param index The change to get.
+ * @param time Receives when it was made (mach absolute time).
+ * @return The gain it set.
+ */
+- (float) gainChange:(NSUInteger) index time:(uint64_t*) time;
+
+@end
+
+@implementation OALBenchmarkRampSource
+
+- (void) dealloc
+{
+	free(gainTimes);
+	free(gainValues);
+	[super dealloc];
+}
+
+- (NSUInteger) numGainChanges
+{
+	@synchronized(self)
+	{
+		return numGainChanges;
+	}
+}
+
+- (void) recordGainChanges:(NSUInteger) maxChanges
+{
+	@synchronized(self)
+	{
+		free(gainTimes);
+		free(gainValues);
+		gainTimes = malloc(sizeof(*gainTimes) * maxChanges);
+		gainValues = malloc(sizeof(*gainValues) * maxChanges);
+		maxGainChanges = NULL != gainTimes && NULL != gainValues ? maxChanges : 0;
+		numGainChanges = 0;
+	}
+}
+
+- (float) gainChange:(NSUInteger) index time:(uint64_t*) time
+{
+	@synchronized(self)
+	{
+		*time = gainTimes[index];
+		return gainValues[index];
+	}
+}
+
+- (void) setGain:(float) value
+{
+	[super setGain:value];
+	uint64_t time = mach_absolute_time();
+	@synchronized(self)
+	{
+		if(numGainChanges < maxGainChanges)
+		{
+			gainTimes[numGainChanges] = time;
+			gainValues[numGainChanges] = value;
+			numGainChanges++;
+		}
+	}
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALBenchmarkInstanceLimiter
+
+/**
+ * (INTERNAL USE) Limits how many instances of an effect play at once, the way OALSimpleAudio
+ * does for an OALEffectPolicy (which the headless build can't include): instances are
+ * forgotten when the channel's pool reports that their voice ended, or once their expected
+ * end time passes, so counting them never asks OpenAL. End times are in mock playback time.
+ * Also counts how many of a set of watched sources lose their voice.
+ */
+@interface OALBenchmarkInstanceLimiter : NSObject <ALSoundSourcePoolDelegate>
+{
+	/** The most instances that can play at once (0 = no limit). */
+	NSUInteger maxInstances;
+	/** The sources playing the instances, oldest first (not retained). */
+	id<ALSoundSource>* sources;
+	/** When each instance finishes, in mock playback time. */
+	double* endTimes;
+	NSUInteger numInstances;
+	NSUInteger numSuppressed;
+	/** Sources whose voices are being watched (NSValue). */
+	NSMutableSet* watchedSources;
+	NSUInteger numWatchedEnded;
+}
+
+/** The number of plays turned away. */
+@property(readonly) NSUInteger numSuppressed;
+
+/** The number of watched sources whose voice ended. */
+@property(readonly) NSUInteger numWatchedEnded;
+
+/** Initialize a limiter.
+ *
+ * @param maxInstances The most instances that can play at once (0 = no limit).
+ * @return The initialized limiter.
+ */
+- (id) initWithMaxInstances:(NSUInteger) maxInstances;
+
+/** Play an instance of the effect on a channel, unless at the limit.
+ *
+ * @param buffer The effect.
+ * @param channel The channel to play it on.
+ * @return The source playing it, or nil if it was turned away.
+ */
+- (id<ALSoundSource>) play:(ALBuffer*) buffer channel:(ALChannelSource*) channel;
+
+/** Watch a source, counting it in numWatchedEnded when its voice ends.
+ *
+ * @param source The source to watch.
+ */
+- (void) watchSource:(id<ALSoundSource>) source;
+
+@end
+
+@implementation OALBenchmarkInstanceLimiter
+
+- (id) initWithMaxInstances:(NSUInteger) maxInstancesIn
+{
+	if(nil != (self = [super init]))
+	{
+		maxInstances = maxInstancesIn;
+		sources = calloc(maxInstances + 1, sizeof(*sources));
+		endTimes = calloc(maxInstances + 1, sizeof(*endTimes));
+		watchedSources = [[NSMutableSet alloc] init];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	free(sources);
+	free(endTimes);
+	[watchedSources release];
+	[super dealloc];
+}
+
+@synthesize numSuppressed;
+@synthesize numWatchedEnded;
+
+- (id<ALSoundSource>) play:(ALBuffer*) buffer channel:(ALChannelSource*) channel
+{
+	if(0 == maxInstances)
+	{
+		return [channel play:buffer];
+	}
+
+	@synchronized(self)
+	{
+		if(numInstances >= maxInstances)
+		{
+			double now = oal_mock_time();
+			NSUInteger kept = 0;
+			for(NSUInteger i = 0; i < numInstances; i++)
+			{
+				if(endTimes[i] > now)
+				{
+					sources[kept] = sources[i];
+					endTimes[kept] = endTimes[i];
+					kept++;
+				}
+			}
+			numInstances = kept;
+		}
+		if(numInstances >= maxInstances)
+		{
+			numSuppressed++;
+			return nil;
+		}
+	}
+
+	// The pool reports ended voices while holding its lock, so don't call the channel
+	// while holding this one.
+	id<ALSoundSource> source = [channel play:buffer];
+	if(nil != source)
+	{
+		@synchronized(self)
+		{
+			sources[numInstances] = source;
+			endTimes[numInstances] = oal_mock_time() + buffer.duration;
+			numInstances++;
+		}
+	}
+	return source;
+}
+
+- (void) watchSource:(id<ALSoundSource>) source
+{
+	@synchronized(self)
+	{
+		[watchedSources addObject:[NSValue valueWithNonretainedObject:source]];
+	}
+}
+
+- (void) sourcePool:(ALSoundSourcePool*) pool voiceEndedOnSource:(id<ALSoundSource>) source
+{
+	@synchronized(self)
+	{
+		for(NSUInteger i = 0; i < numInstances; i++)
+		{
+			if(sources[i] == source)
+			{
+				memmove(sources + i, sources + i + 1, (numInstances - i - 1) * sizeof(*sources));
+				memmove(endTimes + i, endTimes + i + 1, (numInstances - i - 1) * sizeof(*endTimes));
+				numInstances--;
+				break;
+			}
+		}
+		NSValue* key = [NSValue valueWithNonretainedObject:source];
+		if([watchedSources containsObject:key])
+		{
+			[watchedSources removeObject:key];
+			numWatchedEnded++;
+		}
+	}
+}
+
+@end
+
+
+#if !OBJECTAL_USE_COCOS2D_ACTIONS
+
+/** (INTERNAL USE) Exposes the action manager's step so it can be timed directly.
+ */
+@interface OALActionManager (OALBenchmark)
+
+- (void) step:(NSTimer*) timer;
+
+@end
+
+#endif /* !OBJECTAL_USE_COCOS2D_ACTIONS */
+
+
+#pragma mark -
+#pragma mark OALBenchmark
+
+@interface OALBenchmark (Private)
+
+/** (INTERNAL USE) Add a result, logging it as it comes in.
+ */
+- (void) addResult:(OALBenchmarkResult*) result;
+
+/** (INTERNAL USE) Make a context to run the voice heavy cases on.
+ * This is a context on a loopback device if possible, otherwise the current context.
+ *
+ * @param note Receives a description of what the context is on.
+ * @return The context.
+ */
+- (ALContext*) makeVoiceContext:(NSString**) note;
+
+/** (INTERNAL USE) Make a buffer of silence to play on the current context's device.
+ *
+ * @param seconds How long the buffer plays for.
+ * @return The buffer.
+ */
+- (ALBuffer*) makeSilentBuffer:(float) seconds;
+
+/** (INTERNAL USE) Decode a whole file into a buffer, as OALAudioSupport bufferFromFile: does
+ * on iOS (but without the decoded audio cache).
+ *
+ * @param filePath The file to load.
+ * @return The buffer, or nil if the file couldn't be decoded.
+ */
+- (ALBuffer*) bufferFromFile:(NSString*) filePath;
+
+/** (INTERNAL USE) Decode a whole file into a buffer, storing the decoded audio in a cache
+ * as OALAudioSupport bufferFromFile: does on a cache miss.
+ *
+ * @param filePath The file to load.
+ * @param cache The cache to store the decoded audio in (can be nil).
+ * @return The buffer, or nil if the file couldn't be decoded.
+ */
+- (ALBuffer*) bufferFromFile:(NSString*) filePath cache:(OALDecodedAudioCache*) cache;
+
+/** (INTERNAL USE) Write a set of distinct effect files, as a game would ship them.
+ *
+ * @param numEffects The number of effects to write.
+ * @param directory The directory to write them to (created if needed).
+ * @return The paths of the files, or nil if they couldn't all be written.
+ */
+- (NSArray*) writeEffects:(unsigned int) numEffects toDirectory:(NSString*) directory;
+
+/** (INTERNAL USE) Time ALChannelSource play: into a channel with free sources.
+ *
+ * @param context The context to make the channel on.
+ * @param note Description of the context.
+ */
+- (void) runChannelPlayOnContext:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time a steady stream of plays into a full channel, with playback time
+ * passing between frames so that sounds also finish on their own.
+ *
+ * @param context The context to make the channel on.
+ * @param note Description of the context.
+ */
+- (void) runPlayBurstOnContext:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time ALSoundSourcePool getFreeSource: taking sources from the ready queue,
+ * with each returned through notifySourceStopped:.
+ *
+ * @param numVoices The number of sources in the pool.
+ * @param context The context to make the sources on.
+ * @param note Description of the context.
+ */
+- (void) runGetFreeSourceFromReadyQueueWithVoices:(unsigned int) numVoices
+										  context:(ALContext*) context
+											 note:(NSString*) note;
+
+/** (INTERNAL USE) Time ALSoundSourcePool getFreeSource: with every voice busy.
+ *
+ * @param numVoices The number of sources in the pool.
+ * @param context The context to make the sources on.
+ * @param note Description of the context.
+ */
+- (void) runGetFreeSourceWithVoices:(unsigned int) numVoices context:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time ALChannelSource property changes.
+ *
+ * @param context The context to make the channel on.
+ * @param note Description of the context.
+ */
+- (void) runChannelFanOutOnContext:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time frames that change a playing channel's gain, pitch and position
+ * several times each, with the changes applied immediately or deferred and flushed once.
+ *
+ * @param deferred If TRUE, set deferUpdates and call flushUpdates at the end of each frame.
+ * @param context The context to make the channel on.
+ * @param note Description of the context.
+ */
+- (void) runChannelUpdatesDeferred:(bool) deferred context:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time frames of a channel with thousands of sources, most of them playing:
+ * each frame lets playback time pass, refreshes the source states, and plays a burst of
+ * sounds. Checks the channel's view of which sources are playing against the mock's.
+ *
+ * @param numSources The number of sources in the channel.
+ * @param context The context to make the channel on.
+ * @param note Description of the context.
+ */
+- (void) runMockStressWithSources:(unsigned int) numSources context:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time bursts of one effect fired into a channel that is also playing a set
+ * of loops, with the effect limited to a number of instances the way an OALEffectPolicy
+ * limits it in OALSimpleAudio (or not limited at all), counting the loops it cuts off.
+ *
+ * @param maxInstances The most instances of the effect that can play at once (0 = no limit).
+ * @param context The context to make the channel on.
+ * @param note Description of the context.
+ */
+- (void) runEffectBurstWithMaxInstances:(unsigned int) maxInstances context:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time muting and ducking an ALMixerBus that has many sources attached,
+ * of which only a few are playing.
+ *
+ * @param numAttached The number of sources attached to the bus.
+ * @param numPlaying The number of those sources that are playing.
+ * @param context The context to make the sources on.
+ * @param note Description of the context.
+ */
+- (void) runBusChangeWithSources:(unsigned int) numAttached
+						 playing:(unsigned int) numPlaying
+						 context:(ALContext*) context
+							note:(NSString*) note;
+
+/** (INTERNAL USE) Time starting a layered sound, either by playing each layer's source in
+ * turn or by preparing them in an ALSourceGroup and starting it, counting the OpenAL calls.
+ *
+ * @param numLayers The number of layers (sources) in the sound.
+ * @param grouped If TRUE, start the layers through an ALSourceGroup.
+ * @param context The context to make the sources on.
+ * @param note Description of the context.
+ */
+- (void) runLayeredStartWithLayers:(unsigned int) numLayers
+						   grouped:(bool) grouped
+						   context:(ALContext*) context
+							  note:(NSString*) note;
+
+/** (INTERNAL USE) Time frames like those of ChannelsDemo (1, 2, 3 and 8 source channels,
+ * played one tap at a time with a listener gain slider), with a game polling its sources'
+ * state each frame.
+ *
+ * @param refresh If TRUE, start each frame with ALContext refreshSourceStates.
+ * @param context The context to make the channels on.
+ * @param note Description of the context.
+ */
+- (void) runChannelsFrameWithRefresh:(bool) refresh context:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time play and property calls made by several threads at once, each on its
+ * own source.
+ *
+ * @param numThreads The number of threads.
+ * @param context The context to make the sources on.
+ * @param note Description of the context.
+ */
+- (void) runContentionWithThreads:(unsigned int) numThreads context:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time recording a call's statistics (what OBJECTAL_CFG_COLLECT_STATS adds
+ * to every OpenAL call), from several threads at once.
+ *
+ * @param numThreads The number of threads recording.
+ */
+- (void) runStatsRecordWithThreads:(unsigned int) numThreads;
+
+/** (INTERNAL USE) Time ALWrapper calls under the error checking policy this was built with
+ * (OBJECTAL_CFG_AL_ERROR_CHECKING), counting the alGetError() calls they make.
+ *
+ * @param context The context to make the source on.
+ * @param note Description of the context.
+ */
+- (void) runWrappedCallsOnContext:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time OALActionManager steps.
+ *
+ * @param numActions The number of running actions.
+ */
+- (void) runActionStepWithActions:(unsigned int) numActions;
+
+/** (INTERNAL USE) Run a linear gain ramp on a source while keeping the calling thread busy
+ * each frame, and measure how far the gain the source holds strays from the ideal ramp, and
+ * how evenly the action manager's steps arrive.
+ *
+ * @param context The context to make the source on.
+ * @param note Description of the context.
+ */
+- (void) runActionRampOnContext:(ALContext*) context note:(NSString*) note;
+
+/** (INTERNAL USE) Time buffer loading.
+ */
+- (void) runBufferLoad;
+
+/** (INTERNAL USE) Time loading every sound in a sound bank, from the bank and from files.
+ */
+- (void) runBankLoad;
+
+/** (INTERNAL USE) Time preloading a set of effect files one after the other, and decoded in
+ * parallel with one worker per core as OALSimpleAudio preloadEffects: does.
+ *
+ * @param numEffects The number of effect files to load.
+ */
+- (void) runPreloadWithEffects:(unsigned int) numEffects;
+
+/** (INTERNAL USE) Time loading a set of effect files without a cache, through a cold
+ * OALDecodedAudioCache, and mapped from a warm one.
+ *
+ * @param numEffects The number of effect files to load.
+ */
+- (void) runDecodedAudioCacheWithEffects:(unsigned int) numEffects;
+
+@end
+
+@implementation OALBenchmark
+
+#pragma mark Object Management
+
++ (id) benchmark
+{
+	return [[[self alloc] init] autorelease];
+}
+
+- (id) init
+{
+	if(nil != (self = [super init]))
+	{
+		iterations = 200;
+		results = [[NSMutableArray arrayWithCapacity:10] retain];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[loadFile release];
+	[bankFile release];
+	[results release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize iterations;
+@synthesize loadFile;
+@synthesize bankFile;
+@synthesize results;
+
+
+#pragma mark Running
+
+- (void) run
+{
+	[results removeAllObjects];
+
+	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+	NSString* note = nil;
+	ALContext* voiceContext = [self makeVoiceContext:&note];
+
+	// Sources are autoreleased, so release them after each voice heavy case to
+	// keep them from adding up.
+	NSAutoreleasePool* casePool = [[NSAutoreleasePool alloc] init];
+	[self runChannelPlayOnContext:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runPlayBurstOnContext:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runEffectBurstWithMaxInstances:0 context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runEffectBurstWithMaxInstances:4 context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runGetFreeSourceFromReadyQueueWithVoices:32 context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runGetFreeSourceWithVoices:8 context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runGetFreeSourceWithVoices:32 context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runGetFreeSourceWithVoices:256 context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runChannelFanOutOnContext:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runChannelUpdatesDeferred:NO context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runChannelUpdatesDeferred:YES context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runBusChangeWithSources:32 playing:8 context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runBusChangeWithSources:1024 playing:8 context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runLayeredStartWithLayers:4 grouped:NO context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runLayeredStartWithLayers:4 grouped:YES context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runChannelsFrameWithRefresh:NO context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runChannelsFrameWithRefresh:YES context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runContentionWithThreads:kNumContendingThreads context:voiceContext note:note];
+	[casePool release];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runMockStressWithSources:kNumStressSources context:voiceContext note:note];
+	[casePool release];
+
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runWrappedCallsOnContext:voiceContext note:note];
+	[casePool release];
+
+	[self runStatsRecordWithThreads:1];
+	[self runStatsRecordWithThreads:kNumContendingThreads];
+
+	[self runActionStepWithActions:10];
+	[self runActionStepWithActions:100];
+	[self runActionStepWithActions:1000];
+	casePool = [[NSAutoreleasePool alloc] init];
+	[self runActionRampOnContext:voiceContext note:note];
+	[casePool release];
+
+	[self runBufferLoad];
+	[self runBankLoad];
+	[self runDecodedAudioCacheWithEffects:kNumCacheEffects];
+	[self runPreloadWithEffects:kNumCacheEffects];
+	[pool release];
+}
+
+- (NSString*) JSONRepresentation
+{
+	NSMutableString* json = [NSMutableString stringWithCapacity:256 + [results count] * 200];
+	[json appendFormat:@"{\"iterations\":%lu,\"results\":[", (unsigned long)iterations];
+	bool first = YES;
+	for(OALBenchmarkResult* result in results)
+	{
+		if(!first)
+		{
+			[json appendString:@","];
+		}
+		[json appendString:[result JSONRepresentation]];
+		first = NO;
+	}
+	[json appendString:@"]}"];
+	return json;
+}
+
+
+#pragma mark Internal Use
+
+- (void) addResult:(OALBenchmarkResult*) result
+{
+	[results addObject:result];
+	NSLog(@"OALBenchmark: %@", result);
+}
+
+- (ALContext*) makeVoiceContext:(NSString**) note
+{
+	if([ALLoopbackDevice supported])
+	{
+		ALLoopbackDevice* device = [ALLoopbackDevice deviceWithFrequency:kBenchmarkFrequency];
+		if(nil != device)
+		{
+			ALContext* context = [ALContext contextOnDevice:device attributes:nil];
+			if(nil != context)
+			{
+				*note = @"loopback device";
+				return context;
+			}
+		}
+	}
+	*note = @"default device";
+	return [OpenALManager sharedInstance].currentContext;
+}
+
+- (ALBuffer*) makeSilentBuffer:(float) seconds
+{
+	ALsizei size = (ALsizei)(kBenchmarkFrequency * seconds) * sizeof(short);
+	void* data = calloc(1, size);
+	if(NULL == data)
+	{
+		return nil;
+	}
+	return [ALBuffer bufferWithName:@"OALBenchmark silence"
+							   data:data
+							   size:size
+							 format:AL_FORMAT_MONO16
+						  frequency:kBenchmarkFrequency];
+}
+
+- (ALBuffer*) bufferFromFile:(NSString*) filePath
+{
+	return [self bufferFromFile:filePath cache:nil];
+}
+
+- (ALBuffer*) bufferFromFile:(NSString*) filePath cache:(OALDecodedAudioCache*) cache
+{
+	NSURL* url = [NSURL fileURLWithPath:filePath];
+	id<OALAudioDecoder> decoder = [OALAudioDecoderRegistry decoderForUrl:url];
+	if(nil == decoder)
+	{
+		return nil;
+	}
+
+	uint32_t numFrames = (uint32_t)decoder.totalFrames;
+	uint32_t bytesPerFrame = decoder.bytesPerFrame;
+	void* data = malloc(numFrames * bytesPerFrame);
+	if(NULL == data)
+	{
+		OAL_LOG_ERROR(@"Could not allocate %d bytes for %@", numFrames * bytesPerFrame, filePath);
+		return nil;
+	}
+
+	uint32_t numFramesRead = 0;
+	while(numFramesRead < numFrames)
+	{
+		uint32_t numFramesThisRead = [decoder readFrames:numFrames - numFramesRead
+													into:(char*)data + numFramesRead * bytesPerFrame];
+		if(0 == numFramesThisRead)
+		{
+			break;
+		}
+		numFramesRead += numFramesThisRead;
+	}
+	if(0 == numFramesRead)
+	{
+		free(data);
+		return nil;
+	}
+
+	[cache storeData:data
+				size:(ALsizei)(numFramesRead * bytesPerFrame)
+			  format:decoder.format
+		   frequency:decoder.frequency
+			  forUrl:url];
+
+	// ALBuffer maintains this memory from here on.
+	return [ALBuffer bufferWithName:filePath
+							   data:data
+							   size:(ALsizei)(numFramesRead * bytesPerFrame)
+							 format:decoder.format
+						  frequency:decoder.frequency];
+}
+
+- (NSArray*) writeEffects:(unsigned int) numEffects toDirectory:(NSString*) directory
+{
+	NSMutableArray* paths = [NSMutableArray arrayWithCapacity:numEffects];
+	if(![[NSFileManager defaultManager] createDirectoryAtPath:directory
+								  withIntermediateDirectories:YES
+												   attributes:nil
+														error:nil])
+	{
+		return nil;
+	}
+	for(unsigned int i = 0; i < numEffects; i++)
+	{
+		NSString* path = [directory stringByAppendingPathComponent:
+						  [NSString stringWithFormat:@"effect-%03u.wav", i]];
+		if(![wavData((uint32_t)(kBenchmarkFrequency * kCacheEffectSeconds), 50 + i) writeToFile:path atomically:NO])
+		{
+			return nil;
+		}
+		[paths addObject:path];
+	}
+	return paths;
+}
+
+- (void) runChannelPlayOnContext:(ALContext*) context note:(NSString*) note
+{
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	ALBuffer* buffer = [self makeSilentBuffer:1.0f];
+	ALChannelSource* channel = [ALChannelSource channelWithSources:kOperationsPerSample];
+	NSString* name = [NSString stringWithFormat:@"channelPlay/%u", channel.reservedSources];
+
+	// Play into a cleared channel each time, so that every batch does the same work.
+	uint64_t numAlCalls = 0;
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		[channel stop];
+
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startTime = mach_absolute_time();
+		for(int j = 0; j < kOperationsPerSample; j++)
+		{
+			[channel play:buffer gain:1.0f pitch:1.0f pan:0.0f loop:NO priority:0];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / kOperationsPerSample;
+		numAlCalls += oal_mock_total_calls() - startCalls;
+		[pool release];
+	}
+	[channel stop];
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:iterations
+												  bytesPerOperation:0
+															   note:note];
+	result.alCallsPerOperation = (double)numAlCalls / (iterations * kOperationsPerSample);
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runPlayBurstOnContext:(ALContext*) context note:(NSString*) note
+{
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	// Each frame fires a full channel's worth of quarter second sounds, so most plays
+	// have to steal a voice, and some find one that has just finished.
+	ALBuffer* buffer = [self makeSilentBuffer:0.25f];
+	ALChannelSource* channel = [ALChannelSource channelWithSources:kOperationsPerSample];
+	NSString* name = [NSString stringWithFormat:@"playBurst/%u", channel.reservedSources];
+
+	uint64_t numAlCalls = 0;
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		oal_mock_advance(1.0 / kBenchmarkFrameRate);
+
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startTime = mach_absolute_time();
+		for(int j = 0; j < kOperationsPerSample; j++)
+		{
+			[channel play:buffer gain:1.0f pitch:1.0f pan:0.0f loop:NO priority:0];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / kOperationsPerSample;
+		numAlCalls += oal_mock_total_calls() - startCalls;
+		[pool release];
+	}
+	[channel stop];
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:iterations
+												  bytesPerOperation:0
+															   note:[NSString stringWithFormat:@"%d plays per frame at %d fps, %@",
+																	 kOperationsPerSample, kBenchmarkFrameRate, note]];
+	result.alCallsPerOperation = (double)numAlCalls / (iterations * kOperationsPerSample);
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runEffectBurstWithMaxInstances:(unsigned int) maxInstances context:(ALContext*) context note:(NSString*) note
+{
+	NSString* name = 0 == maxInstances ? @"effectBurst/unlimited"
+		: [NSString stringWithFormat:@"effectBurst/limited/%u", maxInstances];
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	// A channel like OALSimpleAudio's (32 interruptible sources), with loops playing under
+	// a rapid fire effect that lasts half a second.
+	ALBuffer* loopBuffer = [self makeSilentBuffer:2.0f];
+	ALBuffer* effectBuffer = [self makeSilentBuffer:0.5f];
+	ALChannelSource* channel = [ALChannelSource channelWithSources:32];
+	channel.interruptible = YES;
+	OALBenchmarkInstanceLimiter* limiter = [[[OALBenchmarkInstanceLimiter alloc] initWithMaxInstances:maxInstances] autorelease];
+	channel.sourcePool.delegate = limiter;
+	for(int i = 0; i < kNumBurstLoops; i++)
+	{
+		[limiter watchSource:[channel play:loopBuffer loop:YES]];
+	}
+
+	uint64_t numAlCalls = 0;
+	uint64_t numPlays = 0;
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		oal_mock_advance(1.0 / kBenchmarkFrameRate);
+
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startPlays = oal_mock_call_count("alSourcePlay");
+		uint64_t startTime = mach_absolute_time();
+		for(int j = 0; j < kBurstPlaysPerFrame; j++)
+		{
+			[limiter play:effectBuffer channel:channel];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / kBurstPlaysPerFrame;
+		numAlCalls += oal_mock_total_calls() - startCalls;
+		numPlays += oal_mock_call_count("alSourcePlay") - startPlays;
+		[pool release];
+	}
+	[channel stop];
+	channel.sourcePool.delegate = nil;
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:iterations
+												  bytesPerOperation:0
+															   note:[NSString stringWithFormat:@"%d plays per frame at %d fps: %llu reached OpenAL, %lu turned away, %lu of %d loops cut off, %@",
+																	 kBurstPlaysPerFrame, kBenchmarkFrameRate,
+																	 (unsigned long long)numPlays, (unsigned long)limiter.numSuppressed,
+																	 (unsigned long)limiter.numWatchedEnded, kNumBurstLoops, note]];
+	result.alCallsPerOperation = (double)numAlCalls / (iterations * kBurstPlaysPerFrame);
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runGetFreeSourceFromReadyQueueWithVoices:(unsigned int) numVoices
+										  context:(ALContext*) context
+											 note:(NSString*) note
+{
+	NSString* name = [NSString stringWithFormat:@"getFreeSource/ready/%u", numVoices];
+	ALSoundSourcePool* pool = [ALSoundSourcePool pool];
+	for(unsigned int i = 0; i < numVoices; i++)
+	{
+		ALSource* source = [ALSource sourceOnContext:context];
+		if((ALuint)AL_INVALID == source.sourceId)
+		{
+			[self addResult:[OALBenchmarkResult resultWithName:name
+													   timings:NULL
+													numTimings:0
+											 bytesPerOperation:0
+														  note:[NSString stringWithFormat:@"Only %u voices available on %@",
+																i, note]]];
+			return;
+		}
+		[pool addSource:source];
+	}
+
+	// Each sample takes every source, then hands them all back as stopped.
+	id<ALSoundSource>* acquired = malloc(sizeof(*acquired) * numVoices);
+	uint64_t numAlCalls = 0;
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startTime = mach_absolute_time();
+		for(unsigned int j = 0; j < numVoices; j++)
+		{
+			acquired[j] = [pool getFreeSource:NO];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / numVoices;
+		numAlCalls += oal_mock_total_calls() - startCalls;
+
+		for(unsigned int j = 0; j < numVoices; j++)
+		{
+			[pool notifySourceStopped:acquired[j]];
+		}
+	}
+	free(acquired);
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:iterations
+												  bytesPerOperation:0
+															   note:note];
+	result.alCallsPerOperation = (double)numAlCalls / (iterations * numVoices);
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runGetFreeSourceWithVoices:(unsigned int) numVoices context:(ALContext*) context note:(NSString*) note
+{
+	NSString* name = [NSString stringWithFormat:@"getFreeSource/%u", numVoices];
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	ALBuffer* buffer = [self makeSilentBuffer:1.0f];
+	ALSoundSourcePool* pool = [ALSoundSourcePool pool];
+	for(unsigned int i = 0; i < numVoices; i++)
+	{
+		ALSource* source = [ALSource sourceOnContext:context];
+		if((ALuint)AL_INVALID == source.sourceId)
+		{
+			break;
+		}
+		[pool addSource:source];
+	}
+
+	unsigned int numSources = [pool.sources count];
+	if(nil == buffer || numSources < numVoices)
+	{
+		[pool.sources makeObjectsPerformSelector:@selector(stop)];
+		manager.currentContext = oldContext;
+		[self addResult:[OALBenchmarkResult resultWithName:name
+												   timings:NULL
+												numTimings:0
+										 bytesPerOperation:0
+													  note:[NSString stringWithFormat:@"Only %u voices available on %@",
+															numSources, note]]];
+		return;
+	}
+
+	// Keep every voice busy so that each request has to find a voice to steal.
+	for(unsigned int i = 0; i < numVoices; i++)
+	{
+		[[pool getFreeSource:NO] play:buffer loop:YES];
+	}
+
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		uint64_t startTime = mach_absolute_time();
+		id<ALSoundSource> source = [pool getFreeSource:YES];
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+		[source play:buffer loop:YES];
+	}
+
+	[pool.sources makeObjectsPerformSelector:@selector(stop)];
+	manager.currentContext = oldContext;
+
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:timings
+											numTimings:iterations
+									 bytesPerOperation:0
+												  note:note]];
+	free(timings);
+}
+
+- (void) runChannelFanOutOnContext:(ALContext*) context note:(NSString*) note
+{
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	ALChannelSource* channel = [ALChannelSource channelWithSources:32];
+	NSString* name = [NSString stringWithFormat:@"channelFanOut/%u", channel.reservedSources];
+
+	// Each sample changes gain, pitch, and pan once.
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		float value = (i % 2) ? 0.5f : 0.25f;
+		uint64_t startTime = mach_absolute_time();
+		channel.gain = value;
+		channel.pitch = value * 2;
+		channel.pan = value;
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / 3;
+	}
+
+	manager.currentContext = oldContext;
+
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:timings
+											numTimings:iterations
+									 bytesPerOperation:0
+												  note:note]];
+	free(timings);
+}
+
+- (void) runChannelUpdatesDeferred:(bool) deferred context:(ALContext*) context note:(NSString*) note
+{
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	ALBuffer* buffer = [self makeSilentBuffer:1.0f];
+	ALChannelSource* channel = [ALChannelSource channelWithSources:32];
+	NSString* name = [NSString stringWithFormat:@"channelUpdates/%@/%u",
+					  deferred ? @"deferred" : @"immediate", channel.reservedSources];
+	for(unsigned int i = 0; i < channel.reservedSources; i++)
+	{
+		[channel play:buffer loop:YES];
+	}
+	channel.deferUpdates = deferred;
+
+	// Each frame is what a game updating a fade and a moving emitter from several places does.
+	uint64_t numAlCalls = 0;
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startTime = mach_absolute_time();
+		for(int j = 0; j < kChangesPerFrame; j++)
+		{
+			float value = 0.5f + (float)((i * kChangesPerFrame + j) % 64) / 128;
+			channel.gain = value;
+			channel.pitch = value * 2;
+			channel.position = alpoint(value, 0, -value);
+		}
+		if(deferred)
+		{
+			[channel flushUpdates];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+		numAlCalls += oal_mock_total_calls() - startCalls;
+	}
+	channel.deferUpdates = NO;
+	[channel stop];
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:iterations
+												  bytesPerOperation:0
+															   note:[NSString stringWithFormat:@"Per frame: gain, pitch and position each changed %d times on %u playing sources, %@",
+																	 kChangesPerFrame, channel.reservedSources, note]];
+	result.alCallsPerOperation = (double)numAlCalls / iterations;
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runBusChangeWithSources:(unsigned int) numAttached
+						 playing:(unsigned int) numPlaying
+						 context:(ALContext*) context
+							note:(NSString*) note
+{
+	NSString* name = [NSString stringWithFormat:@"busChange/%u/%u", numAttached, numPlaying];
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	// A sound effects bus under a master bus, with a level's worth of sources attached.
+	ALMixerBus* master = [ALMixerBus bus];
+	ALMixerBus* effects = [ALMixerBus busWithParent:master];
+	ALBuffer* buffer = [self makeSilentBuffer:1.0f];
+	unsigned int numExisting = oal_mock_num_sources();
+	oal_mock_set_max_sources(numExisting + numAttached);
+	NSMutableArray* sources = [NSMutableArray arrayWithCapacity:numAttached];
+	for(unsigned int i = 0; i < numAttached; i++)
+	{
+		ALSource* source = [ALSource sourceOnContext:context];
+		if((ALuint)AL_INVALID == source.sourceId)
+		{
+			break;
+		}
+		source.bus = effects;
+		[sources addObject:source];
+	}
+	if(nil == buffer || [sources count] < numAttached)
+	{
+		for(ALSource* source in sources)
+		{
+			source.bus = nil;
+		}
+		oal_mock_set_max_sources(256);
+		manager.currentContext = oldContext;
+		[self addResult:[OALBenchmarkResult resultWithName:name
+												   timings:NULL
+												numTimings:0
+										 bytesPerOperation:0
+													  note:[NSString stringWithFormat:@"Only %lu voices available on %@",
+															(unsigned long)[sources count], note]]];
+		return;
+	}
+	for(unsigned int i = 0; i < numPlaying; i++)
+	{
+		[[sources objectAtIndex:i * (numAttached / numPlaying)] play:buffer loop:YES];
+	}
+
+	// Each sample mutes and unmutes the bus, then ducks it and brings it back.
+	uint64_t numAlCalls = 0;
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startTime = mach_absolute_time();
+		effects.muted = YES;
+		effects.muted = NO;
+		effects.gain = 0.3f;
+		effects.gain = 1.0f;
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / 4;
+		numAlCalls += oal_mock_total_calls() - startCalls;
+	}
+
+	for(ALSource* source in sources)
+	{
+		[source stop];
+		source.bus = nil;
+	}
+	oal_mock_set_max_sources(256);
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:iterations
+												  bytesPerOperation:0
+															   note:[NSString stringWithFormat:@"Per bus mute, unmute or gain change, %u sources attached, %u playing, %@",
+																	 numAttached, numPlaying, note]];
+	result.alCallsPerOperation = (double)numAlCalls / (iterations * 4);
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runLayeredStartWithLayers:(unsigned int) numLayers
+						   grouped:(bool) grouped
+						   context:(ALContext*) context
+							  note:(NSString*) note
+{
+	NSString* name = [NSString stringWithFormat:@"layeredStart/%@/%u", grouped ? @"group" : @"individual", numLayers];
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	ALBuffer* buffer = [self makeSilentBuffer:1.0f];
+	NSMutableArray* sources = [NSMutableArray arrayWithCapacity:numLayers];
+	for(unsigned int i = 0; i < numLayers; i++)
+	{
+		ALSource* source = [ALSource sourceOnContext:context];
+		if((ALuint)AL_INVALID == source.sourceId)
+		{
+			manager.currentContext = oldContext;
+			[self addResult:[OALBenchmarkResult resultWithName:name
+													   timings:NULL
+													numTimings:0
+											 bytesPerOperation:0
+														  note:[NSString stringWithFormat:@"Only %u voices available on %@",
+																i, note]]];
+			return;
+		}
+		[sources addObject:source];
+	}
+	ALSourceGroup* group = [ALSourceGroup groupWithSources:sources];
+
+	// Each sample starts the whole sound once, each layer with its own gain and pan.
+	uint64_t numAlCalls = 0;
+	uint64_t numStartCalls = 0;
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		[group stop];
+
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startStarts = oal_mock_call_count("alSourcePlay") + oal_mock_call_count("alSourcePlayv");
+		uint64_t startTime = mach_absolute_time();
+		for(unsigned int j = 0; j < numLayers; j++)
+		{
+			float pan = (float)j / numLayers * 2 - 1;
+			if(grouped)
+			{
+				[group prepareSource:[sources objectAtIndex:j] buffer:buffer gain:0.8f pitch:1.0f pan:pan loop:NO];
+			}
+			else
+			{
+				[[sources objectAtIndex:j] play:buffer gain:0.8f pitch:1.0f pan:pan loop:NO];
+			}
+		}
+		if(grouped)
+		{
+			[group play];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+		numAlCalls += oal_mock_total_calls() - startCalls;
+		numStartCalls += oal_mock_call_count("alSourcePlay") + oal_mock_call_count("alSourcePlayv") - startStarts;
+	}
+	[group stop];
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:iterations
+												  bytesPerOperation:0
+															   note:[NSString stringWithFormat:@"Per %u layer sound, %.1f alSourcePlay/alSourcePlayv calls, %@",
+																	 numLayers, (double)numStartCalls / iterations, note]];
+	result.alCallsPerOperation = (double)numAlCalls / iterations;
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runChannelsFrameWithRefresh:(bool) refresh context:(ALContext*) context note:(NSString*) note
+{
+	NSString* name = refresh ? @"channelsFrame/refreshed" : @"channelsFrame/polled";
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	ALBuffer* buffer = [self makeSilentBuffer:0.25f];
+	NSArray* channels = [NSArray arrayWithObjects:
+						 [ALChannelSource channelWithSources:1],
+						 [ALChannelSource channelWithSources:2],
+						 [ALChannelSource channelWithSources:3],
+						 [ALChannelSource channelWithSources:8],
+						 nil];
+	NSUInteger numSources = 0;
+	for(ALChannelSource* channel in channels)
+	{
+		numSources += channel.reservedSources;
+	}
+
+	// Source states are trusted for a frame's worth of real time, so frames really have to
+	// be a frame apart. That's slow, so take fewer samples.
+	NSUInteger numFrames = iterations / 4 > 0 ? iterations / 4 : 1;
+	uint64_t numAlCalls = 0;
+	NSUInteger numPlaying = 0;
+	double* timings = malloc(sizeof(*timings) * numFrames);
+	for(NSUInteger i = 0; i < numFrames; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		[NSThread sleepForTimeInterval:1.0 / kBenchmarkFrameRate];
+		oal_mock_advance(1.0 / kBenchmarkFrameRate);
+
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startTime = mach_absolute_time();
+		if(refresh)
+		{
+			[context refreshSourceStates];
+		}
+
+		// A tap on one of the channel buttons, and a move of the gain slider.
+		[[channels objectAtIndex:i % [channels count]] play:buffer];
+		context.listener.gain = (i & 1) ? 1.0f : 0.8f;
+
+		// What a game checks about its sounds every frame.
+		if(buffer.frequency > 0 && buffer.size > 0)
+		{
+			for(ALChannelSource* channel in channels)
+			{
+				for(id<ALSoundSource> source in channel.sourcePool.sources)
+				{
+					if(source.playing && !source.looping && source.pitch > 0)
+					{
+						numPlaying++;
+					}
+				}
+			}
+		}
+
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+		numAlCalls += oal_mock_total_calls() - startCalls;
+		[pool release];
+	}
+	for(ALChannelSource* channel in channels)
+	{
+		[channel stop];
+	}
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:numFrames
+												  bytesPerOperation:0
+															   note:[NSString stringWithFormat:@"Per frame: 1 play, 1 listener gain change and %lu property reads over %lu sources (%.1f playing on average), %@",
+																	 (unsigned long)(numSources * 3 + 2), (unsigned long)numSources,
+																	 (double)numPlaying / numFrames, note]];
+	result.alCallsPerOperation = (double)numAlCalls / numFrames;
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runContentionWithThreads:(unsigned int) numThreads context:(ALContext*) context note:(NSString*) note
+{
+	NSString* name = [NSString stringWithFormat:@"contention/%u", numThreads];
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	NSString* mode = @"audio command thread";
+#else
+	NSString* mode = @"ALWrapper lock";
+#endif
+
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+	ALBuffer* buffer = [self makeSilentBuffer:1.0f];
+
+	NSMutableArray* sources = [NSMutableArray arrayWithCapacity:numThreads];
+	for(unsigned int i = 0; i < numThreads; i++)
+	{
+		ALSource* source = [ALSource sourceOnContext:context];
+		if((ALuint)AL_INVALID == source.sourceId)
+		{
+			manager.currentContext = oldContext;
+			[self addResult:[OALBenchmarkResult resultWithName:name
+													   timings:NULL
+													numTimings:0
+											 bytesPerOperation:0
+														  note:[NSString stringWithFormat:@"Only %u voices available on %@",
+																i, note]]];
+			return;
+		}
+		[sources addObject:source];
+	}
+
+	// Every thread waits at the gate so that they all start calling at once.
+	OALBenchmarkGate* gate = [[[OALBenchmarkGate alloc] init] autorelease];
+	double* timings = malloc(sizeof(*timings) * iterations * numThreads);
+	for(unsigned int i = 0; i < numThreads; i++)
+	{
+		OALBenchmarkContentionWorker* worker = [[OALBenchmarkContentionWorker alloc] initWithGate:gate
+																						   source:[sources objectAtIndex:i]
+																						   buffer:buffer
+																						  timings:timings + i * iterations
+																					   numSamples:iterations];
+		[NSThread detachNewThreadSelector:@selector(run:) toTarget:worker withObject:nil];
+		[worker release];
+	}
+	[gate openWhenWaiting:numThreads];
+	uint64_t startTime = mach_absolute_time();
+	[gate waitUntilFinished:numThreads];
+
+	// Reads wait for any queued commands, so this includes the time to drain the queue.
+	[ALWrapper getSourcei:((ALSource*)[sources objectAtIndex:0]).sourceId parameter:AL_SOURCE_STATE];
+	double elapsed = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+
+	for(ALSource* source in sources)
+	{
+		[source stop];
+	}
+	manager.currentContext = oldContext;
+
+	NSUInteger numCalls = iterations * numThreads * kOperationsPerSample;
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:timings
+											numTimings:iterations * numThreads
+									 bytesPerOperation:0
+												  note:[NSString stringWithFormat:@"%@, %.0f calls/s across all threads, %@",
+														mode, numCalls / elapsed, note]]];
+	free(timings);
+}
+
+- (void) runWrappedCallsOnContext:(ALContext*) context note:(NSString*) note
+{
+#if OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_ALWAYS
+	NSString* name = @"wrappedCalls/always";
+#elif OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_SAMPLED
+	NSString* name = @"wrappedCalls/sampled";
+#elif OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_PER_FRAME
+	NSString* name = @"wrappedCalls/per-frame";
+#else
+	NSString* name = @"wrappedCalls/off";
+#endif
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	ALSource* source = [ALSource sourceOnContext:context];
+	if((ALuint)AL_INVALID == source.sourceId)
+	{
+		manager.currentContext = oldContext;
+		[self addResult:[OALBenchmarkResult resultWithName:name
+												   timings:NULL
+												numTimings:0
+										 bytesPerOperation:0
+													  note:[NSString stringWithFormat:@"No voices available on %@", note]]];
+		return;
+	}
+	ALuint sourceId = source.sourceId;
+
+	// Each sample is a frame's worth of calls, ending with the check a game would make once
+	// per frame (which only looks for errors in the per-frame mode).
+	NSUInteger numFrames = kNumWrappedCalls / kWrappedCallsPerFrame;
+	uint64_t startErrorChecks = oal_mock_call_count("alGetError");
+	uint64_t startCalls = oal_mock_total_calls();
+	double* timings = malloc(sizeof(*timings) * numFrames);
+	for(NSUInteger i = 0; i < numFrames; i++)
+	{
+		uint64_t startTime = mach_absolute_time();
+		for(int j = 0; j < kWrappedCallsPerFrame; j++)
+		{
+			[ALWrapper sourcef:sourceId parameter:AL_GAIN value:(j & 1) ? 0.5f : 1.0f];
+		}
+		[ALWrapper checkErrors];
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / kWrappedCallsPerFrame;
+	}
+
+	// Reads wait for any queued commands, so this counts the calls the command thread makes.
+	[ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE];
+	uint64_t numErrorChecks = oal_mock_call_count("alGetError") - startErrorChecks;
+	uint64_t numAlCalls = oal_mock_total_calls() - startCalls;
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:numFrames
+												  bytesPerOperation:0
+															   note:[NSString stringWithFormat:@"%d alSourcef calls with a checkErrors every %d, %llu alGetError calls, %@",
+																	 kNumWrappedCalls, kWrappedCallsPerFrame,
+																	 (unsigned long long)numErrorChecks, note]];
+	result.alCallsPerOperation = (double)numAlCalls / kNumWrappedCalls;
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runStatsRecordWithThreads:(unsigned int) numThreads
+{
+	NSString* name = [NSString stringWithFormat:@"statsRecord/%u", numThreads];
+#if OBJECTAL_CFG_COLLECT_STATS
+	NSString* mode = @"ALWrapper recording statistics";
+#else
+	NSString* mode = @"ALWrapper not recording statistics";
+#endif
+
+	// Start from empty tables, so that the first calls also pay for adding each function.
+	oal_stats_reset();
+
+	OALBenchmarkGate* gate = [[[OALBenchmarkGate alloc] init] autorelease];
+	double* timings = malloc(sizeof(*timings) * iterations * numThreads);
+	for(unsigned int i = 0; i < numThreads; i++)
+	{
+		OALBenchmarkStatsWorker* worker = [[OALBenchmarkStatsWorker alloc] initWithGate:gate
+																				 timings:timings + i * iterations
+																			  numSamples:iterations];
+		[NSThread detachNewThreadSelector:@selector(run:) toTarget:worker withObject:nil];
+		[worker release];
+	}
+	[gate openWhenWaiting:numThreads];
+	uint64_t startTime = mach_absolute_time();
+	[gate waitUntilFinished:numThreads];
+	double elapsed = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+
+	// Merging the threads' counts is part of what reading them costs.
+	startTime = mach_absolute_time();
+	oal_stats_totals totals;
+	oal_stats_get_totals(&totals);
+	double mergeTime = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+	oal_stats_reset();
+
+	NSUInteger numCalls = iterations * numThreads * kOperationsPerSample;
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:timings
+											numTimings:iterations * numThreads
+									 bytesPerOperation:0
+												  note:[NSString stringWithFormat:@"%u functions, %.0f calls/s across all threads, %.3f us to read the totals, %@",
+														kNumStatsFunctions, numCalls / elapsed, mergeTime * 1000000.0, mode]]];
+	free(timings);
+}
+
+- (void) runMockStressWithSources:(unsigned int) numSources context:(ALContext*) context note:(NSString*) note
+{
+	NSString* name = [NSString stringWithFormat:@"mockStress/%u", numSources];
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	// Sounds a bit over a second long, so that at kStressPlaysPerFrame plays per frame
+	// nearly every source is busy and plays start having to steal.
+	unsigned int numExisting = oal_mock_num_sources();
+	oal_mock_set_max_sources(numExisting + numSources);
+	ALBuffer* buffer = [self makeSilentBuffer:(float)numSources / (kStressPlaysPerFrame * kBenchmarkFrameRate) + 0.1f];
+	ALChannelSource* channel = [ALChannelSource channelWithSources:numSources];
+	unsigned int numCreated = oal_mock_num_sources() - numExisting;
+	if(nil == buffer || numCreated < numSources)
+	{
+		channel.reservedSources = 0;
+		oal_mock_set_max_sources(256);
+		manager.currentContext = oldContext;
+		[self addResult:[OALBenchmarkResult resultWithName:name
+												   timings:NULL
+												numTimings:0
+										 bytesPerOperation:0
+													  note:[NSString stringWithFormat:@"Only %u voices available on %@",
+															numCreated, note]]];
+		return;
+	}
+
+	uint64_t numAlCalls = 0;
+	NSUInteger numMismatches = 0;
+	NSUInteger numPlaying = 0;
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		oal_mock_advance(1.0 / kBenchmarkFrameRate);
+
+		uint64_t startCalls = oal_mock_total_calls();
+		uint64_t startTime = mach_absolute_time();
+		[context refreshSourceStates];
+		for(int j = 0; j < kStressPlaysPerFrame; j++)
+		{
+			[channel play:buffer gain:1.0f pitch:1.0f pan:0.0f loop:NO priority:0];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+		numAlCalls += oal_mock_total_calls() - startCalls;
+
+		// Every source the channel thinks is playing should be playing in the mock, and
+		// vice versa. Only the channel's sources play on the mock during this case.
+		[context refreshSourceStates];
+		NSUInteger numChannelPlaying = 0;
+		for(id<ALSoundSource> source in channel.sourcePool.sources)
+		{
+			if(source.playing)
+			{
+				numChannelPlaying++;
+			}
+		}
+		if(numChannelPlaying != oal_mock_num_playing_sources())
+		{
+			numMismatches++;
+		}
+		numPlaying += numChannelPlaying;
+		[pool release];
+	}
+	[channel stop];
+	channel.reservedSources = 0;
+	oal_mock_set_max_sources(256);
+	manager.currentContext = oldContext;
+
+	OALBenchmarkResult* result = [OALBenchmarkResult resultWithName:name
+															timings:timings
+														 numTimings:iterations
+												  bytesPerOperation:0
+															   note:[NSString stringWithFormat:@"Per frame: refreshSourceStates and %d plays, %.0f sources playing on average, %lu frames where the channel and the mock disagreed on how many were playing, %@",
+																	 kStressPlaysPerFrame, (double)numPlaying / iterations,
+																	 (unsigned long)numMismatches, note]];
+	result.alCallsPerOperation = (double)numAlCalls / iterations;
+	[self addResult:result];
+	free(timings);
+}
+
+- (void) runActionStepWithActions:(unsigned int) numActions
+{
+	NSString* name = [NSString stringWithFormat:@"actionStep/%u", numActions];
+#if OBJECTAL_USE_COCOS2D_ACTIONS
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:NULL
+											numTimings:0
+									 bytesPerOperation:0
+												  note:@"Actions are run by cocos2d"]];
+#else
+	OALActionManager* actionManager = [OALActionManager sharedInstance];
+	NSMutableArray* actions = [NSMutableArray arrayWithCapacity:numActions];
+	for(unsigned int i = 0; i < numActions; i++)
+	{
+		// Long enough that none of them finish while being timed.
+		OALGainAction* action = [OALGainAction actionWithDuration:10000 endValue:1];
+		[action runWithTarget:[[[OALBenchmarkTarget alloc] init] autorelease]];
+		[actions addObject:action];
+	}
+
+	// The first step adds the new actions.
+	[actionManager step:nil];
+
+	double* timings = malloc(sizeof(*timings) * iterations);
+	for(NSUInteger i = 0; i < iterations; i++)
+	{
+		uint64_t startTime = mach_absolute_time();
+		[actionManager step:nil];
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+	}
+
+	[actions makeObjectsPerformSelector:@selector(stopAction)];
+	[actionManager step:nil];
+
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:timings
+											numTimings:iterations
+									 bytesPerOperation:0
+												  note:nil]];
+	free(timings);
+#endif /* OBJECTAL_USE_COCOS2D_ACTIONS */
+}
+
+- (void) runActionRampOnContext:(ALContext*) context note:(NSString*) note
+{
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+	NSString* name = @"actionRamp/thread";
+	double stepInterval = kActionThreadStepInterval;
+#else
+	NSString* name = @"actionRamp/timer";
+	double stepInterval = kActionStepInterval;
+#endif
+#if OBJECTAL_USE_COCOS2D_ACTIONS
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:NULL
+											numTimings:0
+									 bytesPerOperation:0
+												  note:@"Actions are run by cocos2d"]];
+#else
+	OpenALManager* manager = [OpenALManager sharedInstance];
+	ALContext* oldContext = manager.currentContext;
+	manager.currentContext = context;
+
+	OALBenchmarkRampSource* source = [OALBenchmarkRampSource sourceOnContext:context];
+	ALBuffer* buffer = [self makeSilentBuffer:1.0f];
+	if((ALuint)AL_INVALID == source.sourceId || nil == buffer)
+	{
+		manager.currentContext = oldContext;
+		[self addResult:[OALBenchmarkResult resultWithName:name
+												   timings:NULL
+												numTimings:0
+										 bytesPerOperation:0
+													  note:[NSString stringWithFormat:@"No voices available on %@", note]]];
+		return;
+	}
+	[source play:buffer loop:YES];
+	source.gain = 0;
+
+	// Steps come from a timer on this thread's run loop (or from the scheduler thread), so
+	// run the loop between frames of busy work, the way a game's main thread would.
+	NSUInteger maxChanges = (NSUInteger)(kRampSeconds / stepInterval) * 4 + 16;
+	[source recordGainChanges:maxChanges];
+	OALGainAction* action = [OALGainAction actionWithDuration:kRampSeconds
+												   startValue:0
+													 endValue:1
+													 function:[OALLinearFunction function]];
+	[action runWithTarget:source];
+	uint64_t workTime = mach_absolute_from_seconds(kRampGameWorkSeconds);
+	NSTimeInterval idleTime = 1.0 / kBenchmarkFrameRate - kRampGameWorkSeconds;
+	while(action.running)
+	{
+		uint64_t workEnd = mach_absolute_time() + workTime;
+		while(mach_absolute_time() < workEnd)
+		{
+		}
+		[[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:idleTime]];
+	}
+	[source stop];
+	manager.currentContext = oldContext;
+
+	// The gain a source holds is the last value it was given, so the error is largest just
+	// before each change: compare the previous value against the ideal ramp at that moment.
+	// The first change is the one runWithTarget: makes.
+	NSUInteger numChanges = source.numGainChanges;
+	NSUInteger numSteps = numChanges > 1 ? numChanges - 1 : 0;
+	double* deviations = malloc(sizeof(*deviations) * (numSteps > 0 ? numSteps : 1));
+	double* intervals = malloc(sizeof(*intervals) * (numSteps > 0 ? numSteps : 1));
+	uint64_t previousTime;
+	float previousValue = [source gainChange:0 time:&previousTime];
+	double maxJitter = 0;
+	for(NSUInteger i = 0; i < numSteps; i++)
+	{
+		uint64_t time;
+		float value = [source gainChange:i + 1 time:&time];
+		double elapsed = mach_absolute_difference_seconds(time, action.startTime);
+		double ideal = elapsed < kRampSeconds ? elapsed / kRampSeconds : 1.0;
+		deviations[i] = fabs(ideal - previousValue);
+		intervals[i] = mach_absolute_difference_seconds(time, previousTime);
+		double jitter = fabs(intervals[i] - stepInterval);
+		if(jitter > maxJitter)
+		{
+			maxJitter = jitter;
+		}
+		previousTime = time;
+		previousValue = value;
+	}
+
+	double maxDeviation = 0;
+	double p99Deviation = 0;
+	if(numSteps > 0)
+	{
+		qsort(deviations, numSteps, sizeof(*deviations), compareDoubles);
+		NSUInteger rank = (NSUInteger)ceil(numSteps * 0.99);
+		maxDeviation = deviations[numSteps - 1];
+		p99Deviation = deviations[(rank > 0 ? rank : 1) - 1];
+	}
+
+	// The timings are the intervals between steps.
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:intervals
+											numTimings:numSteps
+									 bytesPerOperation:0
+												  note:[NSString stringWithFormat:@"%.1f s linear gain ramp, %.0f ms busy per %d fps frame, %lu steps at %.1f ms nominal: deviation from the ideal ramp max %.4f, p99 %.4f; step jitter max %.3f ms, %@",
+														kRampSeconds, kRampGameWorkSeconds * 1000.0, kBenchmarkFrameRate,
+														(unsigned long)numSteps, stepInterval * 1000.0,
+														maxDeviation, p99Deviation, maxJitter * 1000.0, note]]];
+	free(deviations);
+	free(intervals);
+#endif /* OBJECTAL_USE_COCOS2D_ACTIONS */
+}
+
+- (void) runBufferLoad
+{
+	NSString* name = @"bufferLoad";
+	if(nil == loadFile)
+	{
+		[self addResult:[OALBenchmarkResult resultWithName:name
+												   timings:NULL
+												numTimings:0
+										 bytesPerOperation:0
+													  note:@"No load file set"]];
+		return;
+	}
+
+	// Loading a whole file is slow, so take fewer samples.
+	NSUInteger numSamples = iterations / 10 > 0 ? iterations / 10 : 1;
+	NSUInteger size = 0;
+	double* timings = malloc(sizeof(*timings) * numSamples);
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		uint64_t startTime = mach_absolute_time();
+		ALBuffer* buffer = [self bufferFromFile:loadFile];
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+		size = buffer.size;
+		[pool release];
+		if(0 == size)
+		{
+			break;
+		}
+	}
+
+	[self addResult:[OALBenchmarkResult resultWithName:name
+											   timings:timings
+											numTimings:size > 0 ? numSamples : 0
+									 bytesPerOperation:size
+												  note:size > 0 ? nil : [NSString stringWithFormat:@"Could not load %@", loadFile]]];
+	free(timings);
+}
+
+- (void) runBankLoad
+{
+	if(nil == bankFile)
+	{
+		[self addResult:[OALBenchmarkResult resultWithName:@"bankLoad"
+												   timings:NULL
+												numTimings:0
+										 bytesPerOperation:0
+													  note:@"No bank file set"]];
+		return;
+	}
+
+	OALSoundBank* firstBank = [OALSoundBank bankWithFile:bankFile];
+	NSArray* names = firstBank.names;
+	if(0 == [names count])
+	{
+		[self addResult:[OALBenchmarkResult resultWithName:@"bankLoad"
+												   timings:NULL
+												numTimings:0
+										 bytesPerOperation:0
+													  note:[NSString stringWithFormat:@"Could not load %@", bankFile]]];
+		return;
+	}
+	NSUInteger numSounds = [names count];
+	NSString* note = [NSString stringWithFormat:@"%lu sounds", (unsigned long)numSounds];
+
+	// Loading whole sets of sounds is slow, so take fewer samples.
+	NSUInteger numSamples = iterations / 10 > 0 ? iterations / 10 : 1;
+	double* timings = malloc(sizeof(*timings) * numSamples);
+
+	// Open the bank and make a buffer for every sound in it.
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		uint64_t startTime = mach_absolute_time();
+		OALSoundBank* bank = [OALSoundBank bankWithFile:bankFile];
+		for(NSString* name in names)
+		{
+			[bank bufferNamed:name];
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / numSounds;
+		[pool release];
+	}
+	[self addResult:[OALBenchmarkResult resultWithName:@"bankLoad"
+											   timings:timings
+											numTimings:numSamples
+									 bytesPerOperation:0
+												  note:note]];
+
+	// Load the same sounds one file at a time, from the bank's directory.
+	NSString* directory = [bankFile stringByDeletingLastPathComponent];
+	NSUInteger numTimings = numSamples;
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		bool loaded = YES;
+		uint64_t startTime = mach_absolute_time();
+		for(NSString* name in names)
+		{
+			loaded = nil != [self bufferFromFile:[directory stringByAppendingPathComponent:name]] && loaded;
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / numSounds;
+		[pool release];
+		if(!loaded)
+		{
+			numTimings = 0;
+			break;
+		}
+	}
+
+	[self addResult:[OALBenchmarkResult resultWithName:@"fileLoad"
+											   timings:timings
+											numTimings:numTimings
+									 bytesPerOperation:0
+												  note:numTimings > 0 ? note : @"Not every sound in the bank is available as a file"]];
+	free(timings);
+}
+
+- (void) runDecodedAudioCacheWithEffects:(unsigned int) numEffects
+{
+	NSString* decodeName = [NSString stringWithFormat:@"effectLoad/decode/%u", numEffects];
+	NSString* coldName = [NSString stringWithFormat:@"effectLoad/cold/%u", numEffects];
+	NSString* mappedName = [NSString stringWithFormat:@"effectLoad/mapped/%u", numEffects];
+	NSFileManager* fileManager = [NSFileManager defaultManager];
+	NSString* workDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:
+							   [NSString stringWithFormat:@"OALBenchmark-%d", [[NSProcessInfo processInfo] processIdentifier]]];
+	NSString* effectsDirectory = [workDirectory stringByAppendingPathComponent:@"effects"];
+
+	NSArray* paths = [self writeEffects:numEffects toDirectory:effectsDirectory];
+	if(nil == paths)
+	{
+		NSString* note = [NSString stringWithFormat:@"Could not write effects to %@", effectsDirectory];
+		[self addResult:[OALBenchmarkResult resultWithName:decodeName timings:NULL numTimings:0 bytesPerOperation:0 note:note]];
+		[self addResult:[OALBenchmarkResult resultWithName:coldName timings:NULL numTimings:0 bytesPerOperation:0 note:note]];
+		[self addResult:[OALBenchmarkResult resultWithName:mappedName timings:NULL numTimings:0 bytesPerOperation:0 note:note]];
+		[fileManager removeItemAtPath:workDirectory error:nil];
+		return;
+	}
+
+	OALDecodedAudioCache* cache = [OALDecodedAudioCache cacheWithDirectory:[workDirectory stringByAppendingPathComponent:@"cache"]
+																   maxSize:32 * 1024 * 1024];
+	NSString* note = [NSString stringWithFormat:@"%u %.2f s mono 16 bit WAV effects, per effect",
+					  numEffects, kCacheEffectSeconds];
+
+	// Loading whole sets of sounds is slow, so take fewer samples.
+	NSUInteger numSamples = iterations / 10 > 0 ? iterations / 10 : 1;
+	double* timings = malloc(sizeof(*timings) * numSamples);
+	NSUInteger numTimings;
+
+	// Decode every effect, with no cache at all.
+	numTimings = numSamples;
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		bool loaded = YES;
+		uint64_t startTime = mach_absolute_time();
+		for(NSString* path in paths)
+		{
+			loaded = nil != [self bufferFromFile:path] && loaded;
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / numEffects;
+		[pool release];
+		if(!loaded)
+		{
+			numTimings = 0;
+			break;
+		}
+	}
+	[self addResult:[OALBenchmarkResult resultWithName:decodeName
+											   timings:timings
+											numTimings:numTimings
+									 bytesPerOperation:0
+												  note:numTimings > 0 ? note : @"Could not decode the effects"]];
+
+	// A cold start: every lookup misses, so each effect is decoded and then stored.
+	numTimings = numSamples;
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		[cache removeAllEntries];
+		bool loaded = YES;
+		uint64_t startTime = mach_absolute_time();
+		for(NSString* path in paths)
+		{
+			ALBuffer* buffer = [cache bufferForUrl:[NSURL fileURLWithPath:path]];
+			if(nil == buffer)
+			{
+				buffer = [self bufferFromFile:path cache:cache];
+			}
+			loaded = nil != buffer && loaded;
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / numEffects;
+		[pool release];
+		if(!loaded)
+		{
+			numTimings = 0;
+			break;
+		}
+	}
+	[self addResult:[OALBenchmarkResult resultWithName:coldName
+											   timings:timings
+											numTimings:numTimings
+									 bytesPerOperation:0
+												  note:numTimings > 0 ? note : @"Could not decode the effects"]];
+
+	// A warm start: every effect is mapped straight from the cache.
+	numTimings = numSamples;
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		bool loaded = YES;
+		uint64_t startTime = mach_absolute_time();
+		for(NSString* path in paths)
+		{
+			loaded = nil != [cache bufferForUrl:[NSURL fileURLWithPath:path]] && loaded;
+		}
+		timings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / numEffects;
+		[pool release];
+		if(!loaded)
+		{
+			numTimings = 0;
+			break;
+		}
+	}
+	[self addResult:[OALBenchmarkResult resultWithName:mappedName
+											   timings:timings
+											numTimings:numTimings
+									 bytesPerOperation:0
+												  note:numTimings > 0 ? note : @"Not every effect was in the cache"]];
+	free(timings);
+
+	[fileManager removeItemAtPath:workDirectory error:nil];
+}
+
+- (void) runPreloadWithEffects:(unsigned int) numEffects
+{
+	NSString* serialName = [NSString stringWithFormat:@"preload/serial/%u", numEffects];
+	NSString* parallelName = [NSString stringWithFormat:@"preload/parallel/%u", numEffects];
+	NSFileManager* fileManager = [NSFileManager defaultManager];
+	NSString* workDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:
+							   [NSString stringWithFormat:@"OALBenchmark-%d", [[NSProcessInfo processInfo] processIdentifier]]];
+	NSString* effectsDirectory = [workDirectory stringByAppendingPathComponent:@"effects"];
+
+	NSArray* paths = [self writeEffects:numEffects toDirectory:effectsDirectory];
+	if(nil == paths)
+	{
+		NSString* note = [NSString stringWithFormat:@"Could not write effects to %@", effectsDirectory];
+		[self addResult:[OALBenchmarkResult resultWithName:serialName timings:NULL numTimings:0 bytesPerOperation:0 note:note]];
+		[self addResult:[OALBenchmarkResult resultWithName:parallelName timings:NULL numTimings:0 bytesPerOperation:0 note:note]];
+		[fileManager removeItemAtPath:workDirectory error:nil];
+		return;
+	}
+
+	NSUInteger numWorkers = [[NSProcessInfo processInfo] activeProcessorCount];
+	if(numWorkers < 1)
+	{
+		numWorkers = 1;
+	}
+	if(numWorkers > numEffects)
+	{
+		numWorkers = numEffects;
+	}
+	NSString* note = [NSString stringWithFormat:@"%u %.2f s mono 16 bit WAV effects, per effect",
+					  numEffects, kCacheEffectSeconds];
+
+	// Loading whole sets of sounds is slow, so take fewer samples.
+	NSUInteger numSamples = iterations / 10 > 0 ? iterations / 10 : 1;
+	double* serialTimings = malloc(sizeof(*serialTimings) * numSamples);
+	double* parallelTimings = malloc(sizeof(*parallelTimings) * numSamples);
+	ALBuffer** buffers = calloc(numEffects, sizeof(*buffers));
+	NSUInteger numTimings = numSamples;
+
+	// Alternate the two, so that neither gets a warmer file cache than the other.
+	for(NSUInteger i = 0; i < numSamples; i++)
+	{
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		bool loaded = YES;
+		uint64_t startTime = mach_absolute_time();
+		for(NSString* path in paths)
+		{
+			loaded = nil != [self bufferFromFile:path] && loaded;
+		}
+		serialTimings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / numEffects;
+		[pool release];
+
+		// Each worker claims the next file in turn, as OALSimpleAudio preloadEffects: does.
+		__block int32_t nextIndex = -1;
+		startTime = mach_absolute_time();
+		dispatch_apply(numWorkers, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0),
+		^(size_t worker)
+		{
+			(void)worker;
+			uint32_t index;
+			while((index = (uint32_t)__sync_add_and_fetch(&nextIndex, 1)) < numEffects)
+			{
+				NSAutoreleasePool* workerPool = [[NSAutoreleasePool alloc] init];
+				buffers[index] = [[self bufferFromFile:[paths objectAtIndex:index]] retain];
+				[workerPool release];
+			}
+		});
+		parallelTimings[i] = mach_absolute_difference_seconds(mach_absolute_time(), startTime) / numEffects;
+
+		for(unsigned int j = 0; j < numEffects; j++)
+		{
+			loaded = nil != buffers[j] && loaded;
+			[buffers[j] release];
+			buffers[j] = nil;
+		}
+		if(!loaded)
+		{
+			numTimings = 0;
+			break;
+		}
+	}
+	free(buffers);
+
+	OALBenchmarkResult* serialResult = [OALBenchmarkResult resultWithName:serialName
+																  timings:serialTimings
+															   numTimings:numTimings
+														bytesPerOperation:0
+																	 note:numTimings > 0 ? note : @"Could not decode the effects"];
+	[self addResult:serialResult];
+
+	NSString* parallelNote = @"Could not decode the effects";
+	if(numTimings > 0)
+	{
+		qsort(parallelTimings, numTimings, sizeof(*parallelTimings), compareDoubles);
+		double parallelMedian = numTimings % 2 ? parallelTimings[numTimings / 2]
+			: (parallelTimings[numTimings / 2 - 1] + parallelTimings[numTimings / 2]) / 2;
+		parallelNote = [NSString stringWithFormat:@"%@, %lu workers, %.2fx the serial speed",
+						note, (unsigned long)numWorkers, serialResult.medianSeconds / parallelMedian];
+	}
+	[self addResult:[OALBenchmarkResult resultWithName:parallelName
+											   timings:parallelTimings
+											numTimings:numTimings
+									 bytesPerOperation:0
+												  note:parallelNote]];
+	free(serialTimings);
+	free(parallelTimings);
+
+	[fileManager removeItemAtPath:workDirectory error:nil];
+}
+
+@end
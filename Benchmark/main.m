@@ -0,0 +1,60 @@
+//
+//  main.m
+//  ObjectAL Benchmark
+//
+//  Runs OALBenchmark against the mock OpenAL and prints the results as JSON.
+//
+//  Usage: oalbenchmark [-iterations n] [-load file.wav] [-bank file.oalbank] [-out results.json]
+//
+
+#import <Foundation/Foundation.h>
+#import "OALBenchmark.h"
+#import "OpenALManager.h"
+#import "ALDevice.h"
+#import "ALContext.h"
+#import "oal_mock_al.h"
+
+int main(int argc, char *argv[])
+{
+	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+	NSUserDefaults* arguments = [NSUserDefaults standardUserDefaults];
+
+	oal_mock_reset();
+	ALDevice* device = [ALDevice deviceWithDeviceSpecifier:nil];
+	ALContext* context = [ALContext contextOnDevice:device attributes:nil];
+	if(nil == context)
+	{
+		fprintf(stderr, "oalbenchmark: Could not create an OpenAL context\n");
+		[pool release];
+		return 1;
+	}
+	[OpenALManager sharedInstance].currentContext = context;
+
+	OALBenchmark* benchmark = [OALBenchmark benchmark];
+	if([arguments integerForKey:@"iterations"] > 0)
+	{
+		benchmark.iterations = (NSUInteger)[arguments integerForKey:@"iterations"];
+	}
+	benchmark.loadFile = [arguments stringForKey:@"load"];
+	benchmark.bankFile = [arguments stringForKey:@"bank"];
+	[benchmark run];
+
+	NSString* json = [benchmark JSONRepresentation];
+	NSString* outFile = [arguments stringForKey:@"out"];
+	if(nil != outFile)
+	{
+		NSError* error = nil;
+		if(![json writeToFile:outFile atomically:YES encoding:NSUTF8StringEncoding error:&error])
+		{
+			fprintf(stderr, "oalbenchmark: Could not write %s: %s\n",
+					[outFile UTF8String], [[error localizedDescription] UTF8String]);
+			[pool release];
+			return 1;
+		}
+	}
+	printf("%s\n", [json UTF8String]);
+
+	[OpenALManager sharedInstance].currentContext = nil;
+	[pool release];
+	return 0;
+}
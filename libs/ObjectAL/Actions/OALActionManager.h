@@ -41,11 +41,30 @@
  */
 @interface OALActionManager : NSObject
 {
-	/** All targets that have actions running on them (id). */
-	NSMutableArray* targets;
+	/* Running actions are kept in parallel C arrays so that a step is a tight loop
+	 * over plain values rather than a walk through nested object collections.
+	 */
 	
-	/** Parallel array to "targets", maintaining a list of all actions per target (NSMutableArray*) */
-	NSMutableArray* targetActions;
+	/** The running actions (retained). */
+	OALAction** actionObjects;
+	
+	/** Start time of each running action (mach absolute time). */
+	uint64_t* actionStartTimes;
+	
+	/** Completion per mach absolute time unit of each running action (1 / duration). */
+	double* actionRates;
+	
+	/** Cached updateCompletion: implementation of each running action. */
+	IMP* actionUpdateImps;
+	
+	/** Number of running actions. */
+	NSUInteger numActions;
+	
+	/** Number of actions the arrays have room for. */
+	NSUInteger actionCapacity;
+	
+	/** Maps each running action to its index in the arrays (OALAction* -> NSUInteger). */
+	CFMutableDictionaryRef actionIndices;
 	
 	/** All actions that are to be added on the next pass (OALAction*) */
 	NSMutableArray* actionsToAdd;
@@ -53,8 +72,19 @@
 	/** All actions that are to be removed on the next pass (OALAction*) */
 	NSMutableArray* actionsToRemove;
 	
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+	/** Signals the scheduler thread when there are actions to run. */
+	NSCondition* stepCondition;
+	
+	/** Set while there are actions for the scheduler thread to step. */
+	bool stepping;
+	
+	/** Set once the scheduler thread has been started. */
+	bool stepThreadStarted;
+#else
 	/** The timer which we use to update the actions. */
 	NSTimer* stepTimer;
+#endif
 }
 
 
@@ -27,11 +27,60 @@
 #import "OALActionManager.h"
 #import "mach_timing.h"
 #import "ObjectALMacros.h"
-#import "NSMutableArray+WeakReferences.h"
 
 #if !OBJECTAL_USE_COCOS2D_ACTIONS
 
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD && !OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS
+#error "OBJECTAL_CFG_ACTION_SCHEDULER_THREAD requires OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS"
+#endif
 
+
+#pragma mark -
+#pragma mark Private Methods
+
+/** (INTERNAL USE) Private methods for OALActionManager.
+ */
+@interface OALActionManager (Private)
+
+/** (INTERNAL USE) Update all running actions.
+ *
+ * @param timer The timer that fired (nil when called from the scheduler thread).
+ */
+- (void) step:(NSTimer*) timer;
+
+/** (INTERNAL USE) Add an action to the running action arrays.
+ *
+ * @param action The action to add.
+ */
+- (void) addRunningAction:(OALAction*) action;
+
+/** (INTERNAL USE) Remove an action from the running action arrays.
+ * The last action gets moved into the freed slot.
+ *
+ * @param action The action to remove.
+ */
+- (void) removeRunningAction:(OALAction*) action;
+
+/** (INTERNAL USE) Start stepping actions, if it isn't happening already.
+ */
+- (void) startStepping;
+
+/** (INTERNAL USE) Stop stepping actions.
+ */
+- (void) stopStepping;
+
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+/** (INTERNAL USE) Main loop of the scheduler thread.
+ * Steps actions at kActionThreadStepInterval against absolute deadlines,
+ * and sleeps when there's nothing to do.
+ */
+- (void) stepThreadMain;
+#endif
+
+@end
+
+
+#pragma mark -
 #pragma mark OALActionManager
 
 @implementation OALActionManager
@@ -45,20 +94,37 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 {
 	if(nil != (self = [super init]))
 	{
-		targets = [[NSMutableArray mutableArrayUsingWeakReferencesWithCapacity:50] retain];
-		targetActions = [[NSMutableArray arrayWithCapacity:50] retain];
+		actionCapacity = 64;
+		actionObjects = malloc(sizeof(*actionObjects) * actionCapacity);
+		actionStartTimes = malloc(sizeof(*actionStartTimes) * actionCapacity);
+		actionRates = malloc(sizeof(*actionRates) * actionCapacity);
+		actionUpdateImps = malloc(sizeof(*actionUpdateImps) * actionCapacity);
+		actionIndices = CFDictionaryCreateMutable(kCFAllocatorDefault, 0, NULL, NULL);
 		actionsToAdd = [[NSMutableArray arrayWithCapacity:100] retain];
 		actionsToRemove = [[NSMutableArray arrayWithCapacity:100] retain];
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+		stepCondition = [[NSCondition alloc] init];
+#endif
 	}
 	return self;
 }
 
 - (void) dealloc
 {
-	[targets release];
-	[targetActions release];
+	for(NSUInteger i = 0; i < numActions; i++)
+	{
+		[actionObjects[i] release];
+	}
+	free(actionObjects);
+	free(actionStartTimes);
+	free(actionRates);
+	free(actionUpdateImps);
+	CFRelease(actionIndices);
 	[actionsToAdd release];
 	[actionsToRemove release];
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+	[stepCondition release];
+#endif
 	[super dealloc];
 }
 
@@ -69,9 +135,10 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		for(NSMutableArray* actions in targetActions)
+		// stopAction only queues the removal, so the arrays won't change under us.
+		for(NSUInteger i = 0; i < numActions; i++)
 		{
-			[actions makeObjectsPerformSelector:@selector(stopAction)];
+			[actionObjects[i] stopAction];
 		}
 		
 		[actionsToAdd makeObjectsPerformSelector:@selector(stopAction)];
@@ -79,6 +146,84 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 }
 
 
+#pragma mark Stepping
+
+- (void) startStepping
+{
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+	[stepCondition lock];
+	stepping = YES;
+	if(!stepThreadStarted)
+	{
+		stepThreadStarted = YES;
+		[NSThread detachNewThreadSelector:@selector(stepThreadMain) toTarget:self withObject:nil];
+	}
+	[stepCondition signal];
+	[stepCondition unlock];
+#else
+	stepTimer = [NSTimer scheduledTimerWithTimeInterval:kActionStepInterval
+												 target:self
+											   selector:@selector(step:)
+											   userInfo:nil
+												repeats:YES];
+#endif
+}
+
+- (void) stopStepping
+{
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+	[stepCondition lock];
+	stepping = NO;
+	[stepCondition unlock];
+#else
+	[stepTimer invalidate];
+	stepTimer = nil;
+#endif
+}
+
+#if OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+- (void) stepThreadMain
+{
+	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+	[NSThread setThreadPriority:1.0];
+	
+	uint64_t interval = mach_absolute_from_seconds(kActionThreadStepInterval);
+	uint64_t deadline = mach_absolute_time();
+	
+	for(;;)
+	{
+		[stepCondition lock];
+		if(!stepping)
+		{
+			while(!stepping)
+			{
+				[stepCondition wait];
+			}
+			// Don't try to catch up on the time spent sleeping.
+			deadline = mach_absolute_time();
+		}
+		[stepCondition unlock];
+		
+		NSAutoreleasePool* stepPool = [[NSAutoreleasePool alloc] init];
+		[self step:nil];
+		[stepPool release];
+		
+		// Schedule against absolute deadlines so that the step rate doesn't drift.
+		// If we've fallen behind, skip the missed steps rather than bursting.
+		deadline += interval;
+		uint64_t currentTime = mach_absolute_time();
+		if(deadline < currentTime)
+		{
+			deadline = currentTime;
+		}
+		mach_wait_until(deadline);
+	}
+	
+	[pool release];
+}
+#endif
+
+
 #pragma mark Timer Interface
 
 - (void) step:(NSTimer*) timer
@@ -91,74 +236,95 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 			// But only if they haven't been stopped already
 			if(action.running)
 			{
-				NSUInteger index = [targets indexOfObject:action.target];
-				if(NSNotFound == index)
-				{
-					// Since this target has no running actions yet, add the support
-					// structure to keep track of it.
-					index = [targets count];
-					[targets addObject:action.target];
-					[targetActions addObject:[NSMutableArray arrayWithCapacity:5]];
-				}
-
-				// Get the list of actions operating on this target and add the new action.
-				NSMutableArray* actions = [targetActions objectAtIndex:index];
-				[actions addObject:action];
+				[self addRunningAction:action];
 			}
 		}
 		// All actions have been added.  Clear the "add" list.
 		[actionsToAdd removeAllObjects];
 		
-
 		// Remove stopped actions
 		for(OALAction* action in actionsToRemove)
 		{
-			NSUInteger index = [targets indexOfObject:action.target];
-			if(NSNotFound != index)
-			{
-				// Remove the action.
-				NSMutableArray* actions = [targetActions objectAtIndex:index];
-				[actions removeObject:action];
-				if([actions count] == 0)
-				{
-					// If there are no more actions for this target, stop tracking it.
-					[targets removeObjectAtIndex:index];
-					[targetActions removeObjectAtIndex:index];
-					
-					// If there are no more actions running, stop the master timer.
-					if([targets count] == 0)
-					{
-						[stepTimer invalidate];
-						stepTimer = nil;
-						break;
-					}
-				}
-			}
+			[self removeRunningAction:action];
 		}
 		[actionsToRemove removeAllObjects];
 		
-		// Update all remaining actions, if any
+		// If there are no more actions running, stop the master timer.
+		if(0 == numActions)
+		{
+			[self stopStepping];
+			return;
+		}
+		
+		// Update all remaining actions.
+		// Adds and removes are deferred to the next step, so the arrays stay put
+		// even if an action starts or stops other actions while updating.
 		uint64_t currentTime = mach_absolute_time();
-		for(NSMutableArray* actions in targetActions)
+		for(NSUInteger i = 0; i < numActions; i++)
 		{
-			for(OALAction* action in actions)
+			float proportionComplete = (float)((double)(currentTime - actionStartTimes[i]) * actionRates[i]);
+			if(proportionComplete < 1.0f)
+			{
+				((void (*)(id, SEL, float))actionUpdateImps[i])(actionObjects[i], @selector(updateCompletion:), proportionComplete);
+			}
+			else
 			{
-				float elapsedTime = (float)mach_absolute_difference_seconds(currentTime, action.startTime);
-				float proportionComplete = elapsedTime / action.duration;
-				if(proportionComplete < 1.0f)
-				{
-					[action updateCompletion:proportionComplete];
-				}
-				else
-				{
-					[action updateCompletion:1.0f];
-					[action stopAction];
-				}
+				((void (*)(id, SEL, float))actionUpdateImps[i])(actionObjects[i], @selector(updateCompletion:), 1.0f);
+				[actionObjects[i] stopAction];
 			}
 		}
 	}
 }
 
+- (void) addRunningAction:(OALAction*) action
+{
+	if(CFDictionaryContainsKey(actionIndices, action))
+	{
+		return;
+	}
+	
+	if(numActions == actionCapacity)
+	{
+		actionCapacity *= 2;
+		actionObjects = realloc(actionObjects, sizeof(*actionObjects) * actionCapacity);
+		actionStartTimes = realloc(actionStartTimes, sizeof(*actionStartTimes) * actionCapacity);
+		actionRates = realloc(actionRates, sizeof(*actionRates) * actionCapacity);
+		actionUpdateImps = realloc(actionUpdateImps, sizeof(*actionUpdateImps) * actionCapacity);
+	}
+	
+	uint64_t durationUnits = mach_absolute_from_seconds(action.duration);
+	
+	actionObjects[numActions] = [action retain];
+	actionStartTimes[numActions] = action.startTime;
+	actionRates[numActions] = durationUnits > 0 ? 1.0 / (double)durationUnits : 1.0;
+	actionUpdateImps[numActions] = [action methodForSelector:@selector(updateCompletion:)];
+	CFDictionarySetValue(actionIndices, action, (const void*)numActions);
+	numActions++;
+}
+
+- (void) removeRunningAction:(OALAction*) action
+{
+	const void* value;
+	if(!CFDictionaryGetValueIfPresent(actionIndices, action, &value))
+	{
+		return;
+	}
+	NSUInteger index = (NSUInteger)value;
+	CFDictionaryRemoveValue(actionIndices, action);
+	
+	numActions--;
+	if(index != numActions)
+	{
+		// Move the last action into the freed slot.
+		actionObjects[index] = actionObjects[numActions];
+		actionStartTimes[index] = actionStartTimes[numActions];
+		actionRates[index] = actionRates[numActions];
+		actionUpdateImps[index] = actionUpdateImps[numActions];
+		CFDictionarySetValue(actionIndices, actionObjects[index], (const void*)index);
+	}
+	[action release];
+}
+
 
 #pragma mark Internal Use
 
@@ -169,13 +335,9 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALActionManager);
 		[actionsToAdd addObject:action];
 		
 		// Start the timer if it hasn't been started yet and there are actions to perform.
-		if([targets count] == 0 && [actionsToAdd count] == 1)
+		if(0 == numActions && [actionsToAdd count] == 1)
 		{
-			stepTimer = [NSTimer scheduledTimerWithTimeInterval:kActionStepInterval
-														 target:self
-													   selector:@selector(step:)
-													   userInfo:nil
-														repeats:YES];
+			[self startStepping];
 		}
 	}
 }
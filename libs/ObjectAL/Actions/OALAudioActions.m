@@ -25,6 +25,7 @@
 //
 
 #import "OALAudioActions.h"
+#import "OALTrace.h"
 
 
 #pragma mark OAL_GainProtocol
@@ -71,8 +72,11 @@
 
 - (void) updateCompletion:(float) proportionComplete
 {
+	// Not traced, since replaying the fade that started this action makes these calls again.
+	OAL_TRACE_BEGIN_INTERNAL();
 	[(id<OAL_GainProtocol>)target setGain:lowValue
 	 + [realFunction valueForInput:proportionComplete] * delta];
+	OAL_TRACE_END_INTERNAL();
 }
 
 @end
@@ -123,8 +127,10 @@
 
 - (void) updateCompletion:(float) proportionComplete
 {
+	OAL_TRACE_BEGIN_INTERNAL();
 	[(id<OAL_PitchProtocol>)target setPitch:startValue
 	 + [realFunction valueForInput:proportionComplete] * delta];
+	OAL_TRACE_END_INTERNAL();
 }
 
 @end
@@ -175,8 +181,10 @@
 
 - (void) updateCompletion:(float) proportionComplete
 {
+	OAL_TRACE_BEGIN_INTERNAL();
 	[(id<OAL_PanProtocol>)target setPan:startValue
 	 + [realFunction valueForInput:proportionComplete] * delta];
+	OAL_TRACE_END_INTERNAL();
 }
 
 @end
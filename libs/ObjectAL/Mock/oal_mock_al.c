@@ -0,0 +1,2521 @@
+/*
+ *  oal_mock_al.c
+ *  ObjectAL
+ *
+ */
+
+#include "oal_mock_al.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#ifndef ALC_SOFT_loopback
+#define ALC_FORMAT_CHANNELS_SOFT 0x1990
+#define ALC_FORMAT_TYPE_SOFT 0x1991
+#define ALC_BYTE_SOFT 0x1400
+#define ALC_UNSIGNED_BYTE_SOFT 0x1401
+#define ALC_SHORT_SOFT 0x1402
+#define ALC_UNSIGNED_SHORT_SOFT 0x1403
+#define ALC_INT_SOFT 0x1404
+#define ALC_UNSIGNED_INT_SOFT 0x1405
+#define ALC_FLOAT_SOFT 0x1406
+#define ALC_MONO_SOFT 0x1500
+#define ALC_STEREO_SOFT 0x1501
+#define ALC_QUAD_SOFT 0x1503
+#define ALC_5POINT1_SOFT 0x1504
+#define ALC_6POINT1_SOFT 0x1505
+#define ALC_7POINT1_SOFT 0x1506
+#endif /* ALC_SOFT_loopback */
+
+/** Default limit on the number of sources. */
+#define kDefaultMaxSources 256
+
+/** The name the mock device reports. */
+#define kDeviceName "ObjectAL Mock"
+
+
+#pragma mark Call Counting
+
+/** Call count for one entry point.  Registered the first time the entry point is called. */
+typedef struct oal_mock_counter
+{
+	const char* function;
+	uint64_t calls;
+	bool registered;
+	struct oal_mock_counter* next;
+} oal_mock_counter;
+
+/** All registered counters. */
+static oal_mock_counter* counters = NULL;
+
+/** Calls to all entry points. */
+static uint64_t totalCalls = 0;
+
+static void countCall(oal_mock_counter* counter)
+{
+	if(!counter->registered)
+	{
+		counter->registered = true;
+		counter->next = counters;
+		counters = counter;
+	}
+	counter->calls++;
+	totalCalls++;
+}
+
+/** Count a call to the current entry point. */
+#define COUNT_CALL() \
+	static oal_mock_counter counter = {__func__, 0, false, NULL}; \
+	countCall(&counter)
+
+
+#pragma mark -
+#pragma mark State
+
+/** A buffer.  Its name is its index + 1. */
+typedef struct
+{
+	bool inUse;
+	ALint frequency;
+	ALint bits;
+	ALint channels;
+	ALint size;
+	/** Number of sample frames in the buffer. */
+	unsigned int frames;
+	/** Number of source queue entries referring to this buffer. */
+	unsigned int refCount;
+} mock_buffer;
+
+/** A source.  Its name is its index + 1. */
+typedef struct
+{
+	bool inUse;
+	ALenum state;
+	ALenum type;
+	bool looping;
+	bool relative;
+	double pitch;
+	double gain;
+	double minGain;
+	double maxGain;
+	double referenceDistance;
+	double rolloffFactor;
+	double maxDistance;
+	double coneInnerAngle;
+	double coneOuterAngle;
+	double coneOuterGain;
+	double position[3];
+	double velocity[3];
+	double direction[3];
+	/** Buffers queued (or the static buffer), by name. */
+	ALuint* queue;
+	unsigned int queueLength;
+	unsigned int queueCapacity;
+	/** Index into queue of the buffer being played. */
+	unsigned int current;
+	/** Sample frames played of the current buffer. */
+	double offset;
+	/** Offset (in frames from the start of the queue) to start at on the next play, or -1. */
+	double pendingOffset;
+} mock_source;
+
+/** An open device. */
+typedef struct mock_device
+{
+	bool capture;
+	bool loopback;
+	ALCenum error;
+	unsigned int numContexts;
+	/** Capture format. */
+	ALCuint captureFrequency;
+	unsigned int captureFrameSize;
+	ALCsizei captureBufferSize;
+	bool capturing;
+	/** Sample frames captured and not yet read. */
+	double captureAvailable;
+	struct mock_device* next;
+} mock_device;
+
+/** A context. */
+typedef struct mock_context
+{
+	mock_device* device;
+	bool suspended;
+	ALCint frequency;
+	ALCint refresh;
+	ALCint sync;
+	ALCint monoSources;
+	ALCint stereoSources;
+	/** Loopback output format. */
+	ALCint formatChannels;
+	ALCint formatType;
+	struct mock_context* next;
+} mock_context;
+
+static mock_buffer* buffers = NULL;
+static unsigned int buffersCapacity = 0;
+static unsigned int numBuffers = 0;
+/** Every buffer slot below this one is in use, so searches for a free slot start here. */
+static unsigned int firstFreeBuffer = 0;
+
+static mock_source* sources = NULL;
+static unsigned int sourcesCapacity = 0;
+static unsigned int numSources = 0;
+/** Every source slot below this one is in use, so searches for a free slot start here. */
+static unsigned int firstFreeSource = 0;
+static unsigned int maxSources = kDefaultMaxSources;
+
+static mock_device* devices = NULL;
+static mock_context* contexts = NULL;
+static mock_context* currentContext = NULL;
+
+static ALenum alError = AL_NO_ERROR;
+static ALCenum alcError = ALC_NO_ERROR;
+
+static double listenerGain = 1.0;
+static double listenerPosition[3] = {0, 0, 0};
+static double listenerVelocity[3] = {0, 0, 0};
+static double listenerOrientation[6] = {0, 0, -1, 0, 1, 0};
+
+static double dopplerFactor = 1.0;
+static double dopplerVelocity = 1.0;
+static double speedOfSound = 343.3;
+static ALenum distanceModel = AL_INVERSE_DISTANCE_CLAMPED;
+
+static double mixerOutputRate = 44100.0;
+
+static double currentTime = 0;
+
+
+#pragma mark -
+#pragma mark Errors
+
+static void setError(ALenum error)
+{
+	// OpenAL keeps the first error until it is read.
+	if(AL_NO_ERROR == alError)
+	{
+		alError = error;
+	}
+}
+
+static void setDeviceError(mock_device* device, ALCenum error)
+{
+	if(NULL == device)
+	{
+		if(ALC_NO_ERROR == alcError)
+		{
+			alcError = error;
+		}
+	}
+	else if(ALC_NO_ERROR == device->error)
+	{
+		device->error = error;
+	}
+}
+
+
+#pragma mark -
+#pragma mark Buffers
+
+static mock_buffer* getBuffer(ALuint name)
+{
+	if(name > 0 && name <= buffersCapacity && buffers[name - 1].inUse)
+	{
+		return &buffers[name - 1];
+	}
+	return NULL;
+}
+
+static void retainBuffer(ALuint name)
+{
+	mock_buffer* buffer = getBuffer(name);
+	if(NULL != buffer)
+	{
+		buffer->refCount++;
+	}
+}
+
+static void releaseBuffer(ALuint name)
+{
+	mock_buffer* buffer = getBuffer(name);
+	if(NULL != buffer && buffer->refCount > 0)
+	{
+		buffer->refCount--;
+	}
+}
+
+/** Get the size of a sample frame in a buffer format.
+ *
+ * @return The frame size, or 0 if the format is unknown.
+ */
+static unsigned int bufferFormatInfo(ALenum format, ALint* bits, ALint* channels)
+{
+	switch(format)
+	{
+		case AL_FORMAT_MONO8:
+			*bits = 8;
+			*channels = 1;
+			return 1;
+		case AL_FORMAT_MONO16:
+			*bits = 16;
+			*channels = 1;
+			return 2;
+		case AL_FORMAT_STEREO8:
+			*bits = 8;
+			*channels = 2;
+			return 2;
+		case AL_FORMAT_STEREO16:
+			*bits = 16;
+			*channels = 2;
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+static void bufferData(ALuint name, ALenum format, ALsizei size, ALsizei frequency)
+{
+	mock_buffer* buffer = getBuffer(name);
+	if(NULL == buffer)
+	{
+		setError(AL_INVALID_NAME);
+		return;
+	}
+	ALint bits;
+	ALint channels;
+	unsigned int frameSize = bufferFormatInfo(format, &bits, &channels);
+	if(0 == frameSize)
+	{
+		setError(AL_INVALID_ENUM);
+		return;
+	}
+	if(size < 0 || frequency <= 0 || 0 != size % frameSize)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	if(buffer->refCount > 0)
+	{
+		setError(AL_INVALID_OPERATION);
+		return;
+	}
+	buffer->frequency = frequency;
+	buffer->bits = bits;
+	buffer->channels = channels;
+	buffer->size = size;
+	buffer->frames = (unsigned int)size / frameSize;
+}
+
+
+#pragma mark -
+#pragma mark Sources
+
+static mock_source* getSource(ALuint name)
+{
+	if(name > 0 && name <= sourcesCapacity && sources[name - 1].inUse)
+	{
+		return &sources[name - 1];
+	}
+	return NULL;
+}
+
+static void initSource(mock_source* source)
+{
+	ALuint* queue = source->queue;
+	unsigned int queueCapacity = source->queueCapacity;
+	memset(source, 0, sizeof(*source));
+	source->queue = queue;
+	source->queueCapacity = queueCapacity;
+	source->inUse = true;
+	source->state = AL_INITIAL;
+	source->type = AL_UNDETERMINED;
+	source->pitch = 1;
+	source->gain = 1;
+	source->minGain = 0;
+	source->maxGain = 1;
+	source->referenceDistance = 1;
+	source->rolloffFactor = 1;
+	source->maxDistance = HUGE_VAL;
+	source->coneInnerAngle = 360;
+	source->coneOuterAngle = 360;
+	source->coneOuterGain = 0;
+	source->pendingOffset = -1;
+}
+
+static void clearQueue(mock_source* source)
+{
+	for(unsigned int i = 0; i < source->queueLength; i++)
+	{
+		releaseBuffer(source->queue[i]);
+	}
+	source->queueLength = 0;
+	source->current = 0;
+	source->offset = 0;
+}
+
+static bool appendToQueue(mock_source* source, ALuint name)
+{
+	if(source->queueLength == source->queueCapacity)
+	{
+		unsigned int newCapacity = source->queueCapacity > 0 ? source->queueCapacity * 2 : 4;
+		ALuint* newQueue = realloc(source->queue, newCapacity * sizeof(*newQueue));
+		if(NULL == newQueue)
+		{
+			return false;
+		}
+		source->queue = newQueue;
+		source->queueCapacity = newCapacity;
+	}
+	source->queue[source->queueLength++] = name;
+	retainBuffer(name);
+	return true;
+}
+
+static unsigned int queueFrames(mock_source* source, unsigned int end)
+{
+	unsigned int frames = 0;
+	for(unsigned int i = 0; i < end && i < source->queueLength; i++)
+	{
+		mock_buffer* buffer = getBuffer(source->queue[i]);
+		if(NULL != buffer)
+		{
+			frames += buffer->frames;
+		}
+	}
+	return frames;
+}
+
+/** The first buffer with data in a source's queue (which sets the offset units). */
+static mock_buffer* firstBuffer(mock_source* source)
+{
+	for(unsigned int i = 0; i < source->queueLength; i++)
+	{
+		mock_buffer* buffer = getBuffer(source->queue[i]);
+		if(NULL != buffer && buffer->frames > 0)
+		{
+			return buffer;
+		}
+	}
+	return NULL;
+}
+
+static unsigned int buffersProcessed(mock_source* source)
+{
+	switch(source->state)
+	{
+		case AL_STOPPED:
+			return source->queueLength;
+		case AL_PLAYING:
+		case AL_PAUSED:
+			return source->looping ? 0 : source->current;
+		default:
+			return 0;
+	}
+}
+
+/** Move a source to a frame offset from the start of its queue.
+ *
+ * @return false if the offset is past the end of the queue.
+ */
+static bool seekSource(mock_source* source, double frames)
+{
+	for(unsigned int i = 0; i < source->queueLength; i++)
+	{
+		mock_buffer* buffer = getBuffer(source->queue[i]);
+		unsigned int bufferFrames = NULL == buffer ? 0 : buffer->frames;
+		if(frames < bufferFrames)
+		{
+			source->current = i;
+			source->offset = frames;
+			return true;
+		}
+		frames -= bufferFrames;
+	}
+	return false;
+}
+
+static void playSource(mock_source* source)
+{
+	if(0 == queueFrames(source, source->queueLength))
+	{
+		// Nothing to play, so it finishes right away.
+		source->state = AL_STOPPED;
+		source->current = source->queueLength;
+		source->offset = 0;
+		return;
+	}
+	if(AL_PAUSED != source->state)
+	{
+		source->current = 0;
+		source->offset = 0;
+		if(source->pendingOffset >= 0)
+		{
+			seekSource(source, source->pendingOffset);
+			source->pendingOffset = -1;
+		}
+	}
+	source->state = AL_PLAYING;
+}
+
+static void stopSource(mock_source* source)
+{
+	// Stopping a source that was never played leaves it in the initial state.
+	if(AL_INITIAL != source->state)
+	{
+		source->state = AL_STOPPED;
+		source->current = source->queueLength;
+		source->offset = 0;
+	}
+	source->pendingOffset = -1;
+}
+
+static void rewindSource(mock_source* source)
+{
+	source->state = AL_INITIAL;
+	source->current = 0;
+	source->offset = 0;
+	source->pendingOffset = -1;
+}
+
+static void pauseSource(mock_source* source)
+{
+	if(AL_PLAYING == source->state)
+	{
+		source->state = AL_PAUSED;
+	}
+}
+
+static void advanceSource(mock_source* source, double seconds)
+{
+	if(source->pitch <= 0)
+	{
+		return;
+	}
+	// Guards against looping forever over a queue of empty buffers.
+	unsigned int emptyBuffersInARow = 0;
+	while(seconds > 0 && AL_PLAYING == source->state)
+	{
+		mock_buffer* buffer = getBuffer(source->queue[source->current]);
+		if(NULL != buffer && buffer->frames > 0)
+		{
+			emptyBuffersInARow = 0;
+			double rate = buffer->frequency * source->pitch;
+			double remaining = buffer->frames - source->offset;
+			double frames = seconds * rate;
+			if(frames < remaining)
+			{
+				source->offset += frames;
+				return;
+			}
+			seconds -= remaining / rate;
+		}
+		else if(++emptyBuffersInARow > source->queueLength)
+		{
+			stopSource(source);
+			return;
+		}
+
+		source->offset = 0;
+		if(++source->current >= source->queueLength)
+		{
+			if(!source->looping)
+			{
+				stopSource(source);
+				return;
+			}
+			source->current = 0;
+		}
+	}
+}
+
+/** Number of values a source parameter takes, or 0 if it isn't a source parameter. */
+static unsigned int sourceParamSize(ALenum param)
+{
+	switch(param)
+	{
+		case AL_POSITION:
+		case AL_VELOCITY:
+		case AL_DIRECTION:
+			return 3;
+		case AL_PITCH:
+		case AL_GAIN:
+		case AL_MIN_GAIN:
+		case AL_MAX_GAIN:
+		case AL_REFERENCE_DISTANCE:
+		case AL_ROLLOFF_FACTOR:
+		case AL_MAX_DISTANCE:
+		case AL_CONE_INNER_ANGLE:
+		case AL_CONE_OUTER_ANGLE:
+		case AL_CONE_OUTER_GAIN:
+		case AL_SEC_OFFSET:
+		case AL_SAMPLE_OFFSET:
+		case AL_BYTE_OFFSET:
+		case AL_SOURCE_RELATIVE:
+		case AL_LOOPING:
+		case AL_BUFFER:
+		case AL_SOURCE_STATE:
+		case AL_SOURCE_TYPE:
+		case AL_BUFFERS_QUEUED:
+		case AL_BUFFERS_PROCESSED:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+static void setSourceBuffer(mock_source* source, ALuint name)
+{
+	if(AL_PLAYING == source->state || AL_PAUSED == source->state)
+	{
+		setError(AL_INVALID_OPERATION);
+		return;
+	}
+	if(0 != name && NULL == getBuffer(name))
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	clearQueue(source);
+	source->type = AL_UNDETERMINED;
+	if(0 != name)
+	{
+		if(!appendToQueue(source, name))
+		{
+			setError(AL_OUT_OF_MEMORY);
+			return;
+		}
+		source->type = AL_STATIC;
+	}
+}
+
+static void setSourceOffset(mock_source* source, ALenum param, double value)
+{
+	mock_buffer* buffer = firstBuffer(source);
+	if(NULL == buffer || value < 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	double frames = value;
+	if(AL_SEC_OFFSET == param)
+	{
+		frames = value * buffer->frequency;
+	}
+	else if(AL_BYTE_OFFSET == param)
+	{
+		frames = floor(value / (buffer->size / buffer->frames));
+	}
+	if(frames >= queueFrames(source, source->queueLength))
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	if(AL_PLAYING == source->state || AL_PAUSED == source->state)
+	{
+		seekSource(source, frames);
+	}
+	else
+	{
+		source->pendingOffset = frames;
+	}
+}
+
+static void setSourceProperty(ALuint name, ALenum param, const double* values, unsigned int count)
+{
+	mock_source* source = getSource(name);
+	if(NULL == source)
+	{
+		setError(AL_INVALID_NAME);
+		return;
+	}
+	if(sourceParamSize(param) != count)
+	{
+		setError(AL_INVALID_ENUM);
+		return;
+	}
+	double value = values[0];
+	switch(param)
+	{
+		case AL_PITCH:
+		case AL_GAIN:
+		case AL_MIN_GAIN:
+		case AL_MAX_GAIN:
+		case AL_REFERENCE_DISTANCE:
+		case AL_ROLLOFF_FACTOR:
+		case AL_MAX_DISTANCE:
+		case AL_CONE_OUTER_GAIN:
+			if(value < 0 || ((AL_MIN_GAIN == param || AL_MAX_GAIN == param || AL_CONE_OUTER_GAIN == param) && value > 1))
+			{
+				setError(AL_INVALID_VALUE);
+				return;
+			}
+			switch(param)
+			{
+				case AL_PITCH: source->pitch = value; break;
+				case AL_GAIN: source->gain = value; break;
+				case AL_MIN_GAIN: source->minGain = value; break;
+				case AL_MAX_GAIN: source->maxGain = value; break;
+				case AL_REFERENCE_DISTANCE: source->referenceDistance = value; break;
+				case AL_ROLLOFF_FACTOR: source->rolloffFactor = value; break;
+				case AL_MAX_DISTANCE: source->maxDistance = value; break;
+				default: source->coneOuterGain = value; break;
+			}
+			break;
+		case AL_CONE_INNER_ANGLE:
+		case AL_CONE_OUTER_ANGLE:
+			if(value < 0 || value > 360)
+			{
+				setError(AL_INVALID_VALUE);
+				return;
+			}
+			if(AL_CONE_INNER_ANGLE == param)
+			{
+				source->coneInnerAngle = value;
+			}
+			else
+			{
+				source->coneOuterAngle = value;
+			}
+			break;
+		case AL_POSITION:
+			memcpy(source->position, values, sizeof(source->position));
+			break;
+		case AL_VELOCITY:
+			memcpy(source->velocity, values, sizeof(source->velocity));
+			break;
+		case AL_DIRECTION:
+			memcpy(source->direction, values, sizeof(source->direction));
+			break;
+		case AL_SOURCE_RELATIVE:
+		case AL_LOOPING:
+			if(AL_FALSE != value && AL_TRUE != value)
+			{
+				setError(AL_INVALID_VALUE);
+				return;
+			}
+			if(AL_LOOPING == param)
+			{
+				source->looping = AL_TRUE == value;
+			}
+			else
+			{
+				source->relative = AL_TRUE == value;
+			}
+			break;
+		case AL_BUFFER:
+			setSourceBuffer(source, (ALuint)value);
+			break;
+		case AL_SEC_OFFSET:
+		case AL_SAMPLE_OFFSET:
+		case AL_BYTE_OFFSET:
+			setSourceOffset(source, param, value);
+			break;
+		default:
+			// State, type and buffer counts are read only.
+			setError(AL_INVALID_OPERATION);
+			break;
+	}
+}
+
+static void getSourceProperty(ALuint name, ALenum param, double* values, unsigned int count)
+{
+	mock_source* source = getSource(name);
+	if(NULL == source)
+	{
+		setError(AL_INVALID_NAME);
+		return;
+	}
+	if(sourceParamSize(param) != count)
+	{
+		setError(AL_INVALID_ENUM);
+		return;
+	}
+	mock_buffer* buffer;
+	double frames;
+	switch(param)
+	{
+		case AL_PITCH: values[0] = source->pitch; break;
+		case AL_GAIN: values[0] = source->gain; break;
+		case AL_MIN_GAIN: values[0] = source->minGain; break;
+		case AL_MAX_GAIN: values[0] = source->maxGain; break;
+		case AL_REFERENCE_DISTANCE: values[0] = source->referenceDistance; break;
+		case AL_ROLLOFF_FACTOR: values[0] = source->rolloffFactor; break;
+		case AL_MAX_DISTANCE: values[0] = source->maxDistance; break;
+		case AL_CONE_INNER_ANGLE: values[0] = source->coneInnerAngle; break;
+		case AL_CONE_OUTER_ANGLE: values[0] = source->coneOuterAngle; break;
+		case AL_CONE_OUTER_GAIN: values[0] = source->coneOuterGain; break;
+		case AL_POSITION: memcpy(values, source->position, sizeof(source->position)); break;
+		case AL_VELOCITY: memcpy(values, source->velocity, sizeof(source->velocity)); break;
+		case AL_DIRECTION: memcpy(values, source->direction, sizeof(source->direction)); break;
+		case AL_SOURCE_RELATIVE: values[0] = source->relative ? AL_TRUE : AL_FALSE; break;
+		case AL_LOOPING: values[0] = source->looping ? AL_TRUE : AL_FALSE; break;
+		case AL_BUFFER:
+			values[0] = AL_STATIC == source->type ? source->queue[0] : 0;
+			break;
+		case AL_SOURCE_STATE: values[0] = source->state; break;
+		case AL_SOURCE_TYPE: values[0] = source->type; break;
+		case AL_BUFFERS_QUEUED: values[0] = source->queueLength; break;
+		case AL_BUFFERS_PROCESSED: values[0] = buffersProcessed(source); break;
+		default:
+			// Offsets
+			values[0] = 0;
+			buffer = firstBuffer(source);
+			if(NULL == buffer || (AL_PLAYING != source->state && AL_PAUSED != source->state))
+			{
+				break;
+			}
+			frames = queueFrames(source, source->current) + source->offset;
+			if(AL_SEC_OFFSET == param)
+			{
+				values[0] = frames / buffer->frequency;
+			}
+			else if(AL_SAMPLE_OFFSET == param)
+			{
+				values[0] = floor(frames);
+			}
+			else
+			{
+				values[0] = floor(frames) * (buffer->size / buffer->frames);
+			}
+			break;
+	}
+}
+
+
+#pragma mark -
+#pragma mark Devices and Contexts
+
+static mock_device* findDevice(ALCdevice* device)
+{
+	for(mock_device* entry = devices; NULL != entry; entry = entry->next)
+	{
+		if((ALCdevice*)entry == device)
+		{
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static mock_context* findContext(ALCcontext* context)
+{
+	for(mock_context* entry = contexts; NULL != entry; entry = entry->next)
+	{
+		if((ALCcontext*)entry == context)
+		{
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static mock_device* createDevice(void)
+{
+	mock_device* device = calloc(1, sizeof(*device));
+	if(NULL != device)
+	{
+		device->next = devices;
+		devices = device;
+	}
+	return device;
+}
+
+static void destroyDevice(mock_device* device)
+{
+	for(mock_device** entry = &devices; NULL != *entry; entry = &(*entry)->next)
+	{
+		if(*entry == device)
+		{
+			*entry = device->next;
+			free(device);
+			return;
+		}
+	}
+}
+
+static unsigned int loopbackChannels(ALCint channels)
+{
+	switch(channels)
+	{
+		case ALC_MONO_SOFT: return 1;
+		case ALC_STEREO_SOFT: return 2;
+		case ALC_QUAD_SOFT: return 4;
+		case ALC_5POINT1_SOFT: return 6;
+		case ALC_6POINT1_SOFT: return 7;
+		case ALC_7POINT1_SOFT: return 8;
+		default: return 0;
+	}
+}
+
+static unsigned int loopbackSampleSize(ALCint type)
+{
+	switch(type)
+	{
+		case ALC_BYTE_SOFT:
+		case ALC_UNSIGNED_BYTE_SOFT:
+			return 1;
+		case ALC_SHORT_SOFT:
+		case ALC_UNSIGNED_SHORT_SOFT:
+			return 2;
+		case ALC_INT_SOFT:
+		case ALC_UNSIGNED_INT_SOFT:
+		case ALC_FLOAT_SOFT:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+/** Let playback time pass (without counting it as a call). */
+static void advanceTime(double seconds)
+{
+	if(seconds <= 0)
+	{
+		return;
+	}
+	currentTime += seconds;
+	for(unsigned int i = 0; i < sourcesCapacity; i++)
+	{
+		if(sources[i].inUse && AL_PLAYING == sources[i].state)
+		{
+			advanceSource(&sources[i], seconds);
+		}
+	}
+	for(mock_device* device = devices; NULL != device; device = device->next)
+	{
+		if(device->capturing)
+		{
+			device->captureAvailable += seconds * device->captureFrequency;
+			if(device->captureAvailable > device->captureBufferSize)
+			{
+				device->captureAvailable = device->captureBufferSize;
+			}
+		}
+	}
+}
+
+
+#pragma mark -
+#pragma mark Mock Control
+
+void oal_mock_reset(void)
+{
+	for(unsigned int i = 0; i < sourcesCapacity; i++)
+	{
+		free(sources[i].queue);
+	}
+	free(sources);
+	sources = NULL;
+	sourcesCapacity = 0;
+	numSources = 0;
+	firstFreeSource = 0;
+
+	free(buffers);
+	buffers = NULL;
+	buffersCapacity = 0;
+	numBuffers = 0;
+	firstFreeBuffer = 0;
+
+	while(NULL != contexts)
+	{
+		mock_context* next = contexts->next;
+		free(contexts);
+		contexts = next;
+	}
+	currentContext = NULL;
+	while(NULL != devices)
+	{
+		mock_device* next = devices->next;
+		free(devices);
+		devices = next;
+	}
+
+	alError = AL_NO_ERROR;
+	alcError = ALC_NO_ERROR;
+	listenerGain = 1.0;
+	memset(listenerPosition, 0, sizeof(listenerPosition));
+	memset(listenerVelocity, 0, sizeof(listenerVelocity));
+	memset(listenerOrientation, 0, sizeof(listenerOrientation));
+	listenerOrientation[2] = -1;
+	listenerOrientation[4] = 1;
+	dopplerFactor = 1.0;
+	dopplerVelocity = 1.0;
+	speedOfSound = 343.3;
+	distanceModel = AL_INVERSE_DISTANCE_CLAMPED;
+	mixerOutputRate = 44100.0;
+	currentTime = 0;
+
+	oal_mock_reset_call_counts();
+}
+
+void oal_mock_advance(double seconds)
+{
+	advanceTime(seconds);
+}
+
+double oal_mock_time(void)
+{
+	return currentTime;
+}
+
+void oal_mock_set_max_sources(unsigned int maxSourcesIn)
+{
+	maxSources = maxSourcesIn;
+}
+
+unsigned int oal_mock_num_sources(void)
+{
+	return numSources;
+}
+
+unsigned int oal_mock_num_playing_sources(void)
+{
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < sourcesCapacity; i++)
+	{
+		if(sources[i].inUse && AL_PLAYING == sources[i].state)
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+unsigned int oal_mock_num_buffers(void)
+{
+	return numBuffers;
+}
+
+uint64_t oal_mock_call_count(const char* function)
+{
+	for(oal_mock_counter* counter = counters; NULL != counter; counter = counter->next)
+	{
+		if(0 == strcmp(counter->function, function))
+		{
+			return counter->calls;
+		}
+	}
+	return 0;
+}
+
+uint64_t oal_mock_total_calls(void)
+{
+	return totalCalls;
+}
+
+void oal_mock_reset_call_counts(void)
+{
+	for(oal_mock_counter* counter = counters; NULL != counter; counter = counter->next)
+	{
+		counter->calls = 0;
+	}
+	totalCalls = 0;
+}
+
+void oal_mock_print_call_counts(FILE* file)
+{
+	for(oal_mock_counter* counter = counters; NULL != counter; counter = counter->next)
+	{
+		if(counter->calls > 0)
+		{
+			fprintf(file, "%-32s %llu\n", counter->function, (unsigned long long)counter->calls);
+		}
+	}
+	fprintf(file, "%-32s %llu\n", "total", (unsigned long long)totalCalls);
+}
+
+
+#pragma mark -
+#pragma mark AL State
+
+void alEnable(ALenum capability)
+{
+	COUNT_CALL();
+	(void)capability;
+	setError(AL_INVALID_ENUM);
+}
+
+void alDisable(ALenum capability)
+{
+	COUNT_CALL();
+	(void)capability;
+	setError(AL_INVALID_ENUM);
+}
+
+ALboolean alIsEnabled(ALenum capability)
+{
+	COUNT_CALL();
+	(void)capability;
+	setError(AL_INVALID_ENUM);
+	return AL_FALSE;
+}
+
+/** Get a global state value.
+ *
+ * @return false if the parameter is unknown.
+ */
+static bool getState(ALenum param, double* value)
+{
+	switch(param)
+	{
+		case AL_DOPPLER_FACTOR: *value = dopplerFactor; return true;
+		case AL_DOPPLER_VELOCITY: *value = dopplerVelocity; return true;
+		case AL_SPEED_OF_SOUND: *value = speedOfSound; return true;
+		case AL_DISTANCE_MODEL: *value = distanceModel; return true;
+		default:
+			setError(AL_INVALID_ENUM);
+			return false;
+	}
+}
+
+void alGetBooleanv(ALenum param, ALboolean* values)
+{
+	COUNT_CALL();
+	double value;
+	if(getState(param, &value))
+	{
+		*values = 0 != value ? AL_TRUE : AL_FALSE;
+	}
+}
+
+void alGetIntegerv(ALenum param, ALint* values)
+{
+	COUNT_CALL();
+	double value;
+	if(getState(param, &value))
+	{
+		*values = (ALint)value;
+	}
+}
+
+void alGetFloatv(ALenum param, ALfloat* values)
+{
+	COUNT_CALL();
+	double value;
+	if(getState(param, &value))
+	{
+		*values = (ALfloat)value;
+	}
+}
+
+void alGetDoublev(ALenum param, ALdouble* values)
+{
+	COUNT_CALL();
+	double value;
+	if(getState(param, &value))
+	{
+		*values = value;
+	}
+}
+
+ALboolean alGetBoolean(ALenum param)
+{
+	COUNT_CALL();
+	double value = 0;
+	getState(param, &value);
+	return 0 != value ? AL_TRUE : AL_FALSE;
+}
+
+ALint alGetInteger(ALenum param)
+{
+	COUNT_CALL();
+	double value = 0;
+	getState(param, &value);
+	return (ALint)value;
+}
+
+ALfloat alGetFloat(ALenum param)
+{
+	COUNT_CALL();
+	double value = 0;
+	getState(param, &value);
+	return (ALfloat)value;
+}
+
+ALdouble alGetDouble(ALenum param)
+{
+	COUNT_CALL();
+	double value = 0;
+	getState(param, &value);
+	return value;
+}
+
+const ALchar* alGetString(ALenum param)
+{
+	COUNT_CALL();
+	switch(param)
+	{
+		case AL_VENDOR: return "ObjectAL";
+		case AL_VERSION: return "1.1 Mock";
+		case AL_RENDERER: return kDeviceName;
+		case AL_EXTENSIONS: return "AL_EXT_STATIC_BUFFER AL_SOFT_deferred_updates";
+		case AL_NO_ERROR: return "No Error";
+		case AL_INVALID_NAME: return "Invalid Name";
+		case AL_INVALID_ENUM: return "Invalid Enum";
+		case AL_INVALID_VALUE: return "Invalid Value";
+		case AL_INVALID_OPERATION: return "Invalid Operation";
+		case AL_OUT_OF_MEMORY: return "Out of Memory";
+		default:
+			setError(AL_INVALID_ENUM);
+			return NULL;
+	}
+}
+
+ALenum alGetError(void)
+{
+	COUNT_CALL();
+	ALenum error = alError;
+	alError = AL_NO_ERROR;
+	return error;
+}
+
+void alDopplerFactor(ALfloat value)
+{
+	COUNT_CALL();
+	if(value < 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	dopplerFactor = value;
+}
+
+void alDopplerVelocity(ALfloat value)
+{
+	COUNT_CALL();
+	if(value <= 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	dopplerVelocity = value;
+}
+
+void alSpeedOfSound(ALfloat value)
+{
+	COUNT_CALL();
+	if(value <= 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	speedOfSound = value;
+}
+
+void alDistanceModel(ALenum value)
+{
+	COUNT_CALL();
+	switch(value)
+	{
+		case AL_NONE:
+		case AL_INVERSE_DISTANCE:
+		case AL_INVERSE_DISTANCE_CLAMPED:
+		case AL_LINEAR_DISTANCE:
+		case AL_LINEAR_DISTANCE_CLAMPED:
+		case AL_EXPONENT_DISTANCE:
+		case AL_EXPONENT_DISTANCE_CLAMPED:
+			distanceModel = value;
+			break;
+		default:
+			setError(AL_INVALID_VALUE);
+			break;
+	}
+}
+
+
+#pragma mark -
+#pragma mark AL Extensions
+
+static ALvoid alBufferDataStatic(const ALint bid, ALenum format, const ALvoid* data, ALsizei size, ALsizei freq)
+{
+	COUNT_CALL();
+	(void)data;
+	bufferData((ALuint)bid, format, size, freq);
+}
+
+static ALvoid alDeferUpdatesSOFT(void)
+{
+	COUNT_CALL();
+}
+
+static ALvoid alProcessUpdatesSOFT(void)
+{
+	COUNT_CALL();
+}
+
+ALboolean alIsExtensionPresent(const ALchar* name)
+{
+	COUNT_CALL();
+	if(NULL == name)
+	{
+		setError(AL_INVALID_VALUE);
+		return AL_FALSE;
+	}
+	return (0 == strcasecmp(name, "AL_EXT_STATIC_BUFFER") ||
+			0 == strcasecmp(name, "AL_SOFT_deferred_updates")) ? AL_TRUE : AL_FALSE;
+}
+
+void* alGetProcAddress(const ALchar* name)
+{
+	COUNT_CALL();
+	if(NULL == name)
+	{
+		setError(AL_INVALID_VALUE);
+		return NULL;
+	}
+	if(0 == strcmp(name, "alBufferDataStatic")) return (void*)alBufferDataStatic;
+	if(0 == strcmp(name, "alDeferUpdatesSOFT")) return (void*)alDeferUpdatesSOFT;
+	if(0 == strcmp(name, "alProcessUpdatesSOFT")) return (void*)alProcessUpdatesSOFT;
+	return NULL;
+}
+
+ALenum alGetEnumValue(const ALchar* name)
+{
+	COUNT_CALL();
+	if(NULL == name)
+	{
+		setError(AL_INVALID_VALUE);
+	}
+	return 0;
+}
+
+
+#pragma mark -
+#pragma mark Listener
+
+/** Number of values a listener parameter takes, or 0 if it isn't a listener parameter. */
+static unsigned int listenerParamSize(ALenum param)
+{
+	switch(param)
+	{
+		case AL_GAIN: return 1;
+		case AL_POSITION:
+		case AL_VELOCITY: return 3;
+		case AL_ORIENTATION: return 6;
+		default: return 0;
+	}
+}
+
+static double* listenerValues(ALenum param)
+{
+	switch(param)
+	{
+		case AL_GAIN: return &listenerGain;
+		case AL_POSITION: return listenerPosition;
+		case AL_VELOCITY: return listenerVelocity;
+		default: return listenerOrientation;
+	}
+}
+
+static void setListener(ALenum param, const double* values, unsigned int count)
+{
+	unsigned int size = listenerParamSize(param);
+	if(0 == size || (0 != count && size != count))
+	{
+		setError(AL_INVALID_ENUM);
+		return;
+	}
+	if(AL_GAIN == param && values[0] < 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	memcpy(listenerValues(param), values, size * sizeof(*values));
+}
+
+static bool getListener(ALenum param, double* values, unsigned int count)
+{
+	unsigned int size = listenerParamSize(param);
+	if(0 == size || (0 != count && size != count))
+	{
+		setError(AL_INVALID_ENUM);
+		return false;
+	}
+	memcpy(values, listenerValues(param), size * sizeof(*values));
+	return true;
+}
+
+void alListenerf(ALenum param, ALfloat value)
+{
+	COUNT_CALL();
+	double values[1] = {value};
+	setListener(param, values, 1);
+}
+
+void alListener3f(ALenum param, ALfloat value1, ALfloat value2, ALfloat value3)
+{
+	COUNT_CALL();
+	double values[3] = {value1, value2, value3};
+	setListener(param, values, 3);
+}
+
+void alListenerfv(ALenum param, const ALfloat* values)
+{
+	COUNT_CALL();
+	double converted[6];
+	unsigned int size = listenerParamSize(param);
+	for(unsigned int i = 0; i < size; i++)
+	{
+		converted[i] = values[i];
+	}
+	setListener(param, converted, 0);
+}
+
+void alListeneri(ALenum param, ALint value)
+{
+	COUNT_CALL();
+	double values[1] = {value};
+	setListener(param, values, 1);
+}
+
+void alListener3i(ALenum param, ALint value1, ALint value2, ALint value3)
+{
+	COUNT_CALL();
+	double values[3] = {value1, value2, value3};
+	setListener(param, values, 3);
+}
+
+void alListeneriv(ALenum param, const ALint* values)
+{
+	COUNT_CALL();
+	double converted[6];
+	unsigned int size = listenerParamSize(param);
+	for(unsigned int i = 0; i < size; i++)
+	{
+		converted[i] = values[i];
+	}
+	setListener(param, converted, 0);
+}
+
+void alGetListenerf(ALenum param, ALfloat* value)
+{
+	COUNT_CALL();
+	double values[1];
+	if(getListener(param, values, 1))
+	{
+		*value = (ALfloat)values[0];
+	}
+}
+
+void alGetListener3f(ALenum param, ALfloat* value1, ALfloat* value2, ALfloat* value3)
+{
+	COUNT_CALL();
+	double values[3];
+	if(getListener(param, values, 3))
+	{
+		*value1 = (ALfloat)values[0];
+		*value2 = (ALfloat)values[1];
+		*value3 = (ALfloat)values[2];
+	}
+}
+
+void alGetListenerfv(ALenum param, ALfloat* values)
+{
+	COUNT_CALL();
+	double converted[6];
+	if(getListener(param, converted, 0))
+	{
+		for(unsigned int i = 0; i < listenerParamSize(param); i++)
+		{
+			values[i] = (ALfloat)converted[i];
+		}
+	}
+}
+
+void alGetListeneri(ALenum param, ALint* value)
+{
+	COUNT_CALL();
+	double values[1];
+	if(getListener(param, values, 1))
+	{
+		*value = (ALint)values[0];
+	}
+}
+
+void alGetListener3i(ALenum param, ALint* value1, ALint* value2, ALint* value3)
+{
+	COUNT_CALL();
+	double values[3];
+	if(getListener(param, values, 3))
+	{
+		*value1 = (ALint)values[0];
+		*value2 = (ALint)values[1];
+		*value3 = (ALint)values[2];
+	}
+}
+
+void alGetListeneriv(ALenum param, ALint* values)
+{
+	COUNT_CALL();
+	double converted[6];
+	if(getListener(param, converted, 0))
+	{
+		for(unsigned int i = 0; i < listenerParamSize(param); i++)
+		{
+			values[i] = (ALint)converted[i];
+		}
+	}
+}
+
+
+#pragma mark -
+#pragma mark Source Management
+
+void alGenSources(ALsizei n, ALuint* names)
+{
+	COUNT_CALL();
+	if(n < 0 || numSources + (unsigned int)n > maxSources)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		unsigned int index = firstFreeSource;
+		while(index < sourcesCapacity && sources[index].inUse)
+		{
+			index++;
+		}
+		if(index == sourcesCapacity)
+		{
+			unsigned int newCapacity = sourcesCapacity > 0 ? sourcesCapacity * 2 : 32;
+			mock_source* newSources = realloc(sources, newCapacity * sizeof(*newSources));
+			if(NULL == newSources)
+			{
+				alDeleteSources(i, names);
+				setError(AL_OUT_OF_MEMORY);
+				return;
+			}
+			memset(newSources + sourcesCapacity, 0, (newCapacity - sourcesCapacity) * sizeof(*newSources));
+			sources = newSources;
+			sourcesCapacity = newCapacity;
+		}
+		initSource(&sources[index]);
+		numSources++;
+		firstFreeSource = index + 1;
+		names[i] = index + 1;
+	}
+}
+
+void alDeleteSources(ALsizei n, const ALuint* names)
+{
+	COUNT_CALL();
+	if(n < 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		if(NULL == getSource(names[i]))
+		{
+			setError(AL_INVALID_NAME);
+			return;
+		}
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		mock_source* source = getSource(names[i]);
+		if(NULL != source)
+		{
+			clearQueue(source);
+			source->inUse = false;
+			numSources--;
+			if(names[i] - 1 < firstFreeSource)
+			{
+				firstFreeSource = names[i] - 1;
+			}
+		}
+	}
+}
+
+ALboolean alIsSource(ALuint name)
+{
+	COUNT_CALL();
+	return NULL != getSource(name) ? AL_TRUE : AL_FALSE;
+}
+
+
+#pragma mark Source Properties
+
+void alSourcef(ALuint name, ALenum param, ALfloat value)
+{
+	COUNT_CALL();
+	double values[1] = {value};
+	setSourceProperty(name, param, values, 1);
+}
+
+void alSource3f(ALuint name, ALenum param, ALfloat value1, ALfloat value2, ALfloat value3)
+{
+	COUNT_CALL();
+	double values[3] = {value1, value2, value3};
+	setSourceProperty(name, param, values, 3);
+}
+
+void alSourcefv(ALuint name, ALenum param, const ALfloat* values)
+{
+	COUNT_CALL();
+	double converted[3];
+	unsigned int size = sourceParamSize(param);
+	for(unsigned int i = 0; i < size; i++)
+	{
+		converted[i] = values[i];
+	}
+	setSourceProperty(name, param, converted, size > 0 ? size : 1);
+}
+
+void alSourcei(ALuint name, ALenum param, ALint value)
+{
+	COUNT_CALL();
+	// Buffer names are unsigned, so keep them intact.
+	double values[1] = {AL_BUFFER == param ? (double)(ALuint)value : (double)value};
+	setSourceProperty(name, param, values, 1);
+}
+
+void alSource3i(ALuint name, ALenum param, ALint value1, ALint value2, ALint value3)
+{
+	COUNT_CALL();
+	double values[3] = {value1, value2, value3};
+	setSourceProperty(name, param, values, 3);
+}
+
+void alSourceiv(ALuint name, ALenum param, const ALint* values)
+{
+	COUNT_CALL();
+	double converted[3];
+	unsigned int size = sourceParamSize(param);
+	for(unsigned int i = 0; i < size; i++)
+	{
+		converted[i] = AL_BUFFER == param ? (double)(ALuint)values[i] : (double)values[i];
+	}
+	setSourceProperty(name, param, converted, size > 0 ? size : 1);
+}
+
+void alGetSourcef(ALuint name, ALenum param, ALfloat* value)
+{
+	COUNT_CALL();
+	double values[1] = {0};
+	getSourceProperty(name, param, values, 1);
+	*value = (ALfloat)values[0];
+}
+
+void alGetSource3f(ALuint name, ALenum param, ALfloat* value1, ALfloat* value2, ALfloat* value3)
+{
+	COUNT_CALL();
+	double values[3] = {0, 0, 0};
+	getSourceProperty(name, param, values, 3);
+	*value1 = (ALfloat)values[0];
+	*value2 = (ALfloat)values[1];
+	*value3 = (ALfloat)values[2];
+}
+
+void alGetSourcefv(ALuint name, ALenum param, ALfloat* values)
+{
+	COUNT_CALL();
+	double converted[3] = {0, 0, 0};
+	unsigned int size = sourceParamSize(param);
+	getSourceProperty(name, param, converted, size > 0 ? size : 1);
+	for(unsigned int i = 0; i < size; i++)
+	{
+		values[i] = (ALfloat)converted[i];
+	}
+}
+
+void alGetSourcei(ALuint name, ALenum param, ALint* value)
+{
+	COUNT_CALL();
+	double values[1] = {0};
+	getSourceProperty(name, param, values, 1);
+	*value = (ALint)values[0];
+}
+
+void alGetSource3i(ALuint name, ALenum param, ALint* value1, ALint* value2, ALint* value3)
+{
+	COUNT_CALL();
+	double values[3] = {0, 0, 0};
+	getSourceProperty(name, param, values, 3);
+	*value1 = (ALint)values[0];
+	*value2 = (ALint)values[1];
+	*value3 = (ALint)values[2];
+}
+
+void alGetSourceiv(ALuint name, ALenum param, ALint* values)
+{
+	COUNT_CALL();
+	double converted[3] = {0, 0, 0};
+	unsigned int size = sourceParamSize(param);
+	getSourceProperty(name, param, converted, size > 0 ? size : 1);
+	for(unsigned int i = 0; i < size; i++)
+	{
+		values[i] = (ALint)converted[i];
+	}
+}
+
+
+#pragma mark Source Playback
+
+/** Apply a playback operation to a list of sources, if they all exist. */
+static void applyToSources(ALsizei n, const ALuint* names, void (*operation)(mock_source*))
+{
+	if(n < 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		if(NULL == getSource(names[i]))
+		{
+			setError(AL_INVALID_NAME);
+			return;
+		}
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		operation(getSource(names[i]));
+	}
+}
+
+void alSourcePlayv(ALsizei n, const ALuint* names)
+{
+	COUNT_CALL();
+	applyToSources(n, names, playSource);
+}
+
+void alSourceStopv(ALsizei n, const ALuint* names)
+{
+	COUNT_CALL();
+	applyToSources(n, names, stopSource);
+}
+
+void alSourceRewindv(ALsizei n, const ALuint* names)
+{
+	COUNT_CALL();
+	applyToSources(n, names, rewindSource);
+}
+
+void alSourcePausev(ALsizei n, const ALuint* names)
+{
+	COUNT_CALL();
+	applyToSources(n, names, pauseSource);
+}
+
+void alSourcePlay(ALuint name)
+{
+	COUNT_CALL();
+	applyToSources(1, &name, playSource);
+}
+
+void alSourceStop(ALuint name)
+{
+	COUNT_CALL();
+	applyToSources(1, &name, stopSource);
+}
+
+void alSourceRewind(ALuint name)
+{
+	COUNT_CALL();
+	applyToSources(1, &name, rewindSource);
+}
+
+void alSourcePause(ALuint name)
+{
+	COUNT_CALL();
+	applyToSources(1, &name, pauseSource);
+}
+
+void alSourceQueueBuffers(ALuint name, ALsizei n, const ALuint* bufferNames)
+{
+	COUNT_CALL();
+	mock_source* source = getSource(name);
+	if(NULL == source)
+	{
+		setError(AL_INVALID_NAME);
+		return;
+	}
+	if(n < 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	if(AL_STATIC == source->type)
+	{
+		setError(AL_INVALID_OPERATION);
+		return;
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		if(0 != bufferNames[i] && NULL == getBuffer(bufferNames[i]))
+		{
+			setError(AL_INVALID_NAME);
+			return;
+		}
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		if(!appendToQueue(source, bufferNames[i]))
+		{
+			setError(AL_OUT_OF_MEMORY);
+			return;
+		}
+		source->type = AL_STREAMING;
+	}
+}
+
+void alSourceUnqueueBuffers(ALuint name, ALsizei n, ALuint* bufferNames)
+{
+	COUNT_CALL();
+	mock_source* source = getSource(name);
+	if(NULL == source)
+	{
+		setError(AL_INVALID_NAME);
+		return;
+	}
+	if(n < 0 || AL_STATIC == source->type || (unsigned int)n > buffersProcessed(source))
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		bufferNames[i] = source->queue[i];
+		releaseBuffer(source->queue[i]);
+	}
+	source->queueLength -= (unsigned int)n;
+	memmove(source->queue, source->queue + n, source->queueLength * sizeof(*source->queue));
+	source->current = source->current > (unsigned int)n ? source->current - (unsigned int)n : 0;
+	if(0 == source->queueLength)
+	{
+		source->type = AL_UNDETERMINED;
+	}
+}
+
+
+#pragma mark -
+#pragma mark Buffer Management
+
+void alGenBuffers(ALsizei n, ALuint* names)
+{
+	COUNT_CALL();
+	if(n < 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		unsigned int index = firstFreeBuffer;
+		while(index < buffersCapacity && buffers[index].inUse)
+		{
+			index++;
+		}
+		if(index == buffersCapacity)
+		{
+			unsigned int newCapacity = buffersCapacity > 0 ? buffersCapacity * 2 : 64;
+			mock_buffer* newBuffers = realloc(buffers, newCapacity * sizeof(*newBuffers));
+			if(NULL == newBuffers)
+			{
+				alDeleteBuffers(i, names);
+				setError(AL_OUT_OF_MEMORY);
+				return;
+			}
+			memset(newBuffers + buffersCapacity, 0, (newCapacity - buffersCapacity) * sizeof(*newBuffers));
+			buffers = newBuffers;
+			buffersCapacity = newCapacity;
+		}
+		memset(&buffers[index], 0, sizeof(buffers[index]));
+		buffers[index].inUse = true;
+		buffers[index].frequency = 44100;
+		buffers[index].bits = 16;
+		buffers[index].channels = 1;
+		numBuffers++;
+		firstFreeBuffer = index + 1;
+		names[i] = index + 1;
+	}
+}
+
+void alDeleteBuffers(ALsizei n, const ALuint* names)
+{
+	COUNT_CALL();
+	if(n < 0)
+	{
+		setError(AL_INVALID_VALUE);
+		return;
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		if(0 == names[i])
+		{
+			continue;
+		}
+		mock_buffer* buffer = getBuffer(names[i]);
+		if(NULL == buffer)
+		{
+			setError(AL_INVALID_NAME);
+			return;
+		}
+		if(buffer->refCount > 0)
+		{
+			setError(AL_INVALID_OPERATION);
+			return;
+		}
+	}
+	for(ALsizei i = 0; i < n; i++)
+	{
+		mock_buffer* buffer = getBuffer(names[i]);
+		if(NULL != buffer)
+		{
+			buffer->inUse = false;
+			numBuffers--;
+			if(names[i] - 1 < firstFreeBuffer)
+			{
+				firstFreeBuffer = names[i] - 1;
+			}
+		}
+	}
+}
+
+ALboolean alIsBuffer(ALuint name)
+{
+	COUNT_CALL();
+	return (0 == name || NULL != getBuffer(name)) ? AL_TRUE : AL_FALSE;
+}
+
+void alBufferData(ALuint name, ALenum format, const ALvoid* data, ALsizei size, ALsizei frequency)
+{
+	COUNT_CALL();
+	(void)data;
+	bufferData(name, format, size, frequency);
+}
+
+
+#pragma mark Buffer Properties
+
+/** Get an (integer) buffer property.
+ *
+ * @return false if the buffer or property doesn't exist.
+ */
+static bool getBufferProperty(ALuint name, ALenum param, ALint* value)
+{
+	mock_buffer* buffer = getBuffer(name);
+	if(NULL == buffer)
+	{
+		setError(AL_INVALID_NAME);
+		return false;
+	}
+	switch(param)
+	{
+		case AL_FREQUENCY: *value = buffer->frequency; return true;
+		case AL_BITS: *value = buffer->bits; return true;
+		case AL_CHANNELS: *value = buffer->channels; return true;
+		case AL_SIZE: *value = buffer->size; return true;
+		default:
+			setError(AL_INVALID_ENUM);
+			return false;
+	}
+}
+
+/** Set a buffer property (OpenAL 1.1 has none that can be set). */
+static void setBufferProperty(ALuint name)
+{
+	setError(NULL == getBuffer(name) ? AL_INVALID_NAME : AL_INVALID_ENUM);
+}
+
+void alBufferf(ALuint name, ALenum param, ALfloat value)
+{
+	COUNT_CALL();
+	(void)param;
+	(void)value;
+	setBufferProperty(name);
+}
+
+void alBuffer3f(ALuint name, ALenum param, ALfloat value1, ALfloat value2, ALfloat value3)
+{
+	COUNT_CALL();
+	(void)param;
+	(void)value1;
+	(void)value2;
+	(void)value3;
+	setBufferProperty(name);
+}
+
+void alBufferfv(ALuint name, ALenum param, const ALfloat* values)
+{
+	COUNT_CALL();
+	(void)param;
+	(void)values;
+	setBufferProperty(name);
+}
+
+void alBufferi(ALuint name, ALenum param, ALint value)
+{
+	COUNT_CALL();
+	(void)param;
+	(void)value;
+	setBufferProperty(name);
+}
+
+void alBuffer3i(ALuint name, ALenum param, ALint value1, ALint value2, ALint value3)
+{
+	COUNT_CALL();
+	(void)param;
+	(void)value1;
+	(void)value2;
+	(void)value3;
+	setBufferProperty(name);
+}
+
+void alBufferiv(ALuint name, ALenum param, const ALint* values)
+{
+	COUNT_CALL();
+	(void)param;
+	(void)values;
+	setBufferProperty(name);
+}
+
+void alGetBufferf(ALuint name, ALenum param, ALfloat* value)
+{
+	COUNT_CALL();
+	ALint intValue;
+	if(getBufferProperty(name, param, &intValue))
+	{
+		*value = (ALfloat)intValue;
+	}
+}
+
+void alGetBuffer3f(ALuint name, ALenum param, ALfloat* value1, ALfloat* value2, ALfloat* value3)
+{
+	COUNT_CALL();
+	(void)value1;
+	(void)value2;
+	(void)value3;
+	(void)param;
+	setError(NULL == getBuffer(name) ? AL_INVALID_NAME : AL_INVALID_ENUM);
+}
+
+void alGetBufferfv(ALuint name, ALenum param, ALfloat* values)
+{
+	COUNT_CALL();
+	ALint intValue;
+	if(getBufferProperty(name, param, &intValue))
+	{
+		*values = (ALfloat)intValue;
+	}
+}
+
+void alGetBufferi(ALuint name, ALenum param, ALint* value)
+{
+	COUNT_CALL();
+	getBufferProperty(name, param, value);
+}
+
+void alGetBuffer3i(ALuint name, ALenum param, ALint* value1, ALint* value2, ALint* value3)
+{
+	COUNT_CALL();
+	(void)value1;
+	(void)value2;
+	(void)value3;
+	(void)param;
+	setError(NULL == getBuffer(name) ? AL_INVALID_NAME : AL_INVALID_ENUM);
+}
+
+void alGetBufferiv(ALuint name, ALenum param, ALint* values)
+{
+	COUNT_CALL();
+	getBufferProperty(name, param, values);
+}
+
+
+#pragma mark -
+#pragma mark Context Management
+
+ALCcontext* alcCreateContext(ALCdevice* deviceIn, const ALCint* attributes)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device || device->capture)
+	{
+		setDeviceError(NULL, ALC_INVALID_DEVICE);
+		return NULL;
+	}
+	mock_context* context = calloc(1, sizeof(*context));
+	if(NULL == context)
+	{
+		setDeviceError(device, ALC_OUT_OF_MEMORY);
+		return NULL;
+	}
+	context->device = device;
+	context->frequency = 44100;
+	context->refresh = 46;
+	context->sync = ALC_FALSE;
+	context->monoSources = 255;
+	context->stereoSources = 1;
+
+	for(const ALCint* attribute = attributes; NULL != attribute && 0 != attribute[0]; attribute += 2)
+	{
+		switch(attribute[0])
+		{
+			case ALC_FREQUENCY: context->frequency = attribute[1]; break;
+			case ALC_REFRESH: context->refresh = attribute[1]; break;
+			case ALC_SYNC: context->sync = attribute[1]; break;
+			case ALC_MONO_SOURCES: context->monoSources = attribute[1]; break;
+			case ALC_STEREO_SOURCES: context->stereoSources = attribute[1]; break;
+			case ALC_FORMAT_CHANNELS_SOFT: context->formatChannels = attribute[1]; break;
+			case ALC_FORMAT_TYPE_SOFT: context->formatType = attribute[1]; break;
+			default: break;
+		}
+	}
+
+	if(device->loopback &&
+	   (context->frequency <= 0 ||
+		0 == loopbackChannels(context->formatChannels) ||
+		0 == loopbackSampleSize(context->formatType)))
+	{
+		free(context);
+		setDeviceError(device, ALC_INVALID_VALUE);
+		return NULL;
+	}
+
+	context->next = contexts;
+	contexts = context;
+	device->numContexts++;
+	return (ALCcontext*)context;
+}
+
+ALCboolean alcMakeContextCurrent(ALCcontext* contextIn)
+{
+	COUNT_CALL();
+	mock_context* context = findContext(contextIn);
+	if(NULL != contextIn && NULL == context)
+	{
+		setDeviceError(NULL, ALC_INVALID_CONTEXT);
+		return ALC_FALSE;
+	}
+	currentContext = context;
+	return ALC_TRUE;
+}
+
+void alcProcessContext(ALCcontext* contextIn)
+{
+	COUNT_CALL();
+	mock_context* context = findContext(contextIn);
+	if(NULL == context)
+	{
+		setDeviceError(NULL, ALC_INVALID_CONTEXT);
+		return;
+	}
+	context->suspended = false;
+}
+
+void alcSuspendContext(ALCcontext* contextIn)
+{
+	COUNT_CALL();
+	mock_context* context = findContext(contextIn);
+	if(NULL == context)
+	{
+		setDeviceError(NULL, ALC_INVALID_CONTEXT);
+		return;
+	}
+	context->suspended = true;
+}
+
+void alcDestroyContext(ALCcontext* contextIn)
+{
+	COUNT_CALL();
+	for(mock_context** entry = &contexts; NULL != *entry; entry = &(*entry)->next)
+	{
+		mock_context* context = *entry;
+		if((ALCcontext*)context == contextIn)
+		{
+			*entry = context->next;
+			if(currentContext == context)
+			{
+				currentContext = NULL;
+			}
+			context->device->numContexts--;
+			free(context);
+			return;
+		}
+	}
+	setDeviceError(NULL, ALC_INVALID_CONTEXT);
+}
+
+ALCcontext* alcGetCurrentContext(void)
+{
+	COUNT_CALL();
+	return (ALCcontext*)currentContext;
+}
+
+ALCdevice* alcGetContextsDevice(ALCcontext* contextIn)
+{
+	COUNT_CALL();
+	mock_context* context = findContext(contextIn);
+	if(NULL == context)
+	{
+		setDeviceError(NULL, ALC_INVALID_CONTEXT);
+		return NULL;
+	}
+	return (ALCdevice*)context->device;
+}
+
+
+#pragma mark -
+#pragma mark Device Management
+
+ALCdevice* alcOpenDevice(const ALCchar* name)
+{
+	COUNT_CALL();
+	(void)name;
+	mock_device* device = createDevice();
+	if(NULL == device)
+	{
+		setDeviceError(NULL, ALC_OUT_OF_MEMORY);
+	}
+	return (ALCdevice*)device;
+}
+
+ALCboolean alcCloseDevice(ALCdevice* deviceIn)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device || device->capture || device->numContexts > 0)
+	{
+		setDeviceError(NULL, ALC_INVALID_DEVICE);
+		return ALC_FALSE;
+	}
+	destroyDevice(device);
+	return ALC_TRUE;
+}
+
+ALCenum alcGetError(ALCdevice* deviceIn)
+{
+	COUNT_CALL();
+	ALCenum error;
+	if(NULL == deviceIn)
+	{
+		error = alcError;
+		alcError = ALC_NO_ERROR;
+		return error;
+	}
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device)
+	{
+		return ALC_INVALID_DEVICE;
+	}
+	error = device->error;
+	device->error = ALC_NO_ERROR;
+	return error;
+}
+
+
+#pragma mark ALC Extensions
+
+static ALCdevice* alcLoopbackOpenDeviceSOFT(const ALCchar* name)
+{
+	COUNT_CALL();
+	(void)name;
+	mock_device* device = createDevice();
+	if(NULL == device)
+	{
+		setDeviceError(NULL, ALC_OUT_OF_MEMORY);
+		return NULL;
+	}
+	device->loopback = true;
+	return (ALCdevice*)device;
+}
+
+static ALCboolean alcIsRenderFormatSupportedSOFT(ALCdevice* deviceIn, ALCsizei frequency, ALCenum channels, ALCenum type)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device || !device->loopback)
+	{
+		setDeviceError(device, ALC_INVALID_DEVICE);
+		return ALC_FALSE;
+	}
+	if(frequency <= 0)
+	{
+		setDeviceError(device, ALC_INVALID_VALUE);
+		return ALC_FALSE;
+	}
+	return (0 != loopbackChannels(channels) && 0 != loopbackSampleSize(type)) ? ALC_TRUE : ALC_FALSE;
+}
+
+static void alcRenderSamplesSOFT(ALCdevice* deviceIn, ALCvoid* buffer, ALCsizei samples)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device || !device->loopback)
+	{
+		setDeviceError(device, ALC_INVALID_DEVICE);
+		return;
+	}
+	if(samples < 0 || (samples > 0 && NULL == buffer))
+	{
+		setDeviceError(device, ALC_INVALID_VALUE);
+		return;
+	}
+
+	// Render using the format of the device's current context.
+	mock_context* context = currentContext;
+	if(NULL == context || context->device != device)
+	{
+		setDeviceError(device, ALC_INVALID_CONTEXT);
+		return;
+	}
+	unsigned int frameSize = loopbackChannels(context->formatChannels) * loopbackSampleSize(context->formatType);
+	memset(buffer, 0, (size_t)samples * frameSize);
+	advanceTime((double)samples / context->frequency);
+}
+
+static ALCvoid alcMacOSXMixerOutputRate(const ALCdouble value)
+{
+	COUNT_CALL();
+	mixerOutputRate = value;
+}
+
+static ALCdouble alcMacOSXGetMixerOutputRate(void)
+{
+	COUNT_CALL();
+	return mixerOutputRate;
+}
+
+ALCboolean alcIsExtensionPresent(ALCdevice* device, const ALCchar* name)
+{
+	COUNT_CALL();
+	if(NULL == name)
+	{
+		setDeviceError(findDevice(device), ALC_INVALID_VALUE);
+		return ALC_FALSE;
+	}
+	return (0 == strcasecmp(name, "ALC_ENUMERATION_EXT") ||
+			0 == strcasecmp(name, "ALC_EXT_CAPTURE") ||
+			0 == strcasecmp(name, "ALC_SOFT_loopback")) ? ALC_TRUE : ALC_FALSE;
+}
+
+void* alcGetProcAddress(ALCdevice* device, const ALCchar* name)
+{
+	COUNT_CALL();
+	if(NULL == name)
+	{
+		setDeviceError(findDevice(device), ALC_INVALID_VALUE);
+		return NULL;
+	}
+	if(0 == strcmp(name, "alcLoopbackOpenDeviceSOFT")) return (void*)alcLoopbackOpenDeviceSOFT;
+	if(0 == strcmp(name, "alcIsRenderFormatSupportedSOFT")) return (void*)alcIsRenderFormatSupportedSOFT;
+	if(0 == strcmp(name, "alcRenderSamplesSOFT")) return (void*)alcRenderSamplesSOFT;
+	if(0 == strcmp(name, "alcMacOSXMixerOutputRate")) return (void*)alcMacOSXMixerOutputRate;
+	if(0 == strcmp(name, "alcMacOSXGetMixerOutputRate")) return (void*)alcMacOSXGetMixerOutputRate;
+	return NULL;
+}
+
+ALCenum alcGetEnumValue(ALCdevice* device, const ALCchar* name)
+{
+	COUNT_CALL();
+	if(NULL == name)
+	{
+		setDeviceError(findDevice(device), ALC_INVALID_VALUE);
+		return 0;
+	}
+	if(0 == strcmp(name, "ALC_FORMAT_CHANNELS_SOFT")) return ALC_FORMAT_CHANNELS_SOFT;
+	if(0 == strcmp(name, "ALC_FORMAT_TYPE_SOFT")) return ALC_FORMAT_TYPE_SOFT;
+	return 0;
+}
+
+
+#pragma mark ALC Properties
+
+const ALCchar* alcGetString(ALCdevice* deviceIn, ALCenum param)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	switch(param)
+	{
+		case ALC_DEFAULT_DEVICE_SPECIFIER:
+		case ALC_CAPTURE_DEFAULT_DEVICE_SPECIFIER:
+			return kDeviceName;
+		case ALC_DEVICE_SPECIFIER:
+		case ALC_CAPTURE_DEVICE_SPECIFIER:
+			// With no device, this is the list of all devices.
+			return NULL == device ? kDeviceName "\0" : kDeviceName;
+		case ALC_EXTENSIONS:
+			return "ALC_ENUMERATION_EXT ALC_EXT_CAPTURE ALC_SOFT_loopback";
+		case ALC_NO_ERROR: return "No Error";
+		case ALC_INVALID_DEVICE: return "Invalid Device";
+		case ALC_INVALID_CONTEXT: return "Invalid Context";
+		case ALC_INVALID_ENUM: return "Invalid Enum";
+		case ALC_INVALID_VALUE: return "Invalid Value";
+		case ALC_OUT_OF_MEMORY: return "Out of Memory";
+		default:
+			setDeviceError(device, ALC_INVALID_ENUM);
+			return NULL;
+	}
+}
+
+void alcGetIntegerv(ALCdevice* deviceIn, ALCenum param, ALCsizei size, ALCint* values)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(size <= 0 || NULL == values)
+	{
+		setDeviceError(device, ALC_INVALID_VALUE);
+		return;
+	}
+
+	// Context attributes come from the device's current context, if it has one.
+	mock_context* context = NULL;
+	if(NULL != currentContext && currentContext->device == device)
+	{
+		context = currentContext;
+	}
+	else
+	{
+		for(mock_context* entry = contexts; NULL != entry; entry = entry->next)
+		{
+			if(entry->device == device)
+			{
+				context = entry;
+				break;
+			}
+		}
+	}
+
+	ALCint attributes[16];
+	ALCsizei numAttributes = 0;
+	if(NULL != context)
+	{
+		attributes[numAttributes++] = ALC_FREQUENCY;
+		attributes[numAttributes++] = context->frequency;
+		attributes[numAttributes++] = ALC_REFRESH;
+		attributes[numAttributes++] = context->refresh;
+		attributes[numAttributes++] = ALC_SYNC;
+		attributes[numAttributes++] = context->sync;
+		attributes[numAttributes++] = ALC_MONO_SOURCES;
+		attributes[numAttributes++] = context->monoSources;
+		attributes[numAttributes++] = ALC_STEREO_SOURCES;
+		attributes[numAttributes++] = context->stereoSources;
+	}
+	attributes[numAttributes++] = 0;
+
+	switch(param)
+	{
+		case ALC_MAJOR_VERSION:
+			values[0] = 1;
+			break;
+		case ALC_MINOR_VERSION:
+			values[0] = 1;
+			break;
+		case ALC_ATTRIBUTES_SIZE:
+			values[0] = numAttributes;
+			break;
+		case ALC_ALL_ATTRIBUTES:
+			if(size < numAttributes)
+			{
+				setDeviceError(device, ALC_INVALID_VALUE);
+				return;
+			}
+			memcpy(values, attributes, (size_t)numAttributes * sizeof(*values));
+			break;
+		case ALC_FREQUENCY:
+			values[0] = NULL != context ? context->frequency : 44100;
+			break;
+		case ALC_CAPTURE_SAMPLES:
+			if(NULL == device || !device->capture)
+			{
+				setDeviceError(device, ALC_INVALID_DEVICE);
+				return;
+			}
+			values[0] = (ALCint)device->captureAvailable;
+			break;
+		default:
+			setDeviceError(device, ALC_INVALID_ENUM);
+			break;
+	}
+}
+
+
+#pragma mark -
+#pragma mark Capture
+
+ALCdevice* alcCaptureOpenDevice(const ALCchar* name, ALCuint frequency, ALCenum format, ALCsizei bufferSize)
+{
+	COUNT_CALL();
+	(void)name;
+	ALint bits;
+	ALint channels;
+	unsigned int frameSize = bufferFormatInfo(format, &bits, &channels);
+	if(0 == frameSize || 0 == frequency || bufferSize <= 0)
+	{
+		setDeviceError(NULL, ALC_INVALID_VALUE);
+		return NULL;
+	}
+	mock_device* device = createDevice();
+	if(NULL == device)
+	{
+		setDeviceError(NULL, ALC_OUT_OF_MEMORY);
+		return NULL;
+	}
+	device->capture = true;
+	device->captureFrequency = frequency;
+	device->captureFrameSize = frameSize;
+	device->captureBufferSize = bufferSize;
+	return (ALCdevice*)device;
+}
+
+ALCboolean alcCaptureCloseDevice(ALCdevice* deviceIn)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device || !device->capture)
+	{
+		setDeviceError(NULL, ALC_INVALID_DEVICE);
+		return ALC_FALSE;
+	}
+	destroyDevice(device);
+	return ALC_TRUE;
+}
+
+void alcCaptureStart(ALCdevice* deviceIn)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device || !device->capture)
+	{
+		setDeviceError(device, ALC_INVALID_DEVICE);
+		return;
+	}
+	device->capturing = true;
+}
+
+void alcCaptureStop(ALCdevice* deviceIn)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device || !device->capture)
+	{
+		setDeviceError(device, ALC_INVALID_DEVICE);
+		return;
+	}
+	device->capturing = false;
+}
+
+void alcCaptureSamples(ALCdevice* deviceIn, ALCvoid* buffer, ALCsizei samples)
+{
+	COUNT_CALL();
+	mock_device* device = findDevice(deviceIn);
+	if(NULL == device || !device->capture)
+	{
+		setDeviceError(device, ALC_INVALID_DEVICE);
+		return;
+	}
+	if(samples < 0 || samples > (ALCsizei)device->captureAvailable)
+	{
+		setDeviceError(device, ALC_INVALID_VALUE);
+		return;
+	}
+	memset(buffer, 0, (size_t)samples * device->captureFrameSize);
+	device->captureAvailable -= samples;
+}
@@ -0,0 +1,113 @@
+/*
+ *  oal_mock_al.h
+ *  ObjectAL
+ *
+ *  A headless stand-in for the OpenAL library, for testing and profiling ObjectAL itself.
+ *
+ *  oal_mock_al.c defines every OpenAL 1.1 entry point (plus the extensions ObjectAL looks
+ *  for), so linking it instead of the OpenAL framework gives ObjectAL a complete OpenAL
+ *  that needs no audio hardware.  It is deliberately NOT part of the ObjectAL library
+ *  target; add it only to test or benchmark targets.
+ *
+ *  What is modeled:
+ *  - Source and buffer names, all source and listener properties, and the usual errors.
+ *  - Source state, static buffers and buffer queues, looping, and playback offsets.
+ *  - Playback time, which only moves when oal_mock_advance() is called (or when a loopback
+ *    device renders), so results don't depend on timing.
+ *  - Call counts for every entry point.
+ *
+ *  What isn't: mixing (rendered and captured samples are silence), sample data (only its
+ *  size is kept), and separate object namespaces per device or context.
+ *
+ *  Like the real thing, none of this is synchronized beyond what ALWrapper already does.
+ *  Only call the oal_mock functions while no other thread is making OpenAL calls.
+ */
+
+#ifndef OAL_MOCK_AL_H
+#define OAL_MOCK_AL_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __APPLE__
+#include <OpenAL/al.h>
+#include <OpenAL/alc.h>
+#else
+#include <AL/al.h>
+#include <AL/alc.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Destroy all devices, contexts, sources and buffers, clear errors, reset the clock,
+ * and zero all call counts.
+ */
+void oal_mock_reset(void);
+
+/** Let playback time pass.  Playing sources move through their buffers, loop, and stop
+ * at the end as they would in real OpenAL.
+ *
+ * @param seconds The amount of time that passes.
+ */
+void oal_mock_advance(double seconds);
+
+/** Get the amount of playback time that has passed since the last reset.
+ *
+ * @return The time in seconds.
+ */
+double oal_mock_time(void);
+
+/** Set the most sources that can exist at once (alGenSources fails beyond this).
+ *
+ * @param maxSources The source limit (default 256).
+ */
+void oal_mock_set_max_sources(unsigned int maxSources);
+
+/** Get the number of sources that currently exist.
+ *
+ * @return The number of sources.
+ */
+unsigned int oal_mock_num_sources(void);
+
+/** Get the number of sources that are currently playing.
+ *
+ * @return The number of playing sources.
+ */
+unsigned int oal_mock_num_playing_sources(void);
+
+/** Get the number of buffers that currently exist.
+ *
+ * @return The number of buffers.
+ */
+unsigned int oal_mock_num_buffers(void);
+
+/** Get how many times an entry point was called since the last reset.
+ *
+ * @param function The function name (such as "alSourcePlay").
+ * @return The number of calls.
+ */
+uint64_t oal_mock_call_count(const char* function);
+
+/** Get the number of calls to all entry points since the last reset.
+ *
+ * @return The number of calls.
+ */
+uint64_t oal_mock_total_calls(void);
+
+/** Zero all call counts, leaving everything else alone.
+ */
+void oal_mock_reset_call_counts(void);
+
+/** Print the call count of every entry point called since the last reset.
+ *
+ * @param file Where to print.
+ */
+void oal_mock_print_call_counts(FILE* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_MOCK_AL_H */
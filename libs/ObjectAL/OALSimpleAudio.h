@@ -31,6 +31,182 @@
 #import "ALSoundSource.h"
 #import "ALChannelSource.h"
 #import "OALAudioTrack.h"
+#import "OALSoundBank.h"
+
+
+#pragma mark OALDeferredEffect
+
+/** The state of a deferred effect. */
+typedef enum
+{
+	/** The effect is waiting for its sound data to load. */
+	OALDeferredEffectStatePending,
+	/** The effect has started playing. */
+	OALDeferredEffectStatePlaying,
+	/** The sound data loaded too late, so the effect was not played. */
+	OALDeferredEffectStateDropped,
+	/** The sound data could not be loaded, or no source was available. */
+	OALDeferredEffectStateFailed,
+	/** The effect was cancelled before it started. */
+	OALDeferredEffectStateCancelled,
+} OALDeferredEffectState;
+
+/**
+ * A handle to a sound effect started with
+ * OALSimpleAudio playEffectDeferred:volume:pitch:pan:loop:priority:maxLatency:. <br>
+ *
+ * If the effect wasn't in the preload cache, it is loaded in the background and only
+ * started if the data arrives within the requested latency.
+ */
+@interface OALDeferredEffect : NSObject
+{
+	NSString* filePath;
+	OALDeferredEffectState state;
+	id<ALSoundSource> soundSource;
+
+	float volume;
+	float pitch;
+	float pan;
+	bool loop;
+	int priority;
+	/** When the effect was requested (mach absolute time). */
+	uint64_t requestTime;
+	/** How long, in seconds, the effect may wait for its data before being dropped. */
+	NSTimeInterval maxLatency;
+}
+
+
+#pragma mark Properties
+
+/** The path of the sound data. */
+@property(readonly) NSString* filePath;
+
+/** The current state of this effect. */
+@property(readonly) OALDeferredEffectState state;
+
+/** The sound source playing this effect, or nil if it hasn't started. */
+@property(readonly) id<ALSoundSource> soundSource;
+
+
+#pragma mark Object Management
+
+/** (INTERNAL USE) Create a deferred effect.
+ *
+ * @param filePath The path containing the sound data.
+ * @param volume The volume (gain) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param pan Left-right panning (-1.0 = far left, 1.0 = far right).
+ * @param loop If TRUE, the sound will loop until you call "stop" on the sound source.
+ * @param priority How important this effect is (higher = more important).
+ * @param maxLatency The longest time, in seconds, to wait for the sound data.
+ * @return A new deferred effect.
+ */
++ (id) effectWithFile:(NSString*) filePath
+			   volume:(float) volume
+				pitch:(float) pitch
+				  pan:(float) pan
+				 loop:(bool) loop
+			 priority:(int) priority
+		   maxLatency:(NSTimeInterval) maxLatency;
+
+/** (INTERNAL USE) Initialize a deferred effect.
+ *
+ * @param filePath The path containing the sound data.
+ * @param volume The volume (gain) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param pan Left-right panning (-1.0 = far left, 1.0 = far right).
+ * @param loop If TRUE, the sound will loop until you call "stop" on the sound source.
+ * @param priority How important this effect is (higher = more important).
+ * @param maxLatency The longest time, in seconds, to wait for the sound data.
+ * @return The initialized deferred effect.
+ */
+- (id) initWithFile:(NSString*) filePath
+			 volume:(float) volume
+			  pitch:(float) pitch
+				pan:(float) pan
+			   loop:(bool) loop
+		   priority:(int) priority
+		 maxLatency:(NSTimeInterval) maxLatency;
+
+
+#pragma mark Playback
+
+/** Cancel this effect if it hasn't started yet, or stop it if it has.
+ */
+- (void) cancel;
+
+/** (INTERNAL USE) Play the effect on a channel, unless it has been waiting longer than
+ * its maximum latency.
+ *
+ * @param buffer The loaded sound data, or nil if loading failed.
+ * @param channel The channel to play on.
+ * @return TRUE if the effect started playing.
+ */
+- (bool) startWithBuffer:(ALBuffer*) buffer channel:(ALChannelSource*) channel;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALEffectPolicy
+
+/**
+ * Limits how often a sound effect can be played through OALSimpleAudio
+ * (see OALSimpleAudio setPolicy:forEffect:). <br>
+ *
+ * Rapid fire effects like gunshots can otherwise grab (or steal) a voice on every call.
+ * Plays that a policy turns away never touch OpenAL, and return nil.
+ */
+@interface OALEffectPolicy : NSObject
+{
+	NSUInteger maxInstances;
+	NSTimeInterval minInterval;
+	bool restartOldest;
+}
+
+
+#pragma mark Properties
+
+/** The most instances of the effect that can play at once (0 = no limit). */
+@property(readonly) NSUInteger maxInstances;
+
+/** The shortest time, in seconds, between starting one instance of the effect and the next
+ * (0 = no limit). */
+@property(readonly) NSTimeInterval minInterval;
+
+/** If TRUE, playing the effect while maxInstances are already playing restarts the oldest
+ * instance. If FALSE, the new play is dropped. */
+@property(readonly) bool restartOldest;
+
+
+#pragma mark Object Management
+
+/** Create a policy.
+ *
+ * @param maxInstances The most instances of the effect that can play at once (0 = no limit).
+ * @param minInterval The shortest time, in seconds, between starting instances (0 = no limit).
+ * @param restartOldest If TRUE, restart the oldest instance when at the limit rather than
+ *        dropping the new play.
+ * @return A new policy.
+ */
++ (id) policyWithMaxInstances:(NSUInteger) maxInstances
+				  minInterval:(NSTimeInterval) minInterval
+				restartOldest:(bool) restartOldest;
+
+/** Initialize a policy.
+ *
+ * @param maxInstances The most instances of the effect that can play at once (0 = no limit).
+ * @param minInterval The shortest time, in seconds, between starting instances (0 = no limit).
+ * @param restartOldest If TRUE, restart the oldest instance when at the limit rather than
+ *        dropping the new play.
+ * @return The initialized policy.
+ */
+- (id) initWithMaxInstances:(NSUInteger) maxInstances
+				minInterval:(NSTimeInterval) minInterval
+			  restartOldest:(bool) restartOldest;
+
+@end
+
 
 
 #pragma mark OALSimpleAudio
@@ -56,7 +232,7 @@
  * All commands are delegated either to the ALChannelSource (for sound effects),
  * or to the OALAudioTrack (for BG music).
  */
-@interface OALSimpleAudio : NSObject
+@interface OALSimpleAudio : NSObject <ALSoundSourcePoolDelegate>
 {
 	/** The device we are using */
 	ALDevice* device;
@@ -65,8 +241,25 @@
 
 	/** The sound channel used by this object. */
 	ALChannelSource* channel;
-	/** Cache for preloaded sound samples. */
+	/** Cache for preloaded sound samples (key: NSString* filePath, value: OAL_PreloadCacheEntry*). */
 	NSMutableDictionary* preloadCache;
+	/** Ticks on every cache access, to order entries by how recently they were used. */
+	uint64_t preloadCacheClock;
+	NSUInteger preloadCacheSize;
+	NSUInteger preloadCacheMaxSize;
+	NSUInteger preloadCacheHits;
+	NSUInteger preloadCacheMisses;
+	NSUInteger preloadCacheEvictions;
+	/** Banks searched for effects before loading them from files (OALSoundBank*). */
+	NSMutableArray* soundBanks;
+	/** Instances of effects that have a policy (key: NSString* filePath, value: OAL_EffectInstances*). */
+	NSMutableDictionary* effectInstances;
+	/** The effect each recorded instance's source is playing (key: NSValue* holding a non-retained
+	 * ALSource*, value: OAL_EffectInstances*). Its lock guards every instance record, since the
+	 * channel's source pool reports ended voices while holding the pool's lock.
+	 */
+	NSMutableDictionary* instancesBySource;
+	NSUInteger effectsSuppressed;
 #if NS_BLOCKS_AVAILABLE && OBJECTAL_USE_BLOCKS
 	/** Queue for preloading and async operations that use blocks. This ensures all operations are safe because they are guaranteed to run in order. */
 	dispatch_queue_t oal_dispatch_queue;
@@ -74,6 +267,16 @@
 	/** keeping track of how many effects remain to be loaded */
 	uint pendingLoadCount;
 	
+	/** Loads effects for playEffectDeferred on a background thread. */
+	NSOperationQueue* deferredLoadQueue;
+	/** Effects waiting for their data (key: NSString* filePath, value: NSMutableArray* of OALDeferredEffect*). */
+	NSMutableDictionary* deferredEffects;
+	/** Number of deferred plays per file that missed the preload cache (key: NSString*, value: NSNumber*). */
+	NSMutableDictionary* deferredEffectMissCounts;
+	NSUInteger deferredEffectMisses;
+	NSUInteger deferredEffectsLate;
+	NSUInteger deferredEffectsDropped;
+	
 	/** Audio track to play background music */
 	OALAudioTrack* backgroundTrack;
 	
@@ -126,6 +329,11 @@
 /** The number of sources OALSimpleAudio is using (max 32 on current iOS devices). */
 @property(readwrite,assign) unsigned int reservedSources;
 
+/** Decides which effect gets interrupted when all sources are busy (default ALOldestVoicePolicy).
+ * Use ALWeightedVoicePolicy to take effect priorities into account.
+ */
+@property(readwrite,retain) id<ALVoiceStealingPolicy> voiceStealingPolicy;
+
 /** Background audio URL */
 @property(readonly) NSURL* backgroundTrackURL;
 
@@ -168,6 +376,48 @@
 /** The number of items currently in the preload cache. */
 @property(readonly) NSUInteger preloadCacheCount;
 
+/** The total size, in bytes, of the sound data in the preload cache. */
+@property(readonly) NSUInteger preloadCacheSize;
+
+/** The maximum size, in bytes, of the sound data in the preload cache (0 = unlimited). <br>
+ *
+ * When loading an effect pushes the cache over this size, the least recently used effects
+ * are unloaded until it fits again. Effects that are currently playing are never unloaded.
+ * An unloaded effect gets reloaded automatically the next time it is played. <br>
+ *
+ * Default value: 0
+ */
+@property(readwrite,assign) NSUInteger preloadCacheMaxSize;
+
+/** The number of effect loads and plays that found the effect in the preload cache. */
+@property(readonly) NSUInteger preloadCacheHits;
+
+/** The number of effect loads and plays that had to load the effect from disk. */
+@property(readonly) NSUInteger preloadCacheMisses;
+
+/** The number of effects unloaded to keep the cache within preloadCacheMaxSize. */
+@property(readonly) NSUInteger preloadCacheEvictions;
+
+/** The number of deferred effects that weren't in the preload cache and had to be loaded. */
+@property(readonly) NSUInteger deferredEffectMisses;
+
+/** The number of deferred effects that missed the preload cache, but still started within
+ * their maximum latency. */
+@property(readonly) NSUInteger deferredEffectsLate;
+
+/** The number of deferred effects that were dropped because their data took longer than their
+ * maximum latency to load (or failed to load). */
+@property(readonly) NSUInteger deferredEffectsDropped;
+
+/** The number of effect plays dropped by effect policies (see setPolicy:forEffect:). */
+@property(readonly) NSUInteger effectsSuppressed;
+
+/** The number of deferred effect preload cache misses per file
+ * (key: NSString* filePath, value: NSNumber* count).
+ * Files that show up here are good candidates for preloading.
+ */
+@property(readonly) NSDictionary* deferredEffectMissCounts;
+
 #pragma mark Object Management
 
 /** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
@@ -293,6 +543,44 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALSimpleAudio);
 - (void) stopBg;
 
 
+#pragma mark Sound Banks
+
+/** Look for sound effects in a sound bank before loading them from files.
+ * Effects are found by their full path first, then by file name.
+ * Banks are searched in the order they were added.
+ *
+ * @param bank The bank to add.
+ */
+- (void) addSoundBank:(OALSoundBank*) bank;
+
+/** Stop looking for sound effects in a sound bank.
+ * Effects already loaded from it stay loaded.
+ *
+ * @param bank The bank to remove.
+ */
+- (void) removeSoundBank:(OALSoundBank*) bank;
+
+
+#pragma mark Effect Policies
+
+/** Limit how often an effect can be played through playEffect: and friends. <br>
+ * Instances are counted without asking OpenAL: an instance counts until its sound would have
+ * finished (never, if looping), it is stopped by stopAllEffects, or its source is reused for
+ * another sound.
+ *
+ * @param policy The policy, or nil to remove the effect's policy.
+ * @param filePath The path of the effect, as passed to playEffect:.
+ */
+- (void) setPolicy:(OALEffectPolicy*) policy forEffect:(NSString*) filePath;
+
+/** Get the policy set for an effect.
+ *
+ * @param filePath The path of the effect, as passed to playEffect:.
+ * @return The effect's policy, or nil if it has none.
+ */
+- (OALEffectPolicy*) policyForEffect:(NSString*) filePath;
+
+
 #pragma mark Sound Effects
 
 /** Preload and cache a sound effect for later playback.
@@ -312,6 +600,8 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALSimpleAudio);
 	   completionBlock:(void(^)(ALBuffer *)) completionBlock;
 
 /** Asynchronous preload and cache multiple sound effects for later playback.
+ * Files are decoded in parallel, using one thread per processor core. Progress is still
+ * reported in the order the files appear in filePaths.
  *
  * @param filePaths An NSArray of NSStrings with the paths containing the sound data.
  * @param progressBlock Executed regularly while file loading is in progress.
@@ -366,6 +656,55 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALSimpleAudio);
 						   pan:(float) pan
 						  loop:(bool) loop;
 
+/** Play a sound effect with the specified priority.  The sound will be loaded and cached if
+ * it wasn't already. If all sources are busy, a playing effect will only be interrupted if
+ * the voice stealing policy considers it no more important than this one.
+ *
+ * @param filePath The path containing the sound data.
+ * @param volume The volume (gain) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param pan Left-right panning (-1.0 = far left, 1.0 = far right).
+ * @param loop If TRUE, the sound will loop until you call "stop" on the returned sound source.
+ * @param priority How important this effect is (higher = more important).
+ * @return The sound source being used for playback, or nil if an error occurred or no source
+ *         could be freed.
+ */
+- (id<ALSoundSource>) playEffect:(NSString*) filePath
+						volume:(float) volume
+						 pitch:(float) pitch
+						   pan:(float) pan
+						  loop:(bool) loop
+					  priority:(int) priority;
+
+/** Play a sound effect without ever blocking on loading. <br>
+ *
+ * If the effect is in the preload cache, it starts immediately. Otherwise its data is loaded
+ * on a background thread and this method returns right away. The effect then starts once the
+ * data is ready, unless that took longer than maxLatency, in which case it is dropped. <br>
+ *
+ * The loaded data is added to the preload cache (if enabled), so later plays are immediate.
+ * Use deferredEffectMisses, deferredEffectsLate, deferredEffectsDropped and
+ * deferredEffectMissCounts to find effects that should be preloaded. <br>
+ *
+ * Note: Deferred effects are started from the main thread's run loop.
+ *
+ * @param filePath The path containing the sound data.
+ * @param volume The volume (gain) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param pan Left-right panning (-1.0 = far left, 1.0 = far right).
+ * @param loop If TRUE, the sound will loop until you call "stop" on the sound source.
+ * @param priority How important this effect is (higher = more important).
+ * @param maxLatency The longest time, in seconds, the effect may be delayed by loading.
+ * @return A handle to the effect, or nil if an error occurred.
+ */
+- (OALDeferredEffect*) playEffectDeferred:(NSString*) filePath
+								   volume:(float) volume
+									pitch:(float) pitch
+									  pan:(float) pan
+									 loop:(bool) loop
+								 priority:(int) priority
+							   maxLatency:(NSTimeInterval) maxLatency;
+
 /** Stop ALL sound effect playback.
  */
 - (void) stopAllEffects;
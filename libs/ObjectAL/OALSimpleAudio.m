@@ -28,10 +28,401 @@
 #import "ObjectALMacros.h"
 #import "OALAudioSupport.h"
 #import "OpenALManager.h"
+#import "mach_timing.h"
+#import "OALTrace.h"
+#import "ALSource.h"
+#if NS_BLOCKS_AVAILABLE && OBJECTAL_USE_BLOCKS
+#import <libkern/OSAtomic.h>
+#endif
 
 // By default, reserve all 32 sources.
 #define kDefaultReservedSources 32
 
+#pragma mark -
+#pragma mark OAL_PreloadCacheEntry
+
+/**
+ * (INTERNAL USE) An entry in the preload cache.
+ */
+@interface OAL_PreloadCacheEntry: NSObject
+{
+	@public
+	/** The preloaded buffer. */
+	ALBuffer* buffer;
+	/** The size of the buffer's data in bytes. */
+	NSUInteger size;
+	/** The value of the cache clock when this entry was last used. */
+	uint64_t lastUsed;
+}
+
+/** (INTERNAL USE) Create a new entry.
+ *
+ * @param buffer The preloaded buffer.
+ * @return A new entry.
+ */
++ (id) entryWithBuffer:(ALBuffer*) buffer;
+
+/** (INTERNAL USE) Initialize an entry.
+ *
+ * @param buffer The preloaded buffer.
+ * @return The initialized entry.
+ */
+- (id) initWithBuffer:(ALBuffer*) buffer;
+
+@end
+
+@implementation OAL_PreloadCacheEntry
+
++ (id) entryWithBuffer:(ALBuffer*) buffer
+{
+	return [[[self alloc] initWithBuffer:buffer] autorelease];
+}
+
+- (id) initWithBuffer:(ALBuffer*) bufferIn
+{
+	if(nil != (self = [super init]))
+	{
+		buffer = [bufferIn retain];
+		size = bufferIn.size;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[buffer release];
+	[super dealloc];
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OAL_EffectInstances
+
+/**
+ * (INTERNAL USE) The policy for an effect, and the instances of it that are playing.
+ * Instances are kept oldest first, and are never more than the policy's maxInstances.
+ * An instance is forgotten when the channel's source pool reports that its voice ended,
+ * or once its expected end time passes, so counting them never asks OpenAL.
+ */
+@interface OAL_EffectInstances: NSObject
+{
+	@public
+	/** The policy being enforced. */
+	OALEffectPolicy* policy;
+	/** When an instance was last started (mach_absolute_time). */
+	uint64_t lastStartTime;
+	/** Whether an instance has been started yet. */
+	bool started;
+	/** The number of recorded instances. */
+	NSUInteger numInstances;
+	/** The sources playing the instances (retained). */
+	ALSource** sources;
+	/** When each instance finishes (mach_absolute_time), or UINT64_MAX if it loops. */
+	uint64_t* endTimes;
+}
+
+/** (INTERNAL USE) Create a new set of instances.
+ *
+ * @param policy The policy to enforce.
+ * @return A new set of instances.
+ */
++ (id) instancesWithPolicy:(OALEffectPolicy*) policy;
+
+/** (INTERNAL USE) Initialize a set of instances.
+ *
+ * @param policy The policy to enforce.
+ * @return The initialized set of instances.
+ */
+- (id) initWithPolicy:(OALEffectPolicy*) policy;
+
+/** (INTERNAL USE) Forget instances whose expected end time has passed.
+ *
+ * @param now The current mach_absolute_time.
+ */
+- (void) pruneFinished:(uint64_t) now;
+
+/** (INTERNAL USE) Record a newly started instance, dropping the oldest if at the limit.
+ *
+ * @param source The source playing the instance.
+ * @param endTime When the instance finishes, or UINT64_MAX if it loops.
+ */
+- (void) addSource:(ALSource*) source endTime:(uint64_t) endTime;
+
+/** (INTERNAL USE) Forget the instance playing on a source, if there is one.
+ *
+ * @param source The source whose voice ended.
+ */
+- (void) removeSource:(ALSource*) source;
+
+/** (INTERNAL USE) Forget all instances.
+ */
+- (void) removeAllSources;
+
+@end
+
+@implementation OAL_EffectInstances
+
++ (id) instancesWithPolicy:(OALEffectPolicy*) policy
+{
+	return [[[self alloc] initWithPolicy:policy] autorelease];
+}
+
+- (id) initWithPolicy:(OALEffectPolicy*) policyIn
+{
+	if(nil != (self = [super init]))
+	{
+		policy = [policyIn retain];
+		if(policy.maxInstances > 0)
+		{
+			sources = calloc(policy.maxInstances, sizeof(*sources));
+			endTimes = calloc(policy.maxInstances, sizeof(*endTimes));
+			if(NULL == sources || NULL == endTimes)
+			{
+				OAL_LOG_ERROR(@"Could not allocate %d effect instances", (int)policy.maxInstances);
+				[self release];
+				return nil;
+			}
+		}
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[self removeAllSources];
+	free(sources);
+	free(endTimes);
+	[policy release];
+	[super dealloc];
+}
+
+- (void) pruneFinished:(uint64_t) now
+{
+	NSUInteger kept = 0;
+	for(NSUInteger i = 0; i < numInstances; i++)
+	{
+		// Instances that are stopped early are removed when the pool reports it.
+		if(endTimes[i] > now)
+		{
+			sources[kept] = sources[i];
+			endTimes[kept] = endTimes[i];
+			kept++;
+		}
+		else
+		{
+			[sources[i] release];
+		}
+	}
+	numInstances = kept;
+}
+
+- (void) addSource:(ALSource*) source endTime:(uint64_t) endTime
+{
+	if(0 == policy.maxInstances)
+	{
+		return;
+	}
+	
+	// The pool reports a restarted or stolen voice before it gets here, but a source
+	// whose instance was pruned by time could still be on record.
+	[self removeSource:source];
+	if(numInstances == policy.maxInstances)
+	{
+		[sources[0] release];
+		memmove(sources, sources + 1, (numInstances - 1) * sizeof(*sources));
+		memmove(endTimes, endTimes + 1, (numInstances - 1) * sizeof(*endTimes));
+		numInstances--;
+	}
+	sources[numInstances] = [source retain];
+	endTimes[numInstances] = endTime;
+	numInstances++;
+}
+
+- (void) removeSource:(ALSource*) source
+{
+	for(NSUInteger i = 0; i < numInstances; i++)
+	{
+		if(sources[i] == source)
+		{
+			[sources[i] release];
+			memmove(sources + i, sources + i + 1, (numInstances - i - 1) * sizeof(*sources));
+			memmove(endTimes + i, endTimes + i + 1, (numInstances - i - 1) * sizeof(*endTimes));
+			numInstances--;
+			return;
+		}
+	}
+}
+
+- (void) removeAllSources
+{
+	for(NSUInteger i = 0; i < numInstances; i++)
+	{
+		[sources[i] release];
+	}
+	numInstances = 0;
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark OALEffectPolicy
+
+@implementation OALEffectPolicy
+
++ (id) policyWithMaxInstances:(NSUInteger) maxInstances
+				  minInterval:(NSTimeInterval) minInterval
+				restartOldest:(bool) restartOldest
+{
+	return [[[self alloc] initWithMaxInstances:maxInstances
+								   minInterval:minInterval
+								 restartOldest:restartOldest] autorelease];
+}
+
+- (id) initWithMaxInstances:(NSUInteger) maxInstancesIn
+				minInterval:(NSTimeInterval) minIntervalIn
+			  restartOldest:(bool) restartOldestIn
+{
+	if(nil != (self = [super init]))
+	{
+		maxInstances = maxInstancesIn;
+		minInterval = minIntervalIn > 0 ? minIntervalIn : 0;
+		restartOldest = restartOldestIn;
+	}
+	return self;
+}
+
+@synthesize maxInstances;
+@synthesize minInterval;
+@synthesize restartOldest;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALDeferredEffect
+
+@implementation OALDeferredEffect
+
+#pragma mark Object Management
+
++ (id) effectWithFile:(NSString*) filePath
+			   volume:(float) volume
+				pitch:(float) pitch
+				  pan:(float) pan
+				 loop:(bool) loop
+			 priority:(int) priority
+		   maxLatency:(NSTimeInterval) maxLatency
+{
+	return [[[self alloc] initWithFile:filePath
+								volume:volume
+								 pitch:pitch
+								   pan:pan
+								  loop:loop
+							  priority:priority
+							maxLatency:maxLatency] autorelease];
+}
+
+- (id) initWithFile:(NSString*) filePathIn
+			 volume:(float) volumeIn
+			  pitch:(float) pitchIn
+				pan:(float) panIn
+			   loop:(bool) loopIn
+		   priority:(int) priorityIn
+		 maxLatency:(NSTimeInterval) maxLatencyIn
+{
+	if(nil != (self = [super init]))
+	{
+		filePath = [filePathIn retain];
+		volume = volumeIn;
+		pitch = pitchIn;
+		pan = panIn;
+		loop = loopIn;
+		priority = priorityIn;
+		maxLatency = maxLatencyIn;
+		requestTime = mach_absolute_time();
+		state = OALDeferredEffectStatePending;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[filePath release];
+	[soundSource release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize filePath;
+
+- (OALDeferredEffectState) state
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return state;
+	}
+}
+
+- (id<ALSoundSource>) soundSource
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [[soundSource retain] autorelease];
+	}
+}
+
+
+#pragma mark Playback
+
+- (void) cancel
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(OALDeferredEffectStatePending == state)
+		{
+			state = OALDeferredEffectStateCancelled;
+		}
+		else if(OALDeferredEffectStatePlaying == state)
+		{
+			[soundSource stop];
+		}
+	}
+}
+
+- (bool) startWithBuffer:(ALBuffer*) buffer channel:(ALChannelSource*) channel
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(OALDeferredEffectStatePending != state)
+		{
+			return NO;
+		}
+		if(nil == buffer)
+		{
+			state = OALDeferredEffectStateFailed;
+			return NO;
+		}
+		if(mach_absolute_difference_seconds(mach_absolute_time(), requestTime) > maxLatency)
+		{
+			OAL_LOG_INFO(@"Dropping effect %@: loading took longer than %f seconds", filePath, maxLatency);
+			state = OALDeferredEffectStateDropped;
+			return NO;
+		}
+		
+		soundSource = [[channel play:buffer gain:volume pitch:pitch pan:pan loop:loop priority:priority] retain];
+		state = nil != soundSource ? OALDeferredEffectStatePlaying : OALDeferredEffectStateFailed;
+		return nil != soundSource;
+	}
+}
+
+@end
+
+
 #pragma mark -
 #pragma mark Private Methods
 
@@ -47,6 +438,50 @@
  */
 - (ALBuffer*) internalPreloadEffect:(NSString*) filePath;
 
+/** (INTERNAL USE) Load a sound effect from the first sound bank that has it.
+ *
+ * @param filePath The path of the sound effect.
+ * @return A buffer playing from the bank, or nil if no bank has the effect.
+ */
+- (ALBuffer*) bufferFromSoundBanks:(NSString*) filePath;
+
+/** (INTERNAL USE) Play an effect, enforcing its policy if it has one.
+ *
+ * @param filePath The path of the effect.
+ * @param buffer The effect's buffer.
+ * @param volume The volume (gain) to play at.
+ * @param pitch The pitch to play at.
+ * @param pan The left-right panning to play at.
+ * @param loop If TRUE, the sound will loop until you call "stop" on the returned sound source.
+ * @param priority The priority of the sound.
+ * @return The sound source being used for playback, or nil if the policy dropped it or an error occurred.
+ */
+- (id<ALSoundSource>) playEffect:(NSString*) filePath
+						  buffer:(ALBuffer*) buffer
+						  volume:(float) volume
+						   pitch:(float) pitch
+							 pan:(float) pan
+							loop:(bool) loop
+						priority:(int) priority;
+
+/** (INTERNAL USE) Unload least recently used effects until the cache fits in preloadCacheMaxSize.
+ * Must be called while synchronized on self.
+ */
+- (void) evictPreloadedEffects;
+
+/** (INTERNAL USE) Load an effect for playEffectDeferred, then hand it to
+ * deferredEffectLoaded: on the main thread. Runs on deferredLoadQueue.
+ *
+ * @param filePath The path containing the sound data.
+ */
+- (void) loadDeferredEffect:(NSString*) filePath;
+
+/** (INTERNAL USE) Start (or drop) all deferred effects waiting on a file.
+ *
+ * @param result An array containing the file path and, if it loaded, its ALBuffer.
+ */
+- (void) deferredEffectLoaded:(NSArray*) result;
+
 @end
 
 #pragma mark -
@@ -84,6 +519,14 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 		oal_dispatch_queue	= dispatch_queue_create("objectal.simpleaudio.queue", NULL);
 #endif
 		pendingLoadCount	= 0;
+		
+		deferredLoadQueue = [[NSOperationQueue alloc] init];
+		deferredEffects = [[NSMutableDictionary alloc] initWithCapacity:16];
+		deferredEffectMissCounts = [[NSMutableDictionary alloc] initWithCapacity:16];
+		soundBanks = [[NSMutableArray alloc] initWithCapacity:4];
+		effectInstances = [[NSMutableDictionary alloc] initWithCapacity:8];
+		instancesBySource = [[NSMutableDictionary alloc] initWithCapacity:32];
+		channel.sourcePool.delegate = self;
 
 		self.preloadCacheEnabled = YES;
 		self.bgVolume = 1.0f;
@@ -99,22 +542,118 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 #endif
 	
 	[backgroundTrack release];
+	channel.sourcePool.delegate = nil;
 	[channel stop];
 	[channel release];
 	[preloadCache release];
+	[soundBanks release];
+	[effectInstances release];
+	[instancesBySource release];
+	[deferredLoadQueue release];
+	[deferredEffects release];
+	[deferredEffectMissCounts release];
 	[context release];
 	[device release];
 	
 	[super dealloc];
 }
 
-#pragma mark Properties
+#pragma mark Properties
+
+- (NSUInteger) preloadCacheCount
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [preloadCache count];
+	}
+}
+
+- (NSUInteger) preloadCacheSize
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return preloadCacheSize;
+	}
+}
+
+- (NSUInteger) preloadCacheMaxSize
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return preloadCacheMaxSize;
+	}
+}
+
+- (void) setPreloadCacheMaxSize:(NSUInteger) value
+{
+	@synchronized(self)
+	{
+		preloadCacheMaxSize = value;
+		[self evictPreloadedEffects];
+	}
+}
+
+- (NSUInteger) preloadCacheHits
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return preloadCacheHits;
+	}
+}
+
+- (NSUInteger) preloadCacheMisses
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return preloadCacheMisses;
+	}
+}
+
+- (NSUInteger) preloadCacheEvictions
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return preloadCacheEvictions;
+	}
+}
+
+- (NSUInteger) deferredEffectMisses
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return deferredEffectMisses;
+	}
+}
+
+- (NSUInteger) deferredEffectsLate
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return deferredEffectsLate;
+	}
+}
 
-- (NSUInteger) preloadCacheCount
+- (NSUInteger) deferredEffectsDropped
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		return [preloadCache count];
+		return deferredEffectsDropped;
+	}
+}
+
+- (NSUInteger) effectsSuppressed
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return effectsSuppressed;
+	}
+}
+
+- (NSDictionary*) deferredEffectMissCounts
+{
+	@synchronized(self)
+	{
+		return [NSDictionary dictionaryWithDictionary:deferredEffectMissCounts];
 	}
 }
 
@@ -147,6 +686,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 				{
 					[preloadCache release];
 					preloadCache = nil;
+					preloadCacheSize = 0;
 				}
 			}
 		}
@@ -184,6 +724,16 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 	channel.reservedSources = value;
 }
 
+- (id<ALVoiceStealingPolicy>) voiceStealingPolicy
+{
+	return channel.voiceStealingPolicy;
+}
+
+- (void) setVoiceStealingPolicy:(id<ALVoiceStealingPolicy>) value
+{
+	channel.voiceStealingPolicy = value;
+}
+
 @synthesize backgroundTrack;
 
 - (bool) bgPaused
@@ -193,6 +743,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 
 - (void) setBgPaused:(bool) value
 {
+	OAL_TRACE(OAL_TRACE_SET_BG_PAUSED, 0, nil, 0, 0, 0, value);
 	backgroundTrack.paused = value;
 }
 
@@ -208,6 +759,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 
 - (void) setBgVolume:(float) value
 {
+	OAL_TRACE(OAL_TRACE_SET_BG_VOLUME, 0, nil, value, 0, 0, 0);
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		backgroundTrack.gain = value;
@@ -221,7 +773,10 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 
 - (void) setEffectsPaused:(bool) value
 {
+	OAL_TRACE(OAL_TRACE_SET_EFFECTS_PAUSED, 0, nil, 0, 0, 0, value);
+	OAL_TRACE_BEGIN_INTERNAL();
 	channel.paused = value;
+	OAL_TRACE_END_INTERNAL();
 }
 
 - (float) effectsVolume
@@ -231,6 +786,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 
 - (void) setEffectsVolume:(float) value
 {
+	OAL_TRACE(OAL_TRACE_SET_EFFECTS_VOLUME, 0, nil, value, 0, 0, 0);
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		[OpenALManager sharedInstance].currentContext.listener.gain = value;
@@ -307,6 +863,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 
 - (void) setMuted:(bool) value
 {
+	OAL_TRACE(OAL_TRACE_SET_MUTED, 0, nil, 0, 0, 0, value);
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		muted = value;
@@ -353,6 +910,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 		OAL_LOG_ERROR(@"filePath was NULL");
 		return NO;
 	}
+	OAL_TRACE(OAL_TRACE_PLAY_BG, 0, filePath, 0, 0, 0, loop);
 	return [backgroundTrack playFile:filePath loops:loop ? -1 : 0];
 }
 
@@ -361,6 +919,8 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 			pan:(float) pan
 		   loop:(bool) loop
 {
+	OAL_TRACE(OAL_TRACE_SET_BG_VOLUME, 0, nil, volume, 0, 0, 0);
+	OAL_TRACE(OAL_TRACE_PLAY_BG, 0, filePath, 0, 0, 0, loop);
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		backgroundTrack.gain = volume;
@@ -385,35 +945,309 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 
 - (void) stopBg
 {
+	OAL_TRACE(OAL_TRACE_STOP_BG, 0, nil, 0, 0, 0, 0);
 	[backgroundTrack stop];
 }
 
 
+#pragma mark Sound Banks
+
+- (void) addSoundBank:(OALSoundBank*) bank
+{
+	if(nil == bank)
+	{
+		OAL_LOG_ERROR(@"bank was NULL");
+		return;
+	}
+	@synchronized(self)
+	{
+		if(![soundBanks containsObject:bank])
+		{
+			[soundBanks addObject:bank];
+		}
+	}
+}
+
+- (void) removeSoundBank:(OALSoundBank*) bank
+{
+	@synchronized(self)
+	{
+		[soundBanks removeObject:bank];
+	}
+}
+
+- (ALBuffer*) bufferFromSoundBanks:(NSString*) filePath
+{
+	NSArray* banks;
+	@synchronized(self)
+	{
+		if(0 == [soundBanks count])
+		{
+			return nil;
+		}
+		banks = [NSArray arrayWithArray:soundBanks];
+	}
+
+	NSString* fileName = [filePath lastPathComponent];
+	for(OALSoundBank* bank in banks)
+	{
+		ALBuffer* buffer = [bank bufferNamed:filePath];
+		if(nil == buffer && ![fileName isEqualToString:filePath])
+		{
+			buffer = [bank bufferNamed:fileName];
+		}
+		if(nil != buffer)
+		{
+			return buffer;
+		}
+	}
+	return nil;
+}
+
+
+#pragma mark Effect Policies
+
+- (void) setPolicy:(OALEffectPolicy*) policy forEffect:(NSString*) filePath
+{
+	if(nil == filePath)
+	{
+		OAL_LOG_ERROR(@"filePath was NULL");
+		return;
+	}
+	@synchronized(self)
+	{
+		if(nil == policy)
+		{
+			[effectInstances removeObjectForKey:filePath];
+		}
+		else
+		{
+			OAL_EffectInstances* instances = [OAL_EffectInstances instancesWithPolicy:policy];
+			if(nil != instances)
+			{
+				[effectInstances setObject:instances forKey:filePath];
+			}
+		}
+	}
+}
+
+- (OALEffectPolicy*) policyForEffect:(NSString*) filePath
+{
+	@synchronized(self)
+	{
+		OAL_EffectInstances* instances = [effectInstances objectForKey:filePath];
+		return nil == instances ? nil : [[instances->policy retain] autorelease];
+	}
+}
+
+- (id<ALSoundSource>) playEffect:(NSString*) filePath
+						  buffer:(ALBuffer*) buffer
+						  volume:(float) volume
+						   pitch:(float) pitch
+							 pan:(float) pan
+							loop:(bool) loop
+						priority:(int) priority
+{
+	@synchronized(self)
+	{
+		OAL_EffectInstances* instances = [effectInstances objectForKey:filePath];
+		if(nil == instances)
+		{
+			return [channel play:buffer gain:volume pitch:pitch pan:pan loop:loop priority:priority];
+		}
+		
+		OALEffectPolicy* policy = instances->policy;
+		uint64_t now = mach_absolute_time();
+		if(instances->started
+		   && policy.minInterval > 0
+		   && mach_absolute_difference_seconds(now, instances->lastStartTime) < policy.minInterval)
+		{
+			effectsSuppressed++;
+			return nil;
+		}
+		
+		id<ALSoundSource> result = nil;
+		if(policy.maxInstances > 0)
+		{
+			// The instance count is kept current by the pool, so below the limit this is
+			// a single comparison. The instance lock can't be held while calling the
+			// channel, since the pool reports ended voices while holding its own lock.
+			bool atLimit;
+			ALSource* oldest = nil;
+			@synchronized(instancesBySource)
+			{
+				if(instances->numInstances >= policy.maxInstances)
+				{
+					[instances pruneFinished:now];
+				}
+				atLimit = instances->numInstances >= policy.maxInstances;
+				if(atLimit && policy.restartOldest)
+				{
+					oldest = [[instances->sources[0] retain] autorelease];
+				}
+			}
+			if(atLimit)
+			{
+				if(nil != oldest)
+				{
+					result = [channel play:buffer
+								  onSource:oldest
+									  gain:volume
+									 pitch:pitch
+									   pan:pan
+									  loop:loop
+								  priority:priority];
+				}
+				if(nil == result)
+				{
+					effectsSuppressed++;
+					return nil;
+				}
+			}
+		}
+		if(nil == result)
+		{
+			result = [channel play:buffer gain:volume pitch:pitch pan:pan loop:loop priority:priority];
+		}
+		
+		if(nil != result)
+		{
+			instances->started = YES;
+			instances->lastStartTime = now;
+			if([(NSObject*)result isKindOfClass:[ALSource class]])
+			{
+				uint64_t endTime = UINT64_MAX;
+				if(!loop)
+				{
+					endTime = now + mach_absolute_from_seconds(buffer.duration / (pitch > 0 ? pitch : 1.0f));
+				}
+				@synchronized(instancesBySource)
+				{
+					[instances addSource:(ALSource*)result endTime:endTime];
+					[instancesBySource setObject:instances
+										  forKey:[NSValue valueWithNonretainedObject:result]];
+				}
+			}
+		}
+		return result;
+	}
+}
+
+- (void) sourcePool:(ALSoundSourcePool*) pool voiceEndedOnSource:(id<ALSoundSource>) source
+{
+	// Called while the pool holds its lock, so only the instance lock may be taken here.
+	@synchronized(instancesBySource)
+	{
+		if(0 == [instancesBySource count])
+		{
+			return;
+		}
+		NSValue* key = [NSValue valueWithNonretainedObject:source];
+		OAL_EffectInstances* instances = [instancesBySource objectForKey:key];
+		if(nil != instances)
+		{
+			[instances removeSource:(ALSource*)source];
+			[instancesBySource removeObjectForKey:key];
+		}
+	}
+}
+
+
 #pragma mark Sound Effects
 
 - (ALBuffer*) internalPreloadEffect:(NSString*) filePath
 {
-	ALBuffer* buffer;
-	OPTIONALLY_SYNCHRONIZED(self)
+	// Must always be synchronized since preloadEffects: loads on several threads at once.
+	@synchronized(self)
 	{
-		buffer = [preloadCache objectForKey:filePath];
+		OAL_PreloadCacheEntry* entry = [preloadCache objectForKey:filePath];
+		if(nil != entry)
+		{
+			preloadCacheHits++;
+			entry->lastUsed = ++preloadCacheClock;
+			return [[entry->buffer retain] autorelease];
+		}
+		preloadCacheMisses++;
 	}
+
+	ALBuffer* buffer = [self bufferFromSoundBanks:filePath];
 	if(nil == buffer)
 	{
 		buffer = [[OALAudioSupport sharedInstance] bufferFromFile:filePath];
-		if(nil == buffer)
+	}
+	if(nil == buffer)
+	{
+		OAL_LOG_ERROR(@"Could not load effect %@", filePath);
+		return nil;
+	}
+
+	@synchronized(self)
+	{
+		if(nil != preloadCache)
 		{
-			OAL_LOG_ERROR(@"Could not load effect %@", filePath);
-			return nil;
+			OAL_PreloadCacheEntry* entry = [OAL_PreloadCacheEntry entryWithBuffer:buffer];
+			entry->lastUsed = ++preloadCacheClock;
+			OAL_PreloadCacheEntry* oldEntry = [preloadCache objectForKey:filePath];
+			if(nil != oldEntry)
+			{
+				// Another thread loaded the same file in the meantime.
+				preloadCacheSize -= oldEntry->size;
+			}
+			[preloadCache setObject:entry forKey:filePath];
+			preloadCacheSize += entry->size;
+			[self evictPreloadedEffects];
 		}
+	}
+
+	return buffer;
+}
+
+- (void) evictPreloadedEffects
+{
+	if(0 == preloadCacheMaxSize || preloadCacheSize <= preloadCacheMaxSize)
+	{
+		return;
+	}
 
-		OPTIONALLY_SYNCHRONIZED(self)
+	// Gather the buffers that are in use, since those must stay.
+	NSMutableSet* playingBuffers = [NSMutableSet setWithCapacity:[channel.sourcePool.sources count]];
+	for(id<ALSoundSource> source in channel.sourcePool.sources)
+	{
+		if([source isKindOfClass:[ALSource class]] && source.playing)
 		{
-			[preloadCache setObject:buffer forKey:filePath];
+			ALBuffer* buffer = ((ALSource*)source).buffer;
+			if(nil != buffer)
+			{
+				[playingBuffers addObject:buffer];
+			}
 		}
 	}
 
-	return buffer;
+	while(preloadCacheSize > preloadCacheMaxSize)
+	{
+		// Eviction is rare, so a linear scan for the least recently used entry is fine.
+		NSString* oldestKey = nil;
+		OAL_PreloadCacheEntry* oldestEntry = nil;
+		for(NSString* key in preloadCache)
+		{
+			OAL_PreloadCacheEntry* entry = [preloadCache objectForKey:key];
+			if((nil == oldestEntry || entry->lastUsed < oldestEntry->lastUsed)
+			   && ![playingBuffers containsObject:entry->buffer])
+			{
+				oldestKey = key;
+				oldestEntry = entry;
+			}
+		}
+		if(nil == oldestEntry)
+		{
+			// Everything left is playing.
+			break;
+		}
+		OAL_LOG_INFO(@"Evicting effect %@ from the preload cache", oldestKey);
+		preloadCacheSize -= oldestEntry->size;
+		preloadCacheEvictions++;
+		[preloadCache removeObjectForKey:oldestKey];
+	}
 }
 
 - (ALBuffer*) preloadEffect:(NSString*) filePath
@@ -423,6 +1257,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 		OAL_LOG_ERROR(@"filePath was NULL");
 		return nil;
 	}
+	OAL_TRACE(OAL_TRACE_PRELOAD_EFFECT, 0, filePath, 0, 0, 0, 0);
 	if(pendingLoadCount > 0)
 		OAL_LOG_WARNING(@"You are loading an effect synchronously, but have pending async loads that have not completed. Your load will happen after those finish. Your thread is now stuck waiting. Next time just load everything async please.");
 
@@ -453,6 +1288,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 		completionBlock(nil);
 		return NO;
 	}
+	OAL_TRACE(OAL_TRACE_PRELOAD_EFFECT, 0, filePath, 0, 0, 0, 0);
 	
 	pendingLoadCount++;
 	dispatch_async(oal_dispatch_queue, ^{
@@ -482,34 +1318,80 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 		progressBlock(0,0,0);
 		return;
 	}
-	
-	__block uint successCount	= 0;
+#if OBJECTAL_CFG_TRACE
+	for(NSString* filePath in filePaths)
+	{
+		OAL_TRACE(OAL_TRACE_PRELOAD_EFFECT, 0, filePath, 0, 0, 0, 0);
+	}
+#endif
 	
 	pendingLoadCount			+= total;
 	dispatch_async(oal_dispatch_queue,
 	^{
-		[filePaths enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop)
-		 {
-			 OAL_LOG_INFO(@"Preloading effect: %@", obj);
-			 ALBuffer *result = [self internalPreloadEffect:(NSString *)obj];
-			 if(!result)
-			 {
-				 OAL_LOG_WARNING(@"%@ failed to preload.", obj);
-			 }
-			 else
-			 {
-				 successCount++;
-			 }
-			 uint cnt = idx+1;
-			 dispatch_async(dispatch_get_main_queue(), 
-			 ^{
-				 if(cnt == total)
-				 {
-					 pendingLoadCount		-= total;
-				 }
-				 progressBlock(cnt, successCount, total);
-			 });
-		 }];
+		// Decode on a pool of one worker per core. Each worker claims the next file in turn.
+		// OpenAL calls are serialized by ALWrapper, so only buffer creation is done one at a time.
+		NSUInteger numWorkers = [[NSProcessInfo processInfo] activeProcessorCount];
+		if(numWorkers < 1)
+		{
+			numWorkers = 1;
+		}
+		if(numWorkers > total)
+		{
+			numWorkers = total;
+		}
+		
+		// Files can finish in any order, but progress is reported in list order.
+		// outcomes[i] is 0 while pending, 1 on success, 2 on failure.
+		char* outcomes = calloc(total, sizeof(*outcomes));
+		__block int32_t nextIndex = -1;
+		__block uint numReported = 0;
+		__block uint successCount = 0;
+		NSObject* progressLock = [[NSObject alloc] init];
+		
+		dispatch_apply(numWorkers, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0),
+		^(size_t worker)
+		{
+			(void)worker;
+			uint idx;
+			while((idx = (uint)OSAtomicIncrement32Barrier(&nextIndex)) < total)
+			{
+				NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+				NSString* filePath = [filePaths objectAtIndex:idx];
+				OAL_LOG_INFO(@"Preloading effect: %@", filePath);
+				ALBuffer *result = [self internalPreloadEffect:filePath];
+				if(!result)
+				{
+					OAL_LOG_WARNING(@"%@ failed to preload.", filePath);
+				}
+				
+				@synchronized(progressLock)
+				{
+					outcomes[idx] = result ? 1 : 2;
+					while(numReported < total && 0 != outcomes[numReported])
+					{
+						if(1 == outcomes[numReported])
+						{
+							successCount++;
+						}
+						numReported++;
+						uint cnt = numReported;
+						uint successes = successCount;
+						dispatch_async(dispatch_get_main_queue(),
+						^{
+							if(cnt == total)
+							{
+								pendingLoadCount		-= total;
+							}
+							progressBlock(cnt, successes, total);
+						});
+					}
+				}
+				[pool release];
+			}
+		});
+		
+		[progressLock release];
+		free(outcomes);
 	});
 }
 #else
@@ -528,17 +1410,25 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 		OAL_LOG_ERROR(@"filePath was NULL");
 		return;
 	}
-	OPTIONALLY_SYNCHRONIZED(self)
+	OAL_TRACE(OAL_TRACE_UNLOAD_EFFECT, 0, filePath, 0, 0, 0, 0);
+	@synchronized(self)
 	{
-		[preloadCache removeObjectForKey:filePath];
+		OAL_PreloadCacheEntry* entry = [preloadCache objectForKey:filePath];
+		if(nil != entry)
+		{
+			preloadCacheSize -= entry->size;
+			[preloadCache removeObjectForKey:filePath];
+		}
 	}
 }
 
 - (void) unloadAllEffects
 {
-	OPTIONALLY_SYNCHRONIZED(self)
+	OAL_TRACE(OAL_TRACE_UNLOAD_ALL_EFFECTS, 0, nil, 0, 0, 0, 0);
+	@synchronized(self)
 	{
 		[preloadCache removeAllObjects];
+		preloadCacheSize = 0;
 	}
 }
 
@@ -557,23 +1447,159 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALSimpleAudio);
 						   pitch:(float) pitch
 							 pan:(float) pan
 							loop:(bool) loop
+{
+	return [self playEffect:filePath volume:volume pitch:pitch pan:pan loop:loop priority:0];
+}
+
+- (id<ALSoundSource>) playEffect:(NSString*) filePath
+						  volume:(float) volume
+						   pitch:(float) pitch
+							 pan:(float) pan
+							loop:(bool) loop
+						priority:(int) priority
 {
 	if(nil == filePath)
 	{
 		OAL_LOG_ERROR(@"filePath was NULL");
 		return NO;
 	}
+	id<ALSoundSource> result = nil;
+	OAL_TRACE_BEGIN_INTERNAL();
 	ALBuffer* buffer = [self internalPreloadEffect:filePath];
 	if(nil != buffer)
 	{
-		return [channel play:buffer gain:volume pitch:pitch pan:pan loop:loop];
+		result = [self playEffect:filePath buffer:buffer volume:volume pitch:pitch pan:pan loop:loop priority:priority];
+	}
+	OAL_TRACE_END_INTERNAL();
+	OAL_TRACE(OAL_TRACE_PLAY_EFFECT, OALTraceHandle(result), filePath, volume, pitch, pan, priority * 2 + (loop ? 1 : 0));
+	return result;
+}
+
+- (OALDeferredEffect*) playEffectDeferred:(NSString*) filePath
+								   volume:(float) volume
+									pitch:(float) pitch
+									  pan:(float) pan
+									 loop:(bool) loop
+								 priority:(int) priority
+							   maxLatency:(NSTimeInterval) maxLatency
+{
+	if(nil == filePath)
+	{
+		OAL_LOG_ERROR(@"filePath was NULL");
+		return nil;
+	}
+	
+	OALDeferredEffect* effect = [OALDeferredEffect effectWithFile:filePath
+														   volume:volume
+															pitch:pitch
+															  pan:pan
+															 loop:loop
+														 priority:priority
+													   maxLatency:maxLatency];
+	ALBuffer* buffer = nil;
+	bool startLoad = NO;
+	
+	@synchronized(self)
+	{
+		OAL_PreloadCacheEntry* entry = [preloadCache objectForKey:filePath];
+		if(nil != entry)
+		{
+			preloadCacheHits++;
+			entry->lastUsed = ++preloadCacheClock;
+			buffer = [[entry->buffer retain] autorelease];
+		}
+		else
+		{
+			deferredEffectMisses++;
+			NSNumber* missCount = [deferredEffectMissCounts objectForKey:filePath];
+			[deferredEffectMissCounts setObject:[NSNumber numberWithUnsignedInteger:[missCount unsignedIntegerValue] + 1]
+										 forKey:filePath];
+			
+			// Only load each file once, no matter how many effects are waiting on it.
+			NSMutableArray* waiting = [deferredEffects objectForKey:filePath];
+			if(nil == waiting)
+			{
+				waiting = [NSMutableArray arrayWithCapacity:4];
+				[deferredEffects setObject:waiting forKey:filePath];
+				startLoad = YES;
+			}
+			[waiting addObject:effect];
+		}
+	}
+	
+	if(nil != buffer)
+	{
+		[effect startWithBuffer:buffer channel:channel];
+	}
+	else if(startLoad)
+	{
+		[deferredLoadQueue addOperation:[[[NSInvocationOperation alloc] initWithTarget:self
+																			 selector:@selector(loadDeferredEffect:)
+																			   object:filePath] autorelease]];
+	}
+	return effect;
+}
+
+- (void) loadDeferredEffect:(NSString*) filePath
+{
+	ALBuffer* buffer = [self internalPreloadEffect:filePath];
+	[self performSelectorOnMainThread:@selector(deferredEffectLoaded:)
+						   withObject:[NSArray arrayWithObjects:filePath, buffer, nil]
+						waitUntilDone:NO];
+}
+
+- (void) deferredEffectLoaded:(NSArray*) result
+{
+	NSString* filePath = [result objectAtIndex:0];
+	ALBuffer* buffer = [result count] > 1 ? [result objectAtIndex:1] : nil;
+	NSArray* waiting;
+	
+	@synchronized(self)
+	{
+		waiting = [[[deferredEffects objectForKey:filePath] retain] autorelease];
+		[deferredEffects removeObjectForKey:filePath];
+	}
+	
+	for(OALDeferredEffect* effect in waiting)
+	{
+		if([effect startWithBuffer:buffer channel:channel])
+		{
+			@synchronized(self)
+			{
+				deferredEffectsLate++;
+			}
+		}
+		else if(OALDeferredEffectStateCancelled != effect.state)
+		{
+			@synchronized(self)
+			{
+				deferredEffectsDropped++;
+			}
+		}
 	}
-	return nil;
 }
 
 - (void) stopAllEffects
 {
+	@synchronized(self)
+	{
+		for(NSArray* waiting in [deferredEffects allValues])
+		{
+			[waiting makeObjectsPerformSelector:@selector(cancel)];
+		}
+		@synchronized(instancesBySource)
+		{
+			for(OAL_EffectInstances* instances in [effectInstances allValues])
+			{
+				[instances removeAllSources];
+			}
+			[instancesBySource removeAllObjects];
+		}
+	}
+	OAL_TRACE(OAL_TRACE_STOP_ALL_EFFECTS, 0, nil, 0, 0, 0, 0);
+	OAL_TRACE_BEGIN_INTERNAL();
 	[channel stop];
+	OAL_TRACE_END_INTERNAL();
 }
 
 
@@ -42,15 +42,29 @@
 #import "ALCaptureDevice.h"
 #import "ALContext.h"
 #import "ALDevice.h"
+#import "ALLoopbackDevice.h"
 #import "ALListener.h"
 #import "ALSource.h"
 #import "ALWrapper.h"
 #import "ALChannelSource.h"
+#import "ALMixerBus.h"
+#import "ALSourceGroup.h"
 #import "ALSoundSourcePool.h"
+#import "ALVoiceStealingPolicy.h"
+#import "ALVirtualVoice.h"
 #import "OpenALManager.h"
 
 // Other
 #import "OALAudioSupport.h"
+#import "OALAudioDecoder.h"
+#import "OALWavDecoder.h"
+#import "OALExtAudioDecoder.h"
+#import "OALVorbisDecoder.h"
+#import "OALDecodedAudioCache.h"
+#import "OALSoundBank.h"
+#import "OALAudioStream.h"
+#import "OALStats.h"
+#import "OALTrace.h"
 #import "OALSimpleAudio.h"
 
 
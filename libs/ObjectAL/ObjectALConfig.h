@@ -56,6 +56,17 @@
 #endif
 
 
+/** When this option is enabled, Ogg Vorbis (.ogg) files will be decoded by OALVorbisDecoder. <br>
+ *
+ * You'll need to add libogg and libvorbis (including vorbisfile) to your project. <br>
+ *
+ * Recommended setting: 0 unless you ship Ogg Vorbis files.
+ */
+#ifndef OBJECTAL_CFG_USE_VORBIS
+#define OBJECTAL_CFG_USE_VORBIS 0
+#endif
+
+
 /** Sets the interval in seconds between steps when performing actions with OALAction
  * subclasses. Lower values offer better accuracy, but take up more processing time
  * because they fire more often. <br>
@@ -74,6 +85,161 @@
 #endif
 
 
+/** When this option is enabled, OALActionManager steps its actions from a dedicated
+ * high priority thread instead of an NSTimer on the main run loop.  Fades, pans and
+ * pitch bends then stay smooth even while the main thread is busy, and can be stepped
+ * much more often (see kActionThreadStepInterval). <br>
+ *
+ * Note: Actions will be updated (and OALCallAction and fade/pan/pitch completion
+ * callbacks invoked) on the scheduler thread, so this option requires
+ * OBJECTAL_CFG_SYNCHRONIZED_OPERATIONS. <br>
+ *
+ * Recommended setting: 0 unless you need smooth ramps while the main thread is loaded.
+ */
+#ifndef OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+#define OBJECTAL_CFG_ACTION_SCHEDULER_THREAD 0
+#endif
+
+
+/** Sets the interval in seconds between steps when OBJECTAL_CFG_ACTION_SCHEDULER_THREAD
+ * is enabled.  Steps are scheduled against absolute deadlines, so they don't drift. <br>
+ *
+ * Recommended setting: 1.0/200
+ */
+#ifndef kActionThreadStepInterval
+#define kActionThreadStepInterval (1.0/200)
+#endif
+
+
+/** How long (in seconds) ALSource trusts a playback state it read from OpenAL before
+ * reading it again.  All other source properties are only ever changed by ObjectAL, so
+ * they are always served from memory.  The playback state is the exception, since a
+ * sound can finish on its own. <br>
+ *
+ * Calling ALContext's refreshSourceStates once per frame reads every source's state in
+ * one batch, making state checks free for the rest of the frame.  Set this to 0 to
+ * read the state from OpenAL every time. <br>
+ *
+ * Recommended setting: 1.0/60
+ */
+#ifndef kSourceStateCacheLifetime
+#define kSourceStateCacheLifetime (1.0/60)
+#endif
+
+
+/** When this option is enabled, source and listener property changes and source playback
+ * commands (play, pause, stop, rewind) are put on a lock-free queue and executed in order on
+ * a dedicated high priority audio thread, rather than being made while holding ALWrapper's
+ * global lock.  Threads changing audio state then never wait on each other. <br>
+ *
+ * All other OpenAL calls (including reads such as ALSource.playing) first wait until
+ * the commands queued before them have been executed, so they see a consistent state.
+ * This makes reads more expensive, so it works best when the threads using ObjectAL
+ * mostly change state rather than read it. <br>
+ *
+ * Note: Errors from queued commands are logged by the audio thread, and the call that
+ * queued the command always reports success. <br>
+ *
+ * Recommended setting: 0 unless several threads make frequent audio calls.
+ */
+#ifndef OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+#define OBJECTAL_CFG_AUDIO_COMMAND_THREAD 0
+#endif
+
+
+/** Sets how many commands can wait on the queue when OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+ * is enabled (rounded up to a power of 2).  If the queue fills up, callers wait for the
+ * audio thread to make room. <br>
+ *
+ * Recommended setting: 4096
+ */
+#ifndef kAudioCommandQueueCapacity
+#define kAudioCommandQueueCapacity 4096
+#endif
+
+
+/** Error checking policies for OBJECTAL_CFG_AL_ERROR_CHECKING. */
+#define OBJECTAL_AL_ERROR_CHECKING_OFF 0
+#define OBJECTAL_AL_ERROR_CHECKING_PER_FRAME 1
+#define OBJECTAL_AL_ERROR_CHECKING_SAMPLED 2
+#define OBJECTAL_AL_ERROR_CHECKING_ALWAYS 3
+
+/** Decides when ALWrapper calls alGetError() after an OpenAL call.  On many implementations
+ * alGetError() takes the context lock, so checking after every call adds up. <br>
+ *
+ * OBJECTAL_AL_ERROR_CHECKING_ALWAYS: Check after every call.  Errors are logged with the
+ * exact call that caused them, and ALWrapper methods return FALSE on failure. <br>
+ *
+ * OBJECTAL_AL_ERROR_CHECKING_SAMPLED: Check after every kALErrorCheckSampleInterval calls. <br>
+ *
+ * OBJECTAL_AL_ERROR_CHECKING_PER_FRAME: Only check when you call [ALWrapper checkErrors],
+ * typically once per frame. <br>
+ *
+ * OBJECTAL_AL_ERROR_CHECKING_OFF: Never check. <br>
+ *
+ * In the sampled and per-frame modes, ALWrapper remembers the last kALErrorCallSiteHistory
+ * calls made, and logs them when an error turns up.  OpenAL keeps the first error that
+ * occurred since the last check, so the culprit is among them.  ALWrapper methods can't
+ * tell that they failed in these modes, and always return TRUE. <br>
+ *
+ * Recommended setting: OBJECTAL_AL_ERROR_CHECKING_ALWAYS for development,
+ *                      OBJECTAL_AL_ERROR_CHECKING_PER_FRAME for release.
+ */
+#ifndef OBJECTAL_CFG_AL_ERROR_CHECKING
+#define OBJECTAL_CFG_AL_ERROR_CHECKING OBJECTAL_AL_ERROR_CHECKING_ALWAYS
+#endif
+
+
+/** How many calls go by between error checks when OBJECTAL_CFG_AL_ERROR_CHECKING is
+ * OBJECTAL_AL_ERROR_CHECKING_SAMPLED. <br>
+ *
+ * Recommended setting: 64
+ */
+#ifndef kALErrorCheckSampleInterval
+#define kALErrorCheckSampleInterval 64
+#endif
+
+
+/** How many recent OpenAL calls to remember and report when an error is found in the
+ * sampled and per-frame error checking modes.  Must be a power of 2. <br>
+ *
+ * Recommended setting: 32
+ */
+#ifndef kALErrorCallSiteHistory
+#define kALErrorCallSiteHistory 32
+#endif
+
+
+/** When enabled, ALWrapper counts and times every OpenAL call, per function and per frame.
+ * Read the results with [OALStats snapshot], and call [OALStats endFrame] once per frame. <br>
+ *
+ * When disabled, no instrumentation is compiled in at all. <br>
+ *
+ * The counters are kept under ALWrapper's lock (which every call already holds) rather
+ * than per thread, so call times include any time spent waiting for that lock. <br>
+ *
+ * Recommended setting: 0 (1 when profiling)
+ */
+#ifndef OBJECTAL_CFG_COLLECT_STATS
+#define OBJECTAL_CFG_COLLECT_STATS 0
+#endif
+
+
+/** When enabled, OALTraceRecorder can record the ObjectAL API calls your app makes to a
+ * compact binary file, which OALTracePlayer can replay later (faster than real time if
+ * you like) to benchmark builds against the same workload. <br>
+ *
+ * When disabled, no tracing code is compiled into the API methods. When enabled but not
+ * recording, each traced method costs a flag check, plus a thread-local lookup in the
+ * methods that call other traced methods. <br>
+ *
+ * Recommended setting: 0 (1 when capturing sessions for benchmarks)
+ */
+#ifndef OBJECTAL_CFG_TRACE
+#define OBJECTAL_CFG_TRACE 0
+#endif
+
+
 /** When this option is enabled, all critical ObjectAL operations will be wrapped in
  * synchronized blocks. <br>
  *
@@ -43,8 +43,15 @@
 	NSString* name;
 	ALenum format;
 	float duration;
+	/* These can't change once the data is loaded, so they're read from OpenAL only once. */
+	ALuint bits;
+	ALuint channels;
+	ALuint frequency;
+	ALuint size;
 	/** The uncompressed sound data to play. */
 	void* bufferData;
+	/** If not nil, the object that owns bufferData (otherwise bufferData gets freed). */
+	id dataOwner;
 }
 
 
@@ -109,4 +116,41 @@
 			 format:(ALenum) format
 		  frequency:(ALsizei) frequency;
 
+/** Make a new buffer using data that belongs to another object.
+ * The owner is retained for the lifetime of the buffer, and the data is NOT freed.
+ * Use this to play data directly out of memory managed elsewhere, such as a mapped NSData.
+ *
+ * @param name Optional name that you can use to identify this buffer in your code.
+ * @param data The sound data. It must remain valid for as long as the owner is alive.
+ * @param size The size of the data in bytes.
+ * @param format The format of the data (see the Core Audio documentation).
+ * @param frequency The sampling frequency in Hz.
+ * @param dataOwner The object that owns the data.
+ * @return A new buffer.
+ */
++ (id) bufferWithName:(NSString*) name
+				 data:(void*) data
+				 size:(ALsizei) size
+			   format:(ALenum) format
+			frequency:(ALsizei) frequency
+			dataOwner:(id) dataOwner;
+
+/** Initialize the buffer using data that belongs to another object.
+ * The owner is retained for the lifetime of the buffer, and the data is NOT freed.
+ *
+ * @param name Optional name that you can use to identify this buffer in your code.
+ * @param data The sound data. It must remain valid for as long as the owner is alive.
+ * @param size The size of the data in bytes.
+ * @param format The format of the data (see the Core Audio documentation).
+ * @param frequency The sampling frequency in Hz.
+ * @param dataOwner The object that owns the data.
+ * @return The initialized buffer.
+ */
+- (id) initWithName:(NSString*) name
+			   data:(void*) data
+			   size:(ALsizei) size
+			 format:(ALenum) format
+		  frequency:(ALsizei) frequency
+		  dataOwner:(id) dataOwner;
+
 @end
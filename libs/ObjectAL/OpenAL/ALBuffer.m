@@ -39,7 +39,17 @@
 	return [[[self alloc] initWithName:name data:data size:size format:format frequency:frequency] autorelease];
 }
 
-- (id) initWithName:(NSString*) nameIn data:(void*) data size:(ALsizei) size format:(ALenum) formatIn frequency:(ALsizei) frequency
++ (id) bufferWithName:(NSString*) name data:(void*) data size:(ALsizei) size format:(ALenum) format frequency:(ALsizei) frequency dataOwner:(id) dataOwner
+{
+	return [[[self alloc] initWithName:name data:data size:size format:format frequency:frequency dataOwner:dataOwner] autorelease];
+}
+
+- (id) initWithName:(NSString*) nameIn data:(void*) data size:(ALsizei) sizeIn format:(ALenum) formatIn frequency:(ALsizei) frequencyIn
+{
+	return [self initWithName:nameIn data:data size:sizeIn format:formatIn frequency:frequencyIn dataOwner:nil];
+}
+
+- (id) initWithName:(NSString*) nameIn data:(void*) data size:(ALsizei) sizeIn format:(ALenum) formatIn frequency:(ALsizei) frequencyIn dataOwner:(id) dataOwnerIn
 {
 	if(nil != (self = [super init]))
 	{
@@ -47,11 +57,16 @@
 		bufferId = [ALWrapper genBuffer];
 		device = [[OpenALManager sharedInstance].currentContext.device retain];
 		bufferData = data;
+		dataOwner = [dataOwnerIn retain];
 		format = formatIn;
 
-		[ALWrapper bufferDataStatic:bufferId format:format data:bufferData size:size frequency:frequency];
+		[ALWrapper bufferDataStatic:bufferId format:format data:bufferData size:sizeIn frequency:frequencyIn];
 		
-		duration = (float)self.size / ((float)self.frequency * (float)self.bits / 8);
+		bits = [ALWrapper getBufferi:bufferId parameter:AL_BITS];
+		channels = [ALWrapper getBufferi:bufferId parameter:AL_CHANNELS];
+		frequency = [ALWrapper getBufferi:bufferId parameter:AL_FREQUENCY];
+		size = [ALWrapper getBufferi:bufferId parameter:AL_SIZE];
+		duration = (float)size / ((float)frequency * (float)bits / 8);
 	}
 	return self;
 }
@@ -61,7 +76,14 @@
 	[ALWrapper deleteBuffer:bufferId];
 	[device release];
 	[name release];
-	free(bufferData);
+	if(nil != dataOwner)
+	{
+		[dataOwner release];
+	}
+	else
+	{
+		free(bufferData);
+	}
 
 	[super dealloc];
 }
@@ -74,33 +96,21 @@
 
 #pragma mark Properties
 
-- (ALuint) bits
-{
-	return [ALWrapper getBufferi:bufferId parameter:AL_BITS];	
-}
+@synthesize bits;
 
 @synthesize bufferId;
 
-- (ALuint) channels
-{
-	return [ALWrapper getBufferi:bufferId parameter:AL_CHANNELS];	
-}
+@synthesize channels;
 
 @synthesize device;
 
 @synthesize format;
 
-- (ALuint) frequency
-{
-	return [ALWrapper getBufferi:bufferId parameter:AL_FREQUENCY];	
-}
+@synthesize frequency;
 
 @synthesize name;
 
-- (ALuint) size
-{
-	return [ALWrapper getBufferi:bufferId parameter:AL_SIZE];	
-}
+@synthesize size;
 
 @synthesize duration;
 
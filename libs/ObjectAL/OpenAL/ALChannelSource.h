@@ -27,6 +27,7 @@
 #import "ALSoundSource.h"
 #import "ALSoundSourcePool.h"
 #import "ALContext.h"
+#import "ALMixerBus.h"
 
 
 #pragma mark ALChannelSource
@@ -42,6 +43,7 @@
 {
 	ALSoundSourcePool* sourcePool;
 	ALContext* context;
+	ALMixerBus* bus;
 
 	float pitch;
 	float gain;
@@ -66,6 +68,10 @@
 	bool muted;
 	bool paused;
 
+	bool deferUpdates;
+	/** Properties that have changed since the last flush (see deferUpdates). */
+	unsigned int dirtyProperties;
+
 	/** Target to inform when the current fade operation completes. */
 	id fadeCompleteTarget;
 	
@@ -118,6 +124,29 @@
 /** The number of sources reserved by this channel. */
 @property(readwrite,assign,nonatomic) unsigned int reservedSources;
 
+/** If TRUE, changes to this channel's properties are only recorded, and get applied to the
+ * sources when flushUpdates is called. This lets you change several properties (or the same
+ * property several times) per frame, and then apply them in one batch. <br>
+ *
+ * The properties affected are gain, pitch, looping, sourceRelative, position, velocity,
+ * direction and the distance and cone properties. Muting, pausing and playback are always
+ * immediate. Pending changes are also flushed before a new sound is played. <br>
+ *
+ * Setting this to FALSE flushes any pending changes. <br>
+ *
+ * Default value: FALSE
+ */
+@property(readwrite,assign) bool deferUpdates;
+
+/** The mixer bus this channel's sources play through, or nil for none (see ALMixerBus). <br>
+ * Use a bus rather than this channel's gain for volume categories: a bus change only
+ * reaches the sources that are playing, and a bus fade is a single action.
+ */
+@property(readwrite,retain) ALMixerBus* bus;
+
+/** Decides which sound gets interrupted when all sources are busy (default ALOldestVoicePolicy). */
+@property(readwrite,retain) id<ALVoiceStealingPolicy> voiceStealingPolicy;
+
 #pragma mark Object Management
 
 /** Create a channel with a number of sources.
@@ -138,4 +167,55 @@
  */
 - (void) resetToDefault;
 
+
+#pragma mark Playback
+
+/** Apply all property changes recorded while deferUpdates was set.
+ * The changes are applied to every source within a single ALContext deferred update,
+ * with each property written once per source no matter how many times it was changed.
+ * Call this once per frame when using deferred updates.
+ */
+- (void) flushUpdates;
+
+/** Play a sound with the specified priority.
+ * If all sources are busy, the sound that is cheapest to interrupt according to the
+ * voice stealing policy gets interrupted, but only if it is no more important than this one.
+ *
+ * @param buffer the buffer to play.
+ * @param gain The gain (volume) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param pan Left-right panning (-1.0 = far left, 1.0 = far right).
+ * @param loop If TRUE, the sound will loop until you call "stop" on the returned sound source.
+ * @param priority How important this sound is (higher = more important).
+ * @return the source playing the sound, or nil if the sound could not be played.
+ */
+- (id<ALSoundSource>) play:(ALBuffer*) buffer
+					  gain:(float) gain
+					 pitch:(float) pitch
+					   pan:(float) pan
+					  loop:(bool) loop
+				  priority:(int) priority;
+
+/** Play a sound on a specific source of this channel, interrupting whatever it is playing.
+ * The channel's pool is told about the new sound, just as if the source had been
+ * acquired by play:gain:pitch:pan:loop:priority:.
+ *
+ * @param buffer the buffer to play.
+ * @param source The source to play on. It must belong to this channel.
+ * @param gain The gain (volume) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param pan Left-right panning (-1.0 = far left, 1.0 = far right).
+ * @param loop If TRUE, the sound will loop until you call "stop" on the returned sound source.
+ * @param priority How important this sound is (higher = more important).
+ * @return the source playing the sound, or nil if the source is not part of this channel
+ *         or could not be interrupted.
+ */
+- (id<ALSoundSource>) play:(ALBuffer*) buffer
+				  onSource:(id<ALSoundSource>) source
+					  gain:(float) gain
+					 pitch:(float) pitch
+					   pan:(float) pan
+					  loop:(bool) loop
+				  priority:(int) priority;
+
 @end
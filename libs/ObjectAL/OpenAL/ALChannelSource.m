@@ -27,6 +27,54 @@
 #import "ALChannelSource.h"
 #import "ObjectALMacros.h"
 #import "OpenALManager.h"
+#import "ALSourceGroup.h"
+
+
+/** Properties whose changes are waiting to be applied to the sources (see deferUpdates). */
+enum
+{
+	kDirtyConeInnerAngle = 1 << 0,
+	kDirtyConeOuterAngle = 1 << 1,
+	kDirtyConeOuterGain = 1 << 2,
+	kDirtyDirection = 1 << 3,
+	kDirtyGain = 1 << 4,
+	kDirtyLooping = 1 << 5,
+	kDirtyMaxDistance = 1 << 6,
+	kDirtyMaxGain = 1 << 7,
+	kDirtyMinGain = 1 << 8,
+	kDirtyPitch = 1 << 9,
+	kDirtyPosition = 1 << 10,
+	kDirtyReferenceDistance = 1 << 11,
+	kDirtyRolloffFactor = 1 << 12,
+	kDirtySourceRelative = 1 << 13,
+	kDirtyVelocity = 1 << 14,
+};
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for ALChannelSource.
+ */
+@interface ALChannelSource (Private)
+
+/** (INTERNAL USE) Describe a sound that is about to be played on this channel.
+ *
+ * @param buffer the buffer to play.
+ * @param gain The gain the source will play at, before its bus gain (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param loop If TRUE, the sound will loop.
+ * @param priority How important the sound is.
+ * @return A description of the sound for the voice stealing policy.
+ */
+- (ALVoiceInfo) voiceForBuffer:(ALBuffer*) buffer
+						  gain:(float) gain
+						 pitch:(float) pitch
+						  loop:(bool) loop
+					  priority:(int) priority;
+
+@end
 
 
 @implementation ALChannelSource
@@ -87,6 +135,7 @@
 {
 	[sourcePool release];
 	[context release];
+	[bus release];
 	[super dealloc];
 }
 
@@ -118,6 +167,10 @@
 			source.direction = direction;
 			source.sourceRelative = sourceRelative;
 			source.looping = looping;
+			if([(NSObject*)source isKindOfClass:[ALSource class]])
+			{
+				((ALSource*)source).bus = bus;
+			}
 			
 			[sourcePool addSource:source];
 		}
@@ -134,6 +187,60 @@
 
 #pragma mark Properties
 
+- (bool) deferUpdates
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return deferUpdates;
+	}
+}
+
+- (void) setDeferUpdates:(bool) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		deferUpdates = value;
+		if(!deferUpdates)
+		{
+			[self flushUpdates];
+		}
+	}
+}
+
+- (ALMixerBus*) bus
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [[bus retain] autorelease];
+	}
+}
+
+- (void) setBus:(ALMixerBus*) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[bus autorelease];
+		bus = [value retain];
+		for(id<ALSoundSource> source in sourcePool.sources)
+		{
+			if([(NSObject*)source isKindOfClass:[ALSource class]])
+			{
+				((ALSource*)source).bus = value;
+			}
+		}
+	}
+}
+
+- (id<ALVoiceStealingPolicy>) voiceStealingPolicy
+{
+	return sourcePool.stealingPolicy;
+}
+
+- (void) setVoiceStealingPolicy:(id<ALVoiceStealingPolicy>) value
+{
+	sourcePool.stealingPolicy = value;
+}
+
 - (float) coneInnerAngle
 {
 	OPTIONALLY_SYNCHRONIZED(self)
@@ -147,6 +254,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		coneInnerAngle = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyConeInnerAngle;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.coneInnerAngle = value;
@@ -167,6 +279,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		coneOuterAngle = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyConeOuterAngle;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.coneOuterAngle = value;
@@ -187,6 +304,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		coneOuterGain = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyConeOuterGain;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.coneOuterGain = value;
@@ -209,6 +331,11 @@
 	OPTIONALLY_SYNCHRONIZED_STRUCT_OP(self)
 	{
 		direction = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyDirection;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.direction = value;
@@ -239,6 +366,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		gain = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyGain;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.gain = value;
@@ -279,6 +411,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		looping = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyLooping;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.looping = value;
@@ -299,6 +436,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		maxDistance = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyMaxDistance;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.maxDistance = value;
@@ -319,6 +461,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		maxGain = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyMaxGain;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.maxGain = value;
@@ -339,6 +486,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		minGain = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyMinGain;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.minGain = value;
@@ -399,6 +551,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		pitch = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyPitch;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.pitch = value;
@@ -434,6 +591,11 @@
 	OPTIONALLY_SYNCHRONIZED_STRUCT_OP(self)
 	{
 		position = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyPosition;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.position = value;
@@ -464,6 +626,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		referenceDistance = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyReferenceDistance;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.referenceDistance = value;
@@ -484,6 +651,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		rolloffFactor = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyRolloffFactor;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.rolloffFactor = value;
@@ -504,6 +676,11 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		sourceRelative = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtySourceRelative;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.sourceRelative = value;
@@ -534,6 +711,11 @@
 	OPTIONALLY_SYNCHRONIZED_STRUCT_OP(self)
 	{
 		velocity = value;
+		if(deferUpdates)
+		{
+			dirtyProperties |= kDirtyVelocity;
+			return;
+		}
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			source.velocity = value;
@@ -562,29 +744,121 @@
 	{
 		// Try to find a free source for playback.
 		// If this channel is not interruptible, it will not attempt to interrupt its contained sources.
-		id<ALSoundSource> soundSource = [sourcePool getFreeSource:interruptible];
+		if(0 != dirtyProperties)
+		{
+			[self flushUpdates];
+		}
+		ALVoiceInfo voice = [self voiceForBuffer:buffer gain:gain pitch:1.0f loop:loop priority:0];
+		id<ALSoundSource> soundSource = [sourcePool getFreeSource:interruptible voice:&voice];
 		return [soundSource play:buffer loop:loop];
 	}
 }
 
 - (id<ALSoundSource>) play:(ALBuffer*) buffer gain:(float) gainIn pitch:(float) pitchIn pan:(float) panIn loop:(bool) loop
+{
+	return [self play:buffer gain:gainIn pitch:pitchIn pan:panIn loop:loop priority:0];
+}
+
+- (id<ALSoundSource>) play:(ALBuffer*) buffer
+					  gain:(float) gainIn
+					 pitch:(float) pitchIn
+					   pan:(float) panIn
+					  loop:(bool) loop
+				  priority:(int) priority
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		// Try to find a free source for playback.
 		// If this channel is not interruptible, it will not attempt to interrupt its contained sources.
-		id<ALSoundSource> soundSource = [sourcePool getFreeSource:interruptible];
+		if(0 != dirtyProperties)
+		{
+			[self flushUpdates];
+		}
+		ALVoiceInfo voice = [self voiceForBuffer:buffer gain:gainIn pitch:pitchIn loop:loop priority:priority];
+		id<ALSoundSource> soundSource = [sourcePool getFreeSource:interruptible voice:&voice];
 		return [soundSource play:buffer gain:gainIn pitch:pitchIn pan:panIn loop:loop];
 	}
 }
 
-- (void) stop
+- (id<ALSoundSource>) play:(ALBuffer*) buffer
+				  onSource:(id<ALSoundSource>) source
+					  gain:(float) gainIn
+					 pitch:(float) pitchIn
+					   pan:(float) panIn
+					  loop:(bool) loop
+				  priority:(int) priority
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(0 != dirtyProperties)
+		{
+			[self flushUpdates];
+		}
+		ALVoiceInfo voice = [self voiceForBuffer:buffer gain:gainIn pitch:pitchIn loop:loop priority:priority];
+		if(![sourcePool claimSource:source voice:&voice])
+		{
+			return nil;
+		}
+		return [source play:buffer gain:gainIn pitch:pitchIn pan:panIn loop:loop];
+	}
+}
+
+- (ALVoiceInfo) voiceForBuffer:(ALBuffer*) buffer
+						  gain:(float) gainIn
+						 pitch:(float) pitchIn
+						  loop:(bool) loop
+					  priority:(int) priority
+{
+	// All sources in a channel share the same position, so distance attenuation doesn't
+	// distinguish between them. Only the gain they play at does. Once playing, the
+	// sources report gain changes to the pool themselves.
+	float effectiveGain = muted ? 0 : gainIn * (nil == bus ? 1.0f : bus.effectiveGain);
+	float duration = pitchIn > 0 ? buffer.duration / pitchIn : buffer.duration;
+	return ALVoiceInfoMake(priority, effectiveGain, duration, loop);
+}
+
+- (void) flushUpdates
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		if(0 == dirtyProperties)
+		{
+			return;
+		}
+		
+		[context beginDeferredUpdates];
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
-			[source stop];
+			if(dirtyProperties & kDirtyGain) source.gain = gain;
+			if(dirtyProperties & kDirtyConeInnerAngle) source.coneInnerAngle = coneInnerAngle;
+			if(dirtyProperties & kDirtyConeOuterAngle) source.coneOuterAngle = coneOuterAngle;
+			if(dirtyProperties & kDirtyConeOuterGain) source.coneOuterGain = coneOuterGain;
+			if(dirtyProperties & kDirtyDirection) source.direction = direction;
+			if(dirtyProperties & kDirtyLooping) source.looping = looping;
+			if(dirtyProperties & kDirtyMaxDistance) source.maxDistance = maxDistance;
+			if(dirtyProperties & kDirtyMaxGain) source.maxGain = maxGain;
+			if(dirtyProperties & kDirtyMinGain) source.minGain = minGain;
+			if(dirtyProperties & kDirtyPitch) source.pitch = pitch;
+			if(dirtyProperties & kDirtyPosition) source.position = position;
+			if(dirtyProperties & kDirtyReferenceDistance) source.referenceDistance = referenceDistance;
+			if(dirtyProperties & kDirtyRolloffFactor) source.rolloffFactor = rolloffFactor;
+			if(dirtyProperties & kDirtySourceRelative) source.sourceRelative = sourceRelative;
+			if(dirtyProperties & kDirtyVelocity) source.velocity = velocity;
+		}
+		[context endDeferredUpdates];
+		dirtyProperties = 0;
+	}
+}
+
+- (void) stop
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		NSArray* sources = sourcePool.sources;
+		[ALSourceGroup stopSources:sources];
+		for(id<ALSoundSource> source in sources)
+		{
+			[sourcePool notifySourceStopped:source];
 		}
 	}
 }
@@ -726,6 +1000,7 @@
 		for(id<ALSoundSource> source in sourcePool.sources)
 		{
 			[source clear];
+			[sourcePool notifySourceStopped:source];
 		}
 	}
 }
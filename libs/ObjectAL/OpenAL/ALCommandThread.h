@@ -0,0 +1,60 @@
+//
+//  ALCommandThread.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "oal_command_queue.h"
+
+
+/**
+ * (INTERNAL USE) The audio command thread used when OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+ * is enabled. <br>
+ *
+ * ALWrapper queues source and listener property changes and playback commands here
+ * instead of making the OpenAL calls itself.  Queueing never takes a lock, so threads
+ * changing audio state never wait on each other or on the audio thread.  All queued
+ * commands are executed in order on a single high priority thread. <br>
+ *
+ * Every other ALWrapper call waits until the commands queued before it have been
+ * executed, so OpenAL always sees calls in the order they were made.
+ *
+ * Everything here is a class method, so that queueing a command doesn't even need to
+ * look up a shared instance.
+ */
+@interface ALCommandThread : NSObject
+{
+}
+
+/** Queue a command for execution on the audio thread.  Starts the thread if needed.
+ * If the queue is full, waits for the audio thread to make room.
+ *
+ * @param command The command to queue (copied).
+ * @return TRUE if the command was queued.  Errors from executing the command are
+ *         logged by the audio thread.
+ */
++ (bool) submit:(const oal_command*) command;
+
+/** Wait until all commands queued so far have been executed.
+ * Returns immediately when called from the audio thread.
+ */
++ (void) waitUntilDone;
+
+@end
@@ -0,0 +1,238 @@
+//
+//  ALCommandThread.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALCommandThread.h"
+#import "ALWrapper.h"
+#import "ObjectALMacros.h"
+#import <pthread.h>
+#import <sched.h>
+#ifdef __APPLE__
+#import <mach/mach.h>
+#else
+#import <errno.h>
+#import <semaphore.h>
+#import <time.h>
+#endif
+
+
+/** The maximum number of commands to execute per batch. */
+#define kCommandBatchSize 64
+
+/** How long the audio thread sleeps before checking the queue again if it's
+ * never woken up (in nanoseconds).
+ */
+#define kCommandThreadIdleTimeout 10000000
+
+
+/** The queue of commands waiting to be executed. */
+static oal_command_queue* commandQueue = NULL;
+
+/** Wakes the audio thread when there are commands to execute. */
+#ifdef __APPLE__
+static semaphore_t wakeupSemaphore;
+#else
+static sem_t wakeupSemaphore;
+#endif
+
+/** Set while the audio thread is (about to be) waiting on wakeupSemaphore. */
+static volatile int32_t threadSleeping = 0;
+
+/** The audio thread. */
+static pthread_t commandThread;
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for ALCommandThread.
+ */
+@interface ALCommandThread (Private)
+
+/** (INTERNAL USE) Wake the audio thread if it's sleeping.
+ */
++ (void) wakeThread;
+
+/** (INTERNAL USE) Signal wakeupSemaphore.
+ */
++ (void) signalThread;
+
+/** (INTERNAL USE) Wait on wakeupSemaphore for at most kCommandThreadIdleTimeout.
+ */
++ (void) sleepThread;
+
+/** (INTERNAL USE) Main loop of the audio thread.
+ */
++ (void) threadMain;
+
+@end
+
+
+#pragma mark -
+#pragma mark ALCommandThread
+
+@implementation ALCommandThread
+
+#pragma mark Object Management
+
++ (void) initialize
+{
+	if(self != [ALCommandThread class])
+	{
+		return;
+	}
+	
+	commandQueue = oal_command_queue_create(kAudioCommandQueueCapacity);
+	if(NULL == commandQueue)
+	{
+		OAL_LOG_ERROR(@"Could not allocate audio command queue");
+		return;
+	}
+	
+#ifdef __APPLE__
+	kern_return_t result = semaphore_create(mach_task_self(), &wakeupSemaphore, SYNC_POLICY_FIFO, 0);
+	if(KERN_SUCCESS != result)
+#else
+	int result = sem_init(&wakeupSemaphore, 0, 0) ? errno : 0;
+	if(0 != result)
+#endif
+	{
+		OAL_LOG_ERROR(@"Could not create audio command semaphore (error code 0x%08x)", result);
+		oal_command_queue_destroy(commandQueue);
+		commandQueue = NULL;
+		return;
+	}
+	
+	[NSThread detachNewThreadSelector:@selector(threadMain) toTarget:self withObject:nil];
+}
+
+
+#pragma mark Commands
+
++ (bool) submit:(const oal_command*) command
+{
+	if(NULL == commandQueue)
+	{
+		return NO;
+	}
+	
+	while(!oal_command_queue_push(commandQueue, command))
+	{
+		// Full. Make sure the audio thread is running, and give it time to catch up.
+		[self signalThread];
+		sched_yield();
+	}
+	[self wakeThread];
+	return YES;
+}
+
++ (void) waitUntilDone
+{
+	if(NULL == commandQueue || pthread_equal(pthread_self(), commandThread))
+	{
+		return;
+	}
+	
+	unsigned long mark = oal_command_queue_mark(commandQueue);
+	while(!oal_command_queue_is_complete(commandQueue, mark))
+	{
+		[self signalThread];
+		sched_yield();
+	}
+}
+
+
+#pragma mark Internal Use
+
++ (void) wakeThread
+{
+	if(threadSleeping)
+	{
+		[self signalThread];
+	}
+}
+
++ (void) signalThread
+{
+#ifdef __APPLE__
+	semaphore_signal(wakeupSemaphore);
+#else
+	sem_post(&wakeupSemaphore);
+#endif
+}
+
++ (void) sleepThread
+{
+#ifdef __APPLE__
+	mach_timespec_t timeout = {0, kCommandThreadIdleTimeout};
+	semaphore_timedwait(wakeupSemaphore, timeout);
+#else
+	struct timespec timeout;
+	clock_gettime(CLOCK_REALTIME, &timeout);
+	timeout.tv_nsec += kCommandThreadIdleTimeout;
+	if(timeout.tv_nsec >= 1000000000)
+	{
+		timeout.tv_sec++;
+		timeout.tv_nsec -= 1000000000;
+	}
+	sem_timedwait(&wakeupSemaphore, &timeout);
+#endif
+}
+
++ (void) threadMain
+{
+	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+	[NSThread setThreadPriority:1.0];
+	commandThread = pthread_self();
+	
+	oal_command commands[kCommandBatchSize];
+	
+	for(;;)
+	{
+		unsigned int numCommands = oal_command_queue_pop(commandQueue, commands, kCommandBatchSize);
+		if(0 == numCommands)
+		{
+			// Announce that we're going to sleep before checking the queue one last time,
+			// so that a producer either sees the flag or we see its command.
+			threadSleeping = 1;
+			__sync_synchronize();
+			numCommands = oal_command_queue_pop(commandQueue, commands, kCommandBatchSize);
+			if(0 == numCommands)
+			{
+				[self sleepThread];
+				threadSleeping = 0;
+				continue;
+			}
+			threadSleeping = 0;
+		}
+		
+		NSAutoreleasePool* batchPool = [[NSAutoreleasePool alloc] init];
+		[ALWrapper executeCommands:commands numCommands:numCommands];
+		[batchPool release];
+		
+		oal_command_queue_complete(commandQueue, numCommands);
+	}
+	
+	[pool release];
+}
+
+@end
@@ -55,6 +55,10 @@
 	bool suspended;
 	/** This context's attributes. */
 	NSMutableArray* attributes;
+	/** How many beginDeferredUpdates calls are awaiting their endDeferredUpdates. */
+	int deferredUpdatesDepth;
+	/** If true, the outermost beginDeferredUpdates suspended the context. */
+	bool deferredUpdatesSuspended;
 }
 
 
@@ -176,6 +180,8 @@
  * @param device The device to open the context on.
  * @param attributes An array of NSNumber in ordered pairs (attribute id followed by integer value).
  * Posible attributes: ALC_FREQUENCY, ALC_REFRESH, ALC_SYNC, ALC_MONO_SOURCES, ALC_STEREO_SOURCES
+ * Attributes the device requires (such as a loopback device's output format) are added
+ * after these, and take precedence.
  * @return The initialized context.
  */
 - (id) initOnDevice:(ALDevice *) device attributes:(NSArray*) attributes;
@@ -191,10 +197,30 @@
  */
 - (void) stopAllSounds;
 
+/** Hold back source and listener changes so that they get applied all at once
+ * when endDeferredUpdates is called. <br>
+ *
+ * Uses the AL_SOFT_deferred_updates extension if available, otherwise suspends the context.
+ * Calls may be nested; only the outermost pair has any effect.
+ */
+- (void) beginDeferredUpdates;
+
+/** Apply all changes held back since beginDeferredUpdates.
+ */
+- (void) endDeferredUpdates;
+
 /** Clear all buffers being used by sources in this context.
  */
 - (void) clearBuffers;
 
+/** Read the playback state of every source in this context in one batch. <br>
+ *
+ * ALSource remembers its playback state for kSourceStateCacheLifetime seconds.
+ * Calling this once per frame keeps those states fresh, so that checking whether
+ * sources are playing costs no OpenAL calls for the rest of the frame.
+ */
+- (void) refreshSourceStates;
+
 /** Make sure this context is the current context.
  * This method is used to work around iOS 4.0 and 4.2 bugs
  * that could cause the context to be lost.
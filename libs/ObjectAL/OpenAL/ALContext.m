@@ -29,6 +29,8 @@
 #import "ObjectALMacros.h"
 #import "ALWrapper.h"
 #import "OpenALManager.h"
+#import "ALSourceGroup.h"
+#import "mach_timing.h"
 
 
 @implementation ALContext
@@ -107,24 +109,32 @@
 		[attributesList addObject:[NSNumber numberWithInt:stereoSources]];
 	}
 	
-	return [self initOnDevice:deviceIn attributes:attributes];
+	return [self initOnDevice:deviceIn attributes:attributesList];
 }
 
 - (id) initOnDevice:(ALDevice *) deviceIn attributes:(NSArray*) attributesIn
 {
 	if(nil != (self = [super init]))
 	{
-		// Build up an ALCint array for OpenAL's createContext function.
+		// Some devices (such as loopback devices) need certain attributes.
+		NSArray* requiredAttributes = [deviceIn requiredContextAttributes];
+		if([requiredAttributes count] > 0)
+		{
+			attributesIn = nil == attributesIn ? requiredAttributes : [attributesIn arrayByAddingObjectsFromArray:requiredAttributes];
+		}
+
+		// Build up a zero terminated ALCint array for OpenAL's createContext function.
 		ALCint* attributesList = nil;
 
 		if([attributesIn count] > 0)
 		{
-			attributesList = (ALCint*)malloc(sizeof(ALCint) * [attributesIn count]);
+			attributesList = (ALCint*)malloc(sizeof(ALCint) * ([attributesIn count] + 1));
 			ALCint* attributePtr = attributesList;
 			for(NSNumber* number in attributesIn)
 			{
 				*attributePtr++ = [number intValue];
 			}
+			*attributePtr = 0;
 		}
 		
 		// Notify the device that we are being created.
@@ -315,6 +325,40 @@
 	}
 }
 
+- (void) refreshSourceStates
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		NSUInteger numSources = [sources count];
+		if(0 == numSources)
+		{
+			return;
+		}
+		
+		ALuint* sourceIds = malloc(sizeof(*sourceIds) * numSources);
+		ALint* states = malloc(sizeof(*states) * numSources);
+		NSUInteger i = 0;
+		for(ALSource* source in sources)
+		{
+			sourceIds[i++] = source.sourceId;
+		}
+		
+		OBJECTAL_CONTEXT_INTERRUPT_BUG_WORKAROUND();
+		uint64_t timestamp = mach_absolute_time();
+		if([ALWrapper getSourcesi:sourceIds numSources:(ALsizei)numSources parameter:AL_SOURCE_STATE values:states])
+		{
+			i = 0;
+			for(ALSource* source in sources)
+			{
+				[source setRefreshedState:states[i++] timestamp:timestamp];
+			}
+		}
+		
+		free(states);
+		free(sourceIds);
+	}
+}
+
 - (void) process
 {
 	[ALWrapper processContext:context];
@@ -324,9 +368,51 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		for(ALSource* source in sources)
+		[ALSourceGroup stopSources:sources];
+	}
+}
+
+- (void) beginDeferredUpdates
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(0 == deferredUpdatesDepth++)
+		{
+			OBJECTAL_CONTEXT_INTERRUPT_BUG_WORKAROUND();
+			deferredUpdatesSuspended = NO;
+			if(![ALWrapper deferUpdates] && !suspended)
+			{
+				// Don't touch a context that was suspended for other reasons (such as an interrupt).
+				[ALWrapper suspendContext:context];
+				deferredUpdatesSuspended = YES;
+			}
+		}
+	}
+}
+
+- (void) endDeferredUpdates
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(deferredUpdatesDepth <= 0)
 		{
-			[source stop];
+			OAL_LOG_WARNING(@"endDeferredUpdates called without matching beginDeferredUpdates");
+			return;
+		}
+		if(0 == --deferredUpdatesDepth)
+		{
+			if(deferredUpdatesSuspended)
+			{
+				if(!suspended)
+				{
+					[ALWrapper processContext:context];
+				}
+				deferredUpdatesSuspended = NO;
+			}
+			else
+			{
+				[ALWrapper processUpdates];
+			}
 		}
 	}
 }
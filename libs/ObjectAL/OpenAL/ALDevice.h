@@ -104,6 +104,22 @@
 
 #pragma mark Internal Use
 
+/** (INTERNAL USE) Initialize with a device that has already been opened.
+ * The device will be closed when this object is deallocated.
+ *
+ * @param device The opened device (NULL if opening failed).
+ * @return the initialized device.
+ */
+- (id) initWithOpenedDevice:(ALCdevice*) device;
+
+/** (INTERNAL USE) Attributes that every context on this device must be created with.
+ * ALContext adds these to the attributes it is given.
+ *
+ * @return An array of NSNumber in ordered pairs (attribute id followed by integer value),
+ *         or nil if there are none.
+ */
+- (NSArray*) requiredContextAttributes;
+
 /** (INTERNAL USE)  Used by ALContext to announce initialization.
  *
  * @param context The context that is initializing.
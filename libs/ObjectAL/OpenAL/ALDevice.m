@@ -28,7 +28,9 @@
 #import "ALWrapper.h"
 #import "ObjectALMacros.h"
 #import "NSMutableArray+WeakReferences.h"
+#if TARGET_OS_IPHONE
 #import "OALAudioSupport.h"
+#endif
 #import "OpenALManager.h"
 
 
@@ -42,13 +44,20 @@
 }
 
 - (id) initWithDeviceSpecifier:(NSString*) deviceSpecifier
+{
+#if TARGET_OS_IPHONE
+	// Make sure OALAudioSupport is initialized.
+	[OALAudioSupport sharedInstance];
+#endif
+
+	return [self initWithOpenedDevice:[ALWrapper openDevice:deviceSpecifier]];
+}
+
+- (id) initWithOpenedDevice:(ALCdevice*) deviceIn
 {
 	if(nil != (self = [super init]))
 	{
-		// Make sure OALAudioSupport is initialized.
-		[OALAudioSupport sharedInstance];
-
-		if(nil != (device = [ALWrapper openDevice:deviceSpecifier]))
+		if(nil != (device = deviceIn))
 		{
 			contexts = [[NSMutableArray mutableArrayUsingWeakReferencesWithCapacity:5] retain];
 			
@@ -60,9 +69,12 @@
 
 - (void) dealloc
 {
-	[[OpenALManager sharedInstance] notifyDeviceDeallocating:self];
+	if(nil != device)
+	{
+		[[OpenALManager sharedInstance] notifyDeviceDeallocating:self];
+		[ALWrapper closeDevice:device];
+	}
 	[contexts release];
-	[ALWrapper closeDevice:device];
 
 	[super dealloc];
 }
@@ -119,6 +131,11 @@
 
 #pragma mark Internal Use
 
+- (NSArray*) requiredContextAttributes
+{
+	return nil;
+}
+
 - (void) notifyContextInitializing:(ALContext*) context
 {
 	OPTIONALLY_SYNCHRONIZED(self)
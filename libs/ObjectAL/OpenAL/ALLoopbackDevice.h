@@ -0,0 +1,130 @@
+//
+//  ALLoopbackDevice.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALDevice.h"
+#import "ALWrapper.h"
+
+
+#pragma mark ALLoopbackDevice
+
+/**
+ * A device that renders its mix into memory on request instead of playing it through
+ * audio hardware, using the ALC_SOFT_loopback extension. <br>
+ *
+ * Nothing is rendered until you call render:numFrames: or renderFrames:, so rendering
+ * runs as fast as the CPU allows, and needs no audio output at all.  This makes it
+ * useful for checking output against known good renders, measuring mixing cost, and
+ * baking mixes ahead of time. <br>
+ *
+ * Contexts created on a loopback device always use the device's output format
+ * (see ALContext). <br>
+ *
+ * Note: Time only passes for the mix as frames are rendered, but ObjectAL's actions
+ * (fades etc) still run in real time.
+ */
+@interface ALLoopbackDevice : ALDevice
+{
+	int frequency;
+	int channels;
+	int sampleType;
+	unsigned int numChannels;
+	unsigned int bytesPerFrame;
+}
+
+
+#pragma mark Properties
+
+/** The output sample rate. */
+@property(readonly) int frequency;
+
+/** The output channel configuration (ALC_MONO_SOFT, ALC_STEREO_SOFT, etc). */
+@property(readonly) int channels;
+
+/** The output sample type (ALC_SHORT_SOFT, ALC_FLOAT_SOFT, etc). */
+@property(readonly) int sampleType;
+
+/** The number of output channels. */
+@property(readonly) unsigned int numChannels;
+
+/** The size of one rendered sample frame, in bytes. */
+@property(readonly) unsigned int bytesPerFrame;
+
+
+#pragma mark Object Management
+
+/** Check if loopback devices are available.
+ *
+ * @return TRUE if the OpenAL implementation supports ALC_SOFT_loopback.
+ */
++ (bool) supported;
+
+/** Open a loopback device that renders 16-bit stereo.
+ *
+ * @param frequency The output sample rate.
+ * @return A new device, or nil if loopback devices aren't available.
+ */
++ (id) deviceWithFrequency:(int) frequency;
+
+/** Open a loopback device.
+ *
+ * @param frequency The output sample rate.
+ * @param channels The output channel configuration (ALC_MONO_SOFT, ALC_STEREO_SOFT, etc).
+ * @param sampleType The output sample type (ALC_SHORT_SOFT, ALC_FLOAT_SOFT, etc).
+ * @return A new device, or nil if loopback devices aren't available or can't render
+ *         in this format.
+ */
++ (id) deviceWithFrequency:(int) frequency
+				  channels:(int) channels
+				sampleType:(int) sampleType;
+
+/** Initialize a loopback device.
+ *
+ * @param frequency The output sample rate.
+ * @param channels The output channel configuration (ALC_MONO_SOFT, ALC_STEREO_SOFT, etc).
+ * @param sampleType The output sample type (ALC_SHORT_SOFT, ALC_FLOAT_SOFT, etc).
+ * @return The initialized device, or nil if loopback devices aren't available or can't
+ *         render in this format.
+ */
+- (id) initWithFrequency:(int) frequency
+				channels:(int) channels
+			  sampleType:(int) sampleType;
+
+
+#pragma mark Rendering
+
+/** Render the current context's mix into a buffer.  The current context must be one
+ * created on this device.
+ *
+ * @param buffer The buffer to render into (at least numFrames * bytesPerFrame bytes).
+ * @param numFrames The number of sample frames to render.
+ * @return TRUE if the frames were rendered.
+ */
+- (bool) render:(void*) buffer numFrames:(unsigned int) numFrames;
+
+/** Render the current context's mix into a new data object.
+ *
+ * @param numFrames The number of sample frames to render.
+ * @return The rendered samples, or nil if an error occurred.
+ */
+- (NSData*) renderFrames:(unsigned int) numFrames;
+
+@end
@@ -0,0 +1,193 @@
+//
+//  ALLoopbackDevice.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALLoopbackDevice.h"
+#import "ObjectALMacros.h"
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/** (INTERNAL USE) Get the number of channels in a channel configuration.
+ *
+ * @param channels The channel configuration.
+ * @return The number of channels, or 0 if unknown.
+ */
+static unsigned int numChannelsForConfiguration(int channels)
+{
+	switch(channels)
+	{
+		case ALC_MONO_SOFT:
+			return 1;
+		case ALC_STEREO_SOFT:
+			return 2;
+		case ALC_QUAD_SOFT:
+			return 4;
+		case ALC_5POINT1_SOFT:
+			return 6;
+		case ALC_6POINT1_SOFT:
+			return 7;
+		case ALC_7POINT1_SOFT:
+			return 8;
+		default:
+			return 0;
+	}
+}
+
+/** (INTERNAL USE) Get the size of a sample type.
+ *
+ * @param sampleType The sample type.
+ * @return The size in bytes, or 0 if unknown.
+ */
+static unsigned int bytesPerSampleForType(int sampleType)
+{
+	switch(sampleType)
+	{
+		case ALC_BYTE_SOFT:
+		case ALC_UNSIGNED_BYTE_SOFT:
+			return 1;
+		case ALC_SHORT_SOFT:
+		case ALC_UNSIGNED_SHORT_SOFT:
+			return 2;
+		case ALC_INT_SOFT:
+		case ALC_UNSIGNED_INT_SOFT:
+		case ALC_FLOAT_SOFT:
+			return 4;
+		default:
+			return 0;
+	}
+}
+
+
+#pragma mark -
+#pragma mark ALLoopbackDevice
+
+@implementation ALLoopbackDevice
+
+#pragma mark Object Management
+
++ (bool) supported
+{
+	return [ALWrapper loopbackSupported];
+}
+
++ (id) deviceWithFrequency:(int) frequency
+{
+	return [self deviceWithFrequency:frequency channels:ALC_STEREO_SOFT sampleType:ALC_SHORT_SOFT];
+}
+
++ (id) deviceWithFrequency:(int) frequency
+				  channels:(int) channels
+				sampleType:(int) sampleType
+{
+	return [[[self alloc] initWithFrequency:frequency channels:channels sampleType:sampleType] autorelease];
+}
+
+- (id) initWithFrequency:(int) frequencyIn
+				channels:(int) channelsIn
+			  sampleType:(int) sampleTypeIn
+{
+	unsigned int numChannelsIn = numChannelsForConfiguration(channelsIn);
+	unsigned int bytesPerSample = bytesPerSampleForType(sampleTypeIn);
+	if(0 == numChannelsIn || 0 == bytesPerSample || frequencyIn <= 0)
+	{
+		OAL_LOG_ERROR(@"Invalid loopback format: frequency %d, channels 0x%x, type 0x%x", frequencyIn, channelsIn, sampleTypeIn);
+		[self release];
+		return nil;
+	}
+	
+	ALCdevice* loopbackDevice = [ALWrapper openLoopbackDevice:nil];
+	if(NULL == loopbackDevice)
+	{
+		[self release];
+		return nil;
+	}
+	
+	if(![ALWrapper isRenderFormatSupported:loopbackDevice
+								 frequency:frequencyIn
+								  channels:channelsIn
+									  type:sampleTypeIn])
+	{
+		OAL_LOG_ERROR(@"Loopback device can't render frequency %d, channels 0x%x, type 0x%x", frequencyIn, channelsIn, sampleTypeIn);
+		[ALWrapper closeDevice:loopbackDevice];
+		[self release];
+		return nil;
+	}
+	
+	if(nil != (self = [super initWithOpenedDevice:loopbackDevice]))
+	{
+		frequency = frequencyIn;
+		channels = channelsIn;
+		sampleType = sampleTypeIn;
+		numChannels = numChannelsIn;
+		bytesPerFrame = numChannelsIn * bytesPerSample;
+	}
+	return self;
+}
+
+
+#pragma mark Properties
+
+@synthesize frequency;
+@synthesize channels;
+@synthesize sampleType;
+@synthesize numChannels;
+@synthesize bytesPerFrame;
+
+
+#pragma mark Rendering
+
+- (bool) render:(void*) buffer numFrames:(unsigned int) numFrames
+{
+	if(0 == numFrames)
+	{
+		return YES;
+	}
+	return [ALWrapper renderSamples:device buffer:buffer numSamples:(ALCsizei)numFrames];
+}
+
+- (NSData*) renderFrames:(unsigned int) numFrames
+{
+	NSMutableData* data = [NSMutableData dataWithLength:numFrames * bytesPerFrame];
+	if(![self render:[data mutableBytes] numFrames:numFrames])
+	{
+		return nil;
+	}
+	return data;
+}
+
+
+#pragma mark Internal Use
+
+- (NSArray*) requiredContextAttributes
+{
+	return [NSArray arrayWithObjects:
+			[NSNumber numberWithInt:ALC_FREQUENCY],
+			[NSNumber numberWithInt:frequency],
+			[NSNumber numberWithInt:ALC_FORMAT_CHANNELS_SOFT],
+			[NSNumber numberWithInt:channels],
+			[NSNumber numberWithInt:ALC_FORMAT_TYPE_SOFT],
+			[NSNumber numberWithInt:sampleType],
+			nil];
+}
+
+@end
@@ -0,0 +1,186 @@
+//
+//  ALMixerBus.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "OALAction.h"
+
+@class ALSource;
+
+
+#pragma mark ALMixerBus
+
+/**
+ * A node in a tree of volume categories (music, effects, UI, voice...). <br>
+ *
+ * Each bus has its own gain and mute. A source attached to a bus (see ALSource bus and
+ * ALChannelSource bus) plays at its own gain multiplied by the gain of its bus and every
+ * bus above it. <br>
+ *
+ * Changing a bus marks it dirty rather than touching its sources.  A flush recomputes only
+ * the dirty parts of the tree, and only reaches the sources that are playing or paused,
+ * which each bus keeps a set of as they start. The rest pick up the new gain when they
+ * next play, so muting a bus costs the same with 10 or 1000 idle sources attached.  Fading
+ * a bus runs one action no matter how many sources hang off it. <br>
+ *
+ * Each tree of buses has its own lock, so changes to separate trees don't contend. <br>
+ *
+ * Changes are flushed straight away unless this bus or one of its ancestors has
+ * deferUpdates set, in which case they wait until flushUpdates is called (once per frame,
+ * for example).
+ */
+@interface ALMixerBus : NSObject
+{
+	/** The bus above this one (retained), or nil for a root bus. */
+	ALMixerBus* parent;
+	/** The top of this bus's tree (weak reference), whose lock guards the whole tree. */
+	ALMixerBus* root;
+	/** The buses below this one (weak references). */
+	NSMutableArray* children;
+	/** The attached sources that were playing or paused when last seen (weak references).
+	 * Sources that stopped are dropped the next time the bus pushes a gain to them.
+	 */
+	ALSource** playingSources;
+	/** The number of entries in playingSources. */
+	NSUInteger numPlayingSources;
+	/** The number of entries playingSources has room for. */
+	NSUInteger playingSourcesCapacity;
+	NSString* name;
+	float gain;
+	bool muted;
+	bool deferUpdates;
+	/** The gain applied to attached sources as of the last flush. */
+	float effectiveGain;
+	/** Set when this bus's gain or mute changed since the last flush. */
+	bool dirty;
+	/** Set when a bus somewhere below this one is dirty. */
+	bool childrenDirty;
+	/** Current action operating on the gain control. */
+	OALAction* gainAction;
+}
+
+
+#pragma mark Properties
+
+/** The bus above this one, or nil if this is a root bus. */
+@property(readonly) ALMixerBus* parent;
+
+/** A name for this bus, for debugging. */
+@property(readwrite,retain) NSString* name;
+
+/** This bus's own gain (0.0 = silent, 1.0 = unchanged). */
+@property(readwrite,assign) float gain;
+
+/** If TRUE, this bus and everything below it is silent. Its gain is kept for when it
+ * gets unmuted.
+ */
+@property(readwrite,assign) bool muted;
+
+/** The gain sources on this bus get from the bus tree (the product of this bus's gain and
+ * its ancestors' gains, or 0 if any of them are muted), as of the last flush.
+ */
+@property(readonly) float effectiveGain;
+
+/** If TRUE, changes to this bus and the buses below it wait for flushUpdates.
+ * Setting it back to FALSE flushes.
+ */
+@property(readwrite,assign) bool deferUpdates;
+
+
+#pragma mark Object Management
+
+/** Create a new root bus.
+ *
+ * @return A new bus.
+ */
++ (id) bus;
+
+/** Create a new bus below another.
+ *
+ * @param parent The bus above the new one, or nil for a root bus.
+ * @return A new bus.
+ */
++ (id) busWithParent:(ALMixerBus*) parent;
+
+/** Initialize a bus below another.
+ *
+ * @param parent The bus above this one, or nil for a root bus.
+ * @return The initialized bus.
+ */
+- (id) initWithParent:(ALMixerBus*) parent;
+
+
+#pragma mark Updates
+
+/** Apply pending changes to this bus and the buses below it to their sources.
+ */
+- (void) flushUpdates;
+
+
+#pragma mark Fading
+
+/** Fade this bus's gain to the specified value over a duration.
+ *
+ * @param value The gain to fade to.
+ * @param duration The duration of the fade (in seconds).
+ * @param target The target to notify when the fade completes (can be nil).
+ * @param selector The selector to call when the fade completes.  The selector must accept
+ * a single parameter, which will be the object that performed the fade.
+ */
+- (void) fadeTo:(float) value
+	   duration:(float) duration
+		 target:(id) target
+	   selector:(SEL) selector;
+
+/** Stop the currently running fade operation, if any.
+ */
+- (void) stopFade;
+
+
+#pragma mark Internal Use
+
+/** (INTERNAL USE) Used by ALSource to attach itself to this bus.
+ *
+ * @param source The source to attach.
+ */
+- (void) addSource:(ALSource*) source;
+
+/** (INTERNAL USE) Used by ALSource to detach itself from this bus.
+ *
+ * @param source The source to detach.
+ */
+- (void) removeSource:(ALSource*) source;
+
+/** (INTERNAL USE) Used by ALSource to report that it started playing, so that it gets
+ * future gain changes. Must not be called while holding the source's lock.
+ *
+ * @param source The source that started.
+ */
+- (void) sourceStarted:(ALSource*) source;
+
+/** (INTERNAL USE) Used by ALSource to read the effective gain while holding its own lock,
+ * which rules out taking the tree lock. May be a flush behind; sourceStarted: catches up.
+ *
+ * @return The effective gain as of the last flush.
+ */
+- (float) lastEffectiveGain;
+
+@end
@@ -0,0 +1,417 @@
+//
+//  ALMixerBus.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALMixerBus.h"
+#import "ALSource.h"
+#import "ObjectALMacros.h"
+#import "NSMutableArray+WeakReferences.h"
+#import "OALAudioActions.h"
+#import "OALUtilityActions.h"
+
+
+/* Every bus in a tree is guarded by the root's lock, since an update can walk up and down the
+ * tree. Sources never take it while holding their own lock, so it's safe to call sources
+ * while holding it.
+ */
+#define TREE_LOCK root
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for ALMixerBus.
+ */
+@interface ALMixerBus (Private)
+
+/** (INTERNAL USE) Mark this bus as changed, and let its ancestors know.
+ * Must be called while holding the tree lock.
+ */
+- (void) markDirty;
+
+/** (INTERNAL USE) Check whether this bus or any of its ancestors defers updates.
+ * Must be called while holding the tree lock.
+ *
+ * @return TRUE if updates to this bus are deferred.
+ */
+- (bool) updatesDeferred;
+
+/** (INTERNAL USE) Recompute the effective gain of this bus and the dirty buses below it, and
+ * push any changes to their sources. Must be called while holding the tree lock.
+ *
+ * @param parentGain The effective gain of the parent bus.
+ * @param force If TRUE, recompute even if this bus isn't dirty (because its parent changed).
+ */
+- (void) updateWithParentGain:(float) parentGain force:(bool) force;
+
+/** (INTERNAL USE) Remove the entry at the specified index from the playing set.
+ * Must be called while holding the tree lock.
+ *
+ * @param index The index to remove.
+ */
+- (void) removePlayingSourceAtIndex:(NSUInteger) index;
+
+@end
+
+
+#pragma mark -
+#pragma mark ALMixerBus
+
+@implementation ALMixerBus
+
+#pragma mark Object Management
+
++ (id) bus
+{
+	return [[[self alloc] initWithParent:nil] autorelease];
+}
+
++ (id) busWithParent:(ALMixerBus*) parent
+{
+	return [[[self alloc] initWithParent:parent] autorelease];
+}
+
+- (id) init
+{
+	return [self initWithParent:nil];
+}
+
+- (id) initWithParent:(ALMixerBus*) parentIn
+{
+	if(nil != (self = [super init]))
+	{
+		children = [[NSMutableArray mutableArrayUsingWeakReferencesWithCapacity:4] retain];
+		playingSourcesCapacity = 8;
+		playingSources = malloc(sizeof(*playingSources) * playingSourcesCapacity);
+		gain = 1.0f;
+		effectiveGain = 1.0f;
+		root = nil == parentIn ? self : parentIn->root;
+		
+		if(nil != parentIn)
+		{
+			OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+			{
+				parent = [parentIn retain];
+				[parent->children addObject:self];
+				effectiveGain = parent->effectiveGain;
+			}
+		}
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[gainAction stopAction];
+	[gainAction release];
+	
+	if(nil != parent)
+	{
+		OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+		{
+			[parent->children removeObjectIdenticalTo:self];
+		}
+		[parent release];
+	}
+	[children release];
+	free(playingSources);
+	[name release];
+	[super dealloc];
+}
+
+- (NSString*) description
+{
+	return [NSString stringWithFormat:@"<%@: %p: %@, gain %f, effective %f>",
+			[self class], self, name, gain, effectiveGain];
+}
+
+
+#pragma mark Properties
+
+@synthesize parent;
+
+- (NSString*) name
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [[name retain] autorelease];
+	}
+}
+
+- (void) setName:(NSString*) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[name autorelease];
+		name = [value retain];
+	}
+}
+
+- (float) gain
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		return gain;
+	}
+}
+
+- (void) setGain:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		gain = value;
+		[self markDirty];
+		if(![self updatesDeferred])
+		{
+			[self flushUpdates];
+		}
+	}
+}
+
+- (bool) muted
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		return muted;
+	}
+}
+
+- (void) setMuted:(bool) value
+{
+	if(value)
+	{
+		[self stopFade];
+	}
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		muted = value;
+		[self markDirty];
+		if(![self updatesDeferred])
+		{
+			[self flushUpdates];
+		}
+	}
+}
+
+- (float) effectiveGain
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		return effectiveGain;
+	}
+}
+
+- (bool) deferUpdates
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		return deferUpdates;
+	}
+}
+
+- (void) setDeferUpdates:(bool) value
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		deferUpdates = value;
+		if(![self updatesDeferred])
+		{
+			[self flushUpdates];
+		}
+	}
+}
+
+
+#pragma mark Updates
+
+- (void) flushUpdates
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		[self updateWithParentGain:nil == parent ? 1.0f : parent->effectiveGain force:NO];
+	}
+}
+
+- (void) markDirty
+{
+	dirty = YES;
+	for(ALMixerBus* bus = parent; nil != bus && !bus->childrenDirty; bus = bus->parent)
+	{
+		bus->childrenDirty = YES;
+	}
+}
+
+- (bool) updatesDeferred
+{
+	for(ALMixerBus* bus = self; nil != bus; bus = bus->parent)
+	{
+		if(bus->deferUpdates)
+		{
+			return YES;
+		}
+	}
+	return NO;
+}
+
+- (void) updateWithParentGain:(float) parentGain force:(bool) force
+{
+	if(force || dirty)
+	{
+		float value = muted ? 0 : gain * parentGain;
+		force = value != effectiveGain;
+		effectiveGain = value;
+		if(force)
+		{
+			// Only sources that were playing or paused need the change now. Those that
+			// have stopped since are dropped here, and catch up when they next play.
+			for(NSUInteger i = 0; i < numPlayingSources;)
+			{
+				if([playingSources[i] setBusGain:value])
+				{
+					i++;
+				}
+				else
+				{
+					[self removePlayingSourceAtIndex:i];
+				}
+			}
+		}
+	}
+	else if(!childrenDirty)
+	{
+		return;
+	}
+	
+	bool visitChildren = force || childrenDirty;
+	dirty = NO;
+	childrenDirty = NO;
+	if(visitChildren)
+	{
+		for(ALMixerBus* child in children)
+		{
+			if(force || child->dirty || child->childrenDirty)
+			{
+				[child updateWithParentGain:effectiveGain force:force];
+			}
+		}
+	}
+}
+
+
+#pragma mark Fading
+
+- (void) fadeTo:(float) value
+	   duration:(float) duration
+		 target:(id) target
+	   selector:(SEL) selector
+{
+	// Must always be synchronized
+	@synchronized(self)
+	{
+		[self stopFade];
+		gainAction = [[OALSequentialActions actions:
+					   [OALGainAction actionWithDuration:duration endValue:value],
+					   [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
+					   nil] retain];
+		[gainAction runWithTarget:self];
+	}
+}
+
+- (void) stopFade
+{
+	// Must always be synchronized
+	@synchronized(self)
+	{
+		[gainAction stopAction];
+		[gainAction release];
+		gainAction = nil;
+	}
+}
+
+
+#pragma mark Internal Use
+
+- (void) addSource:(ALSource*) source
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		if([source setBusGain:effectiveGain])
+		{
+			[self sourceStarted:source];
+		}
+	}
+}
+
+- (void) removeSource:(ALSource*) source
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		NSUInteger index = source.busPlayingIndex;
+		if(NSNotFound != index && index < numPlayingSources && playingSources[index] == source)
+		{
+			[self removePlayingSourceAtIndex:index];
+		}
+	}
+}
+
+- (void) sourceStarted:(ALSource*) source
+{
+	OPTIONALLY_SYNCHRONIZED(TREE_LOCK)
+	{
+		// The source may have moved to another bus since it started.
+		if(source.bus != self)
+		{
+			return;
+		}
+		NSUInteger index = source.busPlayingIndex;
+		if(NSNotFound == index || index >= numPlayingSources || playingSources[index] != source)
+		{
+			if(numPlayingSources >= playingSourcesCapacity)
+			{
+				playingSourcesCapacity *= 2;
+				playingSources = realloc(playingSources, sizeof(*playingSources) * playingSourcesCapacity);
+			}
+			source.busPlayingIndex = numPlayingSources;
+			playingSources[numPlayingSources++] = source;
+		}
+		// Catch up on a flush that happened while the source was starting.
+		[source setBusGain:effectiveGain];
+	}
+}
+
+- (float) lastEffectiveGain
+{
+	return effectiveGain;
+}
+
+- (void) removePlayingSourceAtIndex:(NSUInteger) index
+{
+	playingSources[index].busPlayingIndex = NSNotFound;
+	numPlayingSources--;
+	if(index < numPlayingSources)
+	{
+		playingSources[index] = playingSources[numPlayingSources];
+		playingSources[index].busPlayingIndex = index;
+	}
+}
+
+@end
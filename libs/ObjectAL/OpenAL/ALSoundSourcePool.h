@@ -25,17 +25,108 @@
 //
 
 #import "ALSoundSource.h"
+#import "ALVoiceStealingPolicy.h"
 
 
+/** A busy source, the voice playing on it, and its stealing key. */
+typedef struct
+{
+	id<ALSoundSource> source;
+	ALVoiceInfo voice;
+	/** The key assigned by the stealing policy, or INFINITY if the source can't be interrupted. */
+	double key;
+	/** Where the source is in the pool's source index. */
+	NSUInteger slot;
+} ALBusySourceEntry;
+
+/** Where a source is in the busy heap (NSNotFound if it's free). */
+typedef struct
+{
+	id<ALSoundSource> source;
+	NSUInteger heapIndex;
+} ALSourceIndexEntry;
+
+
+@class ALSoundSourcePool;
+
+
+#pragma mark ALSoundSourcePoolDelegate
+
+/**
+ * Receives notice of voices ending on a pool's sources, so that per-voice bookkeeping
+ * can be kept without polling the sources.
+ */
+@protocol ALSoundSourcePoolDelegate
+
+/** Called when a voice on a source handed out by the pool ends: the source was reported
+ * as stopped, found stopped when the pool polled, stolen or claimed for another voice,
+ * or removed from the pool. <br>
+ *
+ * This is called while holding the pool's lock, so it must not call back into the pool,
+ * or take any lock that is held while calling into the pool.
+ *
+ * @param pool The pool that handed the source out.
+ * @param source The source whose voice ended.
+ */
+- (void) sourcePool:(ALSoundSourcePool*) pool voiceEndedOnSource:(id<ALSoundSource>) source;
+
+@end
+
+
+#pragma mark -
 #pragma mark ALSoundSourcePool
 
 /**
- * A pool of sound sources, which can be fetched based on availability.
+ * A pool of sound sources, which can be fetched based on availability. <br>
+ *
+ * The pool keeps track of which sources it has handed out, so that acquiring a free source
+ * normally costs nothing more than removing it from the head of a ready queue. Sources return
+ * to the ready queue when they are reported as stopped (see notifySourceStopped:), or when the
+ * ready queue runs dry and the pool polls its busy sources for ones that have finished playing. <br>
+ *
+ * Busy sources are kept in a min-heap ordered by the key assigned to them by the stealing policy,
+ * so the best candidate to interrupt is always at its root. Keys don't change as time passes
+ * (see ALVoiceStealingPolicy). A source's key is only recalculated when the source reports a
+ * change to its gain, mute, bus gain or interruptible setting, and a hash table from source to
+ * heap position keeps that, and removing a stopped source, at O(log n). <br>
+ *
+ * Only ALSource reports its changes. Other sources are keyed with the gain and interruptible
+ * setting they had when they were handed out.
  */
 @interface ALSoundSourcePool : NSObject
 {
 	/** All sources managed by this pool (id<ALSoundSource>). */
 	NSMutableArray* sources;
+
+	/** Sources that are known to be free, in the order they became free (id<ALSoundSource>). */
+	NSMutableArray* freeSources;
+
+	/** Sources that have been handed out, as a min-heap on stealing key (not retained). */
+	ALBusySourceEntry* busySources;
+	/** The number of entries in busySources. */
+	NSUInteger numBusySources;
+	/** The number of entries busySources has room for. */
+	NSUInteger busySourcesCapacity;
+
+	/** Open addressing hash table holding every source's position in busySources (not retained). */
+	ALSourceIndexEntry* sourceIndex;
+	/** The number of slots in sourceIndex (a power of 2). */
+	NSUInteger sourceIndexCapacity;
+
+	/** Sources that reported a change to what their key depends on since the last steal
+	 * (id<ALSoundSource>). Guarded by its own lock rather than the pool's, so that sources
+	 * can report changes while holding their own locks.
+	 */
+	NSMutableArray* changedSources;
+
+	/** When the busy sources were last polled for ones that finished playing (mach time). */
+	uint64_t lastReclaimTime;
+
+	/** Decides which busy source gets interrupted when there are no free sources. */
+	id<ALVoiceStealingPolicy> stealingPolicy;
+
+	/** Told when voices end (not retained). */
+	id<ALSoundSourcePoolDelegate> delegate;
 }
 
 
@@ -44,6 +135,14 @@
 /** All sources managed by this pool (id<ALSoundSource>). */
 @property(readonly) NSArray* sources;
 
+/** Decides which busy source gets interrupted when there are no free sources
+ * (default ALOldestVoicePolicy).
+ */
+@property(readwrite,retain) id<ALVoiceStealingPolicy> stealingPolicy;
+
+/** Told when a voice on one of this pool's sources ends (not retained, default nil). */
+@property(readwrite,assign) id<ALSoundSourcePoolDelegate> delegate;
+
 
 #pragma mark Object Management
 
@@ -68,13 +167,62 @@
 - (void) removeSource:(id<ALSoundSource>) source;
 
 /** Acquire a free or freeable source from this pool.
- * It first attempts to find a completely free source.
- * Failing this, it will attempt to interrupt a source and return that (if attemptToInterrupt
- * is TRUE).
+ * It first attempts to take a source from the ready queue, which involves no OpenAL calls.
+ * If the ready queue is empty, it polls the busy sources to reclaim any that have finished
+ * playing, but no more often than every kSourceStateCacheLifetime seconds. Failing this, it
+ * will attempt to interrupt the interruptible source that is cheapest to steal (the oldest,
+ * by default) and return that (if attemptToInterrupt is TRUE).
  *
  * @param attemptToInterrupt If TRUE, attempt to interrupt sources to free them for use.
  * @return The freed sound source, or nil if no sources are freeable.
  */
 - (id<ALSoundSource>) getFreeSource:(bool) attemptToInterrupt;
 
+/** Acquire a free or freeable source from this pool for the specified voice.
+ * This works like getFreeSource:, except that an interruptible source is only stolen
+ * if the stealing policy gives it a key no higher than the new voice's. Among those,
+ * the one with the lowest key gets stolen.
+ *
+ * @param attemptToInterrupt If TRUE, attempt to interrupt sources to free them for use.
+ * @param voice Describes the sound that will be played on the source.
+ * @return The freed sound source, or nil if no sources are freeable.
+ */
+- (id<ALSoundSource>) getFreeSource:(bool) attemptToInterrupt voice:(const ALVoiceInfo*) voice;
+
+/** Claim a specific source from this pool for the specified voice, whether it is free or busy.
+ * Use this when restarting a sound on the source that was already playing it, so that the
+ * pool knows what the source is now playing.
+ *
+ * @param source The source to claim.
+ * @param voice Describes the sound that will be played on the source.
+ * @return TRUE if the source is part of this pool.
+ */
+- (bool) claimSource:(id<ALSoundSource>) source voice:(const ALVoiceInfo*) voice;
+
+/** Inform the pool that a source it handed out has stopped playing, making it
+ * immediately available again without having to poll OpenAL.
+ *
+ * @param source The source that stopped.
+ */
+- (void) notifySourceStopped:(id<ALSoundSource>) source;
+
+/** Poll all busy sources and return any that have finished playing to the ready queue.
+ * This is done automatically when the ready queue runs dry, but may also be called
+ * periodically (once per frame, for example) to spread the cost out.
+ *
+ * @return The number of sources that were reclaimed.
+ */
+- (int) reclaimStoppedSources;
+
+
+#pragma mark Internal Use
+
+/** (INTERNAL USE) Used by ALSource to report that its gain, mute, bus gain or interruptible
+ * setting changed, so that its key gets recalculated before the next steal.
+ * Only takes a lock of its own, so it may be called while holding the source's lock.
+ *
+ * @param source The source that changed.
+ */
+- (void) notifySourceChanged:(id<ALSoundSource>) source;
+
 @end
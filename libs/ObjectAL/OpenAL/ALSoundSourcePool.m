@@ -25,21 +25,72 @@
 //
 
 #import "ALSoundSourcePool.h"
+#import "ALSource.h"
 #import "ObjectALMacros.h"
+#import "mach_timing.h"
+#import <math.h>
 
 
+/** How long getFreeSource: waits between polls of the busy sources (mach time). */
+static uint64_t reclaimInterval;
+
+
+#pragma mark -
 #pragma mark Private Methods
 
 /**
- * Private interface to SoundSourcePool.
+ * (INTERNAL USE) Private methods for ALSoundSourcePool.
  */
 @interface ALSoundSourcePool (Private)
 
-/** Move a source to the head of the list.
+/** (INTERNAL USE) Calculate the key for a voice on a source.
+ *
+ * @param voice The voice playing on the source.
+ * @param interruptible Whether the source can be interrupted.
+ * @return The key, or INFINITY if the source can't be interrupted.
+ */
+- (double) keyForVoice:(const ALVoiceInfo*) voice interruptible:(bool) interruptible;
+
+/** (INTERNAL USE) Add a source to the busy heap.
+ *
+ * @param source The source to add.
+ * @param voice The voice that will play on the source.
+ * @param key The source's stealing key.
+ */
+- (void) pushBusySource:(id<ALSoundSource>) source voice:(const ALVoiceInfo*) voice key:(double) key;
+
+/** (INTERNAL USE) Remove the entry at the specified index from the busy heap.
+ *
+ * @param index The index to remove.
+ */
+- (void) removeBusySourceAtIndex:(NSUInteger) index;
+
+/** (INTERNAL USE) Find a source in the source index.
+ *
+ * @param source The source to find.
+ * @return The source's slot, or NSNotFound if it isn't part of this pool.
+ */
+- (NSUInteger) slotOfSource:(id<ALSoundSource>) source;
+
+/** (INTERNAL USE) Rebuild the source index after sources were added or removed.
+ */
+- (void) rebuildSourceIndex;
+
+/** (INTERNAL USE) Recalculate the keys of the busy sources that reported changes.
+ */
+- (void) applySourceChanges;
+
+/** (INTERNAL USE) Move an entry towards the root of the heap until it is in order.
+ *
+ * @param index The index of the entry to move.
+ */
+- (void) siftUp:(NSUInteger) index;
+
+/** (INTERNAL USE) Move an entry away from the root of the heap until it is in order.
  *
- * @param index the index of the source to move.
+ * @param index The index of the entry to move.
  */
-- (void) moveToHead:(int) index;
+- (void) siftDown:(NSUInteger) index;
 
 @end
 
@@ -51,6 +102,14 @@
 
 #pragma mark Object Management
 
++ (void) initialize
+{
+	if(self == [ALSoundSourcePool class])
+	{
+		reclaimInterval = mach_absolute_from_seconds(kSourceStateCacheLifetime);
+	}
+}
+
 + (id) pool
 {
 	return [[[self alloc] init] autorelease];
@@ -61,12 +120,30 @@
 	if(nil != (self = [super init]))
 	{
 		sources = [[NSMutableArray alloc] initWithCapacity:10];
+		freeSources = [[NSMutableArray alloc] initWithCapacity:10];
+		busySourcesCapacity = 10;
+		busySources = malloc(sizeof(*busySources) * busySourcesCapacity);
+		changedSources = [[NSMutableArray alloc] initWithCapacity:10];
+		stealingPolicy = [[ALOldestVoicePolicy policy] retain];
+		[self rebuildSourceIndex];
 	}
 	return self;
 }
 
 - (void) dealloc
 {
+	for(id<ALSoundSource> source in sources)
+	{
+		if([(NSObject*)source isKindOfClass:[ALSource class]])
+		{
+			[(ALSource*)source setPool:nil];
+		}
+	}
+	[stealingPolicy release];
+	[changedSources release];
+	free(sourceIndex);
+	free(busySources);
+	[freeSources release];
 	[sources release];
 	[super dealloc];
 }
@@ -75,6 +152,37 @@
 #pragma mark Properties
 
 @synthesize sources;
+@synthesize delegate;
+
+- (id<ALVoiceStealingPolicy>) stealingPolicy
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [[stealingPolicy retain] autorelease];
+	}
+}
+
+- (void) setStealingPolicy:(id<ALVoiceStealingPolicy>) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[stealingPolicy autorelease];
+		stealingPolicy = [value retain];
+
+		// Every key changes, so re-key everything and rebuild the heap.
+		for(NSUInteger i = 0; i < numBusySources; i++)
+		{
+			if(INFINITY != busySources[i].key)
+			{
+				busySources[i].key = [stealingPolicy stealKeyForVoice:&busySources[i].voice];
+			}
+		}
+		for(NSUInteger i = numBusySources / 2; i > 0; i--)
+		{
+			[self siftDown:i - 1];
+		}
+	}
+}
 
 
 #pragma mark Source Management
@@ -84,6 +192,12 @@
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		[sources addObject:source];
+		[freeSources addObject:source];
+		[self rebuildSourceIndex];
+		if([(NSObject*)source isKindOfClass:[ALSource class]])
+		{
+			[(ALSource*)source setPool:self];
+		}
 	}
 }
 
@@ -91,55 +205,324 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		[sources removeObject:source];
+		NSUInteger slot = [self slotOfSource:source];
+		if(NSNotFound == slot)
+		{
+			return;
+		}
+		if(NSNotFound != sourceIndex[slot].heapIndex)
+		{
+			[self removeBusySourceAtIndex:sourceIndex[slot].heapIndex];
+			[delegate sourcePool:self voiceEndedOnSource:source];
+		}
+		if([(NSObject*)source isKindOfClass:[ALSource class]])
+		{
+			[(ALSource*)source setPool:nil];
+		}
+		[freeSources removeObjectIdenticalTo:source];
+		[sources removeObjectIdenticalTo:source];
+		[self rebuildSourceIndex];
 	}
 }
 
-- (void) moveToHead:(int) index
+- (void) notifySourceStopped:(id<ALSoundSource>) source
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		id source = [[sources objectAtIndex:index] retain];
-		[sources removeObjectAtIndex:index];
-		[sources addObject:source];
-		[source release];
+		NSUInteger slot = [self slotOfSource:source];
+		if(NSNotFound != slot && NSNotFound != sourceIndex[slot].heapIndex)
+		{
+			[self removeBusySourceAtIndex:sourceIndex[slot].heapIndex];
+			[freeSources addObject:source];
+			[delegate sourcePool:self voiceEndedOnSource:source];
+		}
 	}
 }
 
-- (id<ALSoundSource>) getFreeSource:(bool) attemptToInterrupt
+- (void) notifySourceChanged:(id<ALSoundSource>) source
+{
+	@synchronized(changedSources)
+	{
+		[changedSources addObject:source];
+	}
+}
+
+- (bool) claimSource:(id<ALSoundSource>) source voice:(const ALVoiceInfo*) voice
 {
-	int index = 0;
-	
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		// Try to find any free source.
-		for(id<ALSoundSource> source in sources)
+		NSUInteger slot = [self slotOfSource:source];
+		if(NSNotFound == slot)
+		{
+			return NO;
+		}
+		
+		double key = [self keyForVoice:voice interruptible:source.interruptible];
+		NSUInteger index = sourceIndex[slot].heapIndex;
+		if(NSNotFound == index)
 		{
-			if(!source.playing)
+			[freeSources removeObjectIdenticalTo:source];
+			[self pushBusySource:source voice:voice key:key];
+		}
+		else
+		{
+			[delegate sourcePool:self voiceEndedOnSource:source];
+			busySources[index].voice = *voice;
+			busySources[index].key = key;
+			[self siftUp:index];
+			[self siftDown:index];
+		}
+	}
+	return YES;
+}
+
+- (int) reclaimStoppedSources
+{
+	int numReclaimed = 0;
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		lastReclaimTime = mach_absolute_time();
+
+		// Compact the still-playing entries to the front, then rebuild the heap in O(n).
+		NSUInteger numRemaining = 0;
+		for(NSUInteger i = 0; i < numBusySources; i++)
+		{
+			ALBusySourceEntry entry = busySources[i];
+			if(entry.source.playing)
+			{
+				sourceIndex[entry.slot].heapIndex = numRemaining;
+				busySources[numRemaining++] = entry;
+			}
+			else
 			{
-				[self moveToHead:index];
-				return source;
+				sourceIndex[entry.slot].heapIndex = NSNotFound;
+				[freeSources addObject:entry.source];
+				[delegate sourcePool:self voiceEndedOnSource:entry.source];
+				numReclaimed++;
 			}
-			index++;
+		}
+		if(numReclaimed > 0)
+		{
+			numBusySources = numRemaining;
+			for(NSUInteger i = numBusySources / 2; i > 0; i--)
+			{
+				[self siftDown:i - 1];
+			}
+		}
+	}
+	return numReclaimed;
+}
+
+- (id<ALSoundSource>) getFreeSource:(bool) attemptToInterrupt
+{
+	ALVoiceInfo voice = ALVoiceInfoMake(0, 1.0f, 0, false);
+	return [self getFreeSource:attemptToInterrupt voice:&voice];
+}
+
+- (id<ALSoundSource>) getFreeSource:(bool) attemptToInterrupt voice:(const ALVoiceInfo*) voice
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		// Only touch OpenAL if we've run out of sources known to be free, and haven't just
+		// polled (the source states would still be cached, so polling again finds nothing).
+		if(0 == [freeSources count] && mach_absolute_time() - lastReclaimTime > reclaimInterval)
+		{
+			[self reclaimStoppedSources];
+		}
+
+		// NSMutableArray is double-ended, so taking from the head is O(1).
+		if([freeSources count] > 0)
+		{
+			id<ALSoundSource> source = [freeSources objectAtIndex:0];
+			[self pushBusySource:source
+						   voice:voice
+							 key:[self keyForVoice:voice interruptible:source.interruptible]];
+			[freeSources removeObjectAtIndex:0];
+			return source;
 		}
 		
-		if(attemptToInterrupt)
+		if(attemptToInterrupt && numBusySources > 0)
 		{
-			// Try to forcibly free a source.
-			index = 0;
-			for(id<ALSoundSource> source in sources)
+			// Once the reported changes are in, the root of the heap is the cheapest source
+			// to steal. Non-interruptible sources sink to the bottom, so if the root can't
+			// be interrupted, none can.
+			[self applySourceChanges];
+			double key = [stealingPolicy stealKeyForVoice:voice];
+			id<ALSoundSource> source = busySources[0].source;
+			if(INFINITY != busySources[0].key && busySources[0].key <= key)
 			{
-				if(!source.playing || source.interruptible)
-				{
-					[source stop];
-					[self moveToHead:index];
-					return source;
-				}
-				index++;
+				[source retain];
+				[source stop];
+				[delegate sourcePool:self voiceEndedOnSource:source];
+				busySources[0].voice = *voice;
+				busySources[0].key = key;
+				[self siftDown:0];
+				return [source autorelease];
 			}
 		}
 	}		
 	return nil;
 }
 
+
+#pragma mark Internal Use
+
+- (double) keyForVoice:(const ALVoiceInfo*) voice interruptible:(bool) interruptible
+{
+	return interruptible ? [stealingPolicy stealKeyForVoice:voice] : INFINITY;
+}
+
+- (void) pushBusySource:(id<ALSoundSource>) source voice:(const ALVoiceInfo*) voice key:(double) key
+{
+	if(numBusySources >= busySourcesCapacity)
+	{
+		busySourcesCapacity *= 2;
+		busySources = realloc(busySources, sizeof(*busySources) * busySourcesCapacity);
+	}
+	busySources[numBusySources].source = source;
+	busySources[numBusySources].voice = *voice;
+	busySources[numBusySources].key = key;
+	busySources[numBusySources].slot = [self slotOfSource:source];
+	numBusySources++;
+	[self siftUp:numBusySources - 1];
+}
+
+- (void) removeBusySourceAtIndex:(NSUInteger) index
+{
+	sourceIndex[busySources[index].slot].heapIndex = NSNotFound;
+	numBusySources--;
+	if(index < numBusySources)
+	{
+		busySources[index] = busySources[numBusySources];
+		[self siftUp:index];
+		[self siftDown:index];
+	}
+}
+
+/** Hash a source pointer into a source index of the specified capacity (a power of 2). */
+static inline NSUInteger sourceIndexHash(id<ALSoundSource> source, NSUInteger capacity)
+{
+	// Objects are at least 16 byte aligned, so the low bits carry no information.
+	return (NSUInteger)(((uintptr_t)source >> 4) * 2654435761u) & (capacity - 1);
+}
+
+- (NSUInteger) slotOfSource:(id<ALSoundSource>) source
+{
+	NSUInteger slot = sourceIndexHash(source, sourceIndexCapacity);
+	while(nil != sourceIndex[slot].source)
+	{
+		if(sourceIndex[slot].source == source)
+		{
+			return slot;
+		}
+		slot = (slot + 1) & (sourceIndexCapacity - 1);
+	}
+	return NSNotFound;
+}
+
+- (void) rebuildSourceIndex
+{
+	// Keep the table at most half full so that probe sequences stay short.
+	NSUInteger capacity = 16;
+	while(capacity < [sources count] * 2)
+	{
+		capacity *= 2;
+	}
+	free(sourceIndex);
+	sourceIndex = calloc(capacity, sizeof(*sourceIndex));
+	sourceIndexCapacity = capacity;
+
+	for(id<ALSoundSource> source in sources)
+	{
+		NSUInteger slot = sourceIndexHash(source, sourceIndexCapacity);
+		while(nil != sourceIndex[slot].source)
+		{
+			slot = (slot + 1) & (sourceIndexCapacity - 1);
+		}
+		sourceIndex[slot].source = source;
+		sourceIndex[slot].heapIndex = NSNotFound;
+	}
+	for(NSUInteger i = 0; i < numBusySources; i++)
+	{
+		busySources[i].slot = [self slotOfSource:busySources[i].source];
+		sourceIndex[busySources[i].slot].heapIndex = i;
+	}
+}
+
+- (void) applySourceChanges
+{
+	NSArray* changed;
+	@synchronized(changedSources)
+	{
+		if(0 == [changedSources count])
+		{
+			return;
+		}
+		changed = [[NSArray alloc] initWithArray:changedSources];
+		[changedSources removeAllObjects];
+	}
+
+	for(ALSource* source in changed)
+	{
+		// Read the source's state even if it's free, so that it reports its next change.
+		float gain;
+		bool interruptible = [source readStealingState:&gain];
+		NSUInteger slot = [self slotOfSource:source];
+		if(NSNotFound == slot || NSNotFound == sourceIndex[slot].heapIndex)
+		{
+			continue;
+		}
+		NSUInteger index = sourceIndex[slot].heapIndex;
+		busySources[index].voice.gain = gain;
+		busySources[index].key = [self keyForVoice:&busySources[index].voice interruptible:interruptible];
+		[self siftUp:index];
+		[self siftDown:index];
+	}
+	[changed release];
+}
+
+- (void) siftUp:(NSUInteger) index
+{
+	ALBusySourceEntry entry = busySources[index];
+	while(index > 0)
+	{
+		NSUInteger parent = (index - 1) / 2;
+		if(busySources[parent].key <= entry.key)
+		{
+			break;
+		}
+		busySources[index] = busySources[parent];
+		sourceIndex[busySources[index].slot].heapIndex = index;
+		index = parent;
+	}
+	busySources[index] = entry;
+	sourceIndex[entry.slot].heapIndex = index;
+}
+
+- (void) siftDown:(NSUInteger) index
+{
+	ALBusySourceEntry entry = busySources[index];
+	for(;;)
+	{
+		NSUInteger child = index * 2 + 1;
+		if(child >= numBusySources)
+		{
+			break;
+		}
+		if(child + 1 < numBusySources && busySources[child + 1].key < busySources[child].key)
+		{
+			child++;
+		}
+		if(entry.key <= busySources[child].key)
+		{
+			break;
+		}
+		busySources[index] = busySources[child];
+		sourceIndex[busySources[index].slot].heapIndex = index;
+		index = child;
+	}
+	busySources[index] = entry;
+	sourceIndex[entry.slot].heapIndex = index;
+}
+
 @end
@@ -31,6 +31,8 @@
 #import "OALAction.h"
 
 @class ALContext;
+@class ALMixerBus;
+@class ALSoundSourcePool;
 
 
 #pragma mark ALSource
@@ -48,6 +50,47 @@
 	bool paused;
 	ALBuffer* buffer;
 	ALContext* context;
+	
+	/** The mixer bus this source plays through (retained), or nil. */
+	ALMixerBus* bus;
+	/** The bus's effective gain, which scales this source's own gain. */
+	float busGain;
+	/** Set when busGain changed while this source wasn't playing, so OpenAL hasn't seen it yet. */
+	bool gainStale;
+	/** Where this source is in its bus's set of playing sources, or NSNotFound.
+	 * Guarded by the bus's tree lock rather than this source's lock.
+	 */
+	NSUInteger busPlayingIndex;
+
+	/** The pool this source belongs to (weak reference), or nil. */
+	ALSoundSourcePool* pool;
+	/** Set when this source has told its pool about a change the pool hasn't read yet. */
+	bool poolNotified;
+
+	/* Shadow copies of the properties only ObjectAL changes, so that reading them
+	 * doesn't need a round trip to OpenAL.
+	 */
+	float coneInnerAngle;
+	float coneOuterAngle;
+	float coneOuterGain;
+	ALVector direction;
+	bool looping;
+	float maxDistance;
+	float maxGain;
+	float minGain;
+	float pitch;
+	ALPoint position;
+	float referenceDistance;
+	float rolloffFactor;
+	int sourceRelative;
+	ALVector velocity;
+
+	/** The last known playback state. OpenAL can change this on its own, so it's only
+	 * trusted for kSourceStateCacheLifetime seconds after stateTimestamp.
+	 */
+	int state;
+	/** When the playback state was last set or read. */
+	uint64_t stateTimestamp;
 
 	/** Current action operating on the gain control. */
 	OALAction* gainAction;
@@ -67,6 +110,11 @@
  */
 @property(readwrite,retain) ALBuffer* buffer;
 
+/** The mixer bus this source plays through, or nil for none.
+ * The gain OpenAL plays this source at is its own gain times the bus's effective gain.
+ */
+@property(readwrite,retain) ALMixerBus* bus;
+
 /** How many buffers this source has queued. */
 @property(readonly) int buffersQueued;
 
@@ -154,4 +202,57 @@
  */
 - (bool) unqueueBuffers:(NSArray*) buffers;
 
+
+#pragma mark Internal Use
+
+/** (INTERNAL USE) Used by ALContext to store a playback state read for many
+ * sources at once.
+ *
+ * @param state The playback state as read from OpenAL.
+ * @param timestamp When the state was read (mach absolute time).
+ */
+- (void) setRefreshedState:(int) state timestamp:(uint64_t) timestamp;
+
+/** (INTERNAL USE) Used by ALMixerBus to pass down a new effective gain.
+ * Playing and paused sources apply it at once; others apply it when they next play.
+ * Only the cached playback state is consulted, so this never asks OpenAL for the state.
+ *
+ * @param value The bus's effective gain.
+ * @return TRUE if the source is playing or paused, as far as it knows.
+ */
+- (bool) setBusGain:(float) value;
+
+/** (INTERNAL USE) Used by ALMixerBus to track where this source is in its playing set.
+ * Only accessed while holding the bus's tree lock.
+ */
+@property(readwrite,assign) NSUInteger busPlayingIndex;
+
+/** (INTERNAL USE) Used by ALSoundSourcePool to have this source report changes to its gain,
+ * mute, bus gain and interruptible setting, which decide how it ranks for voice stealing.
+ *
+ * @param value The pool this source was added to, or nil.
+ */
+- (void) setPool:(ALSoundSourcePool*) value;
+
+/** (INTERNAL USE) Used by ALSoundSourcePool to read what it ranks this source by, after the
+ * source reported a change.
+ *
+ * @param effectiveGain Receives the gain OpenAL plays this source at (0 if muted).
+ * @return TRUE if this source can be interrupted.
+ */
+- (bool) readStealingState:(float*) effectiveGain;
+
+/** (INTERNAL USE) Used by ALSourceGroup to get this source ready to start along with others.
+ *
+ * @return TRUE if the source can be started (FALSE if it's playing and not interruptible).
+ */
+- (bool) prepareForBatchPlay;
+
+/** (INTERNAL USE) Used by ALSourceGroup and OALAudioStream to record a state change
+ * made directly through ALWrapper.
+ *
+ * @param value The state the sources were put in (AL_PLAYING, AL_PAUSED, or AL_STOPPED).
+ */
+- (void) notifyBatchState:(int) value;
+
 @end
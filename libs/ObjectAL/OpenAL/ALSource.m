@@ -25,18 +25,71 @@
 //
 
 #import "ALSource.h"
+#import "ALMixerBus.h"
+#import "ALSoundSourcePool.h"
 #import "mach_timing.h"
 #import "ObjectALMacros.h"
 #import "ALWrapper.h"
 #import "OpenALManager.h"
 #import "OALAudioActions.h"
 #import "OALUtilityActions.h"
+#import "OALTrace.h"
 
 
+/** How long a playback state read from OpenAL stays valid (mach absolute time). */
+static uint64_t stateCacheLifetime;
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for ALSource.
+ */
+@interface ALSource (Private)
+
+/** (INTERNAL USE) Record a playback state change that ObjectAL caused.
+ *
+ * @param value The new state.
+ */
+- (void) setShadowState:(int) value;
+
+/** (INTERNAL USE) Send the gain OpenAL should play at (gain times busGain, or 0 if muted).
+ */
+- (void) applyGain;
+
+/** (INTERNAL USE) Tell the pool that something it ranks this source by has changed.
+ */
+- (void) notifyPool;
+
+/** (INTERNAL USE) Pick up the bus's effective gain, in case it changed while this source
+ * was stopped. Must be called while holding this source's lock.
+ */
+- (void) syncBusGain;
+
+/** (INTERNAL USE) Tell the bus that this source started playing.
+ * Must not be called while holding this source's lock.
+ */
+- (void) notifyBusStarted;
+
+@end
+
+
+#pragma mark -
+#pragma mark ALSource
+
 @implementation ALSource
 
 #pragma mark Object Management
 
++ (void) initialize
+{
+	if(self == [ALSource class])
+	{
+		stateCacheLifetime = mach_absolute_from_seconds(kSourceStateCacheLifetime);
+	}
+}
+
 + (id) source
 {
 	return [[[self alloc] init] autorelease];
@@ -57,6 +110,8 @@
 	if(nil != (self = [super init]))
 	{
 		context = [contextIn retain];
+		busGain = 1.0f;
+		busPlayingIndex = NSNotFound;
 		@synchronized([OpenALManager sharedInstance])
 		{
 			ALContext* oldContext = [OpenALManager sharedInstance].currentContext;
@@ -67,6 +122,22 @@
 		
 		[context notifySourceInitializing:self];
 		gain = [ALWrapper getSourcef:sourceId parameter:AL_GAIN];
+		coneInnerAngle = [ALWrapper getSourcef:sourceId parameter:AL_CONE_INNER_ANGLE];
+		coneOuterAngle = [ALWrapper getSourcef:sourceId parameter:AL_CONE_OUTER_ANGLE];
+		coneOuterGain = [ALWrapper getSourcef:sourceId parameter:AL_CONE_OUTER_GAIN];
+		[ALWrapper getSource3f:sourceId parameter:AL_DIRECTION v1:&direction.x v2:&direction.y v3:&direction.z];
+		looping = [ALWrapper getSourcei:sourceId parameter:AL_LOOPING];
+		maxDistance = [ALWrapper getSourcef:sourceId parameter:AL_MAX_DISTANCE];
+		maxGain = [ALWrapper getSourcef:sourceId parameter:AL_MAX_GAIN];
+		minGain = [ALWrapper getSourcef:sourceId parameter:AL_MIN_GAIN];
+		pitch = [ALWrapper getSourcef:sourceId parameter:AL_PITCH];
+		[ALWrapper getSource3f:sourceId parameter:AL_POSITION v1:&position.x v2:&position.y v3:&position.z];
+		referenceDistance = [ALWrapper getSourcef:sourceId parameter:AL_REFERENCE_DISTANCE];
+		rolloffFactor = [ALWrapper getSourcef:sourceId parameter:AL_ROLLOFF_FACTOR];
+		sourceRelative = [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_RELATIVE];
+		[ALWrapper getSource3f:sourceId parameter:AL_VELOCITY v1:&velocity.x v2:&velocity.y v3:&velocity.z];
+		state = [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE];
+		stateTimestamp = mach_absolute_time();
 	}
 	return self;
 }
@@ -74,6 +145,8 @@
 - (void) dealloc
 {
 	[context notifySourceDeallocating:self];
+	[bus removeSource:self];
+	[bus release];
 	
 	[gainAction stopAction];
 	[gainAction release];
@@ -131,6 +204,40 @@
 	}
 }
 
+- (ALMixerBus*) bus
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [[bus retain] autorelease];
+	}
+}
+
+- (void) setBus:(ALMixerBus*) value
+{
+	// The bus calls back into this source while holding its own lock, so it must not be
+	// called while holding ours.
+	ALMixerBus* oldBus;
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(value == bus)
+		{
+			return;
+		}
+		oldBus = bus;
+		bus = [value retain];
+	}
+	[oldBus removeSource:self];
+	[oldBus release];
+	if(nil == value)
+	{
+		[self setBusGain:1.0f];
+	}
+	else
+	{
+		[value addSource:self];
+	}
+}
+
 - (int) buffersQueued
 {
 	OBJECTAL_INTERRUPT_BUG_WORKAROUND();
@@ -147,8 +254,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_CONE_INNER_ANGLE];
+		return coneInnerAngle;
 	}
 }
 
@@ -156,6 +262,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		coneInnerAngle = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_CONE_INNER_ANGLE value:value];
 	}
@@ -165,8 +272,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_CONE_OUTER_ANGLE];
+		return coneOuterAngle;
 	}
 }
 
@@ -174,6 +280,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		coneOuterAngle = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_CONE_OUTER_ANGLE value:value];
 	}
@@ -183,8 +290,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_CONE_OUTER_GAIN];
+		return coneOuterGain;
 	}
 }
 
@@ -192,6 +298,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		coneOuterGain = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_CONE_OUTER_GAIN value:value];
 	}
@@ -204,8 +311,7 @@
 	ALVector result;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		[ALWrapper getSource3f:sourceId parameter:AL_DIRECTION v1:&result.x v2:&result.y v3:&result.z];
+		result = direction;
 	}
 	return result;
 }
@@ -214,6 +320,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED_STRUCT_OP(self)
 	{
+		direction = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper source3f:sourceId parameter:AL_DIRECTION v1:value.x v2:value.y v3:value.z];
 	}
@@ -239,33 +346,48 @@
 
 - (void) setGain:(float) value
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_GAIN, sourceId, nil, value, 0, 0, 0);
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		gain = value;
-		if(muted)
+		[self applyGain];
+	}
+}
+
+- (bool) interruptible
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return interruptible;
+	}
+}
+
+- (void) setInterruptible:(bool) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(value != interruptible)
 		{
-			value = 0;
+			interruptible = value;
+			[self notifyPool];
 		}
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		[ALWrapper sourcef:sourceId parameter:AL_GAIN value:value];
 	}
 }
 
-@synthesize interruptible;
-
 - (bool) looping
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcei:sourceId parameter:AL_LOOPING];
+		return looping;
 	}
 }
 
 - (void) setLooping:(bool) value
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_LOOPING, sourceId, nil, 0, 0, 0, value);
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		looping = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcei:sourceId parameter:AL_LOOPING value:value];
 	}
@@ -275,8 +397,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_MAX_DISTANCE];
+		return maxDistance;
 	}
 }
 
@@ -284,6 +405,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		maxDistance = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_MAX_DISTANCE value:value];
 	}
@@ -293,8 +415,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_MAX_GAIN];
+		return maxGain;
 	}
 }
 
@@ -302,6 +423,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		maxGain = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_MAX_GAIN value:value];
 	}
@@ -311,8 +433,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_MIN_GAIN];
+		return minGain;
 	}
 }
 
@@ -320,6 +441,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		minGain = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_MIN_GAIN value:value];
 	}
@@ -342,9 +464,7 @@
 		{
 			[self stopActions];
 		}
-		float resultingGain = muted ? 0 : gain;
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		[ALWrapper sourcef:sourceId parameter:AL_GAIN value:resultingGain];
+		[self applyGain];
 	}
 }
 
@@ -409,6 +529,8 @@
 
 - (void) setPaused:(bool) shouldPause
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_PAUSED, sourceId, nil, 0, 0, 0, shouldPause);
+	bool resumed = NO;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		if(shouldPause)
@@ -417,6 +539,7 @@
 			{
 				OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 				[ALWrapper sourcePause:sourceId];
+				[self setShadowState:AL_PAUSED];
 			}
 		}
 		else
@@ -425,24 +548,31 @@
 			{
 				OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 				[ALWrapper sourcePlay:sourceId];
+				[self setShadowState:AL_PLAYING];
+				resumed = YES;
 			}
 		}
 	}
+	if(resumed)
+	{
+		[self notifyBusStarted];
+	}
 }
 
 - (float) pitch
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_PITCH];
+		return pitch;
 	}
 }
 
 - (void) setPitch:(float) value
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_PITCH, sourceId, nil, value, 0, 0, 0);
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		pitch = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_PITCH value:value];
 	}
@@ -458,16 +588,17 @@
 	ALPoint result;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		[ALWrapper getSource3f:sourceId parameter:AL_POSITION v1:&result.x v2:&result.y v3:&result.z];
+		result = position;
 	}
 	return result;
 }
 
 - (void) setPosition:(ALPoint) value
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_POSITION, sourceId, nil, value.x, value.y, value.z, 0);
 	OPTIONALLY_SYNCHRONIZED_STRUCT_OP(self)
 	{
+		position = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper source3f:sourceId parameter:AL_POSITION v1:value.x v2:value.y v3:value.z];
 	}
@@ -487,8 +618,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_REFERENCE_DISTANCE];
+		return referenceDistance;
 	}
 }
 
@@ -496,6 +626,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		referenceDistance = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_REFERENCE_DISTANCE value:value];
 	}
@@ -505,8 +636,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcef:sourceId parameter:AL_ROLLOFF_FACTOR];
+		return rolloffFactor;
 	}
 }
 
@@ -514,6 +644,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		rolloffFactor = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcef:sourceId parameter:AL_ROLLOFF_FACTOR value:value];
 	}
@@ -525,8 +656,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_RELATIVE];
+		return sourceRelative;
 	}
 }
 
@@ -534,6 +664,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
+		sourceRelative = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcei:sourceId parameter:AL_SOURCE_RELATIVE value:value];
 	}
@@ -561,8 +692,14 @@
 {
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		return [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE];
+		uint64_t currentTime = mach_absolute_time();
+		if(currentTime - stateTimestamp > stateCacheLifetime)
+		{
+			OBJECTAL_INTERRUPT_BUG_WORKAROUND();
+			state = [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE];
+			stateTimestamp = currentTime;
+		}
+		return state;
 	}
 }
 
@@ -572,6 +709,11 @@
 	{
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcei:sourceId parameter:AL_SOURCE_STATE value:value];
+		[self setShadowState:value];
+	}
+	if(AL_PLAYING == value)
+	{
+		[self notifyBusStarted];
 	}
 }
 
@@ -580,8 +722,7 @@
 	ALVector result;
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
-		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
-		[ALWrapper getSource3f:sourceId parameter:AL_VELOCITY v1:&result.x v2:&result.y v3:&result.z];
+		result = velocity;
 	}
 	return result;
 }
@@ -590,6 +731,7 @@
 {
 	OPTIONALLY_SYNCHRONIZED_STRUCT_OP(self)
 	{
+		velocity = value;
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper source3f:sourceId parameter:AL_VELOCITY v1:value.x v2:value.y v3:value.z];
 	}
@@ -633,9 +775,16 @@
 			[self stop];
 		}
 		
+		[self syncBusGain];
+		if(gainStale)
+		{
+			[self applyGain];
+		}
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcePlay:sourceId];
+		[self setShadowState:AL_PLAYING];
 	}
+	[self notifyBusStarted];
 	return self;
 }
 
@@ -662,9 +811,16 @@
 		self.buffer = bufferIn;
 		self.looping = loop;
 		
+		[self syncBusGain];
+		if(gainStale)
+		{
+			[self applyGain];
+		}
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcePlay:sourceId];
+		[self setShadowState:AL_PLAYING];
 	}
+	[self notifyBusStarted];
 	return self;
 }
 
@@ -686,6 +842,7 @@
 		self.buffer = bufferIn;
 		
 		// Set gain, pitch, and pan
+		[self syncBusGain];
 		self.gain = gainIn;
 		self.pitch = pitchIn;
 		self.pan = panIn;
@@ -693,19 +850,29 @@
 		
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourcePlay:sourceId];
+		[self setShadowState:AL_PLAYING];
 	}		
+	[self notifyBusStarted];
 	return self;
 }
 
 - (void) stop
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_STOP, sourceId, nil, 0, 0, 0, 0);
+	OAL_TRACE_BEGIN_INTERNAL();
 	OPTIONALLY_SYNCHRONIZED(self)
 	{
 		[self stopActions];
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		[ALWrapper sourceStop:sourceId];
+		if(AL_INITIAL != state)
+		{
+			// Stopping a source that was never played leaves it in the initial state.
+			[self setShadowState:AL_STOPPED];
+		}
 		paused = NO;
 	}
+	OAL_TRACE_END_INTERNAL();
 }
 
 - (void) fadeTo:(float) value
@@ -713,6 +880,7 @@
 		 target:(id) target
 	   selector:(SEL) selector
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_FADE, sourceId, nil, value, duration, 0, 0);
 	// Must always be synchronized
 	@synchronized(self)
 	{
@@ -741,6 +909,7 @@
 		 target:(id) target
 	   selector:(SEL) selector
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_PAN_TO, sourceId, nil, value, duration, 0, 0);
 	// Must always be synchronized
 	@synchronized(self)
 	{
@@ -769,6 +938,7 @@
 		target:(id) target
 	  selector:(SEL) selector
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_PITCH_TO, sourceId, nil, value, duration, 0, 0);
 	// Must always be synchronized
 	@synchronized(self)
 	{
@@ -794,6 +964,7 @@
 
 - (void) stopActions
 {
+	OAL_TRACE(OAL_TRACE_SOURCE_STOP_ACTIONS, sourceId, nil, 0, 0, 0, 0);
 	[self stopFade];
 	[self stopPan];
 	[self stopPitch];
@@ -838,7 +1009,7 @@
 		int i = 0;
 		for(ALBuffer* buf in buffers)
 		{
-			bufferIds[i] = buf.bufferId;
+			bufferIds[i++] = buf.bufferId;
 		}
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		bool result = [ALWrapper sourceQueueBuffers:sourceId numBuffers:numBuffers bufferIds:bufferIds];
@@ -870,7 +1041,7 @@
 		int i = 0;
 		for(ALBuffer* buf in buffers)
 		{
-			bufferIds[i] = buf.bufferId;
+			bufferIds[i++] = buf.bufferId;
 		}
 		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
 		bool result = [ALWrapper sourceUnqueueBuffers:sourceId numBuffers:numBuffers bufferIds:bufferIds];
@@ -899,4 +1070,153 @@
 }
 
 
+- (void) setRefreshedState:(int) value timestamp:(uint64_t) timestamp
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		// Don't overwrite a state change made while the batch was being read.
+		if((int64_t)(timestamp - stateTimestamp) >= 0)
+		{
+			state = value;
+			stateTimestamp = timestamp;
+		}
+	}
+}
+
+- (bool) setBusGain:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		// Sources that aren't making a sound can wait until they next play. Sources started
+		// outside of ALSource report it through notifyBatchState:, so the cached state is
+		// enough, and reading it doesn't cost an OpenAL call per source on the bus.
+		bool audible = AL_PLAYING == state || AL_PAUSED == state;
+		if(value != busGain)
+		{
+			busGain = value;
+			if(audible)
+			{
+				[self applyGain];
+			}
+			else
+			{
+				gainStale = YES;
+				[self notifyPool];
+			}
+		}
+		return audible;
+	}
+}
+
+@synthesize busPlayingIndex;
+
+- (void) setPool:(ALSoundSourcePool*) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		pool = value;
+		poolNotified = NO;
+	}
+}
+
+- (bool) readStealingState:(float*) effectiveGain
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		poolNotified = NO;
+		*effectiveGain = muted ? 0 : gain * busGain;
+		return interruptible;
+	}
+}
+
+- (bool) prepareForBatchPlay
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[self stopActions];
+		if(!interruptible && AL_PLAYING == self.state)
+		{
+			return NO;
+		}
+		[self syncBusGain];
+		if(gainStale)
+		{
+			[self applyGain];
+		}
+		return YES;
+	}
+}
+
+- (void) notifyBatchState:(int) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		switch(value)
+		{
+			case AL_PAUSED:
+				// Pausing only affects sources that were playing.
+				if(AL_PLAYING != self.state)
+				{
+					return;
+				}
+				break;
+			case AL_STOPPED:
+				paused = NO;
+				// Stopping a source that was never played leaves it in the initial state.
+				if(AL_INITIAL == state)
+				{
+					return;
+				}
+				break;
+		}
+		[self setShadowState:value];
+	}
+	if(AL_PLAYING == value)
+	{
+		[self notifyBusStarted];
+	}
+}
+
+- (void) setShadowState:(int) value
+{
+	state = value;
+	stateTimestamp = mach_absolute_time();
+}
+
+- (void) applyGain
+{
+	gainStale = NO;
+	OBJECTAL_INTERRUPT_BUG_WORKAROUND();
+	[ALWrapper sourcef:sourceId parameter:AL_GAIN value:muted ? 0 : gain * busGain];
+	[self notifyPool];
+}
+
+- (void) syncBusGain
+{
+	if(nil != bus)
+	{
+		float value = [bus lastEffectiveGain];
+		if(value != busGain)
+		{
+			busGain = value;
+			gainStale = YES;
+		}
+	}
+}
+
+- (void) notifyBusStarted
+{
+	[self.bus sourceStarted:self];
+}
+
+- (void) notifyPool
+{
+	// Report once until the pool reads the change, so a fade doesn't flood it.
+	if(nil != pool && !poolNotified)
+	{
+		poolNotified = YES;
+		[pool notifySourceChanged:self];
+	}
+}
+
 @end
@@ -0,0 +1,159 @@
+//
+//  ALSourceGroup.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ALSource.h"
+
+
+#pragma mark ALSourceGroup
+
+/**
+ * A set of sources that start, pause, and stop together. <br>
+ *
+ * Starting sources one at a time lets the mixer run between the calls, so layers of one
+ * sound (the stems of an explosion, for example) can start a mixer period apart and
+ * phase.  A group sets up each source first (see prepareSource:buffer:gain:pitch:pan:loop:),
+ * then starts, pauses, or stops them all with a single alSourcePlayv, alSourcePausev, or
+ * alSourceStopv call. <br>
+ *
+ * Only sources on the same context can share a call. Sources on a different context from
+ * the group's first source are handled one at a time.
+ */
+@interface ALSourceGroup : NSObject
+{
+	/** The sources in this group (ALSource*). */
+	NSMutableArray* sources;
+}
+
+
+#pragma mark Properties
+
+/** The sources in this group (ALSource*). */
+@property(readonly) NSArray* sources;
+
+
+#pragma mark Object Management
+
+/** Create a new, empty group.
+ *
+ * @return A new group.
+ */
++ (id) group;
+
+/** Create a new group.
+ *
+ * @param sources The sources to put in the group (ALSource*).
+ * @return A new group.
+ */
++ (id) groupWithSources:(NSArray*) sources;
+
+/** Initialize a group.
+ *
+ * @param sources The sources to put in the group (ALSource*).
+ * @return The initialized group.
+ */
+- (id) initWithSources:(NSArray*) sources;
+
+
+#pragma mark Group Management
+
+/** Add a source to this group. Does nothing if it's already in the group.
+ *
+ * @param source The source to add.
+ */
+- (void) addSource:(ALSource*) source;
+
+/** Remove a source from this group.
+ *
+ * @param source The source to remove.
+ */
+- (void) removeSource:(ALSource*) source;
+
+/** Remove all sources from this group.
+ */
+- (void) removeAllSources;
+
+/** Set up a source to play a buffer when the group next plays, and add it to the group
+ * if it's not already there.  The source doesn't start until play is called.
+ *
+ * @param source The source to set up.
+ * @param buffer The buffer to play.
+ * @param gain The gain (volume) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param pan Left-right panning (-1.0 = far left, 1.0 = far right).
+ * @param loop If TRUE, the sound will loop until stopped.
+ * @return TRUE if the source was set up (FALSE if it's busy and not interruptible).
+ */
+- (bool) prepareSource:(ALSource*) source
+				buffer:(ALBuffer*) buffer
+				  gain:(float) gain
+				 pitch:(float) pitch
+				   pan:(float) pan
+				  loop:(bool) loop;
+
+
+#pragma mark Playback
+
+/** Start all sources in this group at once.  Paused sources resume, and sources that are
+ * playing restart, unless they aren't interruptible.
+ *
+ * @return TRUE if the operation was successful.
+ */
+- (bool) play;
+
+/** Pause all playing sources in this group at once.
+ *
+ * @return TRUE if the operation was successful.
+ */
+- (bool) pause;
+
+/** Stop all sources in this group at once.
+ *
+ * @return TRUE if the operation was successful.
+ */
+- (bool) stop;
+
+
+#pragma mark Batch Operations
+
+/** Start several sources with as few OpenAL calls as possible.
+ *
+ * @param sources The sources to start (id<ALSoundSource>).
+ * @return TRUE if the operation was successful.
+ */
++ (bool) playSources:(NSArray*) sources;
+
+/** Pause several sources with as few OpenAL calls as possible.
+ *
+ * @param sources The sources to pause (id<ALSoundSource>).
+ * @return TRUE if the operation was successful.
+ */
++ (bool) pauseSources:(NSArray*) sources;
+
+/** Stop several sources with as few OpenAL calls as possible.
+ *
+ * @param sources The sources to stop (id<ALSoundSource>).
+ * @return TRUE if the operation was successful.
+ */
++ (bool) stopSources:(NSArray*) sources;
+
+@end
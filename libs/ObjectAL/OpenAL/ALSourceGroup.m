@@ -0,0 +1,289 @@
+//
+//  ALSourceGroup.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALSourceGroup.h"
+#import "ALContext.h"
+#import "ALWrapper.h"
+#import "ObjectALMacros.h"
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for ALSourceGroup.
+ */
+@interface ALSourceGroup (Private)
+
+/** (INTERNAL USE) Move several sources to a new playback state.
+ * ALSources on the same context as the first one share one OpenAL call. Anything
+ * else is handled one source at a time.
+ *
+ * @param sources The sources (id<ALSoundSource>).
+ * @param state AL_PLAYING, AL_PAUSED, or AL_STOPPED.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) setState:(int) state ofSources:(NSArray*) sources;
+
+@end
+
+
+#pragma mark -
+#pragma mark ALSourceGroup
+
+@implementation ALSourceGroup
+
+#pragma mark Object Management
+
++ (id) group
+{
+	return [[[self alloc] initWithSources:nil] autorelease];
+}
+
++ (id) groupWithSources:(NSArray*) sources
+{
+	return [[[self alloc] initWithSources:sources] autorelease];
+}
+
+- (id) init
+{
+	return [self initWithSources:nil];
+}
+
+- (id) initWithSources:(NSArray*) sourcesIn
+{
+	if(nil != (self = [super init]))
+	{
+		sources = [[NSMutableArray alloc] initWithCapacity:MAX(4, [sourcesIn count])];
+		for(ALSource* source in sourcesIn)
+		{
+			[self addSource:source];
+		}
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[sources release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+- (NSArray*) sources
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [NSArray arrayWithArray:sources];
+	}
+}
+
+
+#pragma mark Group Management
+
+- (void) addSource:(ALSource*) source
+{
+	if(nil == source)
+	{
+		OAL_LOG_ERROR(@"source was NULL");
+		return;
+	}
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(NSNotFound == [sources indexOfObjectIdenticalTo:source])
+		{
+			[sources addObject:source];
+		}
+	}
+}
+
+- (void) removeSource:(ALSource*) source
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[sources removeObjectIdenticalTo:source];
+	}
+}
+
+- (void) removeAllSources
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		[sources removeAllObjects];
+	}
+}
+
+- (bool) prepareSource:(ALSource*) source
+				buffer:(ALBuffer*) buffer
+				  gain:(float) gain
+				 pitch:(float) pitch
+				   pan:(float) pan
+				  loop:(bool) loop
+{
+	if(nil == source)
+	{
+		OAL_LOG_ERROR(@"source was NULL");
+		return NO;
+	}
+	OPTIONALLY_SYNCHRONIZED(source)
+	{
+		if(source.playing && !source.interruptible)
+		{
+			return NO;
+		}
+		[source stopActions];
+		
+		// Setting the buffer stops the source.
+		source.buffer = buffer;
+		source.gain = gain;
+		source.pitch = pitch;
+		source.pan = pan;
+		source.looping = loop;
+	}
+	[self addSource:source];
+	return YES;
+}
+
+
+#pragma mark Playback
+
+- (bool) play
+{
+	return [ALSourceGroup playSources:self.sources];
+}
+
+- (bool) pause
+{
+	return [ALSourceGroup pauseSources:self.sources];
+}
+
+- (bool) stop
+{
+	return [ALSourceGroup stopSources:self.sources];
+}
+
+
+#pragma mark Batch Operations
+
++ (bool) playSources:(NSArray*) sourcesIn
+{
+	return [self setState:AL_PLAYING ofSources:sourcesIn];
+}
+
++ (bool) pauseSources:(NSArray*) sourcesIn
+{
+	return [self setState:AL_PAUSED ofSources:sourcesIn];
+}
+
++ (bool) stopSources:(NSArray*) sourcesIn
+{
+	return [self setState:AL_STOPPED ofSources:sourcesIn];
+}
+
++ (bool) setState:(int) state ofSources:(NSArray*) sourcesIn
+{
+	NSUInteger count = [sourcesIn count];
+	if(0 == count)
+	{
+		return YES;
+	}
+	
+	ALuint* sourceIds = malloc(sizeof(*sourceIds) * count);
+	if(NULL == sourceIds)
+	{
+		OAL_LOG_ERROR(@"Could not allocate %d source IDs", (int)count);
+		return NO;
+	}
+	NSMutableArray* batched = [NSMutableArray arrayWithCapacity:count];
+	ALContext* context = nil;
+	bool result = YES;
+	
+	for(id<ALSoundSource> source in sourcesIn)
+	{
+		ALSource* alSource = [(NSObject*)source isKindOfClass:[ALSource class]] ? (ALSource*)source : nil;
+		if(nil != alSource && nil == context)
+		{
+			context = alSource.context;
+		}
+		
+		if(nil != alSource && alSource.context == context)
+		{
+			if(AL_PLAYING == state)
+			{
+				if(![alSource prepareForBatchPlay])
+				{
+					continue;
+				}
+			}
+			else if(AL_STOPPED == state)
+			{
+				[alSource stopActions];
+			}
+			sourceIds[[batched count]] = alSource.sourceId;
+			[batched addObject:alSource];
+		}
+		else switch(state)
+		{
+			case AL_PLAYING:
+				[source play];
+				break;
+			case AL_PAUSED:
+				source.paused = YES;
+				break;
+			default:
+				[source stop];
+				break;
+		}
+	}
+	
+	ALsizei numSources = (ALsizei)[batched count];
+	if(numSources > 0)
+	{
+		OBJECTAL_INTERRUPT_BUG_WORKAROUND();
+		switch(state)
+		{
+			case AL_PLAYING:
+				result = [ALWrapper sourcePlayv:sourceIds numSources:numSources];
+				break;
+			case AL_PAUSED:
+				result = [ALWrapper sourcePausev:sourceIds numSources:numSources];
+				break;
+			default:
+				result = [ALWrapper sourceStopv:sourceIds numSources:numSources];
+				break;
+		}
+		if(result)
+		{
+			for(ALSource* source in batched)
+			{
+				[source notifyBatchState:state];
+			}
+		}
+	}
+	
+	free(sourceIds);
+	return result;
+}
+
+@end
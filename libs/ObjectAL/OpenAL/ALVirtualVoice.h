@@ -0,0 +1,353 @@
+//
+//  ALVirtualVoice.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ALSource.h"
+#import "ALBuffer.h"
+#import "ALContext.h"
+#import "OALAction.h"
+#import "oal_emitter_grid.h"
+
+@class ALVirtualVoiceChannel;
+
+
+#pragma mark ALVirtualVoice
+
+/**
+ * A logical sound playing on an ALVirtualVoiceChannel. <br>
+ *
+ * A voice only holds a real OpenAL source while it is among the most important voices
+ * on its channel.  The rest of the time it is "virtual": its playback position keeps
+ * advancing (including looping, pitch and fades), but it costs no source and no mixing.
+ * When it becomes important enough again, it is resumed on a real source at the
+ * position it would have reached.
+ */
+@interface ALVirtualVoice : NSObject
+{
+	/** The channel this voice plays on (weak reference). */
+	ALVirtualVoiceChannel* channel;
+	/** This voice's ID in the channel's emitter grid. */
+	int emitterId;
+	
+	ALBuffer* buffer;
+	/** The real source playing this voice, or nil if virtual. */
+	ALSource* source;
+	float gain;
+	float pitch;
+	bool looping;
+	int priority;
+	ALPoint position;
+	float referenceDistance;
+	float rolloffFactor;
+	float maxDistance;
+	/** Set when the voice has been stopped, or has played to the end. */
+	bool finished;
+	/** Playback position in seconds, as of cursorTime (only valid while virtual). */
+	double cursor;
+	/** When the cursor was last updated, in seconds. */
+	double cursorTime;
+	
+	/** Current fade operation. */
+	OALAction* gainAction;
+}
+
+
+#pragma mark Properties
+
+/** The sound data this voice plays. */
+@property(readonly) ALBuffer* buffer;
+
+/** The real source this voice is playing on, or nil if it is virtual. */
+@property(readonly) ALSource* source;
+
+/** TRUE if this voice currently has a real source. */
+@property(readonly) bool realized;
+
+/** TRUE until the voice is stopped, or a non-looping voice reaches its end. */
+@property(readonly) bool playing;
+
+/** Gain (volume) (0.0 - 1.0). */
+@property(readwrite,assign) float gain;
+
+/** Pitch (1.0 = normal pitch). */
+@property(readwrite,assign) float pitch;
+
+/** If TRUE, the voice loops until stopped. */
+@property(readonly) bool looping;
+
+/** How important this voice is (higher = more important).  More important voices
+ * get real sources first, regardless of how loud they are.  Most voices should leave
+ * this at 0, since only those can be culled by distance.
+ */
+@property(readwrite,assign) int priority;
+
+/** The voice's position in 3D space. */
+@property(readwrite,assign) ALPoint position;
+
+/** Distance under which the voice is played at full gain (default 1.0). */
+@property(readwrite,assign) float referenceDistance;
+
+/** How quickly the voice gets quieter with distance (default 1.0). */
+@property(readwrite,assign) float rolloffFactor;
+
+/** Distance beyond which the voice gets no quieter (how that applies depends on the
+ * context's distance model) (default FLT_MAX). */
+@property(readwrite,assign) float maxDistance;
+
+/** The playback position, in seconds. */
+@property(readonly) double offsetInSeconds;
+
+
+#pragma mark Object Management
+
+/** Create a new voice.
+ *
+ * @param buffer The sound data to play.
+ * @param gain The gain (volume) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param loop If TRUE, the voice loops until stopped.
+ * @param priority How important the voice is (higher = more important).
+ * @return A new voice.
+ */
++ (id) voiceWithBuffer:(ALBuffer*) buffer
+				  gain:(float) gain
+				 pitch:(float) pitch
+				  loop:(bool) loop
+			  priority:(int) priority;
+
+/** Initialize a voice.
+ *
+ * @param buffer The sound data to play.
+ * @param gain The gain (volume) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param loop If TRUE, the voice loops until stopped.
+ * @param priority How important the voice is (higher = more important).
+ * @return The initialized voice.
+ */
+- (id) initWithBuffer:(ALBuffer*) buffer
+				 gain:(float) gain
+				pitch:(float) pitch
+				 loop:(bool) loop
+			 priority:(int) priority;
+
+
+#pragma mark Playback
+
+/** Stop this voice.  Its source (if any) is given back to the channel on the next update.
+ */
+- (void) stop;
+
+/** Fade to the specified gain value.  Fades keep running while the voice is virtual.
+ *
+ * @param gain The gain to fade to.
+ * @param duration The duration of the fade operation in seconds.
+ * @param target The target to notify when the fade completes (can be nil).
+ * @param selector The selector to call when the fade completes.  The selector must accept
+ * a single parameter, which will be the object that performed the fade.
+ */
+- (void) fadeTo:(float) gain
+	   duration:(float) duration
+		 target:(id) target
+	   selector:(SEL) selector;
+
+/** Stop the currently running fade operation, if any.
+ */
+- (void) stopFade;
+
+
+#pragma mark Internal Use
+
+/** (INTERNAL USE) The voice's ID in its channel's emitter grid. */
+@property(readonly) int emitterId;
+
+/** (INTERNAL USE) When this voice will reach its end, in seconds (INFINITY if it is
+ * looping or realized, -INFINITY if it has finished).
+ */
+@property(readonly) double endTime;
+
+/** (INTERNAL USE) Attach this voice to a channel, or detach it (nil).
+ *
+ * @param channel The channel (not retained).
+ * @param emitterId The voice's ID in the channel's emitter grid.
+ */
+- (void) attachToChannel:(ALVirtualVoiceChannel*) channel emitterId:(int) emitterId;
+
+/** (INTERNAL USE) Start playing on a real source, at the current playback position.
+ *
+ * @param source The source to play on.
+ * @return TRUE if the voice is now playing on the source (FALSE if it has already finished).
+ */
+- (bool) realizeOnSource:(ALSource*) source;
+
+/** (INTERNAL USE) Stop playing on the real source, remembering the playback position.
+ *
+ * @return The source that was released, or nil if the voice was already virtual.
+ */
+- (ALSource*) virtualize;
+
+@end
+
+
+#pragma mark -
+#pragma mark ALVirtualVoiceChannel
+
+/**
+ * Plays any number of positional voices using a fixed set of real OpenAL sources. <br>
+ *
+ * The voices are kept in a spatial grid.  On every update, the channel finds the most
+ * important voices as heard by the context's listener: ranked by priority, then by gain
+ * after distance attenuation (using the context's distance model and each voice's
+ * referenceDistance, rolloffFactor and maxDistance).  Only the grid cells that could hold
+ * a higher ranking voice are examined, so the cost depends on the number of real sources
+ * and the voices near the listener, not on the total number of voices. <br>
+ *
+ * The top voices are played on real sources, and the rest are kept virtual until they
+ * rank high enough again. <br>
+ *
+ * Call update once per frame.
+ */
+@interface ALVirtualVoiceChannel : NSObject
+{
+	/** The context whose listener and distance model are used for ranking. */
+	ALContext* context;
+	/** All real sources owned by this channel (ALSource*). */
+	NSMutableArray* sources;
+	/** Real sources not currently used by any voice (ALSource*). */
+	NSMutableArray* freeSources;
+	/** All playing voices (ALVirtualVoice*). */
+	NSMutableSet* voices;
+	/** Voices currently playing on a real source (ALVirtualVoice*). */
+	NSMutableArray* realizedVoices;
+	/** Spatial index of all voices. */
+	oal_emitter_grid* grid;
+	/** Scratch space for the results of a grid query. */
+	int* rankedEmitters;
+	float audibilityThreshold;
+}
+
+
+#pragma mark Properties
+
+/** The voices that are playing (ALVirtualVoice*), whether real or virtual. */
+@property(readonly) NSArray* voices;
+
+/** The number of real sources this channel plays voices on. */
+@property(readonly) NSUInteger numSources;
+
+/** The number of voices currently playing on a real source. */
+@property(readonly) NSUInteger numRealizedVoices;
+
+/** Voices quieter than this (after distance attenuation) are never given a real source. <br>
+ *
+ * Default value: 0.001
+ */
+@property(readwrite,assign) float audibilityThreshold;
+
+
+#pragma mark Object Management
+
+/** Create a channel with the specified number of real sources, on the current context.
+ *
+ * @param numSources The number of real sources to allocate.
+ * @return A new channel.
+ */
++ (id) channelWithSources:(int) numSources;
+
+/** Create a channel with the specified number of real sources, on the current context.
+ *
+ * @param numSources The number of real sources to allocate.
+ * @param cellSize The size of the spatial grid cells.  Around the distance at which voices
+ *                 become hard to hear works well (default 50).
+ * @return A new channel.
+ */
++ (id) channelWithSources:(int) numSources cellSize:(float) cellSize;
+
+/** Initialize a channel with the specified number of real sources, on the current context.
+ *
+ * @param numSources The number of real sources to allocate.
+ * @return The initialized channel.
+ */
+- (id) initWithSources:(int) numSources;
+
+/** Initialize a channel with the specified number of real sources, on the current context.
+ *
+ * @param numSources The number of real sources to allocate.
+ * @param cellSize The size of the spatial grid cells.  Around the distance at which voices
+ *                 become hard to hear works well (default 50).
+ * @return The initialized channel.
+ */
+- (id) initWithSources:(int) numSources cellSize:(float) cellSize;
+
+
+#pragma mark Playback
+
+/** Start a voice at the origin.  It gets a real source right away if it ranks high enough.
+ *
+ * @param buffer The sound data to play.
+ * @param gain The gain (volume) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param loop If TRUE, the voice loops until stopped.
+ * @param priority How important the voice is (higher = more important).
+ * @return The new voice, or nil if an error occurred.
+ */
+- (ALVirtualVoice*) play:(ALBuffer*) buffer
+					gain:(float) gain
+				   pitch:(float) pitch
+					loop:(bool) loop
+				priority:(int) priority;
+
+/** Start a voice at a position.  It gets a real source right away if it ranks high enough.
+ *
+ * @param buffer The sound data to play.
+ * @param gain The gain (volume) to play at (0.0 - 1.0).
+ * @param pitch The pitch to play at (1.0 = normal pitch).
+ * @param loop If TRUE, the voice loops until stopped.
+ * @param priority How important the voice is (higher = more important).
+ * @param position Where the voice is in 3D space.
+ * @return The new voice, or nil if an error occurred.
+ */
+- (ALVirtualVoice*) play:(ALBuffer*) buffer
+					gain:(float) gain
+				   pitch:(float) pitch
+					loop:(bool) loop
+				priority:(int) priority
+				position:(ALPoint) position;
+
+/** Drop finished voices, and reassign the real sources to the highest ranking voices.
+ */
+- (void) update;
+
+/** Stop all voices.
+ */
+- (void) stop;
+
+
+#pragma mark Internal Use
+
+/** (INTERNAL USE) Used by ALVirtualVoice to announce that its position, gain, priority,
+ * distance settings or playback state changed.
+ *
+ * @param voice The voice that changed.
+ */
+- (void) voiceChanged:(ALVirtualVoice*) voice;
+
+@end
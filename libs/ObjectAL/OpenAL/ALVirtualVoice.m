@@ -0,0 +1,808 @@
+//
+//  ALVirtualVoice.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALVirtualVoice.h"
+#import "ObjectALMacros.h"
+#import "mach_timing.h"
+#import "OALAudioActions.h"
+#import "OALUtilityActions.h"
+
+
+/** The default size of an emitter grid cell. */
+#define kDefaultCellSize 50.0f
+
+/** The maximum number of expired voices to collect per grid call. */
+#define kExpiredChunkSize 64
+
+
+/** (INTERNAL USE) The current time in seconds, in the time base used for voice cursors.
+ */
+static double currentTimeInSeconds(void)
+{
+	return mach_absolute_difference_seconds(mach_absolute_time(), 0);
+}
+
+
+#pragma mark ALVirtualVoice
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for ALVirtualVoice.
+ */
+@interface ALVirtualVoice (Private)
+
+/** (INTERNAL USE) Fold the time elapsed since cursorTime into the cursor.
+ * Only valid while the voice is virtual.
+ *
+ * @param now The current time, in seconds.
+ */
+- (void) advanceCursorTo:(double) now;
+
+/** (INTERNAL USE) Tell the channel (if any) that something that affects ranking changed.
+ * Must NOT be called while holding the voice's lock.
+ */
+- (void) notifyChannel;
+
+@end
+
+
+#pragma mark -
+#pragma mark ALVirtualVoice
+
+@implementation ALVirtualVoice
+
+#pragma mark Object Management
+
++ (id) voiceWithBuffer:(ALBuffer*) buffer
+				  gain:(float) gain
+				 pitch:(float) pitch
+				  loop:(bool) loop
+			  priority:(int) priority
+{
+	return [[[self alloc] initWithBuffer:buffer
+									gain:gain
+								   pitch:pitch
+									loop:loop
+								priority:priority] autorelease];
+}
+
+- (id) initWithBuffer:(ALBuffer*) bufferIn
+				 gain:(float) gainIn
+				pitch:(float) pitchIn
+				 loop:(bool) loopIn
+			 priority:(int) priorityIn
+{
+	if(nil != (self = [super init]))
+	{
+		buffer = [bufferIn retain];
+		gain = gainIn;
+		pitch = pitchIn;
+		looping = loopIn;
+		priority = priorityIn;
+		referenceDistance = 1.0f;
+		rolloffFactor = 1.0f;
+		maxDistance = FLT_MAX;
+		emitterId = -1;
+		cursorTime = currentTimeInSeconds();
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[gainAction stopAction];
+	[gainAction release];
+	[source release];
+	[buffer release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize buffer;
+@synthesize looping;
+@synthesize emitterId;
+
+- (ALSource*) source
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [[source retain] autorelease];
+	}
+}
+
+- (bool) realized
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return nil != source;
+	}
+}
+
+- (bool) playing
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(!finished)
+		{
+			if(nil != source)
+			{
+				if(!source.playing)
+				{
+					// The real source played to the end.
+					finished = YES;
+				}
+			}
+			else if(!looping)
+			{
+				[self advanceCursorTo:currentTimeInSeconds()];
+				if(cursor >= buffer.duration)
+				{
+					finished = YES;
+				}
+			}
+		}
+		return !finished;
+	}
+}
+
+- (float) gain
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return gain;
+	}
+}
+
+- (void) setGain:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		gain = value;
+		source.gain = value;
+	}
+	[self notifyChannel];
+}
+
+- (float) pitch
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return pitch;
+	}
+}
+
+- (void) setPitch:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(nil == source)
+		{
+			// Time played so far was played at the old pitch.
+			[self advanceCursorTo:currentTimeInSeconds()];
+		}
+		pitch = value;
+		source.pitch = value;
+	}
+	[self notifyChannel];
+}
+
+- (int) priority
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return priority;
+	}
+}
+
+- (void) setPriority:(int) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		priority = value;
+	}
+	[self notifyChannel];
+}
+
+- (ALPoint) position
+{
+	OPTIONALLY_SYNCHRONIZED_STRUCT_OP(self)
+	{
+		return position;
+	}
+}
+
+- (void) setPosition:(ALPoint) value
+{
+	OPTIONALLY_SYNCHRONIZED_STRUCT_OP(self)
+	{
+		position = value;
+		source.position = value;
+	}
+	[self notifyChannel];
+}
+
+- (float) referenceDistance
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return referenceDistance;
+	}
+}
+
+- (void) setReferenceDistance:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		referenceDistance = value;
+		source.referenceDistance = value;
+	}
+	[self notifyChannel];
+}
+
+- (float) rolloffFactor
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return rolloffFactor;
+	}
+}
+
+- (void) setRolloffFactor:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		rolloffFactor = value;
+		source.rolloffFactor = value;
+	}
+	[self notifyChannel];
+}
+
+- (float) maxDistance
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return maxDistance;
+	}
+}
+
+- (void) setMaxDistance:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		maxDistance = value;
+		source.maxDistance = value;
+	}
+	[self notifyChannel];
+}
+
+- (double) offsetInSeconds
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(nil != source)
+		{
+			return source.offsetInSeconds;
+		}
+		[self advanceCursorTo:currentTimeInSeconds()];
+		return cursor;
+	}
+}
+
+
+#pragma mark Playback
+
+- (void) stop
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		finished = YES;
+		[source stop];
+	}
+	[self notifyChannel];
+}
+
+- (void) fadeTo:(float) value
+	   duration:(float) duration
+		 target:(id) target
+	   selector:(SEL) selector
+{
+	// Must always be synchronized
+	@synchronized(self)
+	{
+		[self stopFade];
+		gainAction = [[OALSequentialActions actions:
+					   [OALGainAction actionWithDuration:duration endValue:value],
+					   [OALCallAction actionWithCallTarget:target selector:selector withObject:self],
+					   nil] retain];
+		[gainAction runWithTarget:self];
+	}
+}
+
+- (void) stopFade
+{
+	// Must always be synchronized
+	@synchronized(self)
+	{
+		[gainAction stopAction];
+		[gainAction release];
+		gainAction = nil;
+	}
+}
+
+
+#pragma mark Internal Use
+
+- (void) advanceCursorTo:(double) now
+{
+	if(now > cursorTime)
+	{
+		cursor += (now - cursorTime) * pitch;
+		double duration = buffer.duration;
+		if(looping && duration > 0 && cursor >= duration)
+		{
+			cursor = fmod(cursor, duration);
+		}
+	}
+	cursorTime = now;
+}
+
+- (void) notifyChannel
+{
+	ALVirtualVoiceChannel* channelRef;
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		channelRef = channel;
+	}
+	[channelRef voiceChanged:self];
+}
+
+- (double) endTime
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(finished)
+		{
+			return -INFINITY;
+		}
+		if(nil != source || looping || pitch <= 0)
+		{
+			return INFINITY;
+		}
+		return cursorTime + (buffer.duration - cursor) / pitch;
+	}
+}
+
+- (void) attachToChannel:(ALVirtualVoiceChannel*) channelIn emitterId:(int) emitterIdIn
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		channel = channelIn;
+		emitterId = emitterIdIn;
+	}
+}
+
+- (bool) realizeOnSource:(ALSource*) sourceIn
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(finished || nil != source || nil == sourceIn)
+		{
+			return NO;
+		}
+		
+		[self advanceCursorTo:currentTimeInSeconds()];
+		if(!looping && cursor >= buffer.duration)
+		{
+			finished = YES;
+			return NO;
+		}
+		
+		source = [sourceIn retain];
+		source.buffer = buffer;
+		source.looping = looping;
+		source.gain = gain;
+		source.pitch = pitch;
+		source.position = position;
+		source.referenceDistance = referenceDistance;
+		source.rolloffFactor = rolloffFactor;
+		source.maxDistance = maxDistance;
+		source.offsetInSeconds = (float)cursor;
+		[source play];
+		return YES;
+	}
+}
+
+- (ALSource*) virtualize
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(nil == source)
+		{
+			return nil;
+		}
+		
+		if(source.playing)
+		{
+			cursor = source.offsetInSeconds;
+		}
+		else
+		{
+			finished = YES;
+		}
+		cursorTime = currentTimeInSeconds();
+		[source stop];
+		ALSource* result = [source autorelease];
+		source = nil;
+		return result;
+	}
+}
+
+@end
+
+
+#pragma mark -
+#pragma mark ALVirtualVoiceChannel
+
+/** (INTERNAL USE) Convert an OpenAL distance model to its emitter grid equivalent.
+ */
+static oal_distance_model gridDistanceModel(ALenum model)
+{
+	switch(model)
+	{
+		case AL_NONE:
+			return OAL_DISTANCE_NONE;
+		case AL_INVERSE_DISTANCE:
+			return OAL_DISTANCE_INVERSE;
+		case AL_LINEAR_DISTANCE:
+			return OAL_DISTANCE_LINEAR;
+		case AL_LINEAR_DISTANCE_CLAMPED:
+			return OAL_DISTANCE_LINEAR_CLAMPED;
+		case AL_EXPONENT_DISTANCE:
+			return OAL_DISTANCE_EXPONENT;
+		case AL_EXPONENT_DISTANCE_CLAMPED:
+			return OAL_DISTANCE_EXPONENT_CLAMPED;
+		default:
+			return OAL_DISTANCE_INVERSE_CLAMPED;
+	}
+}
+
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for ALVirtualVoiceChannel.
+ */
+@interface ALVirtualVoiceChannel (Private)
+
+/** (INTERNAL USE) Drop a voice from the channel, reclaiming its source.
+ *
+ * @param voice The voice to remove.
+ */
+- (void) removeVoice:(ALVirtualVoice*) voice;
+
+@end
+
+
+@implementation ALVirtualVoiceChannel
+
+#pragma mark Object Management
+
++ (id) channelWithSources:(int) numSources
+{
+	return [[[self alloc] initWithSources:numSources] autorelease];
+}
+
++ (id) channelWithSources:(int) numSources cellSize:(float) cellSize
+{
+	return [[[self alloc] initWithSources:numSources cellSize:cellSize] autorelease];
+}
+
+- (id) initWithSources:(int) numSources
+{
+	return [self initWithSources:numSources cellSize:kDefaultCellSize];
+}
+
+- (id) initWithSources:(int) numSources cellSize:(float) cellSize
+{
+	if(nil != (self = [super init]))
+	{
+		grid = oal_emitter_grid_create(cellSize);
+		if(NULL == grid)
+		{
+			OAL_LOG_ERROR(@"Could not create emitter grid");
+			[self release];
+			return nil;
+		}
+		
+		context = [[ALContext currentContext] retain];
+		sources = [[NSMutableArray alloc] initWithCapacity:numSources];
+		freeSources = [[NSMutableArray alloc] initWithCapacity:numSources];
+		voices = [[NSMutableSet alloc] initWithCapacity:64];
+		realizedVoices = [[NSMutableArray alloc] initWithCapacity:numSources];
+		audibilityThreshold = 0.001f;
+		
+		for(int i = 0; i < numSources; i++)
+		{
+			ALSource* source = [ALSource source];
+			if(nil == source)
+			{
+				OAL_LOG_WARNING(@"Could only allocate %d of %d sources", i, numSources);
+				break;
+			}
+			[sources addObject:source];
+			[freeSources addObject:source];
+		}
+		
+		rankedEmitters = malloc(sizeof(*rankedEmitters) * ([sources count] > 0 ? [sources count] : 1));
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[self stop];
+	free(rankedEmitters);
+	if(NULL != grid)
+	{
+		oal_emitter_grid_destroy(grid);
+	}
+	[realizedVoices release];
+	[voices release];
+	[freeSources release];
+	[sources release];
+	[context release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+- (NSArray*) voices
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [voices allObjects];
+	}
+}
+
+- (NSUInteger) numSources
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [sources count];
+	}
+}
+
+- (NSUInteger) numRealizedVoices
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return [realizedVoices count];
+	}
+}
+
+- (float) audibilityThreshold
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return audibilityThreshold;
+	}
+}
+
+- (void) setAudibilityThreshold:(float) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		audibilityThreshold = value;
+	}
+}
+
+
+#pragma mark Playback
+
+- (ALVirtualVoice*) play:(ALBuffer*) buffer
+					gain:(float) gain
+				   pitch:(float) pitch
+					loop:(bool) loop
+				priority:(int) priority
+{
+	ALPoint origin = {0, 0, 0};
+	return [self play:buffer gain:gain pitch:pitch loop:loop priority:priority position:origin];
+}
+
+- (ALVirtualVoice*) play:(ALBuffer*) buffer
+					gain:(float) gain
+				   pitch:(float) pitch
+					loop:(bool) loop
+				priority:(int) priority
+				position:(ALPoint) position
+{
+	if(nil == buffer)
+	{
+		OAL_LOG_ERROR(@"buffer was NULL");
+		return nil;
+	}
+	
+	ALVirtualVoice* voice = [ALVirtualVoice voiceWithBuffer:buffer
+													   gain:gain
+													  pitch:pitch
+													   loop:loop
+												   priority:priority];
+	voice.position = position;
+	
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		int emitterId = oal_emitter_grid_add(grid, voice);
+		if(emitterId < 0)
+		{
+			OAL_LOG_ERROR(@"Could not add voice to emitter grid");
+			return nil;
+		}
+		[voices addObject:voice];
+		[voice attachToChannel:self emitterId:emitterId];
+		[self voiceChanged:voice];
+		[self update];
+	}
+	return voice;
+}
+
+- (void) update
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		double now = currentTimeInSeconds();
+		
+		// Drop virtual voices that have played to the end.
+		int expired[kExpiredChunkSize];
+		unsigned int numExpired;
+		while(0 < (numExpired = oal_emitter_grid_expired(grid, now, expired, kExpiredChunkSize)))
+		{
+			for(unsigned int i = 0; i < numExpired; i++)
+			{
+				[self removeVoice:(ALVirtualVoice*)oal_emitter_grid_user_data(grid, expired[i])];
+			}
+		}
+		
+		// Drop real voices that have played to the end.
+		for(NSInteger i = (NSInteger)[realizedVoices count] - 1; i >= 0; i--)
+		{
+			ALVirtualVoice* voice = [realizedVoices objectAtIndex:(NSUInteger)i];
+			if(!voice.playing)
+			{
+				[self removeVoice:voice];
+			}
+		}
+		
+		// Find the top ranking voices, as heard by the listener.
+		ALPoint listenerPosition = context.listener.position;
+		unsigned int numRanked = oal_emitter_grid_query(grid,
+														gridDistanceModel(context.distanceModel),
+														listenerPosition.x,
+														listenerPosition.y,
+														listenerPosition.z,
+														now,
+														audibilityThreshold,
+														rankedEmitters,
+														NULL,
+														(unsigned int)[sources count]);
+		
+		NSMutableSet* wanted = [NSMutableSet setWithCapacity:numRanked];
+		for(unsigned int i = 0; i < numRanked; i++)
+		{
+			[wanted addObject:(ALVirtualVoice*)oal_emitter_grid_user_data(grid, rankedEmitters[i])];
+		}
+		
+		// Free up the sources held by voices that no longer rank high enough...
+		for(NSInteger i = (NSInteger)[realizedVoices count] - 1; i >= 0; i--)
+		{
+			ALVirtualVoice* voice = [realizedVoices objectAtIndex:(NSUInteger)i];
+			if(![wanted containsObject:voice])
+			{
+				ALSource* source = [voice virtualize];
+				if(nil != source)
+				{
+					[freeSources addObject:source];
+				}
+				oal_emitter_grid_set_end_time(grid, voice.emitterId, voice.endTime);
+				[realizedVoices removeObjectAtIndex:(NSUInteger)i];
+			}
+		}
+		
+		// ... and give them to the ones that do, most important first.
+		for(unsigned int i = 0; i < numRanked && [freeSources count] > 0; i++)
+		{
+			ALVirtualVoice* voice = (ALVirtualVoice*)oal_emitter_grid_user_data(grid, rankedEmitters[i]);
+			if(!voice.realized)
+			{
+				if([voice realizeOnSource:[freeSources lastObject]])
+				{
+					[freeSources removeLastObject];
+					[realizedVoices addObject:voice];
+				}
+				oal_emitter_grid_set_end_time(grid, voice.emitterId, voice.endTime);
+			}
+		}
+	}
+}
+
+- (void) stop
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		for(ALVirtualVoice* voice in [voices allObjects])
+		{
+			[voice stop];
+			[self removeVoice:voice];
+		}
+	}
+}
+
+
+#pragma mark Internal Use
+
+- (void) removeVoice:(ALVirtualVoice*) voice
+{
+	if(nil == voice || ![voices containsObject:voice])
+	{
+		return;
+	}
+	
+	[voice retain];
+	ALSource* source = [voice virtualize];
+	if(nil != source)
+	{
+		[freeSources addObject:source];
+	}
+	[realizedVoices removeObjectIdenticalTo:voice];
+	oal_emitter_grid_remove(grid, voice.emitterId);
+	[voice attachToChannel:nil emitterId:-1];
+	[voices removeObject:voice];
+	[voice release];
+}
+
+- (void) voiceChanged:(ALVirtualVoice*) voice
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		int emitterId = voice.emitterId;
+		if(emitterId < 0 || ![voices containsObject:voice])
+		{
+			return;
+		}
+		
+		ALPoint voicePosition = voice.position;
+		oal_emitter_grid_move(grid, emitterId, voicePosition.x, voicePosition.y, voicePosition.z);
+		oal_emitter_grid_set_properties(grid,
+										emitterId,
+										voice.gain,
+										voice.priority,
+										voice.referenceDistance,
+										voice.rolloffFactor,
+										voice.maxDistance);
+		oal_emitter_grid_set_end_time(grid, emitterId, voice.endTime);
+	}
+}
+
+@end
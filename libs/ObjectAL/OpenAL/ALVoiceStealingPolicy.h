@@ -0,0 +1,181 @@
+//
+//  ALVoiceStealingPolicy.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "SynthesizeSingleton.h"
+
+
+#pragma mark ALVoiceInfo
+
+/**
+ * Describes a sound that is playing (or about to play) on a pooled source.
+ * All times are in seconds, as measured by mach_absolute_time().
+ */
+typedef struct
+{
+	/** How important the sound is. Higher values are more important. */
+	int priority;
+	/** The gain OpenAL plays the sound at (its source's gain times its bus gain, or 0 if muted).
+	 * ALSoundSourcePool keeps this current for pooled ALSource objects.
+	 */
+	float gain;
+	/** The time at which the sound started playing. */
+	double startTime;
+	/** The time at which the sound is expected to finish playing. */
+	double endTime;
+} ALVoiceInfo;
+
+/** The time span that a looping sound is considered to have remaining. */
+#define kALVoiceLoopingDuration 3600.0
+
+/** Convenience inline for describing a sound that starts now.
+ *
+ * @param priority How important the sound is (higher = more important).
+ * @param gain The gain the sound is played at.
+ * @param duration How long the sound will play for, in seconds (ignored if looping).
+ * @param looping If TRUE, the sound will play until stopped.
+ * @return An ALVoiceInfo.
+ */
+ALVoiceInfo ALVoiceInfoMake(int priority, float gain, float duration, bool looping);
+
+
+#pragma mark -
+#pragma mark ALVoiceStealingPolicy
+
+/**
+ * Decides which voice gets stolen when a source pool runs out of free sources.
+ * Every voice is given a key, and when a new sound needs a source and none are free,
+ * the interruptible voice with the lowest key is stolen, but only if its key is no higher
+ * than the new sound's. <br>
+ *
+ * A voice's key must not depend on the current time, since the pool only recalculates it
+ * when the voice changes. To favor old voices or voices that are about to end, use their
+ * absolute start and end times, which rank voices the same way at any moment.
+ */
+@protocol ALVoiceStealingPolicy
+
+
+#pragma mark Policy
+
+/** Calculate the key used to rank a voice for stealing.
+ *
+ * @param voice The voice to calculate the key for.
+ * @return The key. Voices with lower keys get stolen first.
+ */
+- (double) stealKeyForVoice:(const ALVoiceInfo*) voice;
+
+@end
+
+
+
+#pragma mark -
+#pragma mark ALOldestVoicePolicy
+
+/** Steals the voice that started playing longest ago, regardless of how important it is.
+ * This is the default policy.
+ */
+@interface ALOldestVoicePolicy : NSObject <ALVoiceStealingPolicy>
+{
+}
+
+
+#pragma mark Object Management
+
+/** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
+ *
+ * <b>- (ALOldestVoicePolicy*) sharedInstance</b>: Get the shared singleton instance. <br>
+ * <b>- (void) purgeSharedInstance</b>: Purge (deallocate) the shared instance.
+ */
+SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(ALOldestVoicePolicy);
+
+/** Generate an instance of this policy.
+ *
+ * @return An instance of this policy.
+ */
++ (id) policy;
+
+@end
+
+
+
+#pragma mark -
+#pragma mark ALWeightedVoicePolicy
+
+/** Combines priority, gain, remaining duration and age into a single key:
+ *
+ * key = priority * priorityWeight + gain * gainWeight
+ *     + (min(endTime, startTime + timeScale) * remainingTimeWeight + startTime * ageWeight) / timeScale
+ *
+ * At any moment, this ranks voices the same way as
+ *
+ * cost = priority * priorityWeight + gain * gainWeight
+ *      + remaining * remainingTimeWeight - age * ageWeight
+ *
+ * where remaining and age are the time left until the voice finishes and the time since it
+ * started, divided by timeScale (the two differ only by a term that is the same for every
+ * voice). The remaining time is capped at timeScale after the voice started, so that a
+ * looping voice does not swamp the other terms.
+ *
+ * With the default weights, a lower priority voice is stolen before a higher priority one
+ * unless it started over priorityWeight * timeScale / ageWeight seconds (11 hours) later.
+ * Among voices of equal priority, quiet voices, voices that are about to end, and old
+ * voices are all preferred for stealing.
+ */
+@interface ALWeightedVoicePolicy : NSObject <ALVoiceStealingPolicy>
+{
+	double priorityWeight;
+	double gainWeight;
+	double remainingTimeWeight;
+	double ageWeight;
+	double timeScale;
+}
+
+
+#pragma mark Properties
+
+/** Weight given to priority (default 1000). */
+@property(readwrite,assign) double priorityWeight;
+
+/** Weight given to gain (default 1). */
+@property(readwrite,assign) double gainWeight;
+
+/** Weight given to the time remaining until the voice finishes (default 0.5). */
+@property(readwrite,assign) double remainingTimeWeight;
+
+/** Weight given to how long ago the voice started (default 0.25). */
+@property(readwrite,assign) double ageWeight;
+
+/** The time span, in seconds, that the remaining time and age of a voice are measured
+ * against (default 10). Remaining time beyond this makes no further difference.
+ */
+@property(readwrite,assign) double timeScale;
+
+
+#pragma mark Object Management
+
+/** Create a new policy with the default weights.
+ *
+ * @return A new policy.
+ */
++ (id) policy;
+
+@end
@@ -0,0 +1,115 @@
+//
+//  ALVoiceStealingPolicy.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ALVoiceStealingPolicy.h"
+#import "mach_timing.h"
+#import <math.h>
+
+
+#pragma mark ALVoiceInfo
+
+ALVoiceInfo ALVoiceInfoMake(int priority, float gain, float duration, bool looping)
+{
+	ALVoiceInfo voice;
+	voice.priority = priority;
+	voice.gain = gain;
+	voice.startTime = mach_absolute_difference_seconds(mach_absolute_time(), 0);
+	voice.endTime = voice.startTime + (looping ? kALVoiceLoopingDuration : duration);
+	return voice;
+}
+
+
+#pragma mark -
+#pragma mark ALOldestVoicePolicy
+
+@implementation ALOldestVoicePolicy
+
+
+#pragma mark Object Management
+
+SYNTHESIZE_SINGLETON_FOR_CLASS(ALOldestVoicePolicy);
+
++ (id) policy
+{
+	return [self sharedInstance];
+}
+
+
+#pragma mark Policy
+
+- (double) stealKeyForVoice:(const ALVoiceInfo*) voice
+{
+	return voice->startTime;
+}
+
+@end
+
+
+
+#pragma mark -
+#pragma mark ALWeightedVoicePolicy
+
+@implementation ALWeightedVoicePolicy
+
+
+#pragma mark Object Management
+
++ (id) policy
+{
+	return [[[self alloc] init] autorelease];
+}
+
+- (id) init
+{
+	if(nil != (self = [super init]))
+	{
+		priorityWeight = 1000;
+		gainWeight = 1;
+		remainingTimeWeight = 0.5;
+		ageWeight = 0.25;
+		timeScale = 10;
+	}
+	return self;
+}
+
+
+#pragma mark Properties
+
+@synthesize priorityWeight;
+@synthesize gainWeight;
+@synthesize remainingTimeWeight;
+@synthesize ageWeight;
+@synthesize timeScale;
+
+
+#pragma mark Policy
+
+- (double) stealKeyForVoice:(const ALVoiceInfo*) voice
+{
+	// Both time terms use absolute times, so keys don't change as time passes.
+	double endTime = fmin(voice->endTime, voice->startTime + timeScale);
+	return voice->priority * priorityWeight
+	+ voice->gain * gainWeight
+	+ (endTime * remainingTimeWeight + voice->startTime * ageWeight) / timeScale;
+}
+
+@end
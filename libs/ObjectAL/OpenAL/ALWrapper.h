@@ -27,6 +27,30 @@
 #import <Foundation/Foundation.h>
 #import <OpenAL/al.h>
 #import <OpenAL/alc.h>
+#import "oal_command_queue.h"
+
+
+#ifndef ALC_SOFT_loopback
+/** ALC_SOFT_loopback tokens, for OpenAL headers that don't define them. */
+#define ALC_SOFT_loopback 1
+#define ALC_FORMAT_CHANNELS_SOFT 0x1990
+#define ALC_FORMAT_TYPE_SOFT 0x1991
+
+#define ALC_BYTE_SOFT 0x1400
+#define ALC_UNSIGNED_BYTE_SOFT 0x1401
+#define ALC_SHORT_SOFT 0x1402
+#define ALC_UNSIGNED_SHORT_SOFT 0x1403
+#define ALC_INT_SOFT 0x1404
+#define ALC_UNSIGNED_INT_SOFT 0x1405
+#define ALC_FLOAT_SOFT 0x1406
+
+#define ALC_MONO_SOFT 0x1500
+#define ALC_STEREO_SOFT 0x1501
+#define ALC_QUAD_SOFT 0x1503
+#define ALC_5POINT1_SOFT 0x1504
+#define ALC_6POINT1_SOFT 0x1505
+#define ALC_7POINT1_SOFT 0x1506
+#endif /* ALC_SOFT_loopback */
 
 
 /**
@@ -464,6 +488,19 @@
  */
 + (ALint) getSourcei:(ALuint) sourceId parameter:(ALenum) parameter;
 
+/** Read an integer paramter from many sources at once, with a single lock and error check.
+ *
+ * @param sourceIds The sources' IDs.
+ * @param numSources The number of sources.
+ * @param parameter The parameter to read.
+ * @param values Pointer to an array that will receive the values (one per source).
+ * @return TRUE if the operation was successful.
+ */
++ (bool) getSourcesi:(ALuint*) sourceIds
+		  numSources:(ALsizei) numSources
+		   parameter:(ALenum) parameter
+			  values:(ALint*) values;
+
 /** Read a 3 integer paramter from a source.
  *
  * @param sourceId The source's ID.
@@ -995,4 +1032,101 @@
 					 size:(ALsizei) size
 				frequency:(ALsizei) frequency;
 
+
+
+#pragma mark AL_SOFT_deferred_updates extension
+
+/** Check if the AL_SOFT_deferred_updates extension is available.
+ *
+ * @return TRUE if deferUpdates and processUpdates can be used.
+ */
++ (bool) deferredUpdatesSupported;
+
+/** Start holding back source and listener changes until processUpdates is called
+ * (alDeferUpdatesSOFT). <br>
+ * Does nothing if AL_SOFT_deferred_updates isn't available.
+ *
+ * @return TRUE if updates are now being deferred.
+ */
++ (bool) deferUpdates;
+
+/** Apply all changes held back since deferUpdates at once (alProcessUpdatesSOFT). <br>
+ * Does nothing if AL_SOFT_deferred_updates isn't available.
+ *
+ * @return TRUE if the operation is successful.
+ */
++ (bool) processUpdates;
+
+
+
+#pragma mark ALC_SOFT_loopback extension
+
+/** Check if the ALC_SOFT_loopback extension is available.
+ *
+ * @return TRUE if loopback devices can be opened.
+ */
++ (bool) loopbackSupported;
+
+/** Open a loopback device, which renders into memory on request instead of playing
+ * through audio hardware (alcLoopbackOpenDeviceSOFT). <br>
+ * Contexts on a loopback device must be created with the ALC_FREQUENCY,
+ * ALC_FORMAT_CHANNELS_SOFT and ALC_FORMAT_TYPE_SOFT attributes.
+ *
+ * @param deviceName The playback device whose implementation to use (nil = default).
+ * @return The opened device, or NULL if the device couldn't be opened or the extension
+ *         isn't available.
+ */
++ (ALCdevice*) openLoopbackDevice:(NSString*) deviceName;
+
+/** Check if a loopback device can render in a format (alcIsRenderFormatSupportedSOFT).
+ *
+ * @param device The loopback device.
+ * @param frequency The sample rate.
+ * @param channels The channel configuration (ALC_MONO_SOFT, ALC_STEREO_SOFT, etc).
+ * @param type The sample type (ALC_SHORT_SOFT, ALC_FLOAT_SOFT, etc).
+ * @return TRUE if the format is supported.
+ */
++ (bool) isRenderFormatSupported:(ALCdevice*) device
+					   frequency:(ALCsizei) frequency
+						channels:(ALCenum) channels
+							type:(ALCenum) type;
+
+/** Render samples from a loopback device's current context (alcRenderSamplesSOFT).
+ *
+ * @param device The loopback device.
+ * @param buffer The buffer to render into.
+ * @param numSamples The number of sample frames to render.
+ * @return TRUE if the operation was successful.
+ */
++ (bool) renderSamples:(ALCdevice*) device
+				buffer:(ALCvoid*) buffer
+			numSamples:(ALCsizei) numSamples;
+
+
+
+#pragma mark -
+#pragma mark Error Checking
+
+/** Check for OpenAL errors made since the last check, and log them. <br>
+ *
+ * When OBJECTAL_CFG_AL_ERROR_CHECKING is OBJECTAL_AL_ERROR_CHECKING_PER_FRAME, this is the
+ * only place errors get checked, so call it once per frame.  The recent calls that may
+ * have caused the error are logged along with it.
+ *
+ * @return TRUE if there were no errors.
+ */
++ (bool) checkErrors;
+
+
+#pragma mark -
+#pragma mark Command Queue
+
+/** (INTERNAL USE) Execute commands taken off the audio command queue.
+ * Used by ALCommandThread when OBJECTAL_CFG_AUDIO_COMMAND_THREAD is enabled.
+ *
+ * @param commands The commands to execute, in order.
+ * @param numCommands The number of commands.
+ */
++ (void) executeCommands:(const oal_command*) commands numCommands:(unsigned int) numCommands;
+
 @end
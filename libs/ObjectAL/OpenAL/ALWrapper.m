@@ -26,12 +26,57 @@
 
 #import "ALWrapper.h"
 #import "ObjectALMacros.h"
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+#import "ALCommandThread.h"
+#endif
 
-/** Check the result of an AL call, logging an error if necessary.
+#if OBJECTAL_CFG_COLLECT_STATS
+#import "oal_stats.h"
+#import "mach_timing.h"
+#endif
+
+/** Check the OpenAL error status according to OBJECTAL_CFG_AL_ERROR_CHECKING,
+ * logging an error if necessary.
+ *
+ * @return TRUE if the call was successful (always TRUE unless every call is checked).
+ */
+#if OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_ALWAYS
+#define CHECK_AL_RESULT() checkIfSuccessful(__PRETTY_FUNCTION__)
+#elif OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_SAMPLED
+#define CHECK_AL_RESULT() checkIfSuccessfulSampled(__PRETTY_FUNCTION__)
+#elif OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_PER_FRAME
+#define CHECK_AL_RESULT() recordCallSite(__PRETTY_FUNCTION__)
+#else
+#define CHECK_AL_RESULT() assumeSuccessful()
+#endif
+
+#if OBJECTAL_CFG_COLLECT_STATS
+
+/** Add the call started by SYNCHRONIZED_AL_CALL() to the statistics. */
+#define RECORD_AL_CALL() oal_stats_record(__PRETTY_FUNCTION__, mach_absolute_time() - alCallStartTime)
+
+/** Record an AL call in the statistics, then check its result.
+ *
+ * @return TRUE if the call was successful.
+ */
+#define CHECK_AL_CALL() (RECORD_AL_CALL(), CHECK_AL_RESULT())
+
+/** Record an ALC call in the statistics, then check its result, logging an error if necessary.
  *
+ * @param DEVICE The device involved in the ALC call.
  * @return TRUE if the call was successful.
  */
-#define CHECK_AL_CALL() checkIfSuccessful(__PRETTY_FUNCTION__)
+#define CHECK_ALC_CALL(DEVICE) (RECORD_AL_CALL(), checkIfSuccessfulWithDevice(__PRETTY_FUNCTION__, (DEVICE)))
+
+#else
+
+#define RECORD_AL_CALL()
+
+/** Check the result of an AL call.
+ *
+ * @return TRUE if the call was successful.
+ */
+#define CHECK_AL_CALL() CHECK_AL_RESULT()
 
 /** Check the result of an ALC call, logging an error if necessary.
  *
@@ -40,6 +85,47 @@
  */
 #define CHECK_ALC_CALL(DEVICE) checkIfSuccessfulWithDevice(__PRETTY_FUNCTION__, (DEVICE))
 
+#endif /* OBJECTAL_CFG_COLLECT_STATS */
+
+/** Get ready to make an OpenAL call that isn't queued, by waiting until the queued
+ * commands ahead of it have been executed (if the command thread is enabled).
+ *
+ * @param lock The object the call synchronizes on.
+ * @return The lock.
+ */
+static inline id beginAlCall(id lock)
+{
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	[ALCommandThread waitUntilDone];
+#endif
+	return lock;
+}
+
+/* SYNCHRONIZED_AL_CALL(A) synchronizes an OpenAL call. It expands to a single statement,
+ * so it's safe after an unbraced "if". <br>
+ *
+ * Never call another SYNCHRONIZED_AL_CALL method from inside one: with the command thread
+ * enabled, the inner call would wait for the command thread while holding the lock the
+ * command thread needs.
+ */
+#if OBJECTAL_CFG_COLLECT_STATS
+
+/** Synchronize an OpenAL call, with its start time in scope for RECORD_AL_CALL()
+ * (in a loop that runs its body once).
+ */
+#define SYNCHRONIZED_AL_CALL(A) \
+	for(uint64_t alCallStartTime = (beginAlCall(nil), mach_absolute_time()), alCallPending = 1; \
+		alCallPending; \
+		alCallPending = 0) \
+		@synchronized(A)
+
+#else
+
+/** Synchronize an OpenAL call. */
+#define SYNCHRONIZED_AL_CALL(A) @synchronized(beginAlCall(A))
+
+#endif /* OBJECTAL_CFG_COLLECT_STATS */
+
 
 /**
  * Private interface to ALWrapper.
@@ -93,6 +179,29 @@ static alcMacOSXGetMixerOutputRateProcPtr alcGetMacOSXMixerOutputRate = NULL;
 static alcMacOSXMixerOutputRateProcPtr alcMacOSXMixerOutputRate = NULL;
 static alBufferDataStaticProcPtr alBufferDataStatic = NULL;
 
+typedef ALvoid AL_APIENTRY (*alDeferUpdatesSOFTProcPtr) (void);
+typedef ALvoid AL_APIENTRY (*alProcessUpdatesSOFTProcPtr) (void);
+
+static alDeferUpdatesSOFTProcPtr alDeferUpdatesSOFT = NULL;
+static alProcessUpdatesSOFTProcPtr alProcessUpdatesSOFT = NULL;
+/** If true, we've already looked for the AL_SOFT_deferred_updates procs. */
+static bool deferredUpdatesResolved = NO;
+
+typedef ALCdevice* ALC_APIENTRY (*alcLoopbackOpenDeviceSOFTProcPtr) (const ALCchar* deviceName);
+typedef ALCboolean ALC_APIENTRY (*alcIsRenderFormatSupportedSOFTProcPtr) (ALCdevice* device,
+																		  ALCsizei freq,
+																		  ALCenum channels,
+																		  ALCenum type);
+typedef void ALC_APIENTRY (*alcRenderSamplesSOFTProcPtr) (ALCdevice* device,
+														  ALCvoid* buffer,
+														  ALCsizei samples);
+
+static alcLoopbackOpenDeviceSOFTProcPtr alcLoopbackOpenDeviceSOFT = NULL;
+static alcIsRenderFormatSupportedSOFTProcPtr alcIsRenderFormatSupportedSOFT = NULL;
+static alcRenderSamplesSOFTProcPtr alcRenderSamplesSOFT = NULL;
+/** If true, we've already looked for the ALC_SOFT_loopback procs. */
+static bool loopbackResolved = NO;
+
 
 #pragma mark -
 #pragma mark Error Handling
@@ -108,6 +217,90 @@ BOOL checkIfSuccessful(const char* contextInfo)
 	return YES;
 }
 
+#if OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_SAMPLED || OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_PER_FRAME
+
+/** The most recent calls made, for reporting when an error turns up (ring buffer). */
+static const char* callSites[kALErrorCallSiteHistory];
+
+/** The total number of calls recorded. */
+static unsigned int numCallSites = 0;
+
+/** The value of numCallSites at the last error check. */
+static unsigned int numCallSitesAtLastCheck = 0;
+
+/** Remember a call for error reporting.  Must be called from inside a synchronized block.
+ *
+ * @param contextInfo The call being made.
+ * @return TRUE (the call's success is unknown until the next check).
+ */
+static inline BOOL recordCallSite(const char* contextInfo)
+{
+	callSites[numCallSites++ & (kALErrorCallSiteHistory - 1)] = contextInfo;
+	return YES;
+}
+
+/** Check the OpenAL error status, and log the calls made since the last check if there
+ * was an error.  Must be called from inside a synchronized block.
+ *
+ * @return TRUE if there was no error.
+ */
+static BOOL checkRecordedCallSites(void)
+{
+	unsigned int numCalls = numCallSites - numCallSitesAtLastCheck;
+	numCallSitesAtLastCheck = numCallSites;
+	
+	ALenum error = alGetError();
+	if(AL_NO_ERROR == error)
+	{
+		return YES;
+	}
+	
+	unsigned int numRemembered = numCalls < kALErrorCallSiteHistory ? numCalls : kALErrorCallSiteHistory;
+	NSMutableString* calls = [NSMutableString stringWithCapacity:numRemembered * 64];
+	for(unsigned int i = numCallSites - numRemembered; i != numCallSites; i++)
+	{
+		[calls appendFormat:@"\n    %s", callSites[i & (kALErrorCallSiteHistory - 1)]];
+	}
+	OAL_LOG_ERROR(@"%s (error code 0x%08x) in one of the last %d calls (%d shown, oldest first):%@",
+				  alGetString(error), error, numCalls, numRemembered, calls);
+	return NO;
+}
+
+#endif
+
+#if OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_SAMPLED
+
+/** Record a call, and check the OpenAL error status every kALErrorCheckSampleInterval calls.
+ * Must be called from inside a synchronized block.
+ *
+ * @param contextInfo The call being made.
+ * @return TRUE (the call's success is unknown unless it was checked).
+ */
+static inline BOOL checkIfSuccessfulSampled(const char* contextInfo)
+{
+	recordCallSite(contextInfo);
+	if(numCallSites - numCallSitesAtLastCheck >= kALErrorCheckSampleInterval)
+	{
+		checkRecordedCallSites();
+	}
+	return YES;
+}
+
+#endif
+
+#if OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_OFF
+
+/** Stand-in for an error check when error checking is off.
+ *
+ * @return TRUE.
+ */
+static inline BOOL assumeSuccessful(void)
+{
+	return YES;
+}
+
+#endif
+
 BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 {
 	ALenum error = alcGetError(device);
@@ -177,7 +370,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) enable:(ALenum) capability
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alEnable(capability);
 		result = CHECK_AL_CALL();
@@ -188,7 +381,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) disable:(ALenum) capability
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alDisable(capability);
 		result = CHECK_AL_CALL();
@@ -199,7 +392,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) isEnabled:(ALenum) capability
 {
 	ALboolean result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alIsEnabled(capability);
 		CHECK_AL_CALL();
@@ -213,7 +406,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) isExtensionPresent:(NSString*) extensionName
 {
 	ALboolean result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alIsExtensionPresent([extensionName UTF8String]);
 		CHECK_AL_CALL();
@@ -224,7 +417,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (void*) getProcAddress:(NSString*) functionName
 {
 	void* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetProcAddress([functionName UTF8String]);
 		CHECK_AL_CALL();
@@ -235,7 +428,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALenum) getEnumValue:(NSString*) enumName
 {
 	ALenum result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetEnumValue([enumName UTF8String]);
 		CHECK_AL_CALL();
@@ -250,9 +443,10 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALCdevice*) openDevice:(NSString*) deviceName
 {
 	ALCdevice* device;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		device = alcOpenDevice([deviceName UTF8String]);
+		RECORD_AL_CALL();
 		if(NULL == device)
 		{
 			OAL_LOG_ERROR(@"Could not open device %@", deviceName);
@@ -264,7 +458,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) closeDevice:(ALCdevice*) device
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcCloseDevice(device);
 		result = CHECK_ALC_CALL(device);
@@ -278,7 +472,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) isExtensionPresent:(ALCdevice*) device name:(NSString*) extensionName
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcIsExtensionPresent(device, [extensionName UTF8String]);
 		CHECK_ALC_CALL(device);
@@ -289,7 +483,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (void*) getProcAddress:(ALCdevice*) device name:(NSString*) functionName
 {
 	void* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcGetProcAddress(device, [functionName UTF8String]);
 		CHECK_ALC_CALL(device);
@@ -300,7 +494,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALenum) getEnumValue:(ALCdevice*) device name:(NSString*) enumName
 {
 	ALenum result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcGetEnumValue(device, [enumName UTF8String]);
 		CHECK_ALC_CALL(device);
@@ -314,7 +508,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (NSString*) getString:(ALCdevice*) device attribute:(ALenum) attribute
 {
 	const ALCchar* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcGetString(device, attribute);
 		CHECK_ALC_CALL(device);
@@ -325,7 +519,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (NSArray*) getNullSeparatedStringList:(ALCdevice*) device attribute:(ALenum) attribute
 {
 	const ALCchar* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcGetString(device, attribute);
 		CHECK_ALC_CALL(device);
@@ -336,7 +530,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (NSArray*) getSpaceSeparatedStringList:(ALCdevice*) device attribute:(ALenum) attribute
 {
 	const ALCchar* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcGetString(device, attribute);
 		CHECK_ALC_CALL(device);
@@ -354,7 +548,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getIntegerv:(ALCdevice*) device attribute:(ALenum) attribute size:(ALsizei) size data:(ALCint*) data
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcGetIntegerv(device, attribute, size, data);
 		result = CHECK_ALC_CALL(device);
@@ -368,9 +562,10 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALCdevice*) openCaptureDevice:(NSString*) deviceName frequency:(ALCuint) frequency format:(ALCenum) format bufferSize:(ALCsizei) bufferSize
 {
 	ALCdevice* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcCaptureOpenDevice([deviceName UTF8String], frequency, format, bufferSize);
+		RECORD_AL_CALL();
 		if(nil == result)
 		{
 			OAL_LOG_ERROR(@"Could not open capture device %@", deviceName);
@@ -382,7 +577,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) closeCaptureDevice:(ALCdevice*) device
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcCaptureCloseDevice(device);
 		result = CHECK_ALC_CALL(device);
@@ -393,7 +588,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) startCapture:(ALCdevice*) device
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcCaptureStop(device);
 		result = CHECK_ALC_CALL(device);
@@ -404,7 +599,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) stopCapture:(ALCdevice*) device
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcCaptureStop(device);
 		result = CHECK_ALC_CALL(device);
@@ -415,7 +610,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) captureSamples:(ALCdevice*) device buffer:(ALCvoid*) buffer numSamples:(ALCsizei) numSamples
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcCaptureSamples(device, buffer, numSamples);
 		result = CHECK_ALC_CALL(device);
@@ -430,7 +625,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALCcontext*) createContext:(ALCdevice*) device attributes:(ALCint*) attributes
 {
 	ALCcontext* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcCreateContext(device, attributes);
 		CHECK_ALC_CALL(device);
@@ -445,7 +640,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) makeContextCurrent:(ALCcontext*) context deviceReference:(ALCdevice*) deviceReference
 {
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		if(!alcMakeContextCurrent(context))
 		{
@@ -465,27 +660,30 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (void) processContext:(ALCcontext*) context
 {
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcProcessContext(context);
+		RECORD_AL_CALL();
 		// No way to check for error from here
 	}
 }
 
 + (void) suspendContext:(ALCcontext*) context
 {
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcSuspendContext(context);
+		RECORD_AL_CALL();
 		// No way to check for error from here
 	}
 }
 
 + (void) destroyContext:(ALCcontext*) context
 {
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alcDestroyContext(context);
+		RECORD_AL_CALL();
 		// No way to check for error from here
 	}
 }
@@ -493,9 +691,10 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALCcontext*) getCurrentContext
 {
 	ALCcontext* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcGetCurrentContext();
+		RECORD_AL_CALL();
 	}
 	return result;
 }
@@ -508,7 +707,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALCdevice*) getContextsDevice:(ALCcontext*) context deviceReference:(ALCdevice*) deviceReference
 {
 	ALCdevice* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		if(nil == (result = alcGetContextsDevice(context)))
 		{
@@ -531,7 +730,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getBoolean:(ALenum) parameter
 {
 	ALboolean result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetBoolean(parameter);
 		CHECK_AL_CALL();
@@ -542,7 +741,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALdouble) getDouble:(ALenum) parameter
 {
 	ALdouble result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetDouble(parameter);
 		CHECK_AL_CALL();
@@ -553,7 +752,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALfloat) getFloat:(ALenum) parameter
 {
 	ALfloat result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetFloat(parameter);
 		CHECK_AL_CALL();
@@ -564,7 +763,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALint) getInteger:(ALenum) parameter
 {
 	ALint result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetInteger(parameter);
 		CHECK_AL_CALL();
@@ -575,7 +774,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (NSString*) getString:(ALenum) parameter
 {
 	const ALchar* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetString(parameter);
 		CHECK_AL_CALL();
@@ -586,7 +785,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (NSArray*) getNullSeparatedStringList:(ALenum) parameter
 {
 	const ALchar* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetString(parameter);
 		CHECK_AL_CALL();
@@ -597,7 +796,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (NSArray*) getSpaceSeparatedStringList:(ALenum) parameter
 {
 	const ALchar* result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alGetString(parameter);
 		CHECK_AL_CALL();
@@ -608,7 +807,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getBooleanv:(ALenum) parameter values:(ALboolean*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetBooleanv(parameter, values);
 		result = CHECK_AL_CALL();
@@ -619,7 +818,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getDoublev:(ALenum) parameter values:(ALdouble*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetDoublev(parameter, values);
 		result = CHECK_AL_CALL();
@@ -630,7 +829,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getFloatv:(ALenum) parameter values:(ALfloat*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetFloatv(parameter, values);
 		result = CHECK_AL_CALL();
@@ -641,7 +840,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getIntegerv:(ALenum) parameter values:(ALint*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetIntegerv(parameter, values);
 		result = CHECK_AL_CALL();
@@ -652,7 +851,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) distanceModel:(ALenum) value
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alDistanceModel(value);
 		result = CHECK_AL_CALL();
@@ -663,7 +862,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) dopplerFactor:(ALfloat) value
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alDopplerFactor(value);
 		result = CHECK_AL_CALL();
@@ -674,7 +873,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) speedOfSound:(ALfloat) value
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSpeedOfSound(value);
 		result = CHECK_AL_CALL();
@@ -688,30 +887,40 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) listenerf:(ALenum) parameter value:(ALfloat) value
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_LISTENERF, 0, parameter, {{value}}};
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alListenerf(parameter, value);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) listener3f:(ALenum) parameter v1:(ALfloat) v1 v2:(ALfloat) v2 v3:(ALfloat) v3
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_LISTENER3F, 0, parameter, {{v1, v2, v3}}};
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alListener3f(parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) listenerfv:(ALenum) parameter values:(ALfloat*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alListenerfv(parameter, values);
 		result = CHECK_AL_CALL();
@@ -721,30 +930,44 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) listeneri:(ALenum) parameter value:(ALint) value
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_LISTENERI, 0, parameter, {{0}}};
+	command.values.i[0] = value;
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alListeneri(parameter, value);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) listener3i:(ALenum) parameter v1:(ALint) v1 v2:(ALint) v2 v3:(ALint) v3
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_LISTENER3I, 0, parameter, {{0}}};
+	command.values.i[0] = v1;
+	command.values.i[1] = v2;
+	command.values.i[2] = v3;
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alListener3i(parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) listeneriv:(ALenum) parameter values:(ALint*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alListeneriv(parameter, values);
 		result = CHECK_AL_CALL();
@@ -756,7 +979,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALfloat) getListenerf:(ALenum) parameter
 {
 	ALfloat value;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetListenerf(parameter, &value);
 		CHECK_AL_CALL();
@@ -767,7 +990,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getListener3f:(ALenum) parameter v1:(ALfloat*) v1 v2:(ALfloat*) v2 v3:(ALfloat*) v3
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetListener3f(parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
@@ -778,7 +1001,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getListenerfv:(ALenum) parameter values:(ALfloat*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetListenerfv(parameter, values);
 		result = CHECK_AL_CALL();
@@ -789,7 +1012,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALint) getListeneri:(ALenum) parameter
 {
 	ALint value;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetListeneri(parameter, &value);
 		CHECK_AL_CALL();
@@ -800,7 +1023,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getListener3i:(ALenum) parameter v1:(ALint*) v1 v2:(ALint*) v2 v3:(ALint*) v3
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetListener3i(parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
@@ -811,7 +1034,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getListeneriv:(ALenum) parameter values:(ALint*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetListeneriv(parameter, values);
 		result = CHECK_AL_CALL();
@@ -826,7 +1049,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) genSources:(ALuint*) sourceIds numSources:(ALsizei) numSources
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGenSources(numSources, sourceIds);
 		result = CHECK_AL_CALL();
@@ -836,10 +1059,11 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (ALuint) genSource
 {
-	ALuint sourceId;
-	@synchronized(self)
+	// A failed gen leaves this untouched, and not every error checking mode notices.
+	ALuint sourceId = (ALuint)AL_INVALID;
+	SYNCHRONIZED_AL_CALL(self)
 	{
-		[self genSources:&sourceId numSources:1];
+		alGenSources(1, &sourceId);
 		sourceId = CHECK_AL_CALL() ? sourceId : (ALuint)AL_INVALID;
 	}
 	return sourceId;
@@ -848,7 +1072,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) deleteSources:(ALuint*) sourceIds numSources:(ALsizei) numSources
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alDeleteSources(numSources, sourceIds);
 		result = CHECK_AL_CALL();
@@ -859,9 +1083,9 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) deleteSource:(ALuint) sourceId
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
-		[self deleteSources:&sourceId numSources:1];
+		alDeleteSources(1, &sourceId);
 		result = CHECK_AL_CALL();
 	}
 	return result;
@@ -870,7 +1094,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) isSource:(ALuint) sourceId
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alIsSource(sourceId);
 		CHECK_AL_CALL();
@@ -883,30 +1107,40 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) sourcef:(ALuint) sourceId parameter:(ALenum) parameter value:(ALfloat) value
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_SOURCEF, sourceId, parameter, {{value}}};
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourcef(sourceId, parameter, value);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) source3f:(ALuint) sourceId parameter:(ALenum) parameter v1:(ALfloat) v1 v2:(ALfloat) v2 v3:(ALfloat) v3
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_SOURCE3F, sourceId, parameter, {{v1, v2, v3}}};
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSource3f(sourceId, parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) sourcefv:(ALuint) sourceId parameter:(ALenum) parameter values:(ALfloat*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourcefv(sourceId, parameter, values);
 		result = CHECK_AL_CALL();
@@ -916,30 +1150,44 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) sourcei:(ALuint) sourceId parameter:(ALenum) parameter value:(ALint) value
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_SOURCEI, sourceId, parameter, {{0}}};
+	command.values.i[0] = value;
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourcei(sourceId, parameter, value);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) source3i:(ALuint) sourceId parameter:(ALenum) parameter v1:(ALint) v1 v2:(ALint) v2 v3:(ALint) v3
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_SOURCE3I, sourceId, parameter, {{0}}};
+	command.values.i[0] = v1;
+	command.values.i[1] = v2;
+	command.values.i[2] = v3;
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSource3i(sourceId, parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) sourceiv:(ALuint) sourceId parameter:(ALenum) parameter values:(ALint*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourceiv(sourceId, parameter, values);
 		result = CHECK_AL_CALL();
@@ -951,7 +1199,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALfloat) getSourcef:(ALuint) sourceId parameter:(ALenum) parameter
 {
 	ALfloat value;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetSourcef(sourceId, parameter, &value);
 		CHECK_AL_CALL();
@@ -962,7 +1210,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getSource3f:(ALuint) sourceId parameter:(ALenum) parameter v1:(ALfloat*) v1 v2:(ALfloat*) v2 v3:(ALfloat*) v3
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetSource3f(sourceId, parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
@@ -973,7 +1221,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getSourcefv:(ALuint) sourceId parameter:(ALenum) parameter values:(ALfloat*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetSourcefv(sourceId, parameter, values);
 		result = CHECK_AL_CALL();
@@ -984,7 +1232,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALint) getSourcei:(ALuint) sourceId parameter:(ALenum) parameter
 {
 	ALint value;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetSourcei(sourceId, parameter, &value);
 		CHECK_AL_CALL();
@@ -992,10 +1240,27 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 	return value;
 }
 
++ (bool) getSourcesi:(ALuint*) sourceIds
+		  numSources:(ALsizei) numSources
+		   parameter:(ALenum) parameter
+			  values:(ALint*) values
+{
+	bool result;
+	SYNCHRONIZED_AL_CALL(self)
+	{
+		for(ALsizei i = 0; i < numSources; i++)
+		{
+			alGetSourcei(sourceIds[i], parameter, &values[i]);
+		}
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
 + (bool) getSource3i:(ALuint) sourceId parameter:(ALenum) parameter v1:(ALint*) v1 v2:(ALint*) v2 v3:(ALint*) v3
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetSource3i(sourceId, parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
@@ -1006,7 +1271,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getSourceiv:(ALuint) sourceId parameter:(ALenum) parameter values:(ALint*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetSourceiv(sourceId, parameter, values);
 		result = CHECK_AL_CALL();
@@ -1019,19 +1284,24 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) sourcePlay:(ALuint) sourceId
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_SOURCE_PLAY, sourceId, 0, {{0}}};
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourcePlay(sourceId);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) sourcePlayv:(ALuint*) sourceIds numSources:(ALsizei) numSources
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourcePlayv(numSources, sourceIds);
 		result = CHECK_AL_CALL();
@@ -1041,19 +1311,24 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) sourcePause:(ALuint) sourceId
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_SOURCE_PAUSE, sourceId, 0, {{0}}};
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourcePause(sourceId);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) sourcePausev:(ALuint*) sourceIds numSources:(ALsizei) numSources
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourcePausev(numSources, sourceIds);
 		result = CHECK_AL_CALL();
@@ -1063,19 +1338,24 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) sourceStop:(ALuint) sourceId
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_SOURCE_STOP, sourceId, 0, {{0}}};
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourceStop(sourceId);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) sourceStopv:(ALuint*) sourceIds numSources:(ALsizei) numSources
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourceStopv(numSources, sourceIds);
 		result = CHECK_AL_CALL();
@@ -1085,19 +1365,24 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (bool) sourceRewind:(ALuint) sourceId
 {
+#if OBJECTAL_CFG_AUDIO_COMMAND_THREAD
+	oal_command command = {OAL_COMMAND_SOURCE_REWIND, sourceId, 0, {{0}}};
+	return [ALCommandThread submit:&command];
+#else
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourceRewind(sourceId);
 		result = CHECK_AL_CALL();
 	}
 	return result;
+#endif
 }
 
 + (bool) sourceRewindv:(ALuint*) sourceIds numSources:(ALsizei) numSources
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourceRewindv(numSources, sourceIds);
 		result = CHECK_AL_CALL();
@@ -1108,7 +1393,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) sourceQueueBuffers:(ALuint) sourceId numBuffers:(ALsizei) numBuffers bufferIds:(ALuint*) bufferIds
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourceQueueBuffers(sourceId, numBuffers, bufferIds);
 		result = CHECK_AL_CALL();
@@ -1119,7 +1404,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) sourceUnqueueBuffers:(ALuint) sourceId numBuffers:(ALsizei) numBuffers bufferIds:(ALuint*) bufferIds
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alSourceUnqueueBuffers(sourceId, numBuffers, bufferIds);
 		result = CHECK_AL_CALL();
@@ -1134,7 +1419,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) genBuffers:(ALuint*) bufferIds numBuffers:(ALsizei) numBuffers
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGenBuffers(numBuffers, bufferIds);
 		result = CHECK_AL_CALL();
@@ -1144,10 +1429,11 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 
 + (ALuint) genBuffer
 {
-	ALuint bufferId;
-	@synchronized(self)
+	// A failed gen leaves this untouched, and not every error checking mode notices.
+	ALuint bufferId = (ALuint)AL_INVALID;
+	SYNCHRONIZED_AL_CALL(self)
 	{
-		[self genBuffers:&bufferId numBuffers:1];
+		alGenBuffers(1, &bufferId);
 		bufferId = CHECK_AL_CALL() ? bufferId : (ALuint)AL_INVALID;
 	}
 	return bufferId;
@@ -1156,7 +1442,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) deleteBuffers:(ALuint*) bufferIds numBuffers:(ALsizei) numBuffers
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alDeleteBuffers(numBuffers, bufferIds);
 		result = CHECK_AL_CALL();
@@ -1167,9 +1453,9 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) deleteBuffer:(ALuint) bufferId
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
-		[self deleteBuffers:&bufferId numBuffers:1];
+		alDeleteBuffers(1, &bufferId);
 		result = CHECK_AL_CALL();
 	}
 	return result;
@@ -1178,7 +1464,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) isBuffer:(ALuint) bufferId
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alIsBuffer(bufferId);
 		CHECK_AL_CALL();
@@ -1189,7 +1475,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) bufferData:(ALuint) bufferId format:(ALenum) format data:(const ALvoid*) data size:(ALsizei) size frequency:(ALsizei) frequency
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alBufferData(bufferId, format, data, size, frequency);
 		result = CHECK_AL_CALL();
@@ -1203,7 +1489,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) bufferf:(ALuint) bufferId parameter:(ALenum) parameter value:(ALfloat) value
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alBufferf(bufferId, parameter, value);
 		result = CHECK_AL_CALL();
@@ -1214,7 +1500,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) buffer3f:(ALuint) bufferId parameter:(ALenum) parameter v1:(ALfloat) v1 v2:(ALfloat) v2 v3:(ALfloat) v3
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alBuffer3f(bufferId, parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
@@ -1225,7 +1511,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) bufferfv:(ALuint) bufferId parameter:(ALenum) parameter values:(ALfloat*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alBufferfv(bufferId, parameter, values);
 		result = CHECK_AL_CALL();
@@ -1236,7 +1522,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) bufferi:(ALuint) bufferId parameter:(ALenum) parameter value:(ALint) value
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alBufferi(bufferId, parameter, value);
 		result = CHECK_AL_CALL();
@@ -1247,7 +1533,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) buffer3i:(ALuint) bufferId parameter:(ALenum) parameter v1:(ALint) v1 v2:(ALint) v2 v3:(ALint) v3
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alBuffer3i(bufferId, parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
@@ -1258,7 +1544,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) bufferiv:(ALuint) bufferId parameter:(ALenum) parameter values:(ALint*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alBufferiv(bufferId, parameter, values);
 		result = CHECK_AL_CALL();
@@ -1270,7 +1556,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALfloat) getBufferf:(ALuint) bufferId parameter:(ALenum) parameter
 {
 	ALfloat value;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetBufferf(bufferId, parameter, &value);
 		CHECK_AL_CALL();
@@ -1281,7 +1567,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getBuffer3f:(ALuint) bufferId parameter:(ALenum) parameter v1:(ALfloat*) v1 v2:(ALfloat*) v2 v3:(ALfloat*) v3
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetBuffer3f(bufferId, parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
@@ -1292,7 +1578,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getBufferfv:(ALuint) bufferId parameter:(ALenum) parameter values:(ALfloat*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetBufferfv(bufferId, parameter, values);
 		result = CHECK_AL_CALL();
@@ -1303,7 +1589,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (ALint) getBufferi:(ALuint) bufferId parameter:(ALenum) parameter
 {
 	ALint value;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetBufferi(bufferId, parameter, &value);
 		CHECK_AL_CALL();
@@ -1314,7 +1600,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getBuffer3i:(ALuint) bufferId parameter:(ALenum) parameter v1:(ALint*) v1 v2:(ALint*) v2 v3:(ALint*) v3
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetBuffer3i(bufferId, parameter, v1, v2, v3);
 		result = CHECK_AL_CALL();
@@ -1325,7 +1611,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 + (bool) getBufferiv:(ALuint) bufferId parameter:(ALenum) parameter values:(ALint*) values
 {
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alGetBufferiv(bufferId, parameter, values);
 		result = CHECK_AL_CALL();
@@ -1349,7 +1635,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 	}
 	
 	ALdouble result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		result = alcGetMacOSXMixerOutputRate();
 		CHECK_AL_CALL();
@@ -1383,7 +1669,7 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 	}
 	
 	bool result;
-	@synchronized(self)
+	SYNCHRONIZED_AL_CALL(self)
 	{
 		alBufferDataStatic(bufferId, format, data, size, frequency);
 		result = CHECK_AL_CALL();
@@ -1391,4 +1677,272 @@ BOOL checkIfSuccessfulWithDevice(const char* contextInfo, ALCdevice* device)
 	return result;
 }
 
+
+
+#pragma mark -
+#pragma mark AL_SOFT_deferred_updates Extension
+
++ (bool) deferredUpdatesSupported
+{
+	SYNCHRONIZED_AL_CALL(self)
+	{
+		if(!deferredUpdatesResolved)
+		{
+			deferredUpdatesResolved = YES;
+			if(alIsExtensionPresent("AL_SOFT_deferred_updates"))
+			{
+				alDeferUpdatesSOFT = (alDeferUpdatesSOFTProcPtr) alGetProcAddress("alDeferUpdatesSOFT");
+				alProcessUpdatesSOFT = (alProcessUpdatesSOFTProcPtr) alGetProcAddress("alProcessUpdatesSOFT");
+			}
+			if(NULL == alDeferUpdatesSOFT || NULL == alProcessUpdatesSOFT)
+			{
+				alDeferUpdatesSOFT = NULL;
+				alProcessUpdatesSOFT = NULL;
+				OAL_LOG_INFO(@"AL_SOFT_deferred_updates is not available.");
+			}
+		}
+		return NULL != alDeferUpdatesSOFT;
+	}
+}
+
++ (bool) deferUpdates
+{
+	if(![self deferredUpdatesSupported])
+	{
+		return NO;
+	}
+	bool result;
+	SYNCHRONIZED_AL_CALL(self)
+	{
+		alDeferUpdatesSOFT();
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
++ (bool) processUpdates
+{
+	if(![self deferredUpdatesSupported])
+	{
+		return NO;
+	}
+	bool result;
+	SYNCHRONIZED_AL_CALL(self)
+	{
+		alProcessUpdatesSOFT();
+		result = CHECK_AL_CALL();
+	}
+	return result;
+}
+
+
+#pragma mark -
+#pragma mark ALC_SOFT_loopback Extension
+
++ (bool) loopbackSupported
+{
+	SYNCHRONIZED_AL_CALL(self)
+	{
+		if(!loopbackResolved)
+		{
+			loopbackResolved = YES;
+			if(alcIsExtensionPresent(NULL, "ALC_SOFT_loopback"))
+			{
+				alcLoopbackOpenDeviceSOFT = (alcLoopbackOpenDeviceSOFTProcPtr) alcGetProcAddress(NULL, "alcLoopbackOpenDeviceSOFT");
+				alcIsRenderFormatSupportedSOFT = (alcIsRenderFormatSupportedSOFTProcPtr) alcGetProcAddress(NULL, "alcIsRenderFormatSupportedSOFT");
+				alcRenderSamplesSOFT = (alcRenderSamplesSOFTProcPtr) alcGetProcAddress(NULL, "alcRenderSamplesSOFT");
+			}
+			if(NULL == alcLoopbackOpenDeviceSOFT || NULL == alcIsRenderFormatSupportedSOFT || NULL == alcRenderSamplesSOFT)
+			{
+				alcLoopbackOpenDeviceSOFT = NULL;
+				alcIsRenderFormatSupportedSOFT = NULL;
+				alcRenderSamplesSOFT = NULL;
+				OAL_LOG_INFO(@"ALC_SOFT_loopback is not available.");
+			}
+		}
+		return NULL != alcLoopbackOpenDeviceSOFT;
+	}
+}
+
++ (ALCdevice*) openLoopbackDevice:(NSString*) deviceName
+{
+	if(![self loopbackSupported])
+	{
+		OAL_LOG_ERROR(@"Could not open loopback device: ALC_SOFT_loopback is not available");
+		return NULL;
+	}
+	ALCdevice* device;
+	SYNCHRONIZED_AL_CALL(self)
+	{
+		device = alcLoopbackOpenDeviceSOFT([deviceName UTF8String]);
+		RECORD_AL_CALL();
+		if(NULL == device)
+		{
+			OAL_LOG_ERROR(@"Could not open loopback device %@", deviceName);
+		}
+	}
+	return device;
+}
+
++ (bool) isRenderFormatSupported:(ALCdevice*) device
+					   frequency:(ALCsizei) frequency
+						channels:(ALCenum) channels
+							type:(ALCenum) type
+{
+	if(![self loopbackSupported])
+	{
+		return NO;
+	}
+	bool result;
+	SYNCHRONIZED_AL_CALL(self)
+	{
+		result = alcIsRenderFormatSupportedSOFT(device, frequency, channels, type);
+		CHECK_ALC_CALL(device);
+	}
+	return result;
+}
+
++ (bool) renderSamples:(ALCdevice*) device
+				buffer:(ALCvoid*) buffer
+			numSamples:(ALCsizei) numSamples
+{
+	if(![self loopbackSupported])
+	{
+		return NO;
+	}
+	bool result;
+	SYNCHRONIZED_AL_CALL(self)
+	{
+		alcRenderSamplesSOFT(device, buffer, numSamples);
+		result = CHECK_ALC_CALL(device);
+	}
+	return result;
+}
+
+
+#pragma mark -
+#pragma mark Error Checking
+
++ (bool) checkErrors
+{
+	bool result;
+	SYNCHRONIZED_AL_CALL(self)
+	{
+#if OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_SAMPLED || OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_PER_FRAME
+		result = checkRecordedCallSites();
+#else
+		result = checkIfSuccessful(__PRETTY_FUNCTION__);
+#endif
+	}
+	return result;
+}
+
+
+#pragma mark -
+#pragma mark Command Queue
+
+#if OBJECTAL_CFG_COLLECT_STATS
+/** Names that queued commands are recorded under in the statistics (indexed by oal_command_type). */
+static const char* queuedCommandNames[] =
+{
+	"queued alSourcef",
+	"queued alSource3f",
+	"queued alSourcei",
+	"queued alSource3i",
+	"queued alSourcePlay",
+	"queued alSourcePause",
+	"queued alSourceStop",
+	"queued alSourceRewind",
+	"queued alListenerf",
+	"queued alListener3f",
+	"queued alListeneri",
+	"queued alListener3i",
+};
+#endif
+
++ (void) executeCommands:(const oal_command*) commands numCommands:(unsigned int) numCommands
+{
+	@synchronized(self)
+	{
+		for(unsigned int i = 0; i < numCommands; i++)
+		{
+			const oal_command* command = &commands[i];
+#if OBJECTAL_CFG_COLLECT_STATS
+			uint64_t commandStartTime = mach_absolute_time();
+#endif
+			switch(command->type)
+			{
+				case OAL_COMMAND_SOURCEF:
+					alSourcef(command->object, command->parameter, command->values.f[0]);
+					break;
+				case OAL_COMMAND_SOURCE3F:
+					alSource3f(command->object,
+							   command->parameter,
+							   command->values.f[0],
+							   command->values.f[1],
+							   command->values.f[2]);
+					break;
+				case OAL_COMMAND_SOURCEI:
+					alSourcei(command->object, command->parameter, command->values.i[0]);
+					break;
+				case OAL_COMMAND_SOURCE3I:
+					alSource3i(command->object,
+							   command->parameter,
+							   command->values.i[0],
+							   command->values.i[1],
+							   command->values.i[2]);
+					break;
+				case OAL_COMMAND_SOURCE_PLAY:
+					alSourcePlay(command->object);
+					break;
+				case OAL_COMMAND_SOURCE_PAUSE:
+					alSourcePause(command->object);
+					break;
+				case OAL_COMMAND_SOURCE_STOP:
+					alSourceStop(command->object);
+					break;
+				case OAL_COMMAND_SOURCE_REWIND:
+					alSourceRewind(command->object);
+					break;
+				case OAL_COMMAND_LISTENERF:
+					alListenerf(command->parameter, command->values.f[0]);
+					break;
+				case OAL_COMMAND_LISTENER3F:
+					alListener3f(command->parameter,
+								 command->values.f[0],
+								 command->values.f[1],
+								 command->values.f[2]);
+					break;
+				case OAL_COMMAND_LISTENERI:
+					alListeneri(command->parameter, command->values.i[0]);
+					break;
+				case OAL_COMMAND_LISTENER3I:
+					alListener3i(command->parameter,
+								 command->values.i[0],
+								 command->values.i[1],
+								 command->values.i[2]);
+					break;
+				default:
+					OAL_LOG_ERROR(@"Unknown audio command type %d", command->type);
+					continue;
+			}
+#if OBJECTAL_CFG_COLLECT_STATS
+			oal_stats_record(queuedCommandNames[command->type], mach_absolute_time() - commandStartTime);
+#endif
+			
+#if OBJECTAL_CFG_AL_ERROR_CHECKING == OBJECTAL_AL_ERROR_CHECKING_ALWAYS
+			// Report which command failed, since the caller that queued it is long gone.
+			ALenum error = alGetError();
+			if(AL_NO_ERROR != error)
+			{
+				OAL_LOG_ERROR(@"Queued command %d (source %d, parameter 0x%04x) failed: %s (error code 0x%08x)",
+							  command->type, command->object, command->parameter, alGetString(error), error);
+			}
+#else
+			CHECK_AL_RESULT();
+#endif
+		}
+	}
+}
+
 @end
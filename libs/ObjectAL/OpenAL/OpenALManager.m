@@ -28,7 +28,9 @@
 #import "ObjectALMacros.h"
 #import "ALWrapper.h"
 #import "NSMutableArray+WeakReferences.h"
+#if TARGET_OS_IPHONE
 #import "OALAudioSupport.h"
+#endif
 
 
 #pragma mark OpenALManager
@@ -44,8 +46,10 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OpenALManager);
 {
 	if(nil != (self = [super init]))
 	{
+#if TARGET_OS_IPHONE
 		// Make sure OALAudioSupport is initialized.
 		[OALAudioSupport sharedInstance];
+#endif
 		
 		devices = [[NSMutableArray mutableArrayUsingWeakReferencesWithCapacity:5] retain];
 	}
@@ -0,0 +1,122 @@
+//
+//  OALAudioDecoder.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import <OpenAL/al.h>
+
+
+#pragma mark OALAudioDecoder
+
+/**
+ * Turns a sound file into 16 bit native-endian PCM frames that OpenAL can play, with at most
+ * 2 channels. <br>
+ *
+ * Decoders are looked up by file extension through OALAudioDecoderRegistry.
+ */
+@protocol OALAudioDecoder <NSObject>
+
+
+#pragma mark Object Management
+
+/** Open a file for decoding.
+ *
+ * @param url The URL of the file to decode.
+ * @return A new decoder, or nil if the file could not be opened or is not in a format
+ *         this decoder understands.
+ */
++ (id) decoderWithUrl:(NSURL*) url;
+
+
+#pragma mark Properties
+
+/** The OpenAL format of the decoded data (AL_FORMAT_MONO16 or AL_FORMAT_STEREO16). */
+@property(readonly) ALenum format;
+
+/** The sampling frequency in Hz. */
+@property(readonly) ALsizei frequency;
+
+/** The size of one decoded frame in bytes. */
+@property(readonly) uint32_t bytesPerFrame;
+
+/** The total number of frames in the file. */
+@property(readonly) int64_t totalFrames;
+
+
+#pragma mark Decoding
+
+/** Decode frames from the current position.
+ *
+ * @param numFrames The maximum number of frames to decode.
+ * @param buffer Where to put the frames (must hold numFrames * bytesPerFrame bytes).
+ * @return The number of frames decoded, or 0 at the end of the file or on error.
+ */
+- (uint32_t) readFrames:(uint32_t) numFrames into:(void*) buffer;
+
+/** Move the decode position to the specified frame.
+ *
+ * @param frame The frame to seek to.
+ * @return TRUE if successful.
+ */
+- (bool) seekToFrame:(int64_t) frame;
+
+@end
+
+
+
+#pragma mark -
+#pragma mark OALAudioDecoderRegistry
+
+/**
+ * Selects a decoder for a sound file based on its extension. <br>
+ *
+ * WAV files are handled by OALWavDecoder, and Ogg Vorbis files by OALVorbisDecoder if
+ * OBJECTAL_CFG_USE_VORBIS is enabled. Anything else (or anything a registered decoder
+ * declines to open) goes to the default decoder, which on iOS is OALExtAudioDecoder.
+ */
+@interface OALAudioDecoderRegistry : NSObject
+{
+}
+
+
+#pragma mark Registry
+
+/** Register a decoder for a file extension, replacing any previous registration.
+ *
+ * @param decoderClass The decoder class (must conform to OALAudioDecoder).
+ * @param extension The file extension, without the dot (case insensitive).
+ */
++ (void) registerDecoderClass:(Class) decoderClass forExtension:(NSString*) extension;
+
+/** Set the decoder that is tried when no registered decoder can open a file.
+ *
+ * @param decoderClass The decoder class (must conform to OALAudioDecoder), or Nil for none.
+ */
++ (void) setDefaultDecoderClass:(Class) decoderClass;
+
+/** Open a decoder for a file.
+ *
+ * @param url The URL of the file to decode.
+ * @return A decoder, or nil if no decoder could open the file.
+ */
++ (id<OALAudioDecoder>) decoderForUrl:(NSURL*) url;
+
+@end
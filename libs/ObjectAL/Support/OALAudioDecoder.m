@@ -0,0 +1,112 @@
+//
+//  OALAudioDecoder.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALAudioDecoder.h"
+#import "OALWavDecoder.h"
+#import "ObjectALMacros.h"
+#if OBJECTAL_CFG_USE_VORBIS
+#import "OALVorbisDecoder.h"
+#endif
+#if TARGET_OS_IPHONE
+#import "OALExtAudioDecoder.h"
+#endif
+
+
+/** Maps lowercase file extensions to decoder classes. */
+static NSMutableDictionary* decoderClasses = nil;
+
+/** Used when no registered decoder can open a file. */
+static Class defaultDecoderClass = Nil;
+
+
+#pragma mark OALAudioDecoderRegistry
+
+@implementation OALAudioDecoderRegistry
+
++ (void) initialize
+{
+	if(self == [OALAudioDecoderRegistry class])
+	{
+		decoderClasses = [[NSMutableDictionary alloc] initWithCapacity:4];
+		[decoderClasses setObject:[OALWavDecoder class] forKey:@"wav"];
+		[decoderClasses setObject:[OALWavDecoder class] forKey:@"wave"];
+#if OBJECTAL_CFG_USE_VORBIS
+		[decoderClasses setObject:[OALVorbisDecoder class] forKey:@"ogg"];
+#endif
+#if TARGET_OS_IPHONE
+		defaultDecoderClass = [OALExtAudioDecoder class];
+#endif
+	}
+}
+
+
+#pragma mark Registry
+
++ (void) registerDecoderClass:(Class) decoderClass forExtension:(NSString*) extension
+{
+	@synchronized(self)
+	{
+		[decoderClasses setObject:decoderClass forKey:[extension lowercaseString]];
+	}
+}
+
++ (void) setDefaultDecoderClass:(Class) decoderClass
+{
+	@synchronized(self)
+	{
+		defaultDecoderClass = decoderClass;
+	}
+}
+
++ (id<OALAudioDecoder>) decoderForUrl:(NSURL*) url
+{
+	if(nil == url)
+	{
+		OAL_LOG_ERROR(@"Cannot open NULL file / url");
+		return nil;
+	}
+
+	Class decoderClass;
+	Class fallbackClass;
+	@synchronized(self)
+	{
+		decoderClass = [decoderClasses objectForKey:[[[url path] pathExtension] lowercaseString]];
+		fallbackClass = defaultDecoderClass;
+	}
+
+	id<OALAudioDecoder> decoder = nil;
+	if(Nil != decoderClass)
+	{
+		decoder = [decoderClass decoderWithUrl:url];
+	}
+	if(nil == decoder && Nil != fallbackClass && fallbackClass != decoderClass)
+	{
+		decoder = [fallbackClass decoderWithUrl:url];
+	}
+	if(nil == decoder)
+	{
+		OAL_LOG_ERROR(@"No decoder could open url %@", url);
+	}
+	return decoder;
+}
+
+@end
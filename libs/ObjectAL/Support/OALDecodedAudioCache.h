@@ -0,0 +1,139 @@
+//
+//  OALDecodedAudioCache.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ALBuffer.h"
+
+
+#pragma mark OALDecodedAudioCache
+
+/**
+ * An on-disk cache of decoded (16 bit PCM) audio. <br>
+ *
+ * Cached audio is memory mapped and handed to OpenAL as-is (via alBufferDataStatic), so
+ * loading a cached sound costs little more than opening a file; pages are only read in from
+ * flash when OpenAL actually plays them. <br>
+ *
+ * Entries are keyed on the source file's path, modification date and size, along with the
+ * version of the cache format. Editing or replacing a source file therefore misses the
+ * old entry, which eventually gets removed when the cache grows beyond maxSize
+ * (least recently used entries go first).
+ */
+@interface OALDecodedAudioCache : NSObject
+{
+	NSString* directory;
+	unsigned long long maxSize;
+	/** The total size of all entries in the cache directory. */
+	unsigned long long currentSize;
+	/** Cache statistics. */
+	NSUInteger hits;
+	NSUInteger misses;
+}
+
+
+#pragma mark Properties
+
+/** The directory where cached audio is stored. */
+@property(readonly) NSString* directory;
+
+/** The maximum size of the cache on disk, in bytes (default 32 MB).
+ * Lowering this will immediately trim the cache.
+ */
+@property(readwrite,assign) unsigned long long maxSize;
+
+/** The current size of the cache on disk, in bytes. */
+@property(readonly) unsigned long long currentSize;
+
+/** The number of times bufferForUrl: found a cached entry. */
+@property(readonly) NSUInteger hits;
+
+/** The number of times bufferForUrl: did not find a cached entry. */
+@property(readonly) NSUInteger misses;
+
+
+#pragma mark Object Management
+
+/** Create a cache in the application's Caches directory, limited to 32 MB.
+ *
+ * @return A new cache.
+ */
++ (id) cache;
+
+/** Create a cache.
+ *
+ * @param directory The directory to store cached audio in (it will be created if necessary).
+ * @param maxSize The maximum size of the cache on disk, in bytes.
+ * @return A new cache.
+ */
++ (id) cacheWithDirectory:(NSString*) directory maxSize:(unsigned long long) maxSize;
+
+/** Initialize a cache.
+ *
+ * @param directory The directory to store cached audio in (it will be created if necessary).
+ * @param maxSize The maximum size of the cache on disk, in bytes.
+ * @return The initialized cache.
+ */
+- (id) initWithDirectory:(NSString*) directory maxSize:(unsigned long long) maxSize;
+
+
+#pragma mark Cache Operations
+
+/** Load a buffer from the cache.
+ *
+ * @param url The URL of the source file.
+ * @return A buffer that plays directly from the mapped cache file, or nil if the file is not
+ *         cached (or has changed since it was cached).
+ */
+- (ALBuffer*) bufferForUrl:(NSURL*) url;
+
+/** Store decoded audio in the cache.
+ *
+ * @param data The decoded audio data.
+ * @param size The size of the data in bytes.
+ * @param format The OpenAL format of the data.
+ * @param frequency The sampling frequency in Hz.
+ * @param url The URL of the source file.
+ * @return TRUE if the data was stored.
+ */
+- (bool) storeData:(const void*) data
+			  size:(ALsizei) size
+			format:(ALenum) format
+		 frequency:(ALsizei) frequency
+			forUrl:(NSURL*) url;
+
+/** Remove the cached entry for a source file.
+ *
+ * @param url The URL of the source file.
+ */
+- (void) removeEntryForUrl:(NSURL*) url;
+
+/** Remove all entries from the cache.
+ */
+- (void) removeAllEntries;
+
+/** Remove the least recently used entries until the cache is no bigger than the specified size.
+ *
+ * @param size The size to trim the cache to, in bytes.
+ */
+- (void) trimToSize:(unsigned long long) size;
+
+@end
@@ -0,0 +1,401 @@
+//
+//  OALDecodedAudioCache.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALDecodedAudioCache.h"
+#import "ObjectALMacros.h"
+
+
+/** Bump this whenever the decoded output or the file layout changes. */
+#define kCacheFormatVersion 1
+
+#define kCacheMagic 0x504c414f /* "OALP" */
+
+#define kDefaultMaxSize (32 * 1024 * 1024)
+
+#define kCacheFileExtension @"pcm"
+
+
+/**
+ * (INTERNAL USE) Header at the start of every cache file.
+ * The key string follows the header, padded so that the audio data starts on a 16 byte boundary.
+ */
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t format;
+	uint32_t frequency;
+	uint32_t dataSize;
+	uint32_t keyLength;
+} OALDecodedAudioCacheHeader;
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for OALDecodedAudioCache.
+ */
+@interface OALDecodedAudioCache (Private)
+
+/** (INTERNAL USE) Build the key describing the current state of a source file.
+ *
+ * @param url The URL of the source file.
+ * @return The key, or nil if the file can't be cached.
+ */
+- (NSString*) keyForUrl:(NSURL*) url;
+
+/** (INTERNAL USE) Get the path of the cache file for a key.
+ *
+ * @param key The key.
+ * @return The path of the cache file.
+ */
+- (NSString*) pathForKey:(NSString*) key;
+
+/** (INTERNAL USE) Add up the sizes of all files in the cache directory.
+ *
+ * @return The total size in bytes.
+ */
+- (unsigned long long) calculateSize;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALDecodedAudioCache
+
+@implementation OALDecodedAudioCache
+
+#pragma mark Object Management
+
++ (id) cache
+{
+	NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES);
+	NSString* dir = [[paths objectAtIndex:0] stringByAppendingPathComponent:@"ObjectAL/DecodedAudio"];
+	return [self cacheWithDirectory:dir maxSize:kDefaultMaxSize];
+}
+
++ (id) cacheWithDirectory:(NSString*) directory maxSize:(unsigned long long) maxSize
+{
+	return [[[self alloc] initWithDirectory:directory maxSize:maxSize] autorelease];
+}
+
+- (id) initWithDirectory:(NSString*) directoryIn maxSize:(unsigned long long) maxSizeIn
+{
+	if(nil != (self = [super init]))
+	{
+		directory = [directoryIn copy];
+		maxSize = maxSizeIn;
+		NSError* error = nil;
+		if(![[NSFileManager defaultManager] createDirectoryAtPath:directory
+									  withIntermediateDirectories:YES
+													   attributes:nil
+															error:&error])
+		{
+			OAL_LOG_ERROR(@"Could not create cache directory %@: %@", directory, error);
+			[self release];
+			return nil;
+		}
+		currentSize = [self calculateSize];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[directory release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize directory;
+
+- (unsigned long long) maxSize
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return maxSize;
+	}
+}
+
+- (void) setMaxSize:(unsigned long long) value
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		maxSize = value;
+		[self trimToSize:maxSize];
+	}
+}
+
+- (unsigned long long) currentSize
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return currentSize;
+	}
+}
+
+- (NSUInteger) hits
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return hits;
+	}
+}
+
+- (NSUInteger) misses
+{
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		return misses;
+	}
+}
+
+
+#pragma mark Cache Operations
+
+- (ALBuffer*) bufferForUrl:(NSURL*) url
+{
+	NSString* key = [self keyForUrl:url];
+	if(nil == key)
+	{
+		return nil;
+	}
+	NSString* path = [self pathForKey:key];
+
+	// Mapping only sets up the page tables. Nothing is read until OpenAL touches the data.
+	NSData* data = [[[NSData alloc] initWithContentsOfFile:path options:NSMappedRead error:nil] autorelease];
+	const char* keyBytes = [key UTF8String];
+	uint32_t keyLength = (uint32_t)strlen(keyBytes);
+	uint32_t dataOffset = (sizeof(OALDecodedAudioCacheHeader) + keyLength + 15) & ~15u;
+	const OALDecodedAudioCacheHeader* header = [data bytes];
+
+	if(nil == data
+	   || [data length] < dataOffset
+	   || kCacheMagic != header->magic
+	   || kCacheFormatVersion != header->version
+	   || keyLength != header->keyLength
+	   || 0 != memcmp((const char*)(header + 1), keyBytes, keyLength)
+	   || [data length] < dataOffset + header->dataSize)
+	{
+		OPTIONALLY_SYNCHRONIZED(self)
+		{
+			misses++;
+		}
+		return nil;
+	}
+
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		hits++;
+	}
+
+	// Mark the entry as recently used.
+	[[NSFileManager defaultManager] setAttributes:[NSDictionary dictionaryWithObject:[NSDate date]
+																			   forKey:NSFileModificationDate]
+									 ofItemAtPath:path
+											error:nil];
+
+	return [ALBuffer bufferWithName:[url absoluteString]
+							   data:(char*)[data bytes] + dataOffset
+							   size:(ALsizei)header->dataSize
+							 format:(ALenum)header->format
+						  frequency:(ALsizei)header->frequency
+						  dataOwner:data];
+}
+
+- (bool) storeData:(const void*) data
+			  size:(ALsizei) size
+			format:(ALenum) format
+		 frequency:(ALsizei) frequency
+			forUrl:(NSURL*) url
+{
+	NSString* key = [self keyForUrl:url];
+	if(nil == key)
+	{
+		return NO;
+	}
+
+	const char* keyBytes = [key UTF8String];
+	uint32_t keyLength = (uint32_t)strlen(keyBytes);
+	uint32_t dataOffset = (sizeof(OALDecodedAudioCacheHeader) + keyLength + 15) & ~15u;
+
+	OALDecodedAudioCacheHeader header;
+	header.magic = kCacheMagic;
+	header.version = kCacheFormatVersion;
+	header.format = (uint32_t)format;
+	header.frequency = (uint32_t)frequency;
+	header.dataSize = (uint32_t)size;
+	header.keyLength = keyLength;
+
+	NSMutableData* fileData = [NSMutableData dataWithCapacity:dataOffset + (NSUInteger)size];
+	[fileData appendBytes:&header length:sizeof(header)];
+	[fileData appendBytes:keyBytes length:keyLength];
+	[fileData setLength:dataOffset];
+	[fileData appendBytes:data length:(NSUInteger)size];
+
+	NSString* path = [self pathForKey:key];
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		// Storing the same url again replaces the old file, so it no longer counts.
+		unsigned long long oldSize = [[[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil] fileSize];
+		if(![fileData writeToFile:path atomically:YES])
+		{
+			OAL_LOG_ERROR(@"Could not write cache file %@", path);
+			return NO;
+		}
+
+		currentSize -= oldSize < currentSize ? oldSize : currentSize;
+		currentSize += [fileData length];
+		if(currentSize > maxSize)
+		{
+			[self trimToSize:maxSize];
+		}
+	}
+	return YES;
+}
+
+- (void) removeEntryForUrl:(NSURL*) url
+{
+	NSString* key = [self keyForUrl:url];
+	if(nil == key)
+	{
+		return;
+	}
+	NSString* path = [self pathForKey:key];
+	NSFileManager* fileManager = [NSFileManager defaultManager];
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		unsigned long long size = [[fileManager attributesOfItemAtPath:path error:nil] fileSize];
+		if([fileManager removeItemAtPath:path error:nil])
+		{
+			currentSize -= size < currentSize ? size : currentSize;
+		}
+	}
+}
+
+- (void) removeAllEntries
+{
+	[self trimToSize:0];
+}
+
+- (void) trimToSize:(unsigned long long) size
+{
+	NSFileManager* fileManager = [NSFileManager defaultManager];
+	OPTIONALLY_SYNCHRONIZED(self)
+	{
+		if(currentSize <= size)
+		{
+			return;
+		}
+
+		// Gather the entries, least recently used first.
+		NSMutableArray* entries = [NSMutableArray arrayWithCapacity:32];
+		for(NSString* filename in [fileManager contentsOfDirectoryAtPath:directory error:nil])
+		{
+			if([[filename pathExtension] isEqualToString:kCacheFileExtension])
+			{
+				NSString* path = [directory stringByAppendingPathComponent:filename];
+				NSDictionary* attributes = [fileManager attributesOfItemAtPath:path error:nil];
+				if(nil != attributes)
+				{
+					[entries addObject:[NSDictionary dictionaryWithObjectsAndKeys:
+										[attributes fileModificationDate], @"date",
+										path, @"path",
+										[NSNumber numberWithUnsignedLongLong:[attributes fileSize]], @"size",
+										nil]];
+				}
+			}
+		}
+		NSSortDescriptor* byDate = [[[NSSortDescriptor alloc] initWithKey:@"date" ascending:YES] autorelease];
+		[entries sortUsingDescriptors:[NSArray arrayWithObject:byDate]];
+
+		// Buffers already loaded from a removed file keep their mapping until they're released.
+		for(NSDictionary* entry in entries)
+		{
+			if(currentSize <= size)
+			{
+				break;
+			}
+			if([fileManager removeItemAtPath:[entry objectForKey:@"path"] error:nil])
+			{
+				unsigned long long entrySize = [[entry objectForKey:@"size"] unsignedLongLongValue];
+				currentSize -= entrySize < currentSize ? entrySize : currentSize;
+			}
+		}
+	}
+}
+
+
+#pragma mark Internal Use
+
+- (NSString*) keyForUrl:(NSURL*) url
+{
+	if(![url isFileURL])
+	{
+		return nil;
+	}
+	NSString* path = [url path];
+	NSDictionary* attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil];
+	if(nil == attributes)
+	{
+		return nil;
+	}
+	return [NSString stringWithFormat:@"%@|%.0f|%llu|%d",
+			path,
+			[[attributes fileModificationDate] timeIntervalSince1970],
+			[attributes fileSize],
+			kCacheFormatVersion];
+}
+
+- (NSString*) pathForKey:(NSString*) key
+{
+	// 64-bit FNV-1a. The full key is stored in the file and checked on load, so collisions
+	// only cost a cache miss.
+	uint64_t hash = 14695981039346656037ULL;
+	for(const unsigned char* p = (const unsigned char*)[key UTF8String]; *p; p++)
+	{
+		hash ^= *p;
+		hash *= 1099511628211ULL;
+	}
+	return [directory stringByAppendingPathComponent:
+			[NSString stringWithFormat:@"%016llx.%@", (unsigned long long)hash, kCacheFileExtension]];
+}
+
+- (unsigned long long) calculateSize
+{
+	NSFileManager* fileManager = [NSFileManager defaultManager];
+	unsigned long long size = 0;
+	for(NSString* filename in [fileManager contentsOfDirectoryAtPath:directory error:nil])
+	{
+		if([[filename pathExtension] isEqualToString:kCacheFileExtension])
+		{
+			NSString* path = [directory stringByAppendingPathComponent:filename];
+			size += [[fileManager attributesOfItemAtPath:path error:nil] fileSize];
+		}
+	}
+	return size;
+}
+
+@end
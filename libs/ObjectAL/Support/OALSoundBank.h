@@ -0,0 +1,104 @@
+//
+//  OALSoundBank.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ALBuffer.h"
+#import "oal_sound_bank.h"
+
+
+#pragma mark OALSoundBank
+
+/**
+ * Many sounds packed into a single file (see oal_sound_bank.h), built ahead of time with
+ * Tools/oalbankpack. <br>
+ *
+ * The bank file is memory mapped once, and each buffer is handed to OpenAL straight from
+ * the mapping (via alBufferDataStatic), so making a buffer costs no file opens, decoding,
+ * or copying; pages are only read in from flash when OpenAL actually plays them. Buffers
+ * keep the mapping alive, so they stay valid even after the bank is released. <br>
+ *
+ * Add a bank to OALSimpleAudio (addSoundBank:) to have playEffect: and friends find sounds
+ * in it by file name.
+ */
+@interface OALSoundBank : NSObject
+{
+	NSURL* url;
+	/** The mapped bank file. */
+	NSData* data;
+	oal_sound_bank bank;
+}
+
+
+#pragma mark Properties
+
+/** The URL of the bank file. */
+@property(readonly) NSURL* url;
+
+/** The number of sounds in this bank. */
+@property(readonly) NSUInteger count;
+
+/** The names of all sounds in this bank, in sorted order (NSString). */
+@property(readonly) NSArray* names;
+
+
+#pragma mark Object Management
+
+/** Open a bank file.
+ * On iOS, relative paths are looked up in the main bundle (see OALAudioSupport).
+ *
+ * @param filePath The path of the bank file.
+ * @return A new bank, or nil if the file couldn't be opened or isn't a sound bank.
+ */
++ (id) bankWithFile:(NSString*) filePath;
+
+/** Open a bank file.
+ *
+ * @param url The URL of the bank file.
+ * @return A new bank, or nil if the file couldn't be opened or isn't a sound bank.
+ */
++ (id) bankWithUrl:(NSURL*) url;
+
+/** Initialize with a bank file.
+ *
+ * @param url The URL of the bank file.
+ * @return The initialized bank, or nil if the file couldn't be opened or isn't a sound bank.
+ */
+- (id) initWithUrl:(NSURL*) url;
+
+
+#pragma mark Sounds
+
+/** Check if this bank contains a sound.
+ *
+ * @param name The sound's name (its original file name, such as "Pew.wav").
+ * @return TRUE if the sound is in this bank.
+ */
+- (bool) containsSound:(NSString*) name;
+
+/** Make a buffer that plays a sound directly from the bank.
+ *
+ * @param name The sound's name (its original file name, such as "Pew.wav").
+ * @return A new buffer, or nil if the sound isn't in this bank or can't be played.
+ */
+- (ALBuffer*) bufferNamed:(NSString*) name;
+
+@end
@@ -0,0 +1,155 @@
+//
+//  OALSoundBank.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALSoundBank.h"
+#if TARGET_OS_IPHONE
+#import "OALAudioSupport.h"
+#endif
+#import "ObjectALMacros.h"
+
+
+@implementation OALSoundBank
+
+#pragma mark Object Management
+
++ (id) bankWithFile:(NSString*) filePath
+{
+#if TARGET_OS_IPHONE
+	NSURL* url = [OALAudioSupport urlForPath:filePath];
+#else
+	NSURL* url = nil == filePath ? nil : [NSURL fileURLWithPath:filePath];
+#endif
+	if(nil == url)
+	{
+		return nil;
+	}
+	return [self bankWithUrl:url];
+}
+
++ (id) bankWithUrl:(NSURL*) url
+{
+	return [[[self alloc] initWithUrl:url] autorelease];
+}
+
+- (id) initWithUrl:(NSURL*) urlIn
+{
+	if(nil != (self = [super init]))
+	{
+		url = [urlIn retain];
+
+		// Mapping only sets up the page tables. Nothing is read until it's touched.
+		NSError* error = nil;
+		data = [[NSData alloc] initWithContentsOfFile:[url path] options:NSMappedRead error:&error];
+		if(nil == data)
+		{
+			OAL_LOG_ERROR(@"Could not open sound bank %@: %@", url, error);
+			[self release];
+			return nil;
+		}
+		if(!oal_sound_bank_init(&bank, [data bytes], [data length]))
+		{
+			OAL_LOG_ERROR(@"%@ is not a valid sound bank", url);
+			[self release];
+			return nil;
+		}
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[url release];
+	[data release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize url;
+
+- (NSUInteger) count
+{
+	return oal_sound_bank_count(&bank);
+}
+
+- (NSArray*) names
+{
+	uint32_t count = oal_sound_bank_count(&bank);
+	NSMutableArray* names = [NSMutableArray arrayWithCapacity:count];
+	oal_sound_bank_entry entry;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(oal_sound_bank_entry_at(&bank, i, &entry))
+		{
+			[names addObject:[NSString stringWithUTF8String:entry.name]];
+		}
+	}
+	return names;
+}
+
+
+#pragma mark Sounds
+
+- (bool) containsSound:(NSString*) name
+{
+	oal_sound_bank_entry entry;
+	return nil != name && oal_sound_bank_find(&bank, [name UTF8String], &entry);
+}
+
+- (ALBuffer*) bufferNamed:(NSString*) name
+{
+	oal_sound_bank_entry entry;
+	if(nil == name || !oal_sound_bank_find(&bank, [name UTF8String], &entry))
+	{
+		return nil;
+	}
+
+	ALenum format = 0;
+	if(OAL_SOUND_BANK_PCM == entry.encoding)
+	{
+		if(1 == entry.channels)
+		{
+			format = 8 == entry.bitsPerSample ? AL_FORMAT_MONO8 : (16 == entry.bitsPerSample ? AL_FORMAT_MONO16 : 0);
+		}
+		else if(2 == entry.channels)
+		{
+			format = 8 == entry.bitsPerSample ? AL_FORMAT_STEREO8 : (16 == entry.bitsPerSample ? AL_FORMAT_STEREO16 : 0);
+		}
+	}
+	if(0 == format || entry.size > INT32_MAX)
+	{
+		OAL_LOG_ERROR(@"%@ in sound bank %@ has an unsupported format (encoding %u, %u channels, %u bits)",
+					  name, url, entry.encoding, entry.channels, entry.bitsPerSample);
+		return nil;
+	}
+
+	// The buffer keeps the mapping alive for as long as OpenAL might read from it.
+	return [ALBuffer bufferWithName:name
+							   data:(void*)entry.data
+							   size:(ALsizei)entry.size
+							 format:format
+						  frequency:(ALsizei)entry.frequency
+						  dataOwner:data];
+}
+
+@end
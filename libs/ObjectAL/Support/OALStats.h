@@ -0,0 +1,167 @@
+//
+//  OALStats.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+
+
+#pragma mark OALFunctionStats
+
+/**
+ * Call statistics for a single OpenAL function (see OALStats).
+ */
+@interface OALFunctionStats : NSObject
+{
+	NSString* name;
+	unsigned long long calls;
+	double totalSeconds;
+	double peakSeconds;
+	unsigned long long frameCalls;
+	double frameSeconds;
+}
+
+/** The function's name. Calls queued by the audio command thread are named "queued alXYZ". */
+@property(readonly) NSString* name;
+
+/** Number of calls since statistics were last reset. */
+@property(readonly) unsigned long long calls;
+
+/** Total time spent in calls since statistics were last reset, in seconds. */
+@property(readonly) double totalSeconds;
+
+/** The longest single call since statistics were last reset, in seconds. */
+@property(readonly) double peakSeconds;
+
+/** Number of calls during the current frame. */
+@property(readonly) unsigned long long frameCalls;
+
+/** Time spent in calls during the current frame, in seconds. */
+@property(readonly) double frameSeconds;
+
+/** (INTERNAL USE) Initialize function statistics.
+ *
+ * @param name The function's name.
+ * @param calls Number of calls.
+ * @param totalSeconds Total time spent in calls.
+ * @param peakSeconds The longest single call.
+ * @param frameCalls Number of calls during the current frame.
+ * @param frameSeconds Time spent in calls during the current frame.
+ * @return The initialized statistics.
+ */
+- (id) initWithName:(NSString*) name
+			  calls:(unsigned long long) calls
+	   totalSeconds:(double) totalSeconds
+		peakSeconds:(double) peakSeconds
+		 frameCalls:(unsigned long long) frameCalls
+	   frameSeconds:(double) frameSeconds;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALStats
+
+/**
+ * A snapshot of how many OpenAL calls ObjectAL has made, and how long they took. <br>
+ *
+ * Statistics are only collected when OBJECTAL_CFG_COLLECT_STATS is enabled
+ * (otherwise every snapshot is empty). Times include waiting for ALWrapper's lock,
+ * but not error checking. <br>
+ *
+ * Call endFrame once per frame to get per-frame totals.
+ */
+@interface OALStats : NSObject
+{
+	unsigned long long frames;
+	unsigned long long calls;
+	double totalSeconds;
+	unsigned long long frameCalls;
+	double frameSeconds;
+	unsigned long long lastFrameCalls;
+	double lastFrameSeconds;
+	unsigned long long peakFrameCalls;
+	double peakFrameSeconds;
+	NSArray* functions;
+}
+
+
+#pragma mark Properties
+
+/** Number of frames ended since statistics were last reset. */
+@property(readonly) unsigned long long frames;
+
+/** Number of calls since statistics were last reset. */
+@property(readonly) unsigned long long calls;
+
+/** Total time spent in calls since statistics were last reset, in seconds. */
+@property(readonly) double totalSeconds;
+
+/** Number of calls during the current frame. */
+@property(readonly) unsigned long long frameCalls;
+
+/** Time spent in calls during the current frame, in seconds. */
+@property(readonly) double frameSeconds;
+
+/** Number of calls during the last completed frame. */
+@property(readonly) unsigned long long lastFrameCalls;
+
+/** Time spent in calls during the last completed frame, in seconds. */
+@property(readonly) double lastFrameSeconds;
+
+/** The most calls made during a single frame since statistics were last reset. */
+@property(readonly) unsigned long long peakFrameCalls;
+
+/** The most time spent in calls during a single frame since statistics were last reset, in seconds. */
+@property(readonly) double peakFrameSeconds;
+
+/** Statistics for each function called (OALFunctionStats*), most total time first. */
+@property(readonly) NSArray* functions;
+
+
+#pragma mark Object Management
+
+/** Take a snapshot of the current statistics.
+ *
+ * @return A new snapshot.
+ */
++ (OALStats*) snapshot;
+
+
+#pragma mark Collection
+
+/** End the current frame, starting a new one.
+ */
++ (void) endFrame;
+
+/** Clear all statistics.
+ */
++ (void) reset;
+
+
+#pragma mark Reporting
+
+/** Get this snapshot as a JSON object.
+ *
+ * @return This snapshot in JSON format.
+ */
+- (NSString*) JSONRepresentation;
+
+@end
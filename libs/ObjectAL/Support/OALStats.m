@@ -0,0 +1,251 @@
+//
+//  OALStats.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALStats.h"
+#import "ObjectALMacros.h"
+#import "ALWrapper.h"
+#import "mach_timing.h"
+#import "oal_stats.h"
+
+
+#pragma mark OALFunctionStats
+
+@implementation OALFunctionStats
+
+- (id) initWithName:(NSString*) nameIn
+			  calls:(unsigned long long) callsIn
+	   totalSeconds:(double) totalSecondsIn
+		peakSeconds:(double) peakSecondsIn
+		 frameCalls:(unsigned long long) frameCallsIn
+	   frameSeconds:(double) frameSecondsIn
+{
+	if(nil != (self = [super init]))
+	{
+		name = [nameIn retain];
+		calls = callsIn;
+		totalSeconds = totalSecondsIn;
+		peakSeconds = peakSecondsIn;
+		frameCalls = frameCallsIn;
+		frameSeconds = frameSecondsIn;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[name release];
+	[super dealloc];
+}
+
+- (NSString*) description
+{
+	return [NSString stringWithFormat:@"<%@: %p: %@: %llu calls, %f s>", [self class], self, name, calls, totalSeconds];
+}
+
+@synthesize name;
+@synthesize calls;
+@synthesize totalSeconds;
+@synthesize peakSeconds;
+@synthesize frameCalls;
+@synthesize frameSeconds;
+
+@end
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for OALStats.
+ */
+@interface OALStats (Private)
+
+/** (INTERNAL USE) Initialize a snapshot from the current statistics.
+ *
+ * @return The initialized snapshot.
+ */
+- (id) initWithCurrentStats;
+
+@end
+
+
+/** (INTERNAL USE) Convert a mach absolute time duration to seconds.
+ */
+static double toSeconds(uint64_t duration)
+{
+	return mach_absolute_difference_seconds(duration, 0);
+}
+
+/** (INTERNAL USE) Orders function statistics by total time, most first.
+ */
+static NSInteger compareTotalSeconds(id stats1, id stats2, void* context)
+{
+	(void)context;
+	double seconds1 = ((OALFunctionStats*)stats1).totalSeconds;
+	double seconds2 = ((OALFunctionStats*)stats2).totalSeconds;
+	if(seconds1 != seconds2)
+	{
+		return seconds1 > seconds2 ? NSOrderedAscending : NSOrderedDescending;
+	}
+	return NSOrderedSame;
+}
+
+/** (INTERNAL USE) Escape a string for use in JSON.
+ */
+static NSString* jsonString(NSString* string)
+{
+	NSMutableString* result = [NSMutableString stringWithString:string];
+	[result replaceOccurrencesOfString:@"\\" withString:@"\\\\" options:0 range:NSMakeRange(0, [result length])];
+	[result replaceOccurrencesOfString:@"\"" withString:@"\\\"" options:0 range:NSMakeRange(0, [result length])];
+	return result;
+}
+
+
+#pragma mark -
+#pragma mark OALStats
+
+@implementation OALStats
+
+#pragma mark Object Management
+
++ (OALStats*) snapshot
+{
+	return [[[self alloc] initWithCurrentStats] autorelease];
+}
+
+- (id) initWithCurrentStats
+{
+	if(nil != (self = [super init]))
+	{
+#if OBJECTAL_CFG_COLLECT_STATS
+		oal_stats_totals totals;
+		oal_stats_function* entries = NULL;
+		unsigned int numEntries = 0;
+		
+		// oal_stats merges the per-thread counters under its own lock, so this doesn't
+		// need to hold up OpenAL calls. Functions first called after the count is taken
+		// just get left out of this snapshot.
+		oal_stats_get_totals(&totals);
+		unsigned int maxEntries = oal_stats_function_count();
+		entries = malloc(sizeof(*entries) * (maxEntries > 0 ? maxEntries : 1));
+		numEntries = oal_stats_get_functions(entries, maxEntries);
+		
+		frames = totals.frames;
+		calls = totals.calls;
+		totalSeconds = toSeconds(totals.totalTime);
+		frameCalls = totals.frameCalls;
+		frameSeconds = toSeconds(totals.frameTime);
+		lastFrameCalls = totals.lastFrameCalls;
+		lastFrameSeconds = toSeconds(totals.lastFrameTime);
+		peakFrameCalls = totals.peakFrameCalls;
+		peakFrameSeconds = toSeconds(totals.peakFrameTime);
+		
+		NSMutableArray* functionStats = [NSMutableArray arrayWithCapacity:numEntries];
+		for(unsigned int i = 0; i < numEntries; i++)
+		{
+			OALFunctionStats* stats = [[OALFunctionStats alloc] initWithName:[NSString stringWithUTF8String:entries[i].function]
+																		calls:entries[i].calls
+																 totalSeconds:toSeconds(entries[i].totalTime)
+																  peakSeconds:toSeconds(entries[i].peakTime)
+																   frameCalls:entries[i].frameCalls
+																 frameSeconds:toSeconds(entries[i].frameTime)];
+			[functionStats addObject:stats];
+			[stats release];
+		}
+		free(entries);
+		
+		[functionStats sortUsingFunction:compareTotalSeconds context:NULL];
+		functions = [functionStats retain];
+#else
+		functions = [[NSArray alloc] init];
+#endif
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[functions release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize frames;
+@synthesize calls;
+@synthesize totalSeconds;
+@synthesize frameCalls;
+@synthesize frameSeconds;
+@synthesize lastFrameCalls;
+@synthesize lastFrameSeconds;
+@synthesize peakFrameCalls;
+@synthesize peakFrameSeconds;
+@synthesize functions;
+
+
+#pragma mark Collection
+
++ (void) endFrame
+{
+#if OBJECTAL_CFG_COLLECT_STATS
+	oal_stats_end_frame();
+#endif
+}
+
++ (void) reset
+{
+#if OBJECTAL_CFG_COLLECT_STATS
+	oal_stats_reset();
+#endif
+}
+
+
+#pragma mark Reporting
+
+- (NSString*) JSONRepresentation
+{
+	NSMutableString* json = [NSMutableString stringWithCapacity:256 + [functions count] * 160];
+	[json appendFormat:@"{\"frames\":%llu,\"calls\":%llu,\"totalSeconds\":%.9f,"
+	 @"\"frameCalls\":%llu,\"frameSeconds\":%.9f,"
+	 @"\"lastFrameCalls\":%llu,\"lastFrameSeconds\":%.9f,"
+	 @"\"peakFrameCalls\":%llu,\"peakFrameSeconds\":%.9f,\"functions\":[",
+	 frames, calls, totalSeconds,
+	 frameCalls, frameSeconds,
+	 lastFrameCalls, lastFrameSeconds,
+	 peakFrameCalls, peakFrameSeconds];
+	
+	bool first = YES;
+	for(OALFunctionStats* stats in functions)
+	{
+		[json appendFormat:@"%@{\"name\":\"%@\",\"calls\":%llu,\"totalSeconds\":%.9f,\"peakSeconds\":%.9f,"
+		 @"\"frameCalls\":%llu,\"frameSeconds\":%.9f}",
+		 first ? @"" : @",",
+		 jsonString(stats.name), stats.calls, stats.totalSeconds, stats.peakSeconds,
+		 stats.frameCalls, stats.frameSeconds];
+		first = NO;
+	}
+	[json appendString:@"]}"];
+	return json;
+}
+
+@end
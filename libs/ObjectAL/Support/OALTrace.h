@@ -0,0 +1,229 @@
+//
+//  OALTrace.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ObjectALMacros.h"
+#import "SynthesizeSingleton.h"
+#import "oal_trace.h"
+
+
+#pragma mark Trace Hooks
+
+#if OBJECTAL_CFG_TRACE
+
+/** (INTERNAL USE) TRUE while OALTraceRecorder is recording. */
+extern volatile bool OALTraceIsRecording;
+
+/** (INTERNAL USE) Record a call, unless it was made from inside another traced call
+ * (see OAL_TRACE_BEGIN_INTERNAL).
+ */
+void OALTraceRecord(oal_trace_event_type type,
+					uint32_t handle,
+					NSString* string,
+					float v1,
+					float v2,
+					float v3,
+					int32_t intValue);
+
+/** (INTERNAL USE) Get the handle to record for a sound source (its OpenAL source ID).
+ */
+uint32_t OALTraceHandle(id source);
+
+/** (INTERNAL USE) Start ignoring calls made on the current thread. Calls nest. */
+void OALTraceBeginInternal(void);
+
+/** (INTERNAL USE) Stop ignoring calls made on the current thread. */
+void OALTraceEndInternal(void);
+
+/** (INTERNAL USE) Record a call to a public API method while a trace is being recorded.
+ */
+#define OAL_TRACE(TYPE, HANDLE, STRING, V1, V2, V3, INTVALUE) \
+	do \
+	{ \
+		if(OALTraceIsRecording) \
+		{ \
+			OALTraceRecord((TYPE), (HANDLE), (STRING), (V1), (V2), (V3), (INTVALUE)); \
+		} \
+	} while(0)
+
+/** (INTERNAL USE) Start a region in which calls made by ObjectAL itself are not traced,
+ * because replaying the call that started the region will make them again.
+ */
+#define OAL_TRACE_BEGIN_INTERNAL() OALTraceBeginInternal()
+
+/** (INTERNAL USE) End a region started with OAL_TRACE_BEGIN_INTERNAL.
+ */
+#define OAL_TRACE_END_INTERNAL() OALTraceEndInternal()
+
+#else /* OBJECTAL_CFG_TRACE */
+
+#define OAL_TRACE(TYPE, HANDLE, STRING, V1, V2, V3, INTVALUE)
+#define OAL_TRACE_BEGIN_INTERNAL()
+#define OAL_TRACE_END_INTERNAL()
+
+#endif /* OBJECTAL_CFG_TRACE */
+
+
+#pragma mark -
+#pragma mark OALTraceRecorder
+
+/**
+ * Records ObjectAL API calls to a compact binary trace file, for replay with
+ * OALTracePlayer. <br>
+ *
+ * Only available when OBJECTAL_CFG_TRACE is enabled (otherwise startRecordingToFile
+ * fails). <br>
+ *
+ * Recorded calls: OALSimpleAudio's effect preloading, unloading and playback, background
+ * music playback, and volume, pause and mute settings; and gain, pitch, pan, position,
+ * looping, pause, stop, fadeTo, panTo, pitchTo and stopActions on the sources returned
+ * by playEffect.  Calls ObjectAL makes internally while handling a recorded call are not
+ * recorded.
+ */
+@interface OALTraceRecorder : NSObject
+{
+	oal_trace_writer* writer;
+	uint64_t startTime;
+	unsigned long long eventsRecorded;
+}
+
+
+#pragma mark Properties
+
+/** TRUE if a trace is being recorded. */
+@property(readonly) bool recording;
+
+/** Number of calls recorded to the current (or last) trace. */
+@property(readonly) unsigned long long eventsRecorded;
+
+
+#pragma mark Object Management
+
+/** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
+ *
+ * <b>- (OALTraceRecorder*) sharedInstance</b>: Get the shared singleton instance. <br>
+ * <b>- (void) purgeSharedInstance</b>: Purge (deallocate) the shared instance.
+ */
+SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALTraceRecorder);
+
+
+#pragma mark Recording
+
+/** Start recording a new trace.  Stops any trace currently being recorded.
+ *
+ * @param path The file to write (an existing file is replaced).
+ * @return TRUE if recording started.
+ */
+- (bool) startRecordingToFile:(NSString*) path;
+
+/** Stop recording and close the trace file.
+ *
+ * @return TRUE if the whole trace was written successfully.
+ */
+- (bool) stopRecording;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALTracePlayer
+
+/**
+ * Replays a trace recorded by OALTraceRecorder, making the same calls on
+ * [OALSimpleAudio sharedInstance] and the sources it returns. <br>
+ *
+ * Replays can run faster than real time, so a trace recorded from a long session can
+ * serve as a repeatable benchmark.  Use a device that doesn't need real audio hardware
+ * to keep replays independent of the machine's audio output. <br>
+ *
+ * Each source call goes to the source that the most recent recorded playEffect on the
+ * same OpenAL source returned, so calls on sources that didn't come from playEffect are
+ * skipped. <br>
+ *
+ * Note: fadeTo, panTo and pitchTo run in real time regardless of the replay speed.
+ * If OBJECTAL_CFG_ACTION_SCHEDULER_THREAD is disabled, actions are stepped from the main
+ * run loop, so replay from another thread if the trace contains them.
+ */
+@interface OALTracePlayer : NSObject
+{
+	NSString* path;
+	float speed;
+	unsigned long long eventsPlayed;
+	unsigned long long eventsSkipped;
+	NSTimeInterval traceDuration;
+	NSTimeInterval replayDuration;
+	/** Replayed sources, keyed by the handle they had when recorded. */
+	NSMutableDictionary* sources;
+}
+
+
+#pragma mark Properties
+
+/** The trace file. */
+@property(readonly) NSString* path;
+
+/** How fast to replay (1.0 = real time, 10.0 = 10 times faster).
+ * 0 replays every call as soon as the previous one returns. <br>
+ *
+ * Default value: 0
+ */
+@property(readwrite,assign) float speed;
+
+/** Number of calls made during the last replay. */
+@property(readonly) unsigned long long eventsPlayed;
+
+/** Number of calls skipped during the last replay because their source was unknown. */
+@property(readonly) unsigned long long eventsSkipped;
+
+/** The time between the start of recording and the last recorded call, in seconds. */
+@property(readonly) NSTimeInterval traceDuration;
+
+/** How long the last replay took, in seconds. */
+@property(readonly) NSTimeInterval replayDuration;
+
+
+#pragma mark Object Management
+
+/** Create a player for a trace file.
+ *
+ * @param path The trace file.
+ * @return A new player.
+ */
++ (id) playerWithFile:(NSString*) path;
+
+/** Initialize a player for a trace file.
+ *
+ * @param path The trace file.
+ * @return The initialized player.
+ */
+- (id) initWithFile:(NSString*) path;
+
+
+#pragma mark Playback
+
+/** Replay the trace on the calling thread, returning when it's done.
+ *
+ * @return TRUE if the whole trace was replayed, FALSE if it couldn't be opened or is corrupt.
+ */
+- (bool) replay;
+
+@end
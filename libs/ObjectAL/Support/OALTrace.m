@@ -0,0 +1,452 @@
+//
+//  OALTrace.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALTrace.h"
+#import "OALSimpleAudio.h"
+#import "ALSource.h"
+#import "mach_timing.h"
+#import <pthread.h>
+
+
+#pragma mark Trace Hooks
+
+#if OBJECTAL_CFG_TRACE
+
+volatile bool OALTraceIsRecording = NO;
+
+/** (INTERNAL USE) The recorder currently recording, if any.  Guarded by traceLock. */
+static OALTraceRecorder* activeRecorder = nil;
+
+/** (INTERNAL USE) Serializes writes to the trace. */
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER;
+
+/** (INTERNAL USE) Per-thread depth of OAL_TRACE_BEGIN_INTERNAL regions. */
+static pthread_key_t internalDepthKey;
+static pthread_once_t internalDepthKeyOnce = PTHREAD_ONCE_INIT;
+
+static void createInternalDepthKey(void)
+{
+	pthread_key_create(&internalDepthKey, NULL);
+}
+
+static inline intptr_t internalDepth(void)
+{
+	pthread_once(&internalDepthKeyOnce, createInternalDepthKey);
+	return (intptr_t)pthread_getspecific(internalDepthKey);
+}
+
+void OALTraceBeginInternal(void)
+{
+	intptr_t depth = internalDepth();
+	pthread_setspecific(internalDepthKey, (void*)(depth + 1));
+}
+
+void OALTraceEndInternal(void)
+{
+	intptr_t depth = internalDepth();
+	pthread_setspecific(internalDepthKey, (void*)(depth - 1));
+}
+
+uint32_t OALTraceHandle(id source)
+{
+	if([source isKindOfClass:[ALSource class]])
+	{
+		return ((ALSource*)source).sourceId;
+	}
+	return 0;
+}
+
+/**
+ * (INTERNAL USE) Private methods for OALTraceRecorder.
+ */
+@interface OALTraceRecorder (Private)
+
+/** (INTERNAL USE) Write an event to the trace. Only call while holding traceLock.
+ *
+ * @param event The event (its time and string are filled in here).
+ * @param string The event's string argument, if it has one.
+ */
+- (void) writeEvent:(oal_trace_event*) event string:(NSString*) string;
+
+@end
+
+void OALTraceRecord(oal_trace_event_type type,
+					uint32_t handle,
+					NSString* string,
+					float v1,
+					float v2,
+					float v3,
+					int32_t intValue)
+{
+	if(0 != internalDepth())
+	{
+		return;
+	}
+	
+	oal_trace_event event;
+	memset(&event, 0, sizeof(event));
+	event.type = type;
+	event.handle = handle;
+	event.values[0] = v1;
+	event.values[1] = v2;
+	event.values[2] = v3;
+	event.intValue = intValue;
+	
+	pthread_mutex_lock(&traceLock);
+	[activeRecorder writeEvent:&event string:string];
+	pthread_mutex_unlock(&traceLock);
+}
+
+#endif /* OBJECTAL_CFG_TRACE */
+
+
+#pragma mark -
+#pragma mark OALTraceRecorder
+
+@implementation OALTraceRecorder
+
+#pragma mark Object Management
+
+SYNTHESIZE_SINGLETON_FOR_CLASS(OALTraceRecorder);
+
+- (void) dealloc
+{
+	[self stopRecording];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+- (bool) recording
+{
+	return nil != writer;
+}
+
+@synthesize eventsRecorded;
+
+
+#pragma mark Recording
+
+- (bool) startRecordingToFile:(NSString*) path
+{
+#if OBJECTAL_CFG_TRACE
+	[self stopRecording];
+	
+	oal_trace_writer* newWriter = oal_trace_writer_open([path fileSystemRepresentation]);
+	if(NULL == newWriter)
+	{
+		OAL_LOG_ERROR(@"Could not create trace file %@", path);
+		return NO;
+	}
+	
+	pthread_mutex_lock(&traceLock);
+	writer = newWriter;
+	startTime = mach_absolute_time();
+	eventsRecorded = 0;
+	activeRecorder = self;
+	OALTraceIsRecording = YES;
+	pthread_mutex_unlock(&traceLock);
+	return YES;
+#else
+	(void)path;
+	OAL_LOG_ERROR(@"Tracing is disabled.  Enable OBJECTAL_CFG_TRACE to record traces.");
+	return NO;
+#endif
+}
+
+- (bool) stopRecording
+{
+#if OBJECTAL_CFG_TRACE
+	pthread_mutex_lock(&traceLock);
+	oal_trace_writer* oldWriter = writer;
+	writer = NULL;
+	if(activeRecorder == self)
+	{
+		activeRecorder = nil;
+		OALTraceIsRecording = NO;
+	}
+	pthread_mutex_unlock(&traceLock);
+	
+	if(NULL == oldWriter)
+	{
+		return NO;
+	}
+	if(!oal_trace_writer_close(oldWriter))
+	{
+		OAL_LOG_ERROR(@"Error writing trace file");
+		return NO;
+	}
+	return YES;
+#else
+	return NO;
+#endif
+}
+
+#if OBJECTAL_CFG_TRACE
+
+- (void) writeEvent:(oal_trace_event*) event string:(NSString*) string
+{
+	if(NULL == writer)
+	{
+		return;
+	}
+	event->time = (uint64_t)(mach_absolute_difference_seconds(mach_absolute_time(), startTime) * 1000000.0);
+	if(nil != string)
+	{
+		event->string = oal_trace_writer_string(writer, [string UTF8String]);
+	}
+	if(oal_trace_write(writer, event))
+	{
+		eventsRecorded++;
+	}
+}
+
+#endif /* OBJECTAL_CFG_TRACE */
+
+@end
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for OALTracePlayer.
+ */
+@interface OALTracePlayer (Private)
+
+/** (INTERNAL USE) Make the call an event describes.
+ *
+ * @param event The event.
+ * @param reader The reader the event came from (for looking up strings).
+ */
+- (void) playEvent:(const oal_trace_event*) event reader:(oal_trace_reader*) reader;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALTracePlayer
+
+@implementation OALTracePlayer
+
+#pragma mark Object Management
+
++ (id) playerWithFile:(NSString*) path
+{
+	return [[[self alloc] initWithFile:path] autorelease];
+}
+
+- (id) initWithFile:(NSString*) pathIn
+{
+	if(nil != (self = [super init]))
+	{
+		path = [pathIn copy];
+		sources = [[NSMutableDictionary alloc] initWithCapacity:64];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	[path release];
+	[sources release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize path;
+@synthesize speed;
+@synthesize eventsPlayed;
+@synthesize eventsSkipped;
+@synthesize traceDuration;
+@synthesize replayDuration;
+
+
+#pragma mark Playback
+
+- (bool) replay
+{
+	oal_trace_reader* reader = oal_trace_reader_open([path fileSystemRepresentation]);
+	if(NULL == reader)
+	{
+		OAL_LOG_ERROR(@"Could not open trace file %@", path);
+		return NO;
+	}
+	
+	eventsPlayed = 0;
+	eventsSkipped = 0;
+	traceDuration = 0;
+	[sources removeAllObjects];
+	
+	uint64_t startTime = mach_absolute_time();
+	oal_trace_event event;
+	while(oal_trace_read(reader, &event))
+	{
+		NSTimeInterval eventTime = event.time / 1000000.0;
+		traceDuration = eventTime;
+		if(speed > 0)
+		{
+			NSTimeInterval delay = eventTime / speed - mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+			if(delay > 0)
+			{
+				[NSThread sleepForTimeInterval:delay];
+			}
+		}
+		
+		NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+		[self playEvent:&event reader:reader];
+		[pool release];
+	}
+	replayDuration = mach_absolute_difference_seconds(mach_absolute_time(), startTime);
+	
+	bool success = !oal_trace_reader_failed(reader);
+	if(!success)
+	{
+		OAL_LOG_ERROR(@"Trace file %@ is corrupt after %llu calls", path, eventsPlayed);
+	}
+	oal_trace_reader_close(reader);
+	[sources removeAllObjects];
+	return success;
+}
+
+- (void) playEvent:(const oal_trace_event*) event reader:(oal_trace_reader*) reader
+{
+	OALSimpleAudio* audio = [OALSimpleAudio sharedInstance];
+	NSString* string = nil;
+	switch(event->type)
+	{
+		case OAL_TRACE_PRELOAD_EFFECT:
+		case OAL_TRACE_UNLOAD_EFFECT:
+		case OAL_TRACE_PLAY_EFFECT:
+		case OAL_TRACE_PLAY_BG:
+			string = [NSString stringWithUTF8String:oal_trace_reader_string(reader, event->string)];
+			break;
+		default:
+			break;
+	}
+	
+	ALSource* source = nil;
+	if(event->type >= OAL_TRACE_SOURCE_GAIN)
+	{
+		source = [sources objectForKey:[NSNumber numberWithUnsignedInt:event->handle]];
+		if(nil == source)
+		{
+			eventsSkipped++;
+			return;
+		}
+	}
+	
+	switch(event->type)
+	{
+		case OAL_TRACE_PRELOAD_EFFECT:
+			[audio preloadEffect:string];
+			break;
+		case OAL_TRACE_UNLOAD_EFFECT:
+			[audio unloadEffect:string];
+			break;
+		case OAL_TRACE_UNLOAD_ALL_EFFECTS:
+			[audio unloadAllEffects];
+			break;
+		case OAL_TRACE_PLAY_EFFECT:
+		{
+			id<ALSoundSource> played = [audio playEffect:string
+												  volume:event->values[0]
+												   pitch:event->values[1]
+													 pan:event->values[2]
+													loop:event->intValue & 1
+												priority:(event->intValue - (event->intValue & 1)) / 2];
+			NSNumber* handle = [NSNumber numberWithUnsignedInt:event->handle];
+			if([(id)played isKindOfClass:[ALSource class]])
+			{
+				[sources setObject:played forKey:handle];
+			}
+			else
+			{
+				[sources removeObjectForKey:handle];
+			}
+			break;
+		}
+		case OAL_TRACE_STOP_ALL_EFFECTS:
+			[audio stopAllEffects];
+			break;
+		case OAL_TRACE_PLAY_BG:
+			[audio playBg:string loop:0 != event->intValue];
+			break;
+		case OAL_TRACE_STOP_BG:
+			[audio stopBg];
+			break;
+		case OAL_TRACE_SET_BG_VOLUME:
+			audio.bgVolume = event->values[0];
+			break;
+		case OAL_TRACE_SET_BG_PAUSED:
+			audio.bgPaused = 0 != event->intValue;
+			break;
+		case OAL_TRACE_SET_EFFECTS_VOLUME:
+			audio.effectsVolume = event->values[0];
+			break;
+		case OAL_TRACE_SET_EFFECTS_PAUSED:
+			audio.effectsPaused = 0 != event->intValue;
+			break;
+		case OAL_TRACE_SET_MUTED:
+			audio.muted = 0 != event->intValue;
+			break;
+		case OAL_TRACE_SOURCE_GAIN:
+			source.gain = event->values[0];
+			break;
+		case OAL_TRACE_SOURCE_PITCH:
+			source.pitch = event->values[0];
+			break;
+		case OAL_TRACE_SOURCE_POSITION:
+			source.position = alpoint(event->values[0], event->values[1], event->values[2]);
+			break;
+		case OAL_TRACE_SOURCE_LOOPING:
+			source.looping = 0 != event->intValue;
+			break;
+		case OAL_TRACE_SOURCE_PAUSED:
+			source.paused = 0 != event->intValue;
+			break;
+		case OAL_TRACE_SOURCE_STOP:
+			[source stop];
+			break;
+		case OAL_TRACE_SOURCE_FADE:
+			[source fadeTo:event->values[0] duration:event->values[1] target:nil selector:nil];
+			break;
+		case OAL_TRACE_SOURCE_PAN_TO:
+			[source panTo:event->values[0] duration:event->values[1] target:nil selector:nil];
+			break;
+		case OAL_TRACE_SOURCE_PITCH_TO:
+			[source pitchTo:event->values[0] duration:event->values[1] target:nil selector:nil];
+			break;
+		case OAL_TRACE_SOURCE_STOP_ACTIONS:
+			[source stopActions];
+			break;
+		default:
+			eventsSkipped++;
+			return;
+	}
+	eventsPlayed++;
+}
+
+@end
@@ -0,0 +1,56 @@
+//
+//  OALVorbisDecoder.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "ObjectALConfig.h"
+
+#if OBJECTAL_CFG_USE_VORBIS
+
+#import "OALAudioDecoder.h"
+#import <vorbis/vorbisfile.h>
+
+
+#pragma mark OALVorbisDecoder
+
+/**
+ * Decodes Ogg Vorbis files using libvorbisfile. <br>
+ *
+ * Only available when OBJECTAL_CFG_USE_VORBIS is enabled, in which case you must also link
+ * against libogg and libvorbis.
+ */
+@interface OALVorbisDecoder : NSObject <OALAudioDecoder>
+{
+	OggVorbis_File vorbisFile;
+	/** The number of channels in the file. */
+	int fileChannels;
+	/** The number of channels being output (capped at 2). */
+	int channels;
+	ALsizei frequency;
+	int64_t totalFrames;
+	/** Scratch space for dropping extra channels from files with more than 2. */
+	int16_t* scratch;
+	/** The number of frames scratch can hold. */
+	uint32_t scratchFrames;
+}
+
+@end
+
+#endif /* OBJECTAL_CFG_USE_VORBIS */
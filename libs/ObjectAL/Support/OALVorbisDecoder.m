@@ -0,0 +1,169 @@
+//
+//  OALVorbisDecoder.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALVorbisDecoder.h"
+
+#if OBJECTAL_CFG_USE_VORBIS
+
+#import "ObjectALMacros.h"
+
+
+@implementation OALVorbisDecoder
+
+#pragma mark Object Management
+
++ (id) decoderWithUrl:(NSURL*) url
+{
+	return [[[self alloc] initWithUrl:url] autorelease];
+}
+
+- (id) initWithUrl:(NSURL*) url
+{
+	if(nil != (self = [super init]))
+	{
+		// Pre-declared so that the goto statements are legal in Objective-C++.
+		int error;
+		vorbis_info* info;
+		if(![url isFileURL])
+		{
+			OAL_LOG_ERROR(@"Only file urls are supported: %@", url);
+			goto fail;
+		}
+		if(0 != (error = ov_fopen((char*)[[url path] fileSystemRepresentation], &vorbisFile)))
+		{
+			OAL_LOG_ERROR(@"Could not open url %@ (error %d)", url, error);
+			goto fail;
+		}
+		info = ov_info(&vorbisFile, -1);
+		fileChannels = info->channels;
+		channels = fileChannels > 2 ? 2 : fileChannels;
+		frequency = (ALsizei)info->rate;
+		totalFrames = ov_pcm_total(&vorbisFile, -1);
+		if(fileChannels > 2)
+		{
+			OAL_LOG_WARNING(@"Audio stream for url %@ contains %d channels. Capping at 2.", url, fileChannels);
+		}
+	}
+	return self;
+
+fail:
+	fileChannels = 0;
+	[self release];
+	return nil;
+}
+
+- (void) dealloc
+{
+	if(0 != fileChannels)
+	{
+		ov_clear(&vorbisFile);
+	}
+	free(scratch);
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+- (ALenum) format
+{
+	return 1 == channels ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+}
+
+@synthesize frequency;
+
+- (uint32_t) bytesPerFrame
+{
+	return (uint32_t)channels * sizeof(int16_t);
+}
+
+@synthesize totalFrames;
+
+
+#pragma mark Decoding
+
+- (uint32_t) readFrames:(uint32_t) numFrames into:(void*) buffer
+{
+	// ov_read() outputs all channels, so extra ones must be decoded elsewhere and dropped.
+	char* dest = buffer;
+	if(fileChannels != channels)
+	{
+		if(scratchFrames < numFrames)
+		{
+			free(scratch);
+			scratch = malloc(numFrames * fileChannels * sizeof(int16_t));
+			scratchFrames = numFrames;
+		}
+		dest = (char*)scratch;
+	}
+
+	int fileBytesPerFrame = fileChannels * (int)sizeof(int16_t);
+	int bytesWanted = (int)numFrames * fileBytesPerFrame;
+	int bytesRead = 0;
+	int bitstream;
+	while(bytesRead < bytesWanted)
+	{
+		long result = ov_read(&vorbisFile,
+							  dest + bytesRead,
+							  bytesWanted - bytesRead,
+#if defined(__BIG_ENDIAN__)
+							  1,
+#else
+							  0,
+#endif
+							  2,
+							  1,
+							  &bitstream);
+		if(result <= 0)
+		{
+			if(result < 0)
+			{
+				OAL_LOG_ERROR(@"Error %ld decoding Vorbis data", result);
+			}
+			break;
+		}
+		bytesRead += (int)result;
+	}
+
+	uint32_t framesRead = (uint32_t)(bytesRead / fileBytesPerFrame);
+	if(fileChannels != channels)
+	{
+		int16_t* out = buffer;
+		for(uint32_t frame = 0; frame < framesRead; frame++)
+		{
+			for(int channel = 0; channel < channels; channel++)
+			{
+				*out++ = scratch[frame * (uint32_t)fileChannels + (uint32_t)channel];
+			}
+		}
+	}
+	return framesRead;
+}
+
+- (bool) seekToFrame:(int64_t) frame
+{
+	return 0 == ov_pcm_seek(&vorbisFile, frame);
+}
+
+@end
+
+#endif /* OBJECTAL_CFG_USE_VORBIS */
@@ -0,0 +1,42 @@
+//
+//  OALWavDecoder.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALAudioDecoder.h"
+#import "oal_wav.h"
+
+
+#pragma mark OALWavDecoder
+
+/**
+ * Decodes RIFF/WAVE files containing 8, 16, 24 or 32 bit integer PCM or 32 bit float data. <br>
+ *
+ * The parsing and sample conversion is done by oal_wav.c, which depends only on the C standard
+ * library. Files in other encodings (such as ADPCM) are declined so that the default decoder
+ * can handle them.
+ */
+@interface OALWavDecoder : NSObject <OALAudioDecoder>
+{
+	oal_wav_file wav;
+	uint16_t channels;
+}
+
+@end
@@ -0,0 +1,92 @@
+//
+//  OALWavDecoder.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALWavDecoder.h"
+
+
+@implementation OALWavDecoder
+
+#pragma mark Object Management
+
++ (id) decoderWithUrl:(NSURL*) url
+{
+	return [[[self alloc] initWithUrl:url] autorelease];
+}
+
+- (id) initWithUrl:(NSURL*) url
+{
+	if(nil != (self = [super init]))
+	{
+		if(![url isFileURL] || !oal_wav_open(&wav, [[url path] fileSystemRepresentation]))
+		{
+			[self release];
+			return nil;
+		}
+		// Don't allow more than 2 channels (stereo)
+		channels = wav.channels > 2 ? 2 : wav.channels;
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	oal_wav_close(&wav);
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+- (ALenum) format
+{
+	return 1 == channels ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+}
+
+- (ALsizei) frequency
+{
+	return (ALsizei)wav.sampleRate;
+}
+
+- (uint32_t) bytesPerFrame
+{
+	return channels * sizeof(int16_t);
+}
+
+- (int64_t) totalFrames
+{
+	return (int64_t)wav.numFrames;
+}
+
+
+#pragma mark Decoding
+
+- (uint32_t) readFrames:(uint32_t) numFrames into:(void*) buffer
+{
+	return oal_wav_read16(&wav, (int16_t*)buffer, numFrames, 2);
+}
+
+- (bool) seekToFrame:(int64_t) frame
+{
+	return frame >= 0 && oal_wav_seek(&wav, (uint64_t)frame);
+}
+
+@end
@@ -8,9 +8,26 @@
 
 #include "mach_timing.h"
 
-double mach_absolute_difference_seconds(uint64_t endTime, uint64_t startTime)
+#ifndef __APPLE__
+
+#include <time.h>
+
+uint64_t mach_absolute_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static double mach_seconds_per_unit(void)
+{
+	return 1e-9;
+}
+
+#else
+
+static double mach_seconds_per_unit(void)
 {
-    uint64_t difference = endTime - startTime;
     static double conversion = 0.0;
     
     if(0 == conversion)
@@ -24,6 +41,24 @@ double mach_absolute_difference_seconds(uint64_t endTime, uint64_t startTime)
 			conversion = 1e-9 * (double)info.numer / (double)info.denom;
 		}
     }
+    return conversion;
+}
+
+#endif /* __APPLE__ */
+
+double mach_absolute_difference_seconds(uint64_t endTime, uint64_t startTime)
+{
+    uint64_t difference = endTime - startTime;
     
-    return conversion * (double)difference;
+    return mach_seconds_per_unit() * (double)difference;
+}
+
+uint64_t mach_absolute_from_seconds(double seconds)
+{
+    double conversion = mach_seconds_per_unit();
+    if(0 == conversion)
+    {
+        return 0;
+    }
+    return (uint64_t)(seconds / conversion);
 }
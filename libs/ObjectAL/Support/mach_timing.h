@@ -6,7 +6,18 @@
  *
  */
 
+#ifdef __APPLE__
 #include <mach/mach_time.h>
+#else
+#include <stdint.h>
+
+/** Stands in for the Mach call everywhere else (such as the headless benchmark on Linux).
+ * Units are nanoseconds of the monotonic clock.
+ *
+ * @return the current time.
+ */
+uint64_t mach_absolute_time(void);
+#endif
 
 /** Calculates the difference, in seconds, between two time values that were
  * obtained through mach_absolute_time().
@@ -16,3 +27,10 @@
  * @return the time difference in seconds.
  */
 double mach_absolute_difference_seconds(uint64_t endTime, uint64_t startTime);
+
+/** Converts a duration in seconds into mach_absolute_time() units.
+ *
+ * @param seconds the duration in seconds.
+ * @return the duration in mach absolute time units.
+ */
+uint64_t mach_absolute_from_seconds(double seconds);
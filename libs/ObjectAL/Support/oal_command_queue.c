@@ -0,0 +1,155 @@
+/*
+ *  oal_command_queue.c
+ *  ObjectAL
+ *
+ */
+
+#include "oal_command_queue.h"
+#include <stdlib.h>
+
+
+/** A slot in the ring.  The sequence number tells producers and the consumer
+ * whose turn it is to use the slot (see oal_command_queue_push()).
+ */
+typedef struct
+{
+	volatile unsigned long sequence;
+	oal_command command;
+} oal_command_slot;
+
+struct oal_command_queue
+{
+	oal_command_slot* slots;
+	unsigned long mask;
+	
+	/* Keep the producer and consumer positions on separate cache lines so that
+	 * producers don't slow down the consumer and vice versa.
+	 */
+	char pad0[64];
+	/** The next position producers will claim. */
+	volatile unsigned long pushPosition;
+	char pad1[64];
+	/** The next position the consumer will read. */
+	volatile unsigned long popPosition;
+	char pad2[64];
+	/** The number of commands executed so far. */
+	volatile unsigned long completed;
+	char pad3[64];
+};
+
+
+#pragma mark Queue
+
+oal_command_queue* oal_command_queue_create(unsigned int capacity)
+{
+	unsigned long size = 2;
+	while(size < capacity)
+	{
+		size <<= 1;
+	}
+	
+	oal_command_queue* queue = calloc(1, sizeof(*queue));
+	if(NULL == queue)
+	{
+		return NULL;
+	}
+	queue->slots = malloc(sizeof(*queue->slots) * size);
+	if(NULL == queue->slots)
+	{
+		free(queue);
+		return NULL;
+	}
+	queue->mask = size - 1;
+	for(unsigned long i = 0; i < size; i++)
+	{
+		queue->slots[i].sequence = i;
+	}
+	return queue;
+}
+
+void oal_command_queue_destroy(oal_command_queue* queue)
+{
+	if(NULL != queue)
+	{
+		free(queue->slots);
+		free(queue);
+	}
+}
+
+bool oal_command_queue_push(oal_command_queue* queue, const oal_command* command)
+{
+	/* A slot whose sequence equals the position is free for the producer that
+	 * claims that position.  Once filled, its sequence becomes position + 1, which
+	 * tells the consumer it can be read.
+	 */
+	unsigned long position = queue->pushPosition;
+	for(;;)
+	{
+		oal_command_slot* slot = &queue->slots[position & queue->mask];
+		unsigned long sequence = slot->sequence;
+		long difference = (long)(sequence - position);
+		if(0 == difference)
+		{
+			if(__sync_bool_compare_and_swap(&queue->pushPosition, position, position + 1))
+			{
+				slot->command = *command;
+				__sync_synchronize();
+				slot->sequence = position + 1;
+				return true;
+			}
+			position = queue->pushPosition;
+		}
+		else if(difference < 0)
+		{
+			/* The consumer hasn't freed this slot yet. */
+			return false;
+		}
+		else
+		{
+			/* Another producer claimed this position first. */
+			position = queue->pushPosition;
+		}
+	}
+}
+
+unsigned int oal_command_queue_pop(oal_command_queue* queue, oal_command* commands, unsigned int maxCommands)
+{
+	unsigned long position = queue->popPosition;
+	unsigned int count = 0;
+	while(count < maxCommands)
+	{
+		oal_command_slot* slot = &queue->slots[position & queue->mask];
+		if(slot->sequence != position + 1)
+		{
+			/* Empty, or a producer is still filling this slot. */
+			break;
+		}
+		__sync_synchronize();
+		commands[count++] = slot->command;
+		__sync_synchronize();
+		/* Hand the slot back to producers for the next lap around the ring. */
+		slot->sequence = position + queue->mask + 1;
+		position++;
+	}
+	queue->popPosition = position;
+	return count;
+}
+
+void oal_command_queue_complete(oal_command_queue* queue, unsigned int numCommands)
+{
+	__sync_synchronize();
+	queue->completed += numCommands;
+	__sync_synchronize();
+}
+
+unsigned long oal_command_queue_mark(oal_command_queue* queue)
+{
+	__sync_synchronize();
+	return queue->pushPosition;
+}
+
+bool oal_command_queue_is_complete(oal_command_queue* queue, unsigned long mark)
+{
+	__sync_synchronize();
+	return (long)(queue->completed - mark) >= 0;
+}
@@ -0,0 +1,115 @@
+/*
+ *  oal_command_queue.h
+ *  ObjectAL
+ *
+ *  Bounded lock-free queue of compact audio commands. Any number of threads may push,
+ *  one thread pops. Pushing never takes a lock, so game threads never wait on each
+ *  other or on the thread executing the commands. This file only depends on the C
+ *  standard library and GCC/Clang atomic builtins, so it can be built and profiled on
+ *  any platform.
+ */
+
+#ifndef OAL_COMMAND_QUEUE_H
+#define OAL_COMMAND_QUEUE_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The kinds of command that can be queued. */
+typedef enum
+{
+	OAL_COMMAND_SOURCEF,
+	OAL_COMMAND_SOURCE3F,
+	OAL_COMMAND_SOURCEI,
+	OAL_COMMAND_SOURCE3I,
+	OAL_COMMAND_SOURCE_PLAY,
+	OAL_COMMAND_SOURCE_PAUSE,
+	OAL_COMMAND_SOURCE_STOP,
+	OAL_COMMAND_SOURCE_REWIND,
+	OAL_COMMAND_LISTENERF,
+	OAL_COMMAND_LISTENER3F,
+	OAL_COMMAND_LISTENERI,
+	OAL_COMMAND_LISTENER3I,
+} oal_command_type;
+
+/** A queued command. */
+typedef struct
+{
+	/** What to do (an oal_command_type). */
+	unsigned int type;
+	/** The source ID (unused for listener commands). */
+	unsigned int object;
+	/** The parameter to set. */
+	int parameter;
+	/** The values to set it to. */
+	union
+	{
+		float f[3];
+		int i[3];
+	} values;
+} oal_command;
+
+/** A command queue. Treat as opaque. */
+typedef struct oal_command_queue oal_command_queue;
+
+/** Create a command queue.
+ *
+ * @param capacity The maximum number of commands the queue can hold (rounded up to a power of 2).
+ * @return The new queue, or NULL if out of memory.
+ */
+oal_command_queue* oal_command_queue_create(unsigned int capacity);
+
+/** Destroy a command queue.
+ *
+ * @param queue The queue to destroy.
+ */
+void oal_command_queue_destroy(oal_command_queue* queue);
+
+/** Add a command to the queue.  Safe to call from any number of threads at once.
+ *
+ * @param queue The queue.
+ * @param command The command to add (copied).
+ * @return TRUE if the command was added, FALSE if the queue was full.
+ */
+bool oal_command_queue_push(oal_command_queue* queue, const oal_command* command);
+
+/** Take commands off the queue, oldest first.  Must only be called from one thread at a time.
+ * Call oal_command_queue_complete() once they've been executed.
+ *
+ * @param queue The queue.
+ * @param commands Where to store the commands.
+ * @param maxCommands The maximum number of commands to take.
+ * @return The number of commands taken.
+ */
+unsigned int oal_command_queue_pop(oal_command_queue* queue, oal_command* commands, unsigned int maxCommands);
+
+/** Mark commands taken by oal_command_queue_pop() as executed.
+ *
+ * @param queue The queue.
+ * @param numCommands The number of commands executed.
+ */
+void oal_command_queue_complete(oal_command_queue* queue, unsigned int numCommands);
+
+/** Get a marker for the commands pushed so far.
+ *
+ * @param queue The queue.
+ * @return A marker to pass to oal_command_queue_is_complete().
+ */
+unsigned long oal_command_queue_mark(oal_command_queue* queue);
+
+/** Check if all commands pushed before a marker was taken have been executed.
+ *
+ * @param queue The queue.
+ * @param mark A marker from oal_command_queue_mark().
+ * @return TRUE if they have all been executed.
+ */
+bool oal_command_queue_is_complete(oal_command_queue* queue, unsigned long mark);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_COMMAND_QUEUE_H */
@@ -0,0 +1,878 @@
+/*
+ *  oal_emitter_grid.c
+ *  ObjectAL
+ *
+ */
+
+#include "oal_emitter_grid.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+
+/** Cell coordinates are clamped to +- this value. */
+#define kMaxCellCoordinate (1 << 20)
+
+#define kInitialEmitterCapacity 64
+#define kInitialCellCapacity 256
+
+
+/** An emitter in the grid. */
+typedef struct
+{
+	float x, y, z;
+	float gain;
+	float referenceDistance;
+	float rolloffFactor;
+	float maxDistance;
+	int priority;
+	double endTime;
+	void* userData;
+	/** Index of the cell this emitter is in (-1 = in the prioritized list). */
+	int cell;
+	/** Next and previous emitters in the same cell (-1 = none). "next" also links the free list. */
+	int next;
+	int prev;
+	bool alive;
+} oal_emitter;
+
+/** A cell in the hash table. Cells stay allocated when they become empty. */
+typedef struct
+{
+	int32_t x, y, z;
+	/** First emitter in this cell (-1 = none). */
+	int head;
+	unsigned int count;
+	bool used;
+} oal_cell;
+
+struct oal_emitter_grid
+{
+	float cellSize;
+	float invCellSize;
+
+	oal_emitter* emitters;
+	int emitterCapacity;
+	/** Number of emitter slots that have ever been used. */
+	int emitterHighWater;
+	/** First free emitter slot (-1 = none). */
+	int freeList;
+	unsigned int count;
+
+	/** Open addressing hash table of cells. Capacity is always a power of 2. */
+	oal_cell* cells;
+	unsigned int cellCapacity;
+	unsigned int numCells;
+
+	/** Emitters with a priority other than 0 are rare, so they are kept in a plain list
+	 * (-1 = empty) that every query walks, rather than in the cells.  This keeps the
+	 * cell search prunable by distance alone.
+	 */
+	int prioritized;
+
+	/** Bounding box of all cells that have held emitters. */
+	int32_t minCell[3];
+	int32_t maxCell[3];
+
+	/** Upper bounds of the emitter properties, used to prune the search.
+	 * They only ever widen, and get recalculated once enough changes have accumulated.
+	 */
+	float maxGain;
+	float maxReferenceDistance;
+	float minRolloffFactor;
+	float minMaxDistance;
+	float maxMaxDistance;
+	unsigned int boundsChanges;
+
+	/** Scratch min-heap used by queries. */
+	int* heapEmitters;
+	float* heapAudibilities;
+	unsigned int heapCapacity;
+};
+
+
+#pragma mark Distance Models
+
+float oal_distance_attenuation(oal_distance_model model,
+							   float distance,
+							   float referenceDistance,
+							   float rolloffFactor,
+							   float maxDistance)
+{
+	float result;
+	switch(model)
+	{
+		case OAL_DISTANCE_INVERSE_CLAMPED:
+			if(distance < referenceDistance) distance = referenceDistance;
+			if(distance > maxDistance) distance = maxDistance;
+			// Fall through
+		case OAL_DISTANCE_INVERSE:
+		{
+			float denominator = referenceDistance + rolloffFactor * (distance - referenceDistance);
+			result = denominator > 0 ? referenceDistance / denominator : 1.0f;
+			break;
+		}
+		case OAL_DISTANCE_LINEAR_CLAMPED:
+			if(distance < referenceDistance) distance = referenceDistance;
+			// Fall through
+		case OAL_DISTANCE_LINEAR:
+			if(distance > maxDistance) distance = maxDistance;
+			if(maxDistance <= referenceDistance)
+			{
+				result = distance <= referenceDistance ? 1.0f : 0.0f;
+			}
+			else
+			{
+				result = 1.0f - rolloffFactor * (distance - referenceDistance) / (maxDistance - referenceDistance);
+			}
+			break;
+		case OAL_DISTANCE_EXPONENT_CLAMPED:
+			if(distance < referenceDistance) distance = referenceDistance;
+			if(distance > maxDistance) distance = maxDistance;
+			// Fall through
+		case OAL_DISTANCE_EXPONENT:
+			result = (distance > 0 && referenceDistance > 0) ? powf(distance / referenceDistance, -rolloffFactor) : 1.0f;
+			break;
+		default:
+			result = 1.0f;
+			break;
+	}
+
+	if(!(result > 0.0f)) return 0.0f;
+	if(result > 1.0f) return 1.0f;
+	return result;
+}
+
+/** The loudest any emitter in the grid could be at the specified distance.
+ * Attenuation always falls with distance and reference distance, and rises with rolloff.
+ * It can go either way with max distance, so both extremes are tried.
+ */
+static float loudest_at_distance(const oal_emitter_grid* grid, oal_distance_model model, float distance)
+{
+	float a = oal_distance_attenuation(model, distance, grid->maxReferenceDistance, grid->minRolloffFactor, grid->minMaxDistance);
+	float b = oal_distance_attenuation(model, distance, grid->maxReferenceDistance, grid->minRolloffFactor, grid->maxMaxDistance);
+	return grid->maxGain * (a > b ? a : b);
+}
+
+
+#pragma mark Cells
+
+static int32_t cell_coordinate(const oal_emitter_grid* grid, float value)
+{
+	float cell = floorf(value * grid->invCellSize);
+	if(!(cell > -kMaxCellCoordinate)) return -kMaxCellCoordinate;
+	if(cell > kMaxCellCoordinate) return kMaxCellCoordinate;
+	return (int32_t)cell;
+}
+
+static unsigned int cell_hash(int32_t x, int32_t y, int32_t z)
+{
+	uint32_t hash = (uint32_t)x * 73856093u;
+	hash ^= (uint32_t)y * 19349663u;
+	hash ^= (uint32_t)z * 83492791u;
+	return hash ^ (hash >> 16);
+}
+
+/** Find a cell's slot in the table, or the empty slot where it would go. */
+static unsigned int find_cell_slot(const oal_emitter_grid* grid, int32_t x, int32_t y, int32_t z)
+{
+	unsigned int mask = grid->cellCapacity - 1;
+	unsigned int slot = cell_hash(x, y, z) & mask;
+	for(;;)
+	{
+		const oal_cell* cell = &grid->cells[slot];
+		if(!cell->used || (cell->x == x && cell->y == y && cell->z == z))
+		{
+			return slot;
+		}
+		slot = (slot + 1) & mask;
+	}
+}
+
+/** Rebuild the cell table at the specified capacity, dropping cells that are empty. */
+static bool rebuild_cells(oal_emitter_grid* grid, unsigned int capacity)
+{
+	oal_cell* oldCells = grid->cells;
+	unsigned int oldCapacity = grid->cellCapacity;
+	oal_cell* newCells = calloc(capacity, sizeof(*newCells));
+	if(NULL == newCells)
+	{
+		return false;
+	}
+
+	grid->cells = newCells;
+	grid->cellCapacity = capacity;
+	grid->numCells = 0;
+	for(int axis = 0; axis < 3; axis++)
+	{
+		grid->minCell[axis] = INT32_MAX;
+		grid->maxCell[axis] = INT32_MIN;
+	}
+
+	for(unsigned int i = 0; i < oldCapacity; i++)
+	{
+		oal_cell* oldCell = &oldCells[i];
+		if(oldCell->used && oldCell->count > 0)
+		{
+			unsigned int slot = find_cell_slot(grid, oldCell->x, oldCell->y, oldCell->z);
+			newCells[slot] = *oldCell;
+			grid->numCells++;
+			if(oldCell->x < grid->minCell[0]) grid->minCell[0] = oldCell->x;
+			if(oldCell->y < grid->minCell[1]) grid->minCell[1] = oldCell->y;
+			if(oldCell->z < grid->minCell[2]) grid->minCell[2] = oldCell->z;
+			if(oldCell->x > grid->maxCell[0]) grid->maxCell[0] = oldCell->x;
+			if(oldCell->y > grid->maxCell[1]) grid->maxCell[1] = oldCell->y;
+			if(oldCell->z > grid->maxCell[2]) grid->maxCell[2] = oldCell->z;
+
+			// The emitters point to their cell by index.
+			for(int e = oldCell->head; e >= 0; e = grid->emitters[e].next)
+			{
+				grid->emitters[e].cell = (int)slot;
+			}
+		}
+	}
+	free(oldCells);
+	return true;
+}
+
+/** Get the index of a cell, creating it if needed (-1 = out of memory). */
+static int get_cell(oal_emitter_grid* grid, int32_t x, int32_t y, int32_t z)
+{
+	unsigned int slot = find_cell_slot(grid, x, y, z);
+	oal_cell* cell = &grid->cells[slot];
+	if(cell->used)
+	{
+		return (int)slot;
+	}
+
+	if((grid->numCells + 1) * 2 > grid->cellCapacity)
+	{
+		if(!rebuild_cells(grid, grid->cellCapacity * 2))
+		{
+			return -1;
+		}
+		slot = find_cell_slot(grid, x, y, z);
+		cell = &grid->cells[slot];
+	}
+
+	cell->used = true;
+	cell->x = x;
+	cell->y = y;
+	cell->z = z;
+	cell->head = -1;
+	cell->count = 0;
+	grid->numCells++;
+	if(x < grid->minCell[0]) grid->minCell[0] = x;
+	if(y < grid->minCell[1]) grid->minCell[1] = y;
+	if(z < grid->minCell[2]) grid->minCell[2] = z;
+	if(x > grid->maxCell[0]) grid->maxCell[0] = x;
+	if(y > grid->maxCell[1]) grid->maxCell[1] = y;
+	if(z > grid->maxCell[2]) grid->maxCell[2] = z;
+	return (int)slot;
+}
+
+static void unlink_emitter(oal_emitter_grid* grid, int index)
+{
+	oal_emitter* emitter = &grid->emitters[index];
+	int* head = emitter->cell >= 0 ? &grid->cells[emitter->cell].head : &grid->prioritized;
+	if(emitter->prev >= 0)
+	{
+		grid->emitters[emitter->prev].next = emitter->next;
+	}
+	else
+	{
+		*head = emitter->next;
+	}
+	if(emitter->next >= 0)
+	{
+		grid->emitters[emitter->next].prev = emitter->prev;
+	}
+	if(emitter->cell >= 0)
+	{
+		grid->cells[emitter->cell].count--;
+	}
+}
+
+static bool link_emitter(oal_emitter_grid* grid, int index)
+{
+	oal_emitter* emitter = &grid->emitters[index];
+	if(0 != emitter->priority)
+	{
+		emitter->cell = -1;
+		emitter->prev = -1;
+		emitter->next = grid->prioritized;
+		if(grid->prioritized >= 0)
+		{
+			grid->emitters[grid->prioritized].prev = index;
+		}
+		grid->prioritized = index;
+		return true;
+	}
+	
+	int cellIndex = get_cell(grid,
+							 cell_coordinate(grid, emitter->x),
+							 cell_coordinate(grid, emitter->y),
+							 cell_coordinate(grid, emitter->z));
+	if(cellIndex < 0)
+	{
+		return false;
+	}
+	oal_cell* cell = &grid->cells[cellIndex];
+	emitter->cell = cellIndex;
+	emitter->prev = -1;
+	emitter->next = cell->head;
+	if(cell->head >= 0)
+	{
+		grid->emitters[cell->head].prev = index;
+	}
+	cell->head = index;
+	cell->count++;
+	return true;
+}
+
+
+#pragma mark Bounds
+
+static void widen_bounds(oal_emitter_grid* grid, const oal_emitter* emitter)
+{
+	if(emitter->gain > grid->maxGain) grid->maxGain = emitter->gain;
+	if(emitter->referenceDistance > grid->maxReferenceDistance) grid->maxReferenceDistance = emitter->referenceDistance;
+	if(emitter->rolloffFactor < grid->minRolloffFactor) grid->minRolloffFactor = emitter->rolloffFactor;
+	if(emitter->maxDistance < grid->minMaxDistance) grid->minMaxDistance = emitter->maxDistance;
+	if(emitter->maxDistance > grid->maxMaxDistance) grid->maxMaxDistance = emitter->maxDistance;
+}
+
+static void recalculate_bounds(oal_emitter_grid* grid)
+{
+	grid->maxGain = 0;
+	grid->maxReferenceDistance = 0;
+	grid->minRolloffFactor = FLT_MAX;
+	grid->minMaxDistance = FLT_MAX;
+	grid->maxMaxDistance = 0;
+	grid->boundsChanges = 0;
+	for(int i = 0; i < grid->emitterHighWater; i++)
+	{
+		if(grid->emitters[i].alive)
+		{
+			widen_bounds(grid, &grid->emitters[i]);
+		}
+	}
+}
+
+
+#pragma mark Grid
+
+oal_emitter_grid* oal_emitter_grid_create(float cellSize)
+{
+	oal_emitter_grid* grid = calloc(1, sizeof(*grid));
+	if(NULL == grid)
+	{
+		return NULL;
+	}
+
+	grid->cellSize = cellSize > 0 ? cellSize : 1.0f;
+	grid->invCellSize = 1.0f / grid->cellSize;
+	grid->freeList = -1;
+	grid->prioritized = -1;
+	grid->emitterCapacity = kInitialEmitterCapacity;
+	grid->emitters = malloc(sizeof(*grid->emitters) * (size_t)grid->emitterCapacity);
+	grid->cellCapacity = kInitialCellCapacity;
+	grid->cells = calloc(grid->cellCapacity, sizeof(*grid->cells));
+	if(NULL == grid->emitters || NULL == grid->cells)
+	{
+		oal_emitter_grid_destroy(grid);
+		return NULL;
+	}
+	for(int axis = 0; axis < 3; axis++)
+	{
+		grid->minCell[axis] = INT32_MAX;
+		grid->maxCell[axis] = INT32_MIN;
+	}
+	recalculate_bounds(grid);
+	return grid;
+}
+
+void oal_emitter_grid_destroy(oal_emitter_grid* grid)
+{
+	if(NULL != grid)
+	{
+		free(grid->emitters);
+		free(grid->cells);
+		free(grid->heapEmitters);
+		free(grid->heapAudibilities);
+		free(grid);
+	}
+}
+
+int oal_emitter_grid_add(oal_emitter_grid* grid, void* userData)
+{
+	int index = grid->freeList;
+	if(index >= 0)
+	{
+		grid->freeList = grid->emitters[index].next;
+	}
+	else
+	{
+		if(grid->emitterHighWater == grid->emitterCapacity)
+		{
+			int newCapacity = grid->emitterCapacity * 2;
+			oal_emitter* newEmitters = realloc(grid->emitters, sizeof(*newEmitters) * (size_t)newCapacity);
+			if(NULL == newEmitters)
+			{
+				return -1;
+			}
+			grid->emitters = newEmitters;
+			grid->emitterCapacity = newCapacity;
+		}
+		index = grid->emitterHighWater++;
+	}
+
+	oal_emitter* emitter = &grid->emitters[index];
+	memset(emitter, 0, sizeof(*emitter));
+	emitter->gain = 1.0f;
+	emitter->referenceDistance = 1.0f;
+	emitter->rolloffFactor = 1.0f;
+	emitter->maxDistance = FLT_MAX;
+	emitter->endTime = INFINITY;
+	emitter->userData = userData;
+	if(!link_emitter(grid, index))
+	{
+		emitter->next = grid->freeList;
+		grid->freeList = index;
+		return -1;
+	}
+	emitter->alive = true;
+	widen_bounds(grid, emitter);
+	grid->count++;
+	return index;
+}
+
+void oal_emitter_grid_remove(oal_emitter_grid* grid, int index)
+{
+	if(index < 0 || index >= grid->emitterHighWater || !grid->emitters[index].alive)
+	{
+		return;
+	}
+	unlink_emitter(grid, index);
+	grid->emitters[index].alive = false;
+	grid->emitters[index].userData = NULL;
+	grid->emitters[index].next = grid->freeList;
+	grid->freeList = index;
+	grid->count--;
+}
+
+void oal_emitter_grid_move(oal_emitter_grid* grid, int index, float x, float y, float z)
+{
+	if(index < 0 || index >= grid->emitterHighWater || !grid->emitters[index].alive)
+	{
+		return;
+	}
+	oal_emitter* emitter = &grid->emitters[index];
+	emitter->x = x;
+	emitter->y = y;
+	emitter->z = z;
+	if(emitter->cell < 0)
+	{
+		return;
+	}
+	const oal_cell* cell = &grid->cells[emitter->cell];
+	if(cell->x != cell_coordinate(grid, x)
+	   || cell->y != cell_coordinate(grid, y)
+	   || cell->z != cell_coordinate(grid, z))
+	{
+		unlink_emitter(grid, index);
+		if(!link_emitter(grid, index))
+		{
+			// Out of memory. Keep it in its old cell, which is still allocated.
+			int cellIndex = (int)(cell - grid->cells);
+			oal_cell* oldCell = &grid->cells[cellIndex];
+			emitter->cell = cellIndex;
+			emitter->prev = -1;
+			emitter->next = oldCell->head;
+			if(oldCell->head >= 0)
+			{
+				grid->emitters[oldCell->head].prev = index;
+			}
+			oldCell->head = index;
+			oldCell->count++;
+		}
+	}
+}
+
+void oal_emitter_grid_set_properties(oal_emitter_grid* grid,
+									 int index,
+									 float gain,
+									 int priority,
+									 float referenceDistance,
+									 float rolloffFactor,
+									 float maxDistance)
+{
+	if(index < 0 || index >= grid->emitterHighWater || !grid->emitters[index].alive)
+	{
+		return;
+	}
+	oal_emitter* emitter = &grid->emitters[index];
+	if((0 == priority) != (0 == emitter->priority))
+	{
+		// Move between the cells and the prioritized list.
+		unlink_emitter(grid, index);
+		emitter->priority = priority;
+		if(!link_emitter(grid, index))
+		{
+			// Out of memory. The prioritized list always has room.
+			emitter->priority = priority != 0 ? priority : INT_MIN;
+			link_emitter(grid, index);
+			emitter->priority = priority;
+		}
+	}
+	emitter->gain = gain;
+	emitter->priority = priority;
+	emitter->referenceDistance = referenceDistance;
+	emitter->rolloffFactor = rolloffFactor;
+	emitter->maxDistance = maxDistance;
+	widen_bounds(grid, emitter);
+	grid->boundsChanges++;
+}
+
+void oal_emitter_grid_set_end_time(oal_emitter_grid* grid, int index, double endTime)
+{
+	if(index < 0 || index >= grid->emitterHighWater || !grid->emitters[index].alive)
+	{
+		return;
+	}
+	grid->emitters[index].endTime = endTime;
+}
+
+void* oal_emitter_grid_user_data(oal_emitter_grid* grid, int index)
+{
+	if(index < 0 || index >= grid->emitterHighWater || !grid->emitters[index].alive)
+	{
+		return NULL;
+	}
+	return grid->emitters[index].userData;
+}
+
+unsigned int oal_emitter_grid_count(oal_emitter_grid* grid)
+{
+	return grid->count;
+}
+
+unsigned int oal_emitter_grid_expired(oal_emitter_grid* grid,
+									  double time,
+									  int* emitters,
+									  unsigned int maxEmitters)
+{
+	unsigned int numFound = 0;
+	for(int i = 0; i < grid->emitterHighWater && numFound < maxEmitters; i++)
+	{
+		if(grid->emitters[i].alive && grid->emitters[i].endTime <= time)
+		{
+			emitters[numFound++] = i;
+		}
+	}
+	return numFound;
+}
+
+
+#pragma mark Query
+
+/** State of a query in progress. */
+typedef struct
+{
+	oal_emitter_grid* grid;
+	oal_distance_model model;
+	float x, y, z;
+	double time;
+	float minAudibility;
+	unsigned int maxEmitters;
+	unsigned int heapCount;
+} oal_query;
+
+/** TRUE if emitter a ranks below emitter b. */
+static bool ranks_below(const oal_emitter_grid* grid, int a, float audibilityA, int b, float audibilityB)
+{
+	int priorityA = grid->emitters[a].priority;
+	int priorityB = grid->emitters[b].priority;
+	if(priorityA != priorityB)
+	{
+		return priorityA < priorityB;
+	}
+	return audibilityA < audibilityB;
+}
+
+static void heap_sift_down(oal_query* query, unsigned int index)
+{
+	oal_emitter_grid* grid = query->grid;
+	int* ids = grid->heapEmitters;
+	float* audibilities = grid->heapAudibilities;
+	for(;;)
+	{
+		unsigned int lowest = index;
+		unsigned int left = index * 2 + 1;
+		unsigned int right = left + 1;
+		if(left < query->heapCount && ranks_below(grid, ids[left], audibilities[left], ids[lowest], audibilities[lowest]))
+		{
+			lowest = left;
+		}
+		if(right < query->heapCount && ranks_below(grid, ids[right], audibilities[right], ids[lowest], audibilities[lowest]))
+		{
+			lowest = right;
+		}
+		if(lowest == index)
+		{
+			return;
+		}
+		int id = ids[index]; ids[index] = ids[lowest]; ids[lowest] = id;
+		float audibility = audibilities[index]; audibilities[index] = audibilities[lowest]; audibilities[lowest] = audibility;
+		index = lowest;
+	}
+}
+
+static void heap_sift_up(oal_query* query, unsigned int index)
+{
+	oal_emitter_grid* grid = query->grid;
+	int* ids = grid->heapEmitters;
+	float* audibilities = grid->heapAudibilities;
+	while(index > 0)
+	{
+		unsigned int parent = (index - 1) / 2;
+		if(!ranks_below(grid, ids[index], audibilities[index], ids[parent], audibilities[parent]))
+		{
+			return;
+		}
+		int id = ids[index]; ids[index] = ids[parent]; ids[parent] = id;
+		float audibility = audibilities[index]; audibilities[index] = audibilities[parent]; audibilities[parent] = audibility;
+		index = parent;
+	}
+}
+
+static void visit_emitters(oal_query* query, int head)
+{
+	oal_emitter_grid* grid = query->grid;
+	for(int i = head; i >= 0; i = grid->emitters[i].next)
+	{
+		const oal_emitter* emitter = &grid->emitters[i];
+		if(emitter->endTime <= query->time)
+		{
+			continue;
+		}
+
+		float dx = emitter->x - query->x;
+		float dy = emitter->y - query->y;
+		float dz = emitter->z - query->z;
+		float distance = sqrtf(dx*dx + dy*dy + dz*dz);
+		float audibility = emitter->gain * oal_distance_attenuation(query->model,
+																	distance,
+																	emitter->referenceDistance,
+																	emitter->rolloffFactor,
+																	emitter->maxDistance);
+		if(audibility < query->minAudibility)
+		{
+			continue;
+		}
+
+		if(query->heapCount < query->maxEmitters)
+		{
+			grid->heapEmitters[query->heapCount] = i;
+			grid->heapAudibilities[query->heapCount] = audibility;
+			heap_sift_up(query, query->heapCount++);
+		}
+		else if(ranks_below(grid, grid->heapEmitters[0], grid->heapAudibilities[0], i, audibility))
+		{
+			grid->heapEmitters[0] = i;
+			grid->heapAudibilities[0] = audibility;
+			heap_sift_down(query, 0);
+		}
+	}
+}
+
+static void visit_cell_at(oal_query* query, int32_t x, int32_t y, int32_t z)
+{
+	unsigned int slot = find_cell_slot(query->grid, x, y, z);
+	const oal_cell* cell = &query->grid->cells[slot];
+	if(cell->used && cell->count > 0)
+	{
+		visit_emitters(query, cell->head);
+	}
+}
+
+static int32_t max32(int32_t a, int32_t b) { return a > b ? a : b; }
+static int32_t min32(int32_t a, int32_t b) { return a < b ? a : b; }
+
+/** Number of cells in the cube [center - radius, center + radius], clipped to the bounding box. */
+static uint64_t cells_in_cube(const oal_emitter_grid* grid, const int32_t* center, int32_t radius)
+{
+	if(radius < 0)
+	{
+		return 0;
+	}
+	uint64_t result = 1;
+	for(int axis = 0; axis < 3; axis++)
+	{
+		int32_t low = max32(center[axis] - radius, grid->minCell[axis]);
+		int32_t high = min32(center[axis] + radius, grid->maxCell[axis]);
+		if(high < low)
+		{
+			return 0;
+		}
+		result *= (uint64_t)(high - low + 1);
+	}
+	return result;
+}
+
+/** Visit the cells at Chebyshev distance "ring" from the center, within the bounding box. */
+static void visit_ring(oal_query* query, const int32_t* center, int32_t ring)
+{
+	const oal_emitter_grid* grid = query->grid;
+	int32_t low[3];
+	int32_t high[3];
+	for(int axis = 0; axis < 3; axis++)
+	{
+		low[axis] = max32(center[axis] - ring, grid->minCell[axis]);
+		high[axis] = min32(center[axis] + ring, grid->maxCell[axis]);
+	}
+
+	for(int32_t x = low[0]; x <= high[0]; x++)
+	{
+		bool xOnRing = x == center[0] - ring || x == center[0] + ring;
+		for(int32_t y = low[1]; y <= high[1]; y++)
+		{
+			bool yOnRing = y == center[1] - ring || y == center[1] + ring;
+			if(xOnRing || yOnRing)
+			{
+				for(int32_t z = low[2]; z <= high[2]; z++)
+				{
+					visit_cell_at(query, x, y, z);
+				}
+			}
+			else
+			{
+				// Only the two faces of the ring along z.
+				if(center[2] - ring >= low[2])
+				{
+					visit_cell_at(query, x, y, center[2] - ring);
+				}
+				if(ring > 0 && center[2] + ring <= high[2])
+				{
+					visit_cell_at(query, x, y, center[2] + ring);
+				}
+			}
+		}
+	}
+}
+
+unsigned int oal_emitter_grid_query(oal_emitter_grid* grid,
+									oal_distance_model model,
+									float x,
+									float y,
+									float z,
+									double time,
+									float minAudibility,
+									int* emitters,
+									float* audibilities,
+									unsigned int maxEmitters)
+{
+	if(0 == maxEmitters || 0 == grid->count)
+	{
+		return 0;
+	}
+
+	if(grid->heapCapacity < maxEmitters)
+	{
+		int* newEmitters = realloc(grid->heapEmitters, sizeof(*newEmitters) * maxEmitters);
+		if(NULL == newEmitters)
+		{
+			return 0;
+		}
+		grid->heapEmitters = newEmitters;
+		float* newAudibilities = realloc(grid->heapAudibilities, sizeof(*newAudibilities) * maxEmitters);
+		if(NULL == newAudibilities)
+		{
+			return 0;
+		}
+		grid->heapAudibilities = newAudibilities;
+		grid->heapCapacity = maxEmitters;
+	}
+
+	if(grid->boundsChanges * 4 > grid->count)
+	{
+		recalculate_bounds(grid);
+	}
+
+	oal_query query = {grid, model, x, y, z, time, minAudibility, maxEmitters, 0};
+	int32_t center[3] = {cell_coordinate(grid, x), cell_coordinate(grid, y), cell_coordinate(grid, z)};
+
+	// The furthest ring that still touches the bounding box.
+	int32_t lastRing = 0;
+	for(int axis = 0; axis < 3; axis++)
+	{
+		lastRing = max32(lastRing, center[axis] - grid->minCell[axis]);
+		lastRing = max32(lastRing, grid->maxCell[axis] - center[axis]);
+	}
+
+	visit_emitters(&query, grid->prioritized);
+	
+	// Search outwards one ring of cells at a time, until no emitter further out could rank.
+	uint64_t cellsVisited = 0;
+	for(int32_t ring = 0; ring <= lastRing; ring++)
+	{
+		if(ring > 0)
+		{
+			// Nothing in this ring can be closer than this.
+			float loudest = loudest_at_distance(grid, model, (float)(ring - 1) * grid->cellSize);
+			if(loudest < minAudibility)
+			{
+				break;
+			}
+			// Everything left in the cells has priority 0.
+			if(query.heapCount == maxEmitters)
+			{
+				int lowestPriority = grid->emitters[grid->heapEmitters[0]].priority;
+				if(lowestPriority > 0 || (0 == lowestPriority && grid->heapAudibilities[0] >= loudest))
+				{
+					break;
+				}
+			}
+		}
+
+		uint64_t ringCells = cells_in_cube(grid, center, ring) - cells_in_cube(grid, center, ring - 1);
+		if(cellsVisited + ringCells > grid->numCells)
+		{
+			// Cheaper to walk the remaining allocated cells than the empty space in between.
+			for(unsigned int i = 0; i < grid->cellCapacity; i++)
+			{
+				const oal_cell* cell = &grid->cells[i];
+				if(cell->used && cell->count > 0)
+				{
+					int32_t distance = max32(abs(cell->x - center[0]),
+											 max32(abs(cell->y - center[1]), abs(cell->z - center[2])));
+					if(distance >= ring)
+					{
+						visit_emitters(&query, cell->head);
+					}
+				}
+			}
+			break;
+		}
+		visit_ring(&query, center, ring);
+		cellsVisited += ringCells;
+	}
+
+	// Empty the heap from the bottom up, so that the most important comes first.
+	unsigned int numFound = query.heapCount;
+	while(query.heapCount > 0)
+	{
+		unsigned int last = --query.heapCount;
+		emitters[last] = grid->heapEmitters[0];
+		if(NULL != audibilities)
+		{
+			audibilities[last] = grid->heapAudibilities[0];
+		}
+		grid->heapEmitters[0] = grid->heapEmitters[last];
+		grid->heapAudibilities[0] = grid->heapAudibilities[last];
+		heap_sift_down(&query, 0);
+	}
+	return numFound;
+}
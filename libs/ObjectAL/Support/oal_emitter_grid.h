@@ -0,0 +1,177 @@
+/*
+ *  oal_emitter_grid.h
+ *  ObjectAL
+ *
+ *  Spatial hash of sound emitters, used to find the most audible emitters around a
+ *  listener without looking at every emitter. This file only depends on the C standard
+ *  library, so it can be built and profiled on any platform.
+ */
+
+#ifndef OAL_EMITTER_GRID_H
+#define OAL_EMITTER_GRID_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Distance attenuation models (these mirror the OpenAL distance models). */
+typedef enum
+{
+	OAL_DISTANCE_NONE,
+	OAL_DISTANCE_INVERSE,
+	OAL_DISTANCE_INVERSE_CLAMPED,
+	OAL_DISTANCE_LINEAR,
+	OAL_DISTANCE_LINEAR_CLAMPED,
+	OAL_DISTANCE_EXPONENT,
+	OAL_DISTANCE_EXPONENT_CLAMPED,
+} oal_distance_model;
+
+/** Calculate the distance attenuation of a source, as OpenAL would.
+ * The result is clamped to 0.0 - 1.0.
+ *
+ * @param model The distance model.
+ * @param distance The distance between the source and the listener.
+ * @param referenceDistance The source's reference distance.
+ * @param rolloffFactor The source's rolloff factor.
+ * @param maxDistance The source's maximum distance.
+ * @return The attenuation (0.0 - 1.0).
+ */
+float oal_distance_attenuation(oal_distance_model model,
+							   float distance,
+							   float referenceDistance,
+							   float rolloffFactor,
+							   float maxDistance);
+
+/** A spatial hash of emitters. Treat as opaque. */
+typedef struct oal_emitter_grid oal_emitter_grid;
+
+/** Create an emitter grid.
+ *
+ * @param cellSize The edge length of a grid cell.  Something around the distance at which
+ *                 emitters become hard to hear works well.
+ * @return The new grid, or NULL if out of memory.
+ */
+oal_emitter_grid* oal_emitter_grid_create(float cellSize);
+
+/** Destroy an emitter grid.
+ *
+ * @param grid The grid to destroy.
+ */
+void oal_emitter_grid_destroy(oal_emitter_grid* grid);
+
+/** Add an emitter at the origin, with gain 1, priority 0, and the OpenAL default
+ * distance settings.
+ *
+ * @param grid The grid.
+ * @param userData Returned by oal_emitter_grid_user_data().
+ * @return The emitter's ID, or -1 if out of memory.
+ */
+int oal_emitter_grid_add(oal_emitter_grid* grid, void* userData);
+
+/** Remove an emitter.  Its ID may be reused.
+ *
+ * @param grid The grid.
+ * @param emitter The emitter's ID.
+ */
+void oal_emitter_grid_remove(oal_emitter_grid* grid, int emitter);
+
+/** Move an emitter.
+ *
+ * @param grid The grid.
+ * @param emitter The emitter's ID.
+ * @param x The new X coordinate.
+ * @param y The new Y coordinate.
+ * @param z The new Z coordinate.
+ */
+void oal_emitter_grid_move(oal_emitter_grid* grid, int emitter, float x, float y, float z);
+
+/** Set an emitter's properties.
+ *
+ * @param grid The grid.
+ * @param emitter The emitter's ID.
+ * @param gain The emitter's gain before distance attenuation.
+ * @param priority How important the emitter is.  Higher priorities always rank first.
+ * @param referenceDistance The emitter's reference distance.
+ * @param rolloffFactor The emitter's rolloff factor.
+ * @param maxDistance The emitter's maximum distance.
+ */
+void oal_emitter_grid_set_properties(oal_emitter_grid* grid,
+									 int emitter,
+									 float gain,
+									 int priority,
+									 float referenceDistance,
+									 float rolloffFactor,
+									 float maxDistance);
+
+/** Set the time at which an emitter stops being audible (INFINITY = never).
+ *
+ * @param grid The grid.
+ * @param emitter The emitter's ID.
+ * @param endTime The end time (in whatever time base the caller uses).
+ */
+void oal_emitter_grid_set_end_time(oal_emitter_grid* grid, int emitter, double endTime);
+
+/** Get the user data an emitter was added with.
+ *
+ * @param grid The grid.
+ * @param emitter The emitter's ID.
+ * @return The user data.
+ */
+void* oal_emitter_grid_user_data(oal_emitter_grid* grid, int emitter);
+
+/** Get the number of emitters in the grid.
+ *
+ * @param grid The grid.
+ * @return The number of emitters.
+ */
+unsigned int oal_emitter_grid_count(oal_emitter_grid* grid);
+
+/** Find the emitters whose end time has passed.
+ *
+ * @param grid The grid.
+ * @param time The current time.
+ * @param emitters Where to store the IDs of the expired emitters.
+ * @param maxEmitters The maximum number of IDs to store.
+ * @return The number of IDs stored.
+ */
+unsigned int oal_emitter_grid_expired(oal_emitter_grid* grid,
+									  double time,
+									  int* emitters,
+									  unsigned int maxEmitters);
+
+/** Find the most important emitters as heard from a listener position.
+ * Emitters are ranked by priority, then by gain after distance attenuation.
+ * Only the cells that could hold a higher ranking emitter are examined. <br>
+ *
+ * Expired emitters are skipped (see oal_emitter_grid_set_end_time()).
+ *
+ * @param grid The grid.
+ * @param model The distance model.
+ * @param x The listener's X coordinate.
+ * @param y The listener's Y coordinate.
+ * @param z The listener's Z coordinate.
+ * @param time The current time.
+ * @param minAudibility Emitters quieter than this are ignored.
+ * @param emitters Where to store the IDs of the emitters found, most important first.
+ * @param audibilities Where to store the attenuated gains of the emitters found (can be NULL).
+ * @param maxEmitters The maximum number of emitters to find.
+ * @return The number of emitters found.
+ */
+unsigned int oal_emitter_grid_query(oal_emitter_grid* grid,
+									oal_distance_model model,
+									float x,
+									float y,
+									float z,
+									double time,
+									float minAudibility,
+									int* emitters,
+									float* audibilities,
+									unsigned int maxEmitters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_EMITTER_GRID_H */
@@ -0,0 +1,340 @@
+/*
+ *  oal_sound_bank.c
+ *  ObjectAL
+ *
+ */
+
+#include "oal_sound_bank.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char kMagic[8] = {'O', 'A', 'L', 'B', 'A', 'N', 'K', '\0'};
+
+#define kHeaderSize 32
+#define kIndexEntrySize 40
+
+
+#pragma mark Encoding
+
+static uint32_t read_le32(const uint8_t* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t read_le64(const uint8_t* p)
+{
+	return (uint64_t)read_le32(p) | ((uint64_t)read_le32(p + 4) << 32);
+}
+
+static void write_le32(uint8_t* p, uint32_t value)
+{
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+	p[2] = (uint8_t)(value >> 16);
+	p[3] = (uint8_t)(value >> 24);
+}
+
+static void write_le64(uint8_t* p, uint64_t value)
+{
+	write_le32(p, (uint32_t)value);
+	write_le32(p + 4, (uint32_t)(value >> 32));
+}
+
+
+#pragma mark -
+#pragma mark Reading
+
+/** Fill out an entry from its index record, checking that it lies within the bank. */
+static bool decodeEntry(const oal_sound_bank* bank, const uint8_t* record, oal_sound_bank_entry* entry)
+{
+	uint32_t nameOffset = read_le32(record);
+	uint32_t nameLength = read_le32(record + 4);
+	uint64_t dataOffset = read_le64(record + 24);
+	uint64_t size = read_le64(record + 32);
+
+	if(nameOffset >= bank->namesSize
+	   || nameLength >= bank->namesSize - nameOffset
+	   || '\0' != bank->names[nameOffset + nameLength]
+	   || dataOffset > bank->length
+	   || size > bank->length - dataOffset)
+	{
+		return false;
+	}
+
+	entry->name = bank->names + nameOffset;
+	entry->encoding = read_le32(record + 8);
+	entry->channels = read_le32(record + 12);
+	entry->bitsPerSample = read_le32(record + 16);
+	entry->frequency = read_le32(record + 20);
+	entry->data = bank->bytes + dataOffset;
+	entry->size = size;
+	return true;
+}
+
+bool oal_sound_bank_init(oal_sound_bank* bank, const void* bytes, size_t length)
+{
+	memset(bank, 0, sizeof(*bank));
+	const uint8_t* header = bytes;
+	if(NULL == bytes
+	   || length < kHeaderSize
+	   || 0 != memcmp(header, kMagic, sizeof(kMagic))
+	   || OAL_SOUND_BANK_VERSION != read_le32(header + 8))
+	{
+		return false;
+	}
+
+	uint64_t numEntries = read_le32(header + 12);
+	uint64_t indexOffset = read_le32(header + 16);
+	uint64_t namesOffset = read_le32(header + 20);
+	uint64_t namesSize = read_le32(header + 24);
+	if(indexOffset + numEntries * kIndexEntrySize > length
+	   || namesOffset + namesSize > length)
+	{
+		return false;
+	}
+
+	bank->bytes = bytes;
+	bank->length = length;
+	bank->numEntries = (uint32_t)numEntries;
+	bank->index = header + indexOffset;
+	bank->names = (const char*)header + namesOffset;
+	bank->namesSize = (uint32_t)namesSize;
+
+	// Check every entry once here, so that lookups can trust the index.
+	oal_sound_bank_entry entry;
+	for(uint32_t i = 0; i < bank->numEntries; i++)
+	{
+		if(!decodeEntry(bank, bank->index + i * kIndexEntrySize, &entry))
+		{
+			memset(bank, 0, sizeof(*bank));
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t oal_sound_bank_count(const oal_sound_bank* bank)
+{
+	return bank->numEntries;
+}
+
+bool oal_sound_bank_entry_at(const oal_sound_bank* bank, uint32_t index, oal_sound_bank_entry* entry)
+{
+	if(index >= bank->numEntries)
+	{
+		return false;
+	}
+	return decodeEntry(bank, bank->index + index * kIndexEntrySize, entry);
+}
+
+bool oal_sound_bank_find(const oal_sound_bank* bank, const char* name, oal_sound_bank_entry* entry)
+{
+	// The index is sorted by name.
+	uint32_t low = 0;
+	uint32_t high = bank->numEntries;
+	while(low < high)
+	{
+		uint32_t middle = low + (high - low) / 2;
+		const char* middleName = bank->names + read_le32(bank->index + middle * kIndexEntrySize);
+		int comparison = strcmp(name, middleName);
+		if(0 == comparison)
+		{
+			return oal_sound_bank_entry_at(bank, middle, entry);
+		}
+		if(comparison < 0)
+		{
+			high = middle;
+		}
+		else
+		{
+			low = middle + 1;
+		}
+	}
+	return false;
+}
+
+
+#pragma mark -
+#pragma mark Writing
+
+/** An entry waiting for the index to be written. */
+typedef struct
+{
+	char* name;
+	uint32_t encoding;
+	uint32_t channels;
+	uint32_t bitsPerSample;
+	uint32_t frequency;
+	uint64_t dataOffset;
+	uint64_t size;
+} pending_entry;
+
+struct oal_sound_bank_writer
+{
+	FILE* file;
+	uint64_t position;
+	pending_entry* entries;
+	uint32_t numEntries;
+	uint32_t capacity;
+	bool failed;
+};
+
+static void writeBytes(oal_sound_bank_writer* writer, const void* bytes, size_t length)
+{
+	if(length > 0 && 1 != fwrite(bytes, length, 1, writer->file))
+	{
+		writer->failed = true;
+	}
+	writer->position += length;
+}
+
+/** Pad the file with zeroes up to the next payload boundary. */
+static void writeAlignment(oal_sound_bank_writer* writer)
+{
+	static const uint8_t zeroes[OAL_SOUND_BANK_ALIGNMENT] = {0};
+	uint64_t remainder = writer->position % OAL_SOUND_BANK_ALIGNMENT;
+	if(remainder > 0)
+	{
+		writeBytes(writer, zeroes, (size_t)(OAL_SOUND_BANK_ALIGNMENT - remainder));
+	}
+}
+
+oal_sound_bank_writer* oal_sound_bank_writer_open(const char* path)
+{
+	oal_sound_bank_writer* writer = calloc(1, sizeof(*writer));
+	if(NULL == writer)
+	{
+		return NULL;
+	}
+	if(NULL == (writer->file = fopen(path, "wb")))
+	{
+		free(writer);
+		return NULL;
+	}
+
+	// The real header is written on close, once the index location is known.
+	uint8_t header[kHeaderSize] = {0};
+	writeBytes(writer, header, sizeof(header));
+	return writer;
+}
+
+bool oal_sound_bank_writer_add(oal_sound_bank_writer* writer,
+							   const char* name,
+							   oal_sound_bank_encoding encoding,
+							   uint32_t channels,
+							   uint32_t bitsPerSample,
+							   uint32_t frequency,
+							   const void* data,
+							   uint64_t size)
+{
+	if(writer->numEntries == writer->capacity)
+	{
+		uint32_t newCapacity = writer->capacity > 0 ? writer->capacity * 2 : 64;
+		pending_entry* newEntries = realloc(writer->entries, newCapacity * sizeof(*newEntries));
+		if(NULL == newEntries)
+		{
+			writer->failed = true;
+			return false;
+		}
+		writer->entries = newEntries;
+		writer->capacity = newCapacity;
+	}
+
+	pending_entry* entry = &writer->entries[writer->numEntries];
+	if(NULL == (entry->name = malloc(strlen(name) + 1)))
+	{
+		writer->failed = true;
+		return false;
+	}
+	strcpy(entry->name, name);
+	entry->encoding = encoding;
+	entry->channels = channels;
+	entry->bitsPerSample = bitsPerSample;
+	entry->frequency = frequency;
+
+	writeAlignment(writer);
+	entry->dataOffset = writer->position;
+	entry->size = size;
+	writeBytes(writer, data, (size_t)size);
+	writer->numEntries++;
+	return !writer->failed;
+}
+
+static int compareEntries(const void* a, const void* b)
+{
+	return strcmp(((const pending_entry*)a)->name, ((const pending_entry*)b)->name);
+}
+
+bool oal_sound_bank_writer_close(oal_sound_bank_writer* writer)
+{
+	qsort(writer->entries, writer->numEntries, sizeof(*writer->entries), compareEntries);
+
+	// Lookups are by name, so names must be unique.
+	for(uint32_t i = 1; i < writer->numEntries; i++)
+	{
+		if(0 == strcmp(writer->entries[i - 1].name, writer->entries[i].name))
+		{
+			writer->failed = true;
+		}
+	}
+
+	writeAlignment(writer);
+	uint64_t indexOffset = writer->position;
+	uint32_t nameOffset = 0;
+	for(uint32_t i = 0; i < writer->numEntries; i++)
+	{
+		pending_entry* entry = &writer->entries[i];
+		uint32_t nameLength = (uint32_t)strlen(entry->name);
+		uint8_t record[kIndexEntrySize];
+		write_le32(record, nameOffset);
+		write_le32(record + 4, nameLength);
+		write_le32(record + 8, entry->encoding);
+		write_le32(record + 12, entry->channels);
+		write_le32(record + 16, entry->bitsPerSample);
+		write_le32(record + 20, entry->frequency);
+		write_le64(record + 24, entry->dataOffset);
+		write_le64(record + 32, entry->size);
+		writeBytes(writer, record, sizeof(record));
+		nameOffset += nameLength + 1;
+	}
+
+	uint64_t namesOffset = writer->position;
+	for(uint32_t i = 0; i < writer->numEntries; i++)
+	{
+		writeBytes(writer, writer->entries[i].name, strlen(writer->entries[i].name) + 1);
+	}
+
+	// Offsets in the header are 32 bits.
+	if(writer->position > UINT32_MAX)
+	{
+		writer->failed = true;
+	}
+
+	uint8_t header[kHeaderSize] = {0};
+	memcpy(header, kMagic, sizeof(kMagic));
+	write_le32(header + 8, OAL_SOUND_BANK_VERSION);
+	write_le32(header + 12, writer->numEntries);
+	write_le32(header + 16, (uint32_t)indexOffset);
+	write_le32(header + 20, (uint32_t)namesOffset);
+	write_le32(header + 24, nameOffset);
+	if(0 != fseek(writer->file, 0, SEEK_SET)
+	   || 1 != fwrite(header, sizeof(header), 1, writer->file))
+	{
+		writer->failed = true;
+	}
+
+	if(0 != fclose(writer->file))
+	{
+		writer->failed = true;
+	}
+
+	bool succeeded = !writer->failed;
+	for(uint32_t i = 0; i < writer->numEntries; i++)
+	{
+		free(writer->entries[i].name);
+	}
+	free(writer->entries);
+	free(writer);
+	return succeeded;
+}
@@ -0,0 +1,155 @@
+/*
+ *  oal_sound_bank.h
+ *  ObjectAL
+ *
+ *  Sound banks: many sounds packed into one file, so that loading a level's effects costs
+ *  one open and one mapping instead of an open, header parse and decode per file.
+ *  This file only depends on the C standard library, so banks can be built on any
+ *  platform (see Tools/oalbankpack.c).  None of these functions are synchronized.
+ *
+ *  File format (all header and index values little endian):
+ *  - Header (32 bytes): the 8 bytes "OALBANK\0", then 32-bit values version, number of
+ *    entries, index offset, names offset, names size, and a reserved 0.
+ *  - Payloads, each starting on a 16 byte boundary.  PCM payloads are stored exactly as
+ *    OpenAL wants them (signed 16 bit or unsigned 8 bit, little endian, interleaved), so
+ *    they can be handed to OpenAL straight from the mapped file.
+ *  - Index: one 40 byte entry per sound, sorted by name (strcmp order): 32-bit values name
+ *    offset, name length, encoding, channels, bits per sample, frequency, then 64-bit data
+ *    offset and data size.
+ *  - Names: the entry names, each followed by a NUL.
+ */
+
+#ifndef OAL_SOUND_BANK_H
+#define OAL_SOUND_BANK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The sound bank format version written by this code. */
+#define OAL_SOUND_BANK_VERSION 1
+
+/** Payloads start on multiples of this many bytes. */
+#define OAL_SOUND_BANK_ALIGNMENT 16
+
+/** How an entry's payload is stored. */
+typedef enum
+{
+	/** Interleaved PCM, ready for OpenAL. */
+	OAL_SOUND_BANK_PCM = 0,
+} oal_sound_bank_encoding;
+
+/** A sound in a bank. */
+typedef struct
+{
+	/** The sound's name (NUL terminated). */
+	const char* name;
+	/** How the payload is stored (oal_sound_bank_encoding). */
+	uint32_t encoding;
+	uint32_t channels;
+	uint32_t bitsPerSample;
+	uint32_t frequency;
+	/** The payload, which points into the bank's memory. */
+	const void* data;
+	uint64_t size;
+} oal_sound_bank_entry;
+
+
+#pragma mark Reading
+
+/** A bank in memory. Treat as opaque. */
+typedef struct
+{
+	const uint8_t* bytes;
+	size_t length;
+	uint32_t numEntries;
+	const uint8_t* index;
+	const char* names;
+	uint32_t namesSize;
+} oal_sound_bank;
+
+/** Check a bank's header and index, and prepare to read from it.
+ * The memory is used in place, and must stay valid for as long as the bank is in use.
+ *
+ * @param bank The structure to fill out.
+ * @param bytes The bank's contents (typically a mapped file).
+ * @param length The length of the contents.
+ * @return true if the contents are a valid bank.
+ */
+bool oal_sound_bank_init(oal_sound_bank* bank, const void* bytes, size_t length);
+
+/** Get the number of sounds in a bank.
+ *
+ * @param bank The bank.
+ * @return The number of sounds.
+ */
+uint32_t oal_sound_bank_count(const oal_sound_bank* bank);
+
+/** Get a sound by its position in the index (which is in name order).
+ *
+ * @param bank The bank.
+ * @param index The position.
+ * @param entry Where to store the sound's details.
+ * @return true if there is a sound at that position.
+ */
+bool oal_sound_bank_entry_at(const oal_sound_bank* bank, uint32_t index, oal_sound_bank_entry* entry);
+
+/** Find a sound by name.
+ *
+ * @param bank The bank.
+ * @param name The sound's name.
+ * @param entry Where to store the sound's details.
+ * @return true if the bank contains the sound.
+ */
+bool oal_sound_bank_find(const oal_sound_bank* bank, const char* name, oal_sound_bank_entry* entry);
+
+
+#pragma mark Writing
+
+/** A bank being written. Treat as opaque. */
+typedef struct oal_sound_bank_writer oal_sound_bank_writer;
+
+/** Create a bank file.
+ *
+ * @param path The file to create (an existing file is replaced).
+ * @return The writer, or NULL if the file couldn't be created.
+ */
+oal_sound_bank_writer* oal_sound_bank_writer_open(const char* path);
+
+/** Add a sound.  The payload is written immediately; the index is written on close.
+ *
+ * @param writer The writer.
+ * @param name The sound's name (must be unique within the bank).
+ * @param encoding How the payload is stored.
+ * @param channels The number of channels.
+ * @param bitsPerSample The number of bits per sample.
+ * @param frequency The sample rate in Hz.
+ * @param data The payload.
+ * @param size The size of the payload in bytes.
+ * @return true if the sound was added.
+ */
+bool oal_sound_bank_writer_add(oal_sound_bank_writer* writer,
+							   const char* name,
+							   oal_sound_bank_encoding encoding,
+							   uint32_t channels,
+							   uint32_t bitsPerSample,
+							   uint32_t frequency,
+							   const void* data,
+							   uint64_t size);
+
+/** Write the index and close the file.
+ *
+ * @param writer The writer.
+ * @return true if everything was written successfully (including every sound added).
+ */
+bool oal_sound_bank_writer_close(oal_sound_bank_writer* writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_SOUND_BANK_H */
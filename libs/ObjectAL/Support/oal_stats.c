@@ -0,0 +1,399 @@
+/*
+ *  oal_stats.c
+ *  ObjectAL
+ *
+ *  Each thread records into its own block of counters, so recording never takes a lock
+ *  or shares a cache line with another thread.  Every counter in a block has exactly one
+ *  writer (the block's thread), and readers merge the blocks with atomic loads.
+ *
+ *  Rather than reaching into other threads' blocks to clear them, a reset bumps a global
+ *  epoch and a frame end bumps a global frame number.  Writers clear their own counters
+ *  when they notice, and readers ignore counters tagged with an old epoch or frame.
+ */
+
+#include "oal_stats.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/** Maximum number of distinct functions tracked.  Must be a power of 2, and comfortably
+ * larger than the number of OpenAL entry points in ALWrapper.
+ */
+#define kMaxFunctions 512
+
+/** Read a counter that another thread may be writing. */
+#define LOAD(VALUE) __atomic_load_n(&(VALUE), __ATOMIC_RELAXED)
+
+/** Write a counter that other threads may be reading. */
+#define STORE(VALUE, NEW_VALUE) __atomic_store_n(&(VALUE), (NEW_VALUE), __ATOMIC_RELAXED)
+
+
+/** One function's counters in a thread's block. */
+typedef struct
+{
+	/** The function's name, or NULL if the entry is unused. */
+	const char* function;
+	uint64_t calls;
+	uint64_t totalTime;
+	uint64_t peakTime;
+	/** The frame that frameCalls and frameTime belong to. */
+	uint64_t frame;
+	uint64_t frameCalls;
+	uint64_t frameTime;
+} stats_entry;
+
+/** One thread's counters. */
+typedef struct stats_block
+{
+	/** The next block in the list of all blocks. */
+	struct stats_block* next;
+	/** Whether a thread currently owns this block.  Blocks of exited threads get reused. */
+	int inUse;
+	/** The reset epoch the counters belong to. */
+	uint64_t epoch;
+	uint64_t calls;
+	uint64_t totalTime;
+	/** The frame that frameCalls and frameTime belong to. */
+	uint64_t frame;
+	uint64_t frameCalls;
+	uint64_t frameTime;
+	/** Function counters, hashed by function name pointer (open addressing). */
+	stats_entry entries[kMaxFunctions];
+	/** Number of entries used. */
+	unsigned int numEntries;
+} stats_block;
+
+
+/** Every block ever created.  Blocks are never freed, so readers can walk the list
+ * while holding blocksLock without racing against thread exit.
+ */
+static stats_block* blocks = NULL;
+
+/** Guards the block list, and serializes readers (merging, ending frames, resetting). */
+static pthread_mutex_t blocksLock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Points to the calling thread's block. */
+static pthread_key_t blockKey;
+
+static pthread_once_t blockKeyOnce = PTHREAD_ONCE_INIT;
+
+/** Incremented by oal_stats_reset().  Counters from an older epoch count as zero. */
+static uint64_t currentEpoch = 0;
+
+/** Incremented by oal_stats_end_frame().  Frame counters from an older frame count as zero. */
+static uint64_t currentFrame = 0;
+
+/** Totals that only readers maintain (frames and per-frame peaks). Guarded by blocksLock. */
+static oal_stats_totals frameTotals;
+
+/** Merged function statistics, rebuilt by each read.  Guarded by blocksLock. */
+static oal_stats_function merged[kMaxFunctions];
+
+/** Number of entries used in merged. */
+static unsigned int numMerged = 0;
+
+
+#pragma mark Blocks
+
+/** Give a block back when its thread exits, so that the next new thread can reuse it.
+ * Its counters are kept, since they still count towards the totals.
+ */
+static void releaseBlock(void* block)
+{
+	__atomic_store_n(&((stats_block*)block)->inUse, 0, __ATOMIC_RELEASE);
+}
+
+static void createBlockKey(void)
+{
+	pthread_key_create(&blockKey, releaseBlock);
+}
+
+/** Get the calling thread's block, creating or reusing one if necessary.
+ *
+ * @return The block, or NULL if none could be allocated.
+ */
+static stats_block* threadBlock(void)
+{
+	pthread_once(&blockKeyOnce, createBlockKey);
+	stats_block* block = pthread_getspecific(blockKey);
+	if(NULL != block)
+	{
+		return block;
+	}
+
+	pthread_mutex_lock(&blocksLock);
+	for(block = blocks; NULL != block; block = block->next)
+	{
+		if(!__atomic_load_n(&block->inUse, __ATOMIC_ACQUIRE))
+		{
+			break;
+		}
+	}
+	if(NULL == block)
+	{
+		block = calloc(1, sizeof(*block));
+		if(NULL != block)
+		{
+			block->epoch = LOAD(currentEpoch);
+			block->frame = LOAD(currentFrame);
+			block->next = blocks;
+			blocks = block;
+		}
+	}
+	if(NULL != block)
+	{
+		__atomic_store_n(&block->inUse, 1, __ATOMIC_RELAXED);
+		pthread_setspecific(blockKey, block);
+	}
+	pthread_mutex_unlock(&blocksLock);
+	return block;
+}
+
+/** Hash a function name pointer into a table of kMaxFunctions entries. */
+static inline unsigned int hashFunction(const char* function)
+{
+	// Names are compared by pointer, so hash the pointer.
+	uintptr_t hash = (uintptr_t)function;
+	hash ^= hash >> 9;
+	hash *= 0x9E3779B1u;
+	return (unsigned int)(hash >> 7) & (kMaxFunctions - 1);
+}
+
+
+#pragma mark Recording
+
+/** Find the entry for a function in a block, adding it if necessary.
+ *
+ * @param block The calling thread's block.
+ * @param function The function name.
+ * @return The entry, or NULL if the table is full.
+ */
+static inline stats_entry* entryForFunction(stats_block* block, const char* function)
+{
+	unsigned int index = hashFunction(function);
+	for(;;)
+	{
+		stats_entry* entry = &block->entries[index];
+		if(entry->function == function)
+		{
+			return entry;
+		}
+		if(NULL == entry->function)
+		{
+			if(block->numEntries >= kMaxFunctions / 2)
+			{
+				return NULL;
+			}
+			entry->frame = block->frame;
+			// Publish the name last, so a reader that sees it also sees zeroed counters.
+			__atomic_store_n(&entry->function, function, __ATOMIC_RELEASE);
+			block->numEntries++;
+			return entry;
+		}
+		index = (index + 1) & (kMaxFunctions - 1);
+	}
+}
+
+void oal_stats_record(const char* function, uint64_t elapsed)
+{
+	stats_block* block = threadBlock();
+	if(NULL == block)
+	{
+		return;
+	}
+
+	uint64_t epoch = LOAD(currentEpoch);
+	if(block->epoch != epoch)
+	{
+		// Statistics were reset since this thread last recorded.
+		for(unsigned int i = 0; i < kMaxFunctions; i++)
+		{
+			stats_entry* entry = &block->entries[i];
+			STORE(entry->calls, 0);
+			STORE(entry->totalTime, 0);
+			STORE(entry->peakTime, 0);
+			STORE(entry->frameCalls, 0);
+			STORE(entry->frameTime, 0);
+		}
+		STORE(block->calls, 0);
+		STORE(block->totalTime, 0);
+		STORE(block->frameCalls, 0);
+		STORE(block->frameTime, 0);
+		__atomic_store_n(&block->epoch, epoch, __ATOMIC_RELEASE);
+	}
+
+	uint64_t frame = LOAD(currentFrame);
+	if(block->frame != frame)
+	{
+		STORE(block->frameCalls, 0);
+		STORE(block->frameTime, 0);
+		STORE(block->frame, frame);
+	}
+	STORE(block->calls, block->calls + 1);
+	STORE(block->totalTime, block->totalTime + elapsed);
+	STORE(block->frameCalls, block->frameCalls + 1);
+	STORE(block->frameTime, block->frameTime + elapsed);
+
+	stats_entry* entry = entryForFunction(block, function);
+	if(NULL != entry)
+	{
+		if(entry->frame != frame)
+		{
+			STORE(entry->frameCalls, 0);
+			STORE(entry->frameTime, 0);
+			STORE(entry->frame, frame);
+		}
+		STORE(entry->calls, entry->calls + 1);
+		STORE(entry->totalTime, entry->totalTime + elapsed);
+		STORE(entry->frameCalls, entry->frameCalls + 1);
+		STORE(entry->frameTime, entry->frameTime + elapsed);
+		if(elapsed > entry->peakTime)
+		{
+			STORE(entry->peakTime, elapsed);
+		}
+	}
+}
+
+
+#pragma mark Merging
+
+/** Add up every block's totals.  Must be called while holding blocksLock.
+ *
+ * @param totals Where to store the totals.
+ */
+static void mergeTotals(oal_stats_totals* totals)
+{
+	*totals = frameTotals;
+	uint64_t epoch = LOAD(currentEpoch);
+	uint64_t frame = LOAD(currentFrame);
+	for(stats_block* block = blocks; NULL != block; block = block->next)
+	{
+		if(__atomic_load_n(&block->epoch, __ATOMIC_ACQUIRE) != epoch)
+		{
+			continue;
+		}
+		totals->calls += LOAD(block->calls);
+		totals->totalTime += LOAD(block->totalTime);
+		if(LOAD(block->frame) == frame)
+		{
+			totals->frameCalls += LOAD(block->frameCalls);
+			totals->frameTime += LOAD(block->frameTime);
+		}
+	}
+}
+
+/** Rebuild the merged function table from every block.  Must be called while holding blocksLock.
+ */
+static void mergeFunctions(void)
+{
+	memset(merged, 0, sizeof(merged));
+	numMerged = 0;
+	uint64_t epoch = LOAD(currentEpoch);
+	uint64_t frame = LOAD(currentFrame);
+	for(stats_block* block = blocks; NULL != block; block = block->next)
+	{
+		if(__atomic_load_n(&block->epoch, __ATOMIC_ACQUIRE) != epoch)
+		{
+			continue;
+		}
+		for(unsigned int i = 0; i < kMaxFunctions; i++)
+		{
+			stats_entry* entry = &block->entries[i];
+			const char* function = __atomic_load_n(&entry->function, __ATOMIC_ACQUIRE);
+			uint64_t calls = LOAD(entry->calls);
+			if(NULL == function || 0 == calls)
+			{
+				continue;
+			}
+
+			unsigned int index = hashFunction(function);
+			while(NULL != merged[index].function && merged[index].function != function)
+			{
+				index = (index + 1) & (kMaxFunctions - 1);
+			}
+			oal_stats_function* result = &merged[index];
+			if(NULL == result->function)
+			{
+				result->function = function;
+				numMerged++;
+			}
+			result->calls += calls;
+			result->totalTime += LOAD(entry->totalTime);
+			uint64_t peakTime = LOAD(entry->peakTime);
+			if(peakTime > result->peakTime)
+			{
+				result->peakTime = peakTime;
+			}
+			if(LOAD(entry->frame) == frame)
+			{
+				result->frameCalls += LOAD(entry->frameCalls);
+				result->frameTime += LOAD(entry->frameTime);
+			}
+		}
+	}
+}
+
+void oal_stats_end_frame(void)
+{
+	pthread_mutex_lock(&blocksLock);
+	oal_stats_totals totals;
+	mergeTotals(&totals);
+	frameTotals.frames++;
+	frameTotals.lastFrameCalls = totals.frameCalls;
+	frameTotals.lastFrameTime = totals.frameTime;
+	if(totals.frameCalls > frameTotals.peakFrameCalls)
+	{
+		frameTotals.peakFrameCalls = totals.frameCalls;
+	}
+	if(totals.frameTime > frameTotals.peakFrameTime)
+	{
+		frameTotals.peakFrameTime = totals.frameTime;
+	}
+	// Writers start the new frame's counters from zero when they see this.
+	STORE(currentFrame, currentFrame + 1);
+	pthread_mutex_unlock(&blocksLock);
+}
+
+void oal_stats_reset(void)
+{
+	pthread_mutex_lock(&blocksLock);
+	memset(&frameTotals, 0, sizeof(frameTotals));
+	STORE(currentEpoch, currentEpoch + 1);
+	pthread_mutex_unlock(&blocksLock);
+}
+
+
+#pragma mark Reporting
+
+void oal_stats_get_totals(oal_stats_totals* totalsOut)
+{
+	pthread_mutex_lock(&blocksLock);
+	mergeTotals(totalsOut);
+	pthread_mutex_unlock(&blocksLock);
+}
+
+unsigned int oal_stats_function_count(void)
+{
+	pthread_mutex_lock(&blocksLock);
+	mergeFunctions();
+	unsigned int count = numMerged;
+	pthread_mutex_unlock(&blocksLock);
+	return count;
+}
+
+unsigned int oal_stats_get_functions(oal_stats_function* functionsOut, unsigned int maxFunctions)
+{
+	pthread_mutex_lock(&blocksLock);
+	mergeFunctions();
+	unsigned int count = 0;
+	for(unsigned int i = 0; i < kMaxFunctions && count < maxFunctions; i++)
+	{
+		if(NULL != merged[i].function)
+		{
+			functionsOut[count++] = merged[i];
+		}
+	}
+	pthread_mutex_unlock(&blocksLock);
+	return count;
+}
@@ -0,0 +1,101 @@
+/*
+ *  oal_stats.h
+ *  ObjectAL
+ *
+ *  Per-function call counts and timings for OpenAL calls, used when
+ *  OBJECTAL_CFG_COLLECT_STATS is enabled.  Any thread may record calls without locking,
+ *  since each thread counts into its own block; the blocks are merged when the totals
+ *  are read or a frame ends.  A call recorded at the very moment a frame ends or the
+ *  statistics are reset may be left out of that frame's (or the new epoch's) counts.
+ */
+
+#ifndef OAL_STATS_H
+#define OAL_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Statistics for one function. */
+typedef struct
+{
+	/** The function's name (as given to oal_stats_record()). */
+	const char* function;
+	/** Number of calls since the last reset. */
+	uint64_t calls;
+	/** Total time spent in calls since the last reset (mach absolute time). */
+	uint64_t totalTime;
+	/** Longest single call since the last reset (mach absolute time). */
+	uint64_t peakTime;
+	/** Number of calls during the current frame. */
+	uint64_t frameCalls;
+	/** Time spent in calls during the current frame (mach absolute time). */
+	uint64_t frameTime;
+} oal_stats_function;
+
+/** Statistics for all functions. */
+typedef struct
+{
+	/** Number of frames ended since the last reset. */
+	uint64_t frames;
+	/** Number of calls since the last reset. */
+	uint64_t calls;
+	/** Total time spent in calls since the last reset (mach absolute time). */
+	uint64_t totalTime;
+	/** Number of calls during the current frame. */
+	uint64_t frameCalls;
+	/** Time spent in calls during the current frame (mach absolute time). */
+	uint64_t frameTime;
+	/** Number of calls during the last completed frame. */
+	uint64_t lastFrameCalls;
+	/** Time spent in calls during the last completed frame (mach absolute time). */
+	uint64_t lastFrameTime;
+	/** Most calls during a single frame since the last reset. */
+	uint64_t peakFrameCalls;
+	/** Most time spent in calls during a single frame since the last reset (mach absolute time). */
+	uint64_t peakFrameTime;
+} oal_stats_totals;
+
+/** Record a call.
+ *
+ * @param function The function called.  Must point to a string that never changes or goes
+ *                 away (such as __PRETTY_FUNCTION__), since only the pointer is stored.
+ * @param elapsed How long the call took (mach absolute time).
+ */
+void oal_stats_record(const char* function, uint64_t elapsed);
+
+/** End the current frame, starting a new one.
+ */
+void oal_stats_end_frame(void);
+
+/** Clear all statistics.
+ */
+void oal_stats_reset(void);
+
+/** Get the statistics for all functions.
+ *
+ * @param totals Where to store the statistics.
+ */
+void oal_stats_get_totals(oal_stats_totals* totals);
+
+/** Get the number of functions that have been recorded.
+ *
+ * @return The number of functions.
+ */
+unsigned int oal_stats_function_count(void);
+
+/** Get the statistics for each function.
+ *
+ * @param functions Where to store the statistics.
+ * @param maxFunctions The maximum number of functions to store.
+ * @return The number of functions stored.
+ */
+unsigned int oal_stats_get_functions(oal_stats_function* functions, unsigned int maxFunctions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_STATS_H */
@@ -0,0 +1,559 @@
+/*
+ *  oal_trace.c
+ *  ObjectAL
+ *
+ */
+
+#include "oal_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The 8 bytes every trace starts with. */
+static const char kTraceMagic[8] = {'O', 'A', 'L', 'T', 'R', 'A', 'C', 'E'};
+
+/** Size of the stdio buffer for trace files. */
+#define kTraceFileBufferSize (64 * 1024)
+
+/** Initial size of the writer's string table.  Must be a power of 2. */
+#define kInitialStringTableSize 64
+
+/** Longest string accepted when reading. */
+#define kMaxStringLength 4096
+
+
+/** Which fields an event type uses. */
+typedef struct
+{
+	bool handle;
+	bool string;
+	unsigned char numValues;
+	bool intValue;
+} oal_trace_layout;
+
+/** Field layouts, indexed by event type. */
+static const oal_trace_layout layouts[OAL_TRACE_NUM_EVENT_TYPES] =
+{
+	/* OAL_TRACE_STRING */				{false, false, 0, false},
+	/* OAL_TRACE_PRELOAD_EFFECT */		{false, true,  0, false},
+	/* OAL_TRACE_UNLOAD_EFFECT */		{false, true,  0, false},
+	/* OAL_TRACE_UNLOAD_ALL_EFFECTS */	{false, false, 0, false},
+	/* OAL_TRACE_PLAY_EFFECT */			{true,  true,  3, true},
+	/* OAL_TRACE_STOP_ALL_EFFECTS */	{false, false, 0, false},
+	/* OAL_TRACE_PLAY_BG */				{false, true,  0, true},
+	/* OAL_TRACE_STOP_BG */				{false, false, 0, false},
+	/* OAL_TRACE_SET_BG_VOLUME */		{false, false, 1, false},
+	/* OAL_TRACE_SET_BG_PAUSED */		{false, false, 0, true},
+	/* OAL_TRACE_SET_EFFECTS_VOLUME */	{false, false, 1, false},
+	/* OAL_TRACE_SET_EFFECTS_PAUSED */	{false, false, 0, true},
+	/* OAL_TRACE_SET_MUTED */			{false, false, 0, true},
+	/* OAL_TRACE_SOURCE_GAIN */			{true,  false, 1, false},
+	/* OAL_TRACE_SOURCE_PITCH */		{true,  false, 1, false},
+	/* OAL_TRACE_SOURCE_POSITION */		{true,  false, 3, false},
+	/* OAL_TRACE_SOURCE_LOOPING */		{true,  false, 0, true},
+	/* OAL_TRACE_SOURCE_PAUSED */		{true,  false, 0, true},
+	/* OAL_TRACE_SOURCE_STOP */			{true,  false, 0, false},
+	/* OAL_TRACE_SOURCE_FADE */			{true,  false, 2, false},
+	/* OAL_TRACE_SOURCE_PAN_TO */		{true,  false, 2, false},
+	/* OAL_TRACE_SOURCE_PITCH_TO */		{true,  false, 2, false},
+	/* OAL_TRACE_SOURCE_STOP_ACTIONS */	{true,  false, 0, false},
+};
+
+
+#pragma mark -
+#pragma mark Writing
+
+/** A string the writer has already defined. */
+typedef struct
+{
+	char* string;
+	uint32_t hash;
+	uint32_t id;
+} oal_trace_string_entry;
+
+struct oal_trace_writer
+{
+	FILE* file;
+	char* fileBuffer;
+	uint64_t lastTime;
+	bool failed;
+	/** Defined strings, hashed by content (open addressing). */
+	oal_trace_string_entry* strings;
+	uint32_t stringTableSize;
+	uint32_t numStrings;
+};
+
+/** FNV-1a hash of a string. */
+static uint32_t hashString(const char* string)
+{
+	uint32_t hash = 2166136261u;
+	for(const unsigned char* ch = (const unsigned char*)string; *ch != 0; ch++)
+	{
+		hash ^= *ch;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void writeBytes(oal_trace_writer* writer, const void* bytes, size_t length)
+{
+	if(fwrite(bytes, 1, length, writer->file) != length)
+	{
+		writer->failed = true;
+	}
+}
+
+static void writeVarint(oal_trace_writer* writer, uint64_t value)
+{
+	unsigned char bytes[10];
+	size_t length = 0;
+	while(value >= 0x80)
+	{
+		bytes[length++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	bytes[length++] = (unsigned char)value;
+	writeBytes(writer, bytes, length);
+}
+
+static void writeUInt32(oal_trace_writer* writer, uint32_t value)
+{
+	unsigned char bytes[4] =
+	{
+		(unsigned char)value,
+		(unsigned char)(value >> 8),
+		(unsigned char)(value >> 16),
+		(unsigned char)(value >> 24),
+	};
+	writeBytes(writer, bytes, sizeof(bytes));
+}
+
+static void writeFloat(oal_trace_writer* writer, float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	writeUInt32(writer, bits);
+}
+
+oal_trace_writer* oal_trace_writer_open(const char* path)
+{
+	oal_trace_writer* writer = calloc(1, sizeof(*writer));
+	if(NULL == writer)
+	{
+		return NULL;
+	}
+	writer->stringTableSize = kInitialStringTableSize;
+	writer->strings = calloc(writer->stringTableSize, sizeof(*writer->strings));
+	writer->fileBuffer = malloc(kTraceFileBufferSize);
+	writer->file = fopen(path, "wb");
+	if(NULL == writer->strings || NULL == writer->fileBuffer || NULL == writer->file)
+	{
+		if(NULL != writer->file)
+		{
+			fclose(writer->file);
+		}
+		free(writer->fileBuffer);
+		free(writer->strings);
+		free(writer);
+		return NULL;
+	}
+	setvbuf(writer->file, writer->fileBuffer, _IOFBF, kTraceFileBufferSize);
+
+	writeBytes(writer, kTraceMagic, sizeof(kTraceMagic));
+	writeUInt32(writer, OAL_TRACE_VERSION);
+	return writer;
+}
+
+bool oal_trace_writer_close(oal_trace_writer* writer)
+{
+	if(NULL == writer)
+	{
+		return false;
+	}
+	bool success = !writer->failed;
+	if(0 != fclose(writer->file))
+	{
+		success = false;
+	}
+	for(uint32_t i = 0; i < writer->stringTableSize; i++)
+	{
+		free(writer->strings[i].string);
+	}
+	free(writer->strings);
+	free(writer->fileBuffer);
+	free(writer);
+	return success;
+}
+
+/** Double the size of the string table.
+ *
+ * @param writer The writer.
+ * @return false if out of memory.
+ */
+static bool growStringTable(oal_trace_writer* writer)
+{
+	uint32_t newSize = writer->stringTableSize * 2;
+	oal_trace_string_entry* newStrings = calloc(newSize, sizeof(*newStrings));
+	if(NULL == newStrings)
+	{
+		return false;
+	}
+	for(uint32_t i = 0; i < writer->stringTableSize; i++)
+	{
+		oal_trace_string_entry* entry = &writer->strings[i];
+		if(NULL != entry->string)
+		{
+			uint32_t index = entry->hash & (newSize - 1);
+			while(NULL != newStrings[index].string)
+			{
+				index = (index + 1) & (newSize - 1);
+			}
+			newStrings[index] = *entry;
+		}
+	}
+	free(writer->strings);
+	writer->strings = newStrings;
+	writer->stringTableSize = newSize;
+	return true;
+}
+
+uint32_t oal_trace_writer_string(oal_trace_writer* writer, const char* string)
+{
+	uint32_t hash = hashString(string);
+	uint32_t mask = writer->stringTableSize - 1;
+	uint32_t index = hash & mask;
+	for(;;)
+	{
+		oal_trace_string_entry* entry = &writer->strings[index];
+		if(NULL == entry->string)
+		{
+			break;
+		}
+		if(entry->hash == hash && 0 == strcmp(entry->string, string))
+		{
+			return entry->id;
+		}
+		index = (index + 1) & mask;
+	}
+
+	// Keep the table at most half full.
+	if((writer->numStrings + 1) * 2 > writer->stringTableSize)
+	{
+		if(!growStringTable(writer))
+		{
+			writer->failed = true;
+			return 0;
+		}
+		mask = writer->stringTableSize - 1;
+		index = hash & mask;
+		while(NULL != writer->strings[index].string)
+		{
+			index = (index + 1) & mask;
+		}
+	}
+
+	size_t length = strlen(string);
+	char* copy = malloc(length + 1);
+	if(NULL == copy)
+	{
+		writer->failed = true;
+		return 0;
+	}
+	memcpy(copy, string, length + 1);
+
+	oal_trace_string_entry* entry = &writer->strings[index];
+	entry->string = copy;
+	entry->hash = hash;
+	entry->id = writer->numStrings++;
+
+	unsigned char type = OAL_TRACE_STRING;
+	writeBytes(writer, &type, 1);
+	writeVarint(writer, 0);
+	writeVarint(writer, entry->id);
+	writeVarint(writer, length);
+	writeBytes(writer, string, length);
+	return entry->id;
+}
+
+bool oal_trace_write(oal_trace_writer* writer, const oal_trace_event* event)
+{
+	if(event->type <= OAL_TRACE_STRING || event->type >= OAL_TRACE_NUM_EVENT_TYPES)
+	{
+		return false;
+	}
+	const oal_trace_layout* layout = &layouts[event->type];
+
+	uint64_t delta = event->time > writer->lastTime ? event->time - writer->lastTime : 0;
+	writer->lastTime += delta;
+
+	unsigned char type = (unsigned char)event->type;
+	writeBytes(writer, &type, 1);
+	writeVarint(writer, delta);
+	if(layout->handle)
+	{
+		writeVarint(writer, event->handle);
+	}
+	if(layout->string)
+	{
+		writeVarint(writer, event->string);
+	}
+	for(unsigned int i = 0; i < layout->numValues; i++)
+	{
+		writeFloat(writer, event->values[i]);
+	}
+	if(layout->intValue)
+	{
+		// Zigzag encode so that small negative values stay small.
+		uint32_t value = (uint32_t)event->intValue;
+		writeVarint(writer, (value << 1) ^ (uint32_t)(event->intValue >> 31));
+	}
+	return !writer->failed;
+}
+
+
+#pragma mark -
+#pragma mark Reading
+
+struct oal_trace_reader
+{
+	FILE* file;
+	char* fileBuffer;
+	uint64_t time;
+	bool failed;
+	/** Defined strings, indexed by ID. */
+	char** strings;
+	uint32_t numStrings;
+	uint32_t stringsCapacity;
+};
+
+/** Read bytes, distinguishing a clean end of file from a truncated record.
+ *
+ * @return 1 if read, 0 at end of file before any byte, -1 on a partial read.
+ */
+static int readBytes(oal_trace_reader* reader, void* bytes, size_t length)
+{
+	size_t numRead = fread(bytes, 1, length, reader->file);
+	if(numRead == length)
+	{
+		return 1;
+	}
+	return 0 == numRead ? 0 : -1;
+}
+
+static bool readVarint(oal_trace_reader* reader, uint64_t* value)
+{
+	uint64_t result = 0;
+	for(unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		int ch = fgetc(reader->file);
+		if(EOF == ch)
+		{
+			return false;
+		}
+		result |= (uint64_t)(ch & 0x7f) << shift;
+		if(0 == (ch & 0x80))
+		{
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool readUInt32(oal_trace_reader* reader, uint32_t* value)
+{
+	unsigned char bytes[4];
+	if(1 != readBytes(reader, bytes, sizeof(bytes)))
+	{
+		return false;
+	}
+	*value = (uint32_t)bytes[0] |
+		(uint32_t)bytes[1] << 8 |
+		(uint32_t)bytes[2] << 16 |
+		(uint32_t)bytes[3] << 24;
+	return true;
+}
+
+oal_trace_reader* oal_trace_reader_open(const char* path)
+{
+	oal_trace_reader* reader = calloc(1, sizeof(*reader));
+	if(NULL == reader)
+	{
+		return NULL;
+	}
+	reader->fileBuffer = malloc(kTraceFileBufferSize);
+	reader->file = fopen(path, "rb");
+	if(NULL == reader->fileBuffer || NULL == reader->file)
+	{
+		oal_trace_reader_close(reader);
+		return NULL;
+	}
+	setvbuf(reader->file, reader->fileBuffer, _IOFBF, kTraceFileBufferSize);
+
+	char magic[sizeof(kTraceMagic)];
+	uint32_t version;
+	if(1 != readBytes(reader, magic, sizeof(magic)) ||
+	   0 != memcmp(magic, kTraceMagic, sizeof(magic)) ||
+	   !readUInt32(reader, &version) ||
+	   version != OAL_TRACE_VERSION)
+	{
+		oal_trace_reader_close(reader);
+		return NULL;
+	}
+	return reader;
+}
+
+void oal_trace_reader_close(oal_trace_reader* reader)
+{
+	if(NULL == reader)
+	{
+		return;
+	}
+	if(NULL != reader->file)
+	{
+		fclose(reader->file);
+	}
+	for(uint32_t i = 0; i < reader->numStrings; i++)
+	{
+		free(reader->strings[i]);
+	}
+	free(reader->strings);
+	free(reader->fileBuffer);
+	free(reader);
+}
+
+/** Read a string definition (after the type and time have been read).
+ *
+ * @return false if the definition is corrupt.
+ */
+static bool readString(oal_trace_reader* reader)
+{
+	uint64_t id;
+	uint64_t length;
+	if(!readVarint(reader, &id) || !readVarint(reader, &length))
+	{
+		return false;
+	}
+	// Strings are defined in ID order.
+	if(id != reader->numStrings || length > kMaxStringLength)
+	{
+		return false;
+	}
+	if(reader->numStrings == reader->stringsCapacity)
+	{
+		uint32_t newCapacity = reader->stringsCapacity > 0 ? reader->stringsCapacity * 2 : 64;
+		char** newStrings = realloc(reader->strings, newCapacity * sizeof(*newStrings));
+		if(NULL == newStrings)
+		{
+			return false;
+		}
+		reader->strings = newStrings;
+		reader->stringsCapacity = newCapacity;
+	}
+	char* string = malloc((size_t)length + 1);
+	if(NULL == string)
+	{
+		return false;
+	}
+	if(length > 0 && 1 != readBytes(reader, string, (size_t)length))
+	{
+		free(string);
+		return false;
+	}
+	string[length] = 0;
+	reader->strings[reader->numStrings++] = string;
+	return true;
+}
+
+bool oal_trace_read(oal_trace_reader* reader, oal_trace_event* event)
+{
+	if(reader->failed)
+	{
+		return false;
+	}
+	for(;;)
+	{
+		unsigned char type;
+		int result = readBytes(reader, &type, 1);
+		if(1 != result)
+		{
+			// A clean end of file between records is the normal end of a trace.
+			reader->failed = ferror(reader->file) || result < 0;
+			return false;
+		}
+
+		uint64_t delta;
+		if(type >= OAL_TRACE_NUM_EVENT_TYPES || !readVarint(reader, &delta))
+		{
+			reader->failed = true;
+			return false;
+		}
+		reader->time += delta;
+
+		if(OAL_TRACE_STRING == type)
+		{
+			if(!readString(reader))
+			{
+				reader->failed = true;
+				return false;
+			}
+			continue;
+		}
+
+		const oal_trace_layout* layout = &layouts[type];
+		memset(event, 0, sizeof(*event));
+		event->type = (oal_trace_event_type)type;
+		event->time = reader->time;
+
+		uint64_t value;
+		if(layout->handle)
+		{
+			if(!readVarint(reader, &value))
+			{
+				reader->failed = true;
+				return false;
+			}
+			event->handle = (uint32_t)value;
+		}
+		if(layout->string)
+		{
+			if(!readVarint(reader, &value) || value >= reader->numStrings)
+			{
+				reader->failed = true;
+				return false;
+			}
+			event->string = (uint32_t)value;
+		}
+		for(unsigned int i = 0; i < layout->numValues; i++)
+		{
+			uint32_t bits;
+			if(!readUInt32(reader, &bits))
+			{
+				reader->failed = true;
+				return false;
+			}
+			memcpy(&event->values[i], &bits, sizeof(bits));
+		}
+		if(layout->intValue)
+		{
+			if(!readVarint(reader, &value))
+			{
+				reader->failed = true;
+				return false;
+			}
+			uint32_t zigzag = (uint32_t)value;
+			event->intValue = (int32_t)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+		}
+		return true;
+	}
+}
+
+bool oal_trace_reader_failed(oal_trace_reader* reader)
+{
+	return reader->failed;
+}
+
+const char* oal_trace_reader_string(oal_trace_reader* reader, uint32_t string)
+{
+	return string < reader->numStrings ? reader->strings[string] : NULL;
+}
@@ -0,0 +1,170 @@
+/*
+ *  oal_trace.h
+ *  ObjectAL
+ *
+ *  Compact binary traces of ObjectAL API calls, used by OALTraceRecorder and
+ *  OALTracePlayer.  This file only depends on the C standard library, so traces can be
+ *  read and written on any platform.  None of these functions are synchronized.
+ *
+ *  File format (all multibyte values little endian):
+ *  - Header: the 8 bytes "OALTRACE", then a 32-bit version number.
+ *  - Events: an event type byte, then the time since the previous event in microseconds
+ *    (varint), then the fields the event type uses, in this order: handle (varint),
+ *    string ID (varint), float values (32-bit IEEE), integer value (zigzag varint).
+ *  - Strings are sent once, as an OAL_TRACE_STRING event (ID varint, length varint, bytes)
+ *    before the first event that refers to them.
+ */
+
+#ifndef OAL_TRACE_H
+#define OAL_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The trace format version written by this code. */
+#define OAL_TRACE_VERSION 1
+
+/** Traced calls. */
+typedef enum
+{
+	/** (INTERNAL USE) A string definition.  Never returned by oal_trace_read(). */
+	OAL_TRACE_STRING = 0,
+
+	// OALSimpleAudio
+	OAL_TRACE_PRELOAD_EFFECT,		/**< string = path */
+	OAL_TRACE_UNLOAD_EFFECT,		/**< string = path */
+	OAL_TRACE_UNLOAD_ALL_EFFECTS,
+	OAL_TRACE_PLAY_EFFECT,			/**< handle = source played on, string = path, values = volume, pitch, pan,
+									 *   intValue = priority * 2 + loop */
+	OAL_TRACE_STOP_ALL_EFFECTS,
+	OAL_TRACE_PLAY_BG,				/**< string = path, intValue = loop */
+	OAL_TRACE_STOP_BG,
+	OAL_TRACE_SET_BG_VOLUME,		/**< values[0] = volume */
+	OAL_TRACE_SET_BG_PAUSED,		/**< intValue = paused */
+	OAL_TRACE_SET_EFFECTS_VOLUME,	/**< values[0] = volume */
+	OAL_TRACE_SET_EFFECTS_PAUSED,	/**< intValue = paused */
+	OAL_TRACE_SET_MUTED,			/**< intValue = muted */
+
+	// ALSource
+	OAL_TRACE_SOURCE_GAIN,			/**< handle = source, values[0] = gain */
+	OAL_TRACE_SOURCE_PITCH,			/**< handle = source, values[0] = pitch */
+	OAL_TRACE_SOURCE_POSITION,		/**< handle = source, values = x, y, z */
+	OAL_TRACE_SOURCE_LOOPING,		/**< handle = source, intValue = looping */
+	OAL_TRACE_SOURCE_PAUSED,		/**< handle = source, intValue = paused */
+	OAL_TRACE_SOURCE_STOP,			/**< handle = source */
+	OAL_TRACE_SOURCE_FADE,			/**< handle = source, values = target gain, duration */
+	OAL_TRACE_SOURCE_PAN_TO,		/**< handle = source, values = target pan, duration */
+	OAL_TRACE_SOURCE_PITCH_TO,		/**< handle = source, values = target pitch, duration */
+	OAL_TRACE_SOURCE_STOP_ACTIONS,	/**< handle = source */
+
+	/** (INTERNAL USE) Number of event types. */
+	OAL_TRACE_NUM_EVENT_TYPES
+} oal_trace_event_type;
+
+/** A traced call.  Fields not used by the event type are 0. */
+typedef struct
+{
+	/** What was called. */
+	oal_trace_event_type type;
+	/** When it was called, in microseconds since recording started. */
+	uint64_t time;
+	/** The object it was called on (for sources, the OpenAL source ID). */
+	uint32_t handle;
+	/** String argument, as a string ID (see oal_trace_writer_string() and
+	 * oal_trace_reader_string()).
+	 */
+	uint32_t string;
+	/** Float arguments. */
+	float values[3];
+	/** Integer or boolean argument. */
+	int32_t intValue;
+} oal_trace_event;
+
+
+#pragma mark Writing
+
+/** A trace being written. Treat as opaque. */
+typedef struct oal_trace_writer oal_trace_writer;
+
+/** Create a trace file and write its header.
+ *
+ * @param path The file to create (an existing file is replaced).
+ * @return The writer, or NULL if the file couldn't be created.
+ */
+oal_trace_writer* oal_trace_writer_open(const char* path);
+
+/** Flush and close a trace file.
+ *
+ * @param writer The writer.
+ * @return true if everything was written successfully.
+ */
+bool oal_trace_writer_close(oal_trace_writer* writer);
+
+/** Get the ID of a string, writing its definition to the trace if this is the first time
+ * it's been seen.
+ *
+ * @param writer The writer.
+ * @param string The string.
+ * @return The string's ID.
+ */
+uint32_t oal_trace_writer_string(oal_trace_writer* writer, const char* string);
+
+/** Write an event.  Events must be written in time order.
+ *
+ * @param writer The writer.
+ * @param event The event.
+ * @return true if the event was written.
+ */
+bool oal_trace_write(oal_trace_writer* writer, const oal_trace_event* event);
+
+
+#pragma mark Reading
+
+/** A trace being read. Treat as opaque. */
+typedef struct oal_trace_reader oal_trace_reader;
+
+/** Open a trace file and check its header.
+ *
+ * @param path The file to open.
+ * @return The reader, or NULL if the file couldn't be opened or isn't a trace.
+ */
+oal_trace_reader* oal_trace_reader_open(const char* path);
+
+/** Close a trace file.
+ *
+ * @param reader The reader.
+ */
+void oal_trace_reader_close(oal_trace_reader* reader);
+
+/** Read the next event.
+ *
+ * @param reader The reader.
+ * @param event Where to store the event.
+ * @return true if an event was read, false at the end of the trace or if it is corrupt.
+ */
+bool oal_trace_read(oal_trace_reader* reader, oal_trace_event* event);
+
+/** Check if the reader stopped because the trace is corrupt or truncated.
+ *
+ * @param reader The reader.
+ * @return true if an error occurred.
+ */
+bool oal_trace_reader_failed(oal_trace_reader* reader);
+
+/** Get a string that has been defined so far in the trace.
+ *
+ * @param reader The reader.
+ * @param string The string's ID.
+ * @return The string, or NULL if no such string has been defined.
+ */
+const char* oal_trace_reader_string(oal_trace_reader* reader, uint32_t string);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_TRACE_H */
@@ -0,0 +1,226 @@
+/*
+ *  oal_wav.c
+ *  ObjectAL
+ *
+ */
+
+#include "oal_wav.h"
+#include <string.h>
+
+#define kWaveFormatPCM 1
+#define kWaveFormatFloat 3
+#define kWaveFormatExtensible 0xfffe
+
+/** Frames are converted in blocks of this many bytes to keep the stack usage small. */
+#define kReadBlockSize 4096
+
+
+static uint16_t read_le16(const uint8_t* p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_le32(const uint8_t* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/** Convert one sample in the file's encoding to a signed 16 bit value. */
+static int16_t sample_to_16(const oal_wav_file* wav, const uint8_t* p)
+{
+	switch(wav->bitsPerSample)
+	{
+		case 8:
+			return (int16_t)((p[0] - 128) * 256);
+		case 16:
+			return (int16_t)read_le16(p);
+		case 24:
+			return (int16_t)read_le16(p + 1);
+		case 32:
+			if(kWaveFormatFloat == wav->encoding)
+			{
+				union { uint32_t i; float f; } value;
+				value.i = read_le32(p);
+				float f = value.f * 32768.0f;
+				if(f > 32767.0f) return 32767;
+				if(f < -32768.0f) return -32768;
+				return (int16_t)f;
+			}
+			return (int16_t)read_le16(p + 2);
+	}
+	return 0;
+}
+
+bool oal_wav_open(oal_wav_file* wav, const char* path)
+{
+	uint8_t header[40];
+	bool foundFormat = false;
+
+	memset(wav, 0, sizeof(*wav));
+	if(NULL == (wav->file = fopen(path, "rb")))
+	{
+		return false;
+	}
+
+	if(1 != fread(header, 12, 1, wav->file)
+	   || 0 != memcmp(header, "RIFF", 4)
+	   || 0 != memcmp(header + 8, "WAVE", 4))
+	{
+		goto fail;
+	}
+
+	// Walk the chunks until we find "data". "fmt " must come before it.
+	for(;;)
+	{
+		if(1 != fread(header, 8, 1, wav->file))
+		{
+			goto fail;
+		}
+		uint32_t chunkSize = read_le32(header + 4);
+
+		if(0 == memcmp(header, "fmt ", 4))
+		{
+			if(chunkSize < 16 || 1 != fread(header, chunkSize < 40 ? chunkSize : 40, 1, wav->file))
+			{
+				goto fail;
+			}
+			wav->encoding = read_le16(header);
+			wav->channels = read_le16(header + 2);
+			wav->sampleRate = read_le32(header + 4);
+			wav->bytesPerFrame = read_le16(header + 12);
+			wav->bitsPerSample = read_le16(header + 14);
+			if(kWaveFormatExtensible == wav->encoding && chunkSize >= 26)
+			{
+				// The first two bytes of the sub-format GUID hold the real encoding.
+				wav->encoding = read_le16(header + 24);
+			}
+			if(chunkSize > 40 && 0 != fseek(wav->file, (long)(chunkSize - 40), SEEK_CUR))
+			{
+				goto fail;
+			}
+			foundFormat = true;
+		}
+		else if(0 == memcmp(header, "data", 4))
+		{
+			if(!foundFormat)
+			{
+				goto fail;
+			}
+			wav->dataOffset = ftell(wav->file);
+			wav->numFrames = wav->bytesPerFrame > 0 ? chunkSize / wav->bytesPerFrame : 0;
+			break;
+		}
+		else if(0 != fseek(wav->file, (long)(chunkSize + (chunkSize & 1)), SEEK_CUR))
+		{
+			goto fail;
+		}
+	}
+
+	// Only handle what we can convert losslessly (or nearly so) to 16 bit.
+	if(0 == wav->channels || 0 == wav->sampleRate)
+	{
+		goto fail;
+	}
+	if(kWaveFormatPCM == wav->encoding)
+	{
+		if(8 != wav->bitsPerSample && 16 != wav->bitsPerSample
+		   && 24 != wav->bitsPerSample && 32 != wav->bitsPerSample)
+		{
+			goto fail;
+		}
+	}
+	else if(kWaveFormatFloat != wav->encoding || 32 != wav->bitsPerSample)
+	{
+		goto fail;
+	}
+	if(wav->bytesPerFrame != wav->channels * wav->bitsPerSample / 8)
+	{
+		goto fail;
+	}
+	// oal_wav_read16 converts whole frames a block at a time.
+	if(wav->bytesPerFrame > kReadBlockSize)
+	{
+		goto fail;
+	}
+	return true;
+
+fail:
+	oal_wav_close(wav);
+	return false;
+}
+
+uint32_t oal_wav_read16(oal_wav_file* wav, int16_t* dest, uint32_t numFrames, uint16_t maxChannels)
+{
+	uint8_t block[kReadBlockSize];
+	uint32_t bytesPerSample = wav->bitsPerSample / 8;
+	uint32_t framesPerBlock = kReadBlockSize / wav->bytesPerFrame;
+	uint16_t outChannels = wav->channels < maxChannels ? wav->channels : maxChannels;
+	uint32_t totalRead = 0;
+
+	if(wav->position + numFrames > wav->numFrames)
+	{
+		numFrames = (uint32_t)(wav->numFrames - wav->position);
+	}
+
+	// Fast path: the file is already in the output format.
+	if(16 == wav->bitsPerSample && outChannels == wav->channels && kWaveFormatPCM == wav->encoding)
+	{
+		totalRead = (uint32_t)fread(dest, wav->bytesPerFrame, numFrames, wav->file);
+#if defined(__BIG_ENDIAN__) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+		for(uint32_t i = 0; i < totalRead * outChannels; i++)
+		{
+			dest[i] = (int16_t)read_le16((const uint8_t*)&dest[i]);
+		}
+#endif
+		wav->position += totalRead;
+		return totalRead;
+	}
+
+	while(totalRead < numFrames)
+	{
+		uint32_t framesWanted = numFrames - totalRead;
+		if(framesWanted > framesPerBlock)
+		{
+			framesWanted = framesPerBlock;
+		}
+		uint32_t framesRead = (uint32_t)fread(block, wav->bytesPerFrame, framesWanted, wav->file);
+		for(uint32_t frame = 0; frame < framesRead; frame++)
+		{
+			const uint8_t* p = block + frame * wav->bytesPerFrame;
+			for(uint16_t channel = 0; channel < outChannels; channel++)
+			{
+				*dest++ = sample_to_16(wav, p + channel * bytesPerSample);
+			}
+		}
+		totalRead += framesRead;
+		if(framesRead < framesWanted)
+		{
+			break;
+		}
+	}
+	wav->position += totalRead;
+	return totalRead;
+}
+
+bool oal_wav_seek(oal_wav_file* wav, uint64_t frame)
+{
+	if(frame > wav->numFrames)
+	{
+		return false;
+	}
+	if(0 != fseek(wav->file, wav->dataOffset + (long)(frame * wav->bytesPerFrame), SEEK_SET))
+	{
+		return false;
+	}
+	wav->position = frame;
+	return true;
+}
+
+void oal_wav_close(oal_wav_file* wav)
+{
+	if(NULL != wav->file)
+	{
+		fclose(wav->file);
+		wav->file = NULL;
+	}
+}
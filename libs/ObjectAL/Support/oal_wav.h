@@ -0,0 +1,76 @@
+/*
+ *  oal_wav.h
+ *  ObjectAL
+ *
+ *  Portable RIFF/WAVE reader. This file only depends on the C standard library,
+ *  so it can be built and profiled on any platform.
+ */
+
+#ifndef OAL_WAV_H
+#define OAL_WAV_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** An open WAVE file. Treat as opaque. */
+typedef struct
+{
+	FILE* file;
+	/** Sample encoding: 1 = integer PCM, 3 = IEEE float. */
+	uint16_t encoding;
+	uint16_t channels;
+	uint16_t bitsPerSample;
+	uint32_t sampleRate;
+	/** Size of one frame in the file. */
+	uint32_t bytesPerFrame;
+	/** File offset of the first frame. */
+	long dataOffset;
+	uint64_t numFrames;
+	uint64_t position;
+} oal_wav_file;
+
+/** Open a WAVE file and parse its header.
+ * Supports 8, 16, 24 and 32 bit integer PCM and 32 bit float, including WAVE_FORMAT_EXTENSIBLE,
+ * with frames of up to 4096 bytes (2048 channels of 16 bit audio).
+ *
+ * @param wav The structure to fill out.
+ * @param path The path of the file to open.
+ * @return true if the file was opened and is in a supported format.
+ */
+bool oal_wav_open(oal_wav_file* wav, const char* path);
+
+/** Read frames as native-endian signed 16 bit samples.
+ * Channels beyond maxChannels are dropped.
+ *
+ * @param wav The file to read from.
+ * @param dest Where to write the samples (numFrames * min(channels, maxChannels) samples).
+ * @param numFrames The maximum number of frames to read.
+ * @param maxChannels The maximum number of channels per frame to output.
+ * @return The number of frames read (0 at the end of the file).
+ */
+uint32_t oal_wav_read16(oal_wav_file* wav, int16_t* dest, uint32_t numFrames, uint16_t maxChannels);
+
+/** Move the read position to the specified frame.
+ *
+ * @param wav The file to seek within.
+ * @param frame The frame to seek to.
+ * @return true if successful.
+ */
+bool oal_wav_seek(oal_wav_file* wav, uint64_t frame);
+
+/** Close the file.
+ *
+ * @param wav The file to close.
+ */
+void oal_wav_close(oal_wav_file* wav);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OAL_WAV_H */
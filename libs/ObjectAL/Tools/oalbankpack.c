@@ -0,0 +1,168 @@
+/*
+ *  oalbankpack.c
+ *  ObjectAL
+ *
+ *  Command line tool that packs WAVE files into a sound bank (see oal_sound_bank.h and
+ *  OALSoundBank).  Sounds are converted to 16 bit PCM (mono or stereo; extra channels are
+ *  dropped) and named after their file names, so OALSimpleAudio's playEffect:@"Pew.wav"
+ *  finds the packed copy of Pew.wav.
+ *
+ *  Only depends on the C standard library and POSIX, so it builds anywhere:
+ *
+ *      cc -std=c99 -O2 -o oalbankpack Tools/oalbankpack.c Support/oal_sound_bank.c Support/oal_wav.c
+ *
+ *  Usage: oalbankpack <bank file> <directory or .wav file>...
+ *  Directories are scanned (not recursively) for files ending in .wav.
+ */
+
+#include "../Support/oal_sound_bank.h"
+#include "../Support/oal_wav.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+/** Frames converted per read. */
+#define kFramesPerRead 4096
+
+
+static bool hasWavExtension(const char* path)
+{
+	size_t length = strlen(path);
+	return length > 4 && 0 == strcasecmp(path + length - 4, ".wav");
+}
+
+static const char* fileName(const char* path)
+{
+	const char* slash = strrchr(path, '/');
+	return NULL == slash ? path : slash + 1;
+}
+
+/** Convert a WAVE file to 16 bit little endian PCM and add it to the bank. */
+static bool packFile(oal_sound_bank_writer* writer, const char* path)
+{
+	oal_wav_file wav;
+	if(!oal_wav_open(&wav, path))
+	{
+		fprintf(stderr, "%s: not a supported WAVE file\n", path);
+		return false;
+	}
+
+	uint16_t channels = wav.channels > 2 ? 2 : wav.channels;
+	uint64_t size = wav.numFrames * channels * sizeof(int16_t);
+	uint8_t* data = malloc(size > 0 ? (size_t)size : 1);
+	int16_t* samples = malloc(kFramesPerRead * channels * sizeof(*samples));
+	bool succeeded = NULL != data && NULL != samples;
+
+	uint64_t offset = 0;
+	uint32_t numFrames;
+	while(succeeded && 0 != (numFrames = oal_wav_read16(&wav, samples, kFramesPerRead, channels)))
+	{
+		uint32_t numSamples = numFrames * channels;
+		if(offset + numSamples * sizeof(int16_t) > size)
+		{
+			break;
+		}
+		for(uint32_t i = 0; i < numSamples; i++)
+		{
+			data[offset++] = (uint8_t)samples[i];
+			data[offset++] = (uint8_t)((uint16_t)samples[i] >> 8);
+		}
+	}
+	oal_wav_close(&wav);
+
+	if(succeeded)
+	{
+		succeeded = oal_sound_bank_writer_add(writer,
+											  fileName(path),
+											  OAL_SOUND_BANK_PCM,
+											  channels,
+											  16,
+											  wav.sampleRate,
+											  data,
+											  offset);
+		if(succeeded)
+		{
+			printf("%s: %u channels, %u Hz, %llu bytes\n",
+				   fileName(path), channels, wav.sampleRate, (unsigned long long)offset);
+		}
+	}
+	if(!succeeded)
+	{
+		fprintf(stderr, "%s: could not pack\n", path);
+	}
+	free(samples);
+	free(data);
+	return succeeded;
+}
+
+static bool packDirectory(oal_sound_bank_writer* writer, const char* path)
+{
+	DIR* directory = opendir(path);
+	if(NULL == directory)
+	{
+		fprintf(stderr, "%s: could not open directory\n", path);
+		return false;
+	}
+
+	bool succeeded = true;
+	struct dirent* dirEntry;
+	while(NULL != (dirEntry = readdir(directory)))
+	{
+		if(!hasWavExtension(dirEntry->d_name))
+		{
+			continue;
+		}
+		size_t length = strlen(path) + strlen(dirEntry->d_name) + 2;
+		char* filePath = malloc(length);
+		if(NULL == filePath)
+		{
+			succeeded = false;
+			break;
+		}
+		snprintf(filePath, length, "%s/%s", path, dirEntry->d_name);
+		succeeded = packFile(writer, filePath) && succeeded;
+		free(filePath);
+	}
+	closedir(directory);
+	return succeeded;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 3)
+	{
+		fprintf(stderr, "Usage: %s <bank file> <directory or .wav file>...\n", argv[0]);
+		return 1;
+	}
+
+	oal_sound_bank_writer* writer = oal_sound_bank_writer_open(argv[1]);
+	if(NULL == writer)
+	{
+		fprintf(stderr, "%s: could not create\n", argv[1]);
+		return 1;
+	}
+
+	bool succeeded = true;
+	for(int i = 2; i < argc; i++)
+	{
+		struct stat info;
+		if(0 == stat(argv[i], &info) && S_ISDIR(info.st_mode))
+		{
+			succeeded = packDirectory(writer, argv[i]) && succeeded;
+		}
+		else
+		{
+			succeeded = packFile(writer, argv[i]) && succeeded;
+		}
+	}
+
+	if(!oal_sound_bank_writer_close(writer))
+	{
+		fprintf(stderr, "%s: could not write (are any names duplicated?)\n", argv[1]);
+		return 1;
+	}
+	return succeeded ? 0 : 1;
+}
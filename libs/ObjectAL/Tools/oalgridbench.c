@@ -0,0 +1,295 @@
+/*
+ *  oalgridbench.c
+ *  ObjectAL
+ *
+ *  Command line benchmark for the emitter grid (see oal_emitter_grid.h and
+ *  ALVirtualVoiceChannel).  It registers a level's worth of emitters, then runs frames
+ *  the way ALVirtualVoiceChannel update does: some emitters move, the listener moves,
+ *  and the grid finds the most audible emitters to give real voices to.  Every query is
+ *  checked against a brute force ranking of every emitter.
+ *
+ *  Only depends on the C standard library and POSIX, so it builds anywhere:
+ *
+ *      cc -std=c99 -O2 -o oalgridbench Tools/oalgridbench.c Support/oal_emitter_grid.c -lm
+ *
+ *  Usage: oalgridbench [emitters] [frames] [voices]
+ *  Defaults to 10000 emitters, 1000 frames and 32 voices.  Exits with 1 if any query
+ *  disagrees with the brute force ranking.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../Support/oal_emitter_grid.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Edge length of the (cubic) level, with the origin at its center. */
+#define kWorldSize 2000.0f
+
+/** Grid cell size, as ALVirtualVoiceChannel uses by default. */
+#define kCellSize 50.0f
+
+/** Emitters quieter than this are ignored, as ALVirtualVoiceChannel does by default. */
+#define kMinAudibility 0.001f
+
+/** Fraction of the emitters that move each frame. */
+#define kMovingFraction 0.1
+
+/** Frames per second of the simulated game. */
+#define kFrameRate 60.0
+
+/** The frame time a query has to stay under, in seconds. */
+#define kUpdateBudget 0.001
+
+/** M_PI isn't part of C99. */
+#define kPi 3.14159265358979f
+
+
+typedef struct
+{
+	float x, y, z;
+	float gain;
+	int priority;
+	float referenceDistance;
+	float rolloffFactor;
+	float maxDistance;
+	double endTime;
+} emitter;
+
+typedef struct
+{
+	int id;
+	int priority;
+	float audibility;
+} ranking;
+
+static uint32_t randomState = 2463534242u;
+
+/** xorshift32, so that every run sees the same level. */
+static uint32_t nextRandom(void)
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+static float randomFloat(float min, float max)
+{
+	return min + (max - min) * (float)(nextRandom() >> 8) / (float)(1 << 24);
+}
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1000000000.0;
+}
+
+static int compareDoubles(const void* a, const void* b)
+{
+	double first = *(const double*)a;
+	double second = *(const double*)b;
+	return first < second ? -1 : (first > second ? 1 : 0);
+}
+
+/** Most important first: by priority, then by audibility. */
+static int compareRankings(const void* a, const void* b)
+{
+	const ranking* first = a;
+	const ranking* second = b;
+	if(first->priority != second->priority)
+	{
+		return first->priority > second->priority ? -1 : 1;
+	}
+	if(first->audibility != second->audibility)
+	{
+		return first->audibility > second->audibility ? -1 : 1;
+	}
+	return 0;
+}
+
+/** Rank every emitter the slow way, as the grid query should. */
+static unsigned int bruteForceQuery(const emitter* emitters,
+									unsigned int numEmitters,
+									float x,
+									float y,
+									float z,
+									double time,
+									ranking* rankings,
+									unsigned int maxRankings)
+{
+	unsigned int numRanked = 0;
+	for(unsigned int i = 0; i < numEmitters; i++)
+	{
+		const emitter* e = &emitters[i];
+		if(e->endTime <= time)
+		{
+			continue;
+		}
+		float dx = e->x - x;
+		float dy = e->y - y;
+		float dz = e->z - z;
+		float audibility = e->gain * oal_distance_attenuation(OAL_DISTANCE_INVERSE_CLAMPED,
+															  sqrtf(dx*dx + dy*dy + dz*dz),
+															  e->referenceDistance,
+															  e->rolloffFactor,
+															  e->maxDistance);
+		if(audibility < kMinAudibility)
+		{
+			continue;
+		}
+		rankings[numRanked].id = (int)i;
+		rankings[numRanked].priority = e->priority;
+		rankings[numRanked].audibility = audibility;
+		numRanked++;
+	}
+	qsort(rankings, numRanked, sizeof(*rankings), compareRankings);
+	return numRanked < maxRankings ? numRanked : maxRankings;
+}
+
+static void printTimings(const char* name, double* timings, unsigned int numTimings)
+{
+	qsort(timings, numTimings, sizeof(*timings), compareDoubles);
+	printf("%-8s median %8.2f us, p99 %8.2f us, max %8.2f us\n",
+		   name,
+		   timings[numTimings / 2] * 1000000.0,
+		   timings[numTimings * 99 / 100] * 1000000.0,
+		   timings[numTimings - 1] * 1000000.0);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int numEmitters = argc > 1 ? (unsigned int)strtoul(argv[1], NULL, 10) : 10000;
+	unsigned int numFrames = argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : 1000;
+	unsigned int numVoices = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : 32;
+	if(0 == numEmitters || 0 == numFrames || 0 == numVoices)
+	{
+		fprintf(stderr, "Usage: %s [emitters] [frames] [voices]\n", argv[0]);
+		return 1;
+	}
+
+	oal_emitter_grid* grid = oal_emitter_grid_create(kCellSize);
+	emitter* emitters = malloc(sizeof(*emitters) * numEmitters);
+	ranking* expected = malloc(sizeof(*expected) * numEmitters);
+	int* found = malloc(sizeof(*found) * numVoices);
+	float* audibilities = malloc(sizeof(*audibilities) * numVoices);
+	double* moveTimings = malloc(sizeof(*moveTimings) * numFrames);
+	double* queryTimings = malloc(sizeof(*queryTimings) * numFrames);
+	if(NULL == grid || NULL == emitters || NULL == expected || NULL == found
+	   || NULL == audibilities || NULL == moveTimings || NULL == queryTimings)
+	{
+		fprintf(stderr, "%s: out of memory\n", argv[0]);
+		return 1;
+	}
+
+	// Scatter the emitters over the level. A few are important, and some are one-shot
+	// sounds that finish during the run.
+	double duration = numFrames / kFrameRate;
+	for(unsigned int i = 0; i < numEmitters; i++)
+	{
+		emitter* e = &emitters[i];
+		e->x = randomFloat(-kWorldSize / 2, kWorldSize / 2);
+		e->y = randomFloat(-kWorldSize / 2, kWorldSize / 2);
+		e->z = randomFloat(-kWorldSize / 20, kWorldSize / 20);
+		e->gain = randomFloat(0.2f, 1.0f);
+		e->priority = 0 == nextRandom() % 100 ? 1 : 0;
+		e->referenceDistance = randomFloat(1.0f, 10.0f);
+		e->rolloffFactor = 1.0f;
+		e->maxDistance = randomFloat(50.0f, 300.0f);
+		e->endTime = 0 == nextRandom() % 10 ? randomFloat(0.0f, (float)duration) : INFINITY;
+
+		int id = oal_emitter_grid_add(grid, NULL);
+		if(id != (int)i)
+		{
+			fprintf(stderr, "%s: could not add emitter %u\n", argv[0], i);
+			return 1;
+		}
+		oal_emitter_grid_move(grid, id, e->x, e->y, e->z);
+		oal_emitter_grid_set_properties(grid, id, e->gain, e->priority,
+										e->referenceDistance, e->rolloffFactor, e->maxDistance);
+		oal_emitter_grid_set_end_time(grid, id, e->endTime);
+	}
+
+	unsigned int numMoving = (unsigned int)(numEmitters * kMovingFraction);
+	unsigned int numMismatches = 0;
+	unsigned int numOverBudget = 0;
+	for(unsigned int frame = 0; frame < numFrames; frame++)
+	{
+		double time = frame / kFrameRate;
+
+		// The listener circles the middle of the level.
+		float angle = 2.0f * kPi * frame / numFrames;
+		float listenerX = kWorldSize / 4 * cosf(angle);
+		float listenerY = kWorldSize / 4 * sinf(angle);
+		float listenerZ = 0.0f;
+
+		double startTime = now();
+		for(unsigned int i = 0; i < numMoving; i++)
+		{
+			int id = (int)(nextRandom() % numEmitters);
+			emitter* e = &emitters[id];
+			e->x += randomFloat(-2.0f, 2.0f);
+			e->y += randomFloat(-2.0f, 2.0f);
+			oal_emitter_grid_move(grid, id, e->x, e->y, e->z);
+		}
+		moveTimings[frame] = now() - startTime;
+
+		startTime = now();
+		unsigned int numFound = oal_emitter_grid_query(grid,
+													   OAL_DISTANCE_INVERSE_CLAMPED,
+													   listenerX,
+													   listenerY,
+													   listenerZ,
+													   time,
+													   kMinAudibility,
+													   found,
+													   audibilities,
+													   numVoices);
+		queryTimings[frame] = now() - startTime;
+		if(queryTimings[frame] > kUpdateBudget)
+		{
+			numOverBudget++;
+		}
+
+		// Emitters can tie, so compare what was found rank by rank rather than by ID.
+		unsigned int numExpected = bruteForceQuery(emitters, numEmitters,
+												   listenerX, listenerY, listenerZ,
+												   time, expected, numVoices);
+		bool matches = numFound == numExpected;
+		for(unsigned int i = 0; matches && i < numFound; i++)
+		{
+			matches = emitters[found[i]].priority == expected[i].priority
+				&& audibilities[i] == expected[i].audibility;
+		}
+		if(!matches)
+		{
+			if(0 == numMismatches)
+			{
+				fprintf(stderr, "Frame %u: the grid found %u emitters, brute force found %u\n",
+						frame, numFound, numExpected);
+			}
+			numMismatches++;
+		}
+	}
+
+	printf("%u emitters, %u frames, %u voices, %u emitters moving per frame\n",
+		   numEmitters, numFrames, numVoices, numMoving);
+	printTimings("move", moveTimings, numFrames);
+	printTimings("query", queryTimings, numFrames);
+	printf("%u of %u queries took over %.0f us\n", numOverBudget, numFrames, kUpdateBudget * 1000000.0);
+	printf("%u of %u queries disagreed with brute force\n", numMismatches, numFrames);
+
+	free(queryTimings);
+	free(moveTimings);
+	free(audibilities);
+	free(found);
+	free(expected);
+	free(emitters);
+	oal_emitter_grid_destroy(grid);
+	return 0 == numMismatches ? 0 : 1;
+}
@@ -0,0 +1,564 @@
+/*
+ *  oaltracereplay.c
+ *  ObjectAL
+ *
+ *  Command line tool that replays a trace recorded by OALTraceRecorder (see oal_trace.h)
+ *  against the mock OpenAL (see Mock/oal_mock_al.h), with no audio hardware and without
+ *  OALSimpleAudio.  Each traced call is turned into the OpenAL calls ObjectAL makes for it:
+ *  playEffect sets up and plays the source it was recorded on, effects volume and muting
+ *  go to the listener's gain, and fades, pans and pitch ramps step every
+ *  kActionStepInterval of trace time as OALActionManager steps them.  Playback time moves
+ *  with the trace's timestamps, so sounds finish when they would have.
+ *
+ *  Background music doesn't go through OpenAL, so those calls are only counted.  Effect
+ *  files aren't opened; every effect is a silent buffer of the length given with -seconds.
+ *
+ *  Builds anywhere with the OpenAL headers (AL/al.h and AL/alc.h, as installed by
+ *  openal-soft); nothing from OpenAL is linked:
+ *
+ *      cc -std=c99 -O2 -o oaltracereplay Tools/oaltracereplay.c \
+ *          Support/oal_trace.c Mock/oal_mock_al.c -lm
+ *
+ *  Usage: oaltracereplay [-seconds n] [-counts] <trace file>
+ *  Prints what was replayed and how many OpenAL calls it took (-counts adds a count for each
+ *  entry point).  Exits with 1 if the trace can't be read or is corrupt.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../Support/oal_trace.h"
+#include "../Mock/oal_mock_al.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Time between action steps, as OALActionManager uses by default (in microseconds). */
+#define kActionStepMicroseconds (1000000 / 30)
+
+/** Sample rate of the silent effect buffers. */
+#define kEffectFrequency 44100
+
+/** The most sources the mock will make. */
+#define kMaxSources 4096
+
+
+/** A recorded source, and the mock source standing in for it. */
+typedef struct
+{
+	uint32_t recorded;
+	ALuint source;
+	/** Paused by setEffectsPaused, and to be resumed by it. */
+	bool pausedByEffects;
+} replaySource;
+
+/** A fade, pan or pitch ramp in progress. */
+typedef struct
+{
+	ALuint source;
+	/** AL_GAIN, AL_PITCH, or AL_POSITION for a pan. */
+	ALenum param;
+	float startValue;
+	float endValue;
+	uint64_t startTime;
+	uint64_t duration;
+} replayRamp;
+
+typedef struct
+{
+	replaySource* sources;
+	unsigned int numSources;
+	unsigned int sourcesCapacity;
+
+	/** Buffer for each string ID (0 = not loaded). */
+	ALuint* buffers;
+	uint32_t buffersCapacity;
+	unsigned int numBuffers;
+
+	replayRamp* ramps;
+	unsigned int numRamps;
+	unsigned int rampsCapacity;
+
+	/** Silence to load into each effect buffer. */
+	void* silence;
+	ALsizei silenceSize;
+
+	float effectsVolume;
+	bool muted;
+
+	/** Trace time that playback has reached (microseconds). */
+	uint64_t time;
+	uint64_t nextStepTime;
+
+	uint64_t eventCounts[OAL_TRACE_NUM_EVENT_TYPES];
+	uint64_t numBackgroundEvents;
+	uint64_t numErrors;
+	unsigned int peakPlaying;
+} replayer;
+
+static const char* eventNames[OAL_TRACE_NUM_EVENT_TYPES] =
+{
+	"string",
+	"preloadEffect", "unloadEffect", "unloadAllEffects", "playEffect", "stopAllEffects",
+	"playBg", "stopBg", "bgVolume", "bgPaused", "effectsVolume", "effectsPaused", "muted",
+	"source gain", "source pitch", "source position", "source looping", "source paused",
+	"source stop", "source fadeTo", "source panTo", "source pitchTo", "source stopActions",
+};
+
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1000000000.0;
+}
+
+/** Grow an array so that it holds at least minCount elements. */
+static bool grow(void** array, unsigned int* capacity, unsigned int minCount, size_t elementSize)
+{
+	if(minCount <= *capacity)
+	{
+		return true;
+	}
+	unsigned int newCapacity = *capacity > 0 ? *capacity : 16;
+	while(newCapacity < minCount)
+	{
+		newCapacity *= 2;
+	}
+	void* newArray = realloc(*array, newCapacity * elementSize);
+	if(NULL == newArray)
+	{
+		return false;
+	}
+	memset((char*)newArray + *capacity * elementSize, 0, (newCapacity - *capacity) * elementSize);
+	*array = newArray;
+	*capacity = newCapacity;
+	return true;
+}
+
+/** Find the mock source standing in for a recorded one, making it if needed (0 on failure). */
+static ALuint sourceFor(replayer* r, uint32_t recorded, bool create)
+{
+	for(unsigned int i = 0; i < r->numSources; i++)
+	{
+		if(r->sources[i].recorded == recorded)
+		{
+			return r->sources[i].source;
+		}
+	}
+	if(!create || !grow((void**)&r->sources, &r->sourcesCapacity, r->numSources + 1, sizeof(*r->sources)))
+	{
+		return 0;
+	}
+	ALuint source = 0;
+	alGenSources(1, &source);
+	if(AL_NO_ERROR != alGetError())
+	{
+		return 0;
+	}
+	r->sources[r->numSources].recorded = recorded;
+	r->sources[r->numSources].source = source;
+	r->sources[r->numSources].pausedByEffects = false;
+	r->numSources++;
+	return source;
+}
+
+/** Get the buffer for an effect, loading it if needed (0 on failure). */
+static ALuint bufferFor(replayer* r, uint32_t string)
+{
+	if(string < r->buffersCapacity && 0 != r->buffers[string])
+	{
+		return r->buffers[string];
+	}
+	if(!grow((void**)&r->buffers, &r->buffersCapacity, string + 1, sizeof(*r->buffers)))
+	{
+		return 0;
+	}
+	ALuint buffer = 0;
+	alGenBuffers(1, &buffer);
+	alBufferData(buffer, AL_FORMAT_MONO16, r->silence, r->silenceSize, kEffectFrequency);
+	if(AL_NO_ERROR != alGetError())
+	{
+		return 0;
+	}
+	r->buffers[string] = buffer;
+	r->numBuffers++;
+	return buffer;
+}
+
+/** Stop every source playing an effect and delete the effect's buffer. */
+static void unloadBuffer(replayer* r, uint32_t string)
+{
+	if(string >= r->buffersCapacity || 0 == r->buffers[string])
+	{
+		return;
+	}
+	for(unsigned int i = 0; i < r->numSources; i++)
+	{
+		ALint buffer = 0;
+		alGetSourcei(r->sources[i].source, AL_BUFFER, &buffer);
+		if((ALuint)buffer == r->buffers[string])
+		{
+			alSourceStop(r->sources[i].source);
+			alSourcei(r->sources[i].source, AL_BUFFER, 0);
+		}
+	}
+	alDeleteBuffers(1, &r->buffers[string]);
+	r->buffers[string] = 0;
+	r->numBuffers--;
+}
+
+static void removeRamps(replayer* r, ALuint source, ALenum param)
+{
+	unsigned int kept = 0;
+	for(unsigned int i = 0; i < r->numRamps; i++)
+	{
+		if(r->ramps[i].source != source || (0 != param && r->ramps[i].param != param))
+		{
+			r->ramps[kept++] = r->ramps[i];
+		}
+	}
+	r->numRamps = kept;
+}
+
+static void startRamp(replayer* r, ALuint source, ALenum param, float endValue, float duration)
+{
+	removeRamps(r, source, param);
+	float startValue = 0;
+	if(AL_POSITION == param)
+	{
+		float y, z;
+		alGetSource3f(source, AL_POSITION, &startValue, &y, &z);
+	}
+	else
+	{
+		alGetSourcef(source, param, &startValue);
+	}
+	if(!grow((void**)&r->ramps, &r->rampsCapacity, r->numRamps + 1, sizeof(*r->ramps)))
+	{
+		return;
+	}
+	replayRamp* ramp = &r->ramps[r->numRamps++];
+	ramp->source = source;
+	ramp->param = param;
+	ramp->startValue = startValue;
+	ramp->endValue = endValue;
+	ramp->startTime = r->time;
+	ramp->duration = duration > 0 ? (uint64_t)(duration * 1000000.0) : 0;
+}
+
+/** Apply every ramp's value for the current time, dropping the ones that are done. */
+static void stepRamps(replayer* r)
+{
+	unsigned int kept = 0;
+	for(unsigned int i = 0; i < r->numRamps; i++)
+	{
+		replayRamp* ramp = &r->ramps[i];
+		uint64_t elapsed = r->time - ramp->startTime;
+		bool done = elapsed >= ramp->duration;
+		float value = done ? ramp->endValue
+			: ramp->startValue + (ramp->endValue - ramp->startValue) * (float)elapsed / ramp->duration;
+		if(AL_POSITION == ramp->param)
+		{
+			alSource3f(ramp->source, AL_POSITION, value, 0, 0);
+		}
+		else
+		{
+			alSourcef(ramp->source, ramp->param, value);
+		}
+		if(!done)
+		{
+			r->ramps[kept++] = *ramp;
+		}
+	}
+	r->numRamps = kept;
+}
+
+/** Let playback time pass up to a point in the trace, stepping ramps on the way. */
+static void advanceTo(replayer* r, uint64_t time)
+{
+	while(r->numRamps > 0 && r->nextStepTime <= time)
+	{
+		if(r->nextStepTime > r->time)
+		{
+			oal_mock_advance((r->nextStepTime - r->time) / 1000000.0);
+			r->time = r->nextStepTime;
+		}
+		stepRamps(r);
+		r->nextStepTime += kActionStepMicroseconds;
+	}
+	if(time > r->time)
+	{
+		oal_mock_advance((time - r->time) / 1000000.0);
+		r->time = time;
+	}
+	if(0 == r->numRamps)
+	{
+		r->nextStepTime = r->time + kActionStepMicroseconds;
+	}
+}
+
+static void replayEvent(replayer* r, const oal_trace_event* event)
+{
+	ALuint source = 0;
+	switch(event->type)
+	{
+		case OAL_TRACE_PRELOAD_EFFECT:
+			bufferFor(r, event->string);
+			break;
+		case OAL_TRACE_UNLOAD_EFFECT:
+			unloadBuffer(r, event->string);
+			break;
+		case OAL_TRACE_UNLOAD_ALL_EFFECTS:
+			for(uint32_t i = 0; i < r->buffersCapacity; i++)
+			{
+				unloadBuffer(r, i);
+			}
+			break;
+		case OAL_TRACE_PLAY_EFFECT:
+		{
+			ALuint buffer = bufferFor(r, event->string);
+			if(0 == buffer || 0 == (source = sourceFor(r, event->handle, true)))
+			{
+				break;
+			}
+			// What ALSource play:gain:pitch:pan:loop: does, on the source it was recorded on.
+			removeRamps(r, source, 0);
+			alSourceStop(source);
+			alSourcei(source, AL_BUFFER, (ALint)buffer);
+			alSourcef(source, AL_GAIN, event->values[0]);
+			alSourcef(source, AL_PITCH, event->values[1]);
+			alSource3f(source, AL_POSITION, event->values[2], 0, 0);
+			alSourcei(source, AL_LOOPING, (event->intValue & 1) ? AL_TRUE : AL_FALSE);
+			alSourcePlay(source);
+			break;
+		}
+		case OAL_TRACE_STOP_ALL_EFFECTS:
+			for(unsigned int i = 0; i < r->numSources; i++)
+			{
+				alSourceStop(r->sources[i].source);
+				removeRamps(r, r->sources[i].source, 0);
+			}
+			break;
+		case OAL_TRACE_PLAY_BG:
+		case OAL_TRACE_STOP_BG:
+		case OAL_TRACE_SET_BG_VOLUME:
+		case OAL_TRACE_SET_BG_PAUSED:
+			r->numBackgroundEvents++;
+			break;
+		case OAL_TRACE_SET_EFFECTS_VOLUME:
+			r->effectsVolume = event->values[0];
+			alListenerf(AL_GAIN, r->muted ? 0 : r->effectsVolume);
+			break;
+		case OAL_TRACE_SET_EFFECTS_PAUSED:
+			for(unsigned int i = 0; i < r->numSources; i++)
+			{
+				ALint state = AL_STOPPED;
+				alGetSourcei(r->sources[i].source, AL_SOURCE_STATE, &state);
+				if(0 != event->intValue && AL_PLAYING == state)
+				{
+					alSourcePause(r->sources[i].source);
+					r->sources[i].pausedByEffects = true;
+				}
+				else if(0 == event->intValue && r->sources[i].pausedByEffects)
+				{
+					if(AL_PAUSED == state)
+					{
+						alSourcePlay(r->sources[i].source);
+					}
+					r->sources[i].pausedByEffects = false;
+				}
+			}
+			break;
+		case OAL_TRACE_SET_MUTED:
+			r->muted = 0 != event->intValue;
+			alListenerf(AL_GAIN, r->muted ? 0 : r->effectsVolume);
+			break;
+		default:
+			// Source calls go to whichever mock source stands in for the recorded one.
+			if(0 == (source = sourceFor(r, event->handle, false)))
+			{
+				break;
+			}
+			switch(event->type)
+			{
+				case OAL_TRACE_SOURCE_GAIN:
+					alSourcef(source, AL_GAIN, event->values[0]);
+					break;
+				case OAL_TRACE_SOURCE_PITCH:
+					alSourcef(source, AL_PITCH, event->values[0]);
+					break;
+				case OAL_TRACE_SOURCE_POSITION:
+					alSource3f(source, AL_POSITION, event->values[0], event->values[1], event->values[2]);
+					break;
+				case OAL_TRACE_SOURCE_LOOPING:
+					alSourcei(source, AL_LOOPING, event->intValue ? AL_TRUE : AL_FALSE);
+					break;
+				case OAL_TRACE_SOURCE_PAUSED:
+				{
+					ALint state = AL_STOPPED;
+					alGetSourcei(source, AL_SOURCE_STATE, &state);
+					if(0 != event->intValue && AL_PLAYING == state)
+					{
+						alSourcePause(source);
+					}
+					else if(0 == event->intValue && AL_PAUSED == state)
+					{
+						alSourcePlay(source);
+					}
+					break;
+				}
+				case OAL_TRACE_SOURCE_STOP:
+					removeRamps(r, source, 0);
+					alSourceStop(source);
+					break;
+				case OAL_TRACE_SOURCE_FADE:
+					startRamp(r, source, AL_GAIN, event->values[0], event->values[1]);
+					break;
+				case OAL_TRACE_SOURCE_PAN_TO:
+					startRamp(r, source, AL_POSITION, event->values[0], event->values[1]);
+					break;
+				case OAL_TRACE_SOURCE_PITCH_TO:
+					startRamp(r, source, AL_PITCH, event->values[0], event->values[1]);
+					break;
+				case OAL_TRACE_SOURCE_STOP_ACTIONS:
+					removeRamps(r, source, 0);
+					break;
+				default:
+					break;
+			}
+			break;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	double effectSeconds = 1.0;
+	bool printCounts = false;
+	const char* path = NULL;
+	for(int i = 1; i < argc; i++)
+	{
+		if(0 == strcmp(argv[i], "-seconds") && i + 1 < argc)
+		{
+			effectSeconds = strtod(argv[++i], NULL);
+		}
+		else if(0 == strcmp(argv[i], "-counts"))
+		{
+			printCounts = true;
+		}
+		else if('-' != argv[i][0] && NULL == path)
+		{
+			path = argv[i];
+		}
+		else
+		{
+			path = NULL;
+			break;
+		}
+	}
+	if(NULL == path || effectSeconds <= 0)
+	{
+		fprintf(stderr, "Usage: %s [-seconds n] [-counts] <trace file>\n", argv[0]);
+		return 1;
+	}
+
+	oal_trace_reader* reader = oal_trace_reader_open(path);
+	if(NULL == reader)
+	{
+		fprintf(stderr, "%s: not a trace file\n", path);
+		return 1;
+	}
+
+	replayer r;
+	memset(&r, 0, sizeof(r));
+	r.effectsVolume = 1.0f;
+	r.silenceSize = (ALsizei)(effectSeconds * kEffectFrequency) * (ALsizei)sizeof(int16_t);
+	r.silence = calloc(1, (size_t)r.silenceSize);
+	r.nextStepTime = kActionStepMicroseconds;
+
+	oal_mock_reset();
+	oal_mock_set_max_sources(kMaxSources);
+	ALCdevice* device = alcOpenDevice(NULL);
+	ALCcontext* context = NULL != device ? alcCreateContext(device, NULL) : NULL;
+	if(NULL == r.silence || NULL == context || !alcMakeContextCurrent(context))
+	{
+		fprintf(stderr, "%s: could not set up the mock OpenAL\n", argv[0]);
+		oal_trace_reader_close(reader);
+		free(r.silence);
+		return 1;
+	}
+
+	uint64_t numEvents = 0;
+	oal_trace_event event;
+	double startTime = now();
+	while(oal_trace_read(reader, &event))
+	{
+		advanceTo(&r, event.time);
+		replayEvent(&r, &event);
+		if(AL_NO_ERROR != alGetError())
+		{
+			r.numErrors++;
+		}
+		if((unsigned int)event.type < OAL_TRACE_NUM_EVENT_TYPES)
+		{
+			r.eventCounts[event.type]++;
+		}
+		numEvents++;
+
+		unsigned int numPlaying = oal_mock_num_playing_sources();
+		if(numPlaying > r.peakPlaying)
+		{
+			r.peakPlaying = numPlaying;
+		}
+	}
+	// Let the last fades finish.
+	while(r.numRamps > 0)
+	{
+		advanceTo(&r, r.nextStepTime);
+	}
+	double elapsed = now() - startTime;
+	bool failed = oal_trace_reader_failed(reader);
+	oal_trace_reader_close(reader);
+
+	// The reads the replay itself makes aren't calls the app would have caused, but they're
+	// few next to the calls replayed, so they are counted along with everything else.
+	uint64_t numCalls = oal_mock_total_calls();
+	printf("%s: %llu events over %.2f s of trace time, replayed in %.3f s (%.0f events/s)\n",
+		   path, (unsigned long long)numEvents, r.time / 1000000.0, elapsed,
+		   elapsed > 0 ? numEvents / elapsed : 0);
+	for(int i = 1; i < OAL_TRACE_NUM_EVENT_TYPES; i++)
+	{
+		if(r.eventCounts[i] > 0)
+		{
+			printf("  %-20s %llu\n", eventNames[i], (unsigned long long)r.eventCounts[i]);
+		}
+	}
+	printf("%llu OpenAL calls (%.2f per event), %llu OpenAL errors\n",
+		   (unsigned long long)numCalls, numEvents > 0 ? (double)numCalls / numEvents : 0,
+		   (unsigned long long)r.numErrors);
+	printf("%u sources used, at most %u playing at once, %u effects loaded at the end\n",
+		   r.numSources, r.peakPlaying, r.numBuffers);
+	if(r.numBackgroundEvents > 0)
+	{
+		printf("%llu background music calls skipped (they don't go through OpenAL)\n",
+			   (unsigned long long)r.numBackgroundEvents);
+	}
+	if(printCounts)
+	{
+		oal_mock_print_call_counts(stdout);
+	}
+	if(failed)
+	{
+		fprintf(stderr, "%s: the trace is corrupt or truncated\n", path);
+	}
+
+	alcMakeContextCurrent(NULL);
+	alcDestroyContext(context);
+	alcCloseDevice(device);
+	free(r.sources);
+	free(r.buffers);
+	free(r.ramps);
+	free(r.silence);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,318 @@
+/*
+ *  oalwavbench.c
+ *  ObjectAL
+ *
+ *  Command line benchmark for the WAVE reader (see oal_wav.h and OALWavDecoder).  It
+ *  decodes each file to 16 bit stereo the way OALWavDecoder does, several times over,
+ *  and reports the throughput in MB/s of file data.
+ *
+ *  With no files given, it writes a stereo test file in each format oal_wav reads
+ *  (8, 16, 24 and 32 bit integer, and 32 bit float) to the temporary directory and
+ *  decodes those, checking every decoded sample against what was written.
+ *
+ *  Only depends on the C standard library and POSIX, so it builds anywhere:
+ *
+ *      cc -std=c99 -O2 -o oalwavbench Tools/oalwavbench.c Support/oal_wav.c
+ *
+ *  Usage: oalwavbench [-passes n] [file.wav ...]
+ *  Defaults to 20 passes over each file.  Exits with 1 if a file can't be decoded, or if a
+ *  test file decodes to the wrong samples.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../Support/oal_wav.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Frames per read, as OALWavDecoder gets asked for by a streaming buffer. */
+#define kFramesPerRead 4096
+
+/** Channels decoded, as OALWavDecoder does. */
+#define kMaxChannels 2
+
+/** Length of each test file, in frames (10 seconds at 44.1 kHz). */
+#define kTestFrames 441000
+
+/** Sample rate of the test files. */
+#define kTestFrequency 44100
+
+
+typedef struct
+{
+	const char* name;
+	uint16_t encoding;
+	uint16_t bitsPerSample;
+} testFormat;
+
+static const testFormat testFormats[] =
+{
+	{"pcm8", 1, 8},
+	{"pcm16", 1, 16},
+	{"pcm24", 1, 24},
+	{"pcm32", 1, 32},
+	{"float32", 3, 32},
+};
+
+#define kNumTestFormats (sizeof(testFormats) / sizeof(*testFormats))
+
+
+static double now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1000000000.0;
+}
+
+static int compareDoubles(const void* a, const void* b)
+{
+	double first = *(const double*)a;
+	double second = *(const double*)b;
+	return first < second ? -1 : (first > second ? 1 : 0);
+}
+
+static void writeLe16(FILE* file, uint16_t value)
+{
+	fputc(value & 0xff, file);
+	fputc(value >> 8, file);
+}
+
+static void writeLe32(FILE* file, uint32_t value)
+{
+	writeLe16(file, (uint16_t)(value & 0xffff));
+	writeLe16(file, (uint16_t)(value >> 16));
+}
+
+/** The 16 bit sample written to a channel of a test file, covering the full range. */
+static int16_t testSample(uint32_t frame, uint16_t channel)
+{
+	return (int16_t)(uint16_t)(frame * 97 + channel * 12345);
+}
+
+/** Write one sample of a test file, returning the 16 bit sample it should decode to. */
+static int16_t writeTestSample(FILE* file, const testFormat* format, int16_t sample)
+{
+	switch(format->bitsPerSample)
+	{
+		case 8:
+		{
+			uint8_t value = (uint8_t)(sample / 256 + 128);
+			fputc(value, file);
+			return (int16_t)((value - 128) * 256);
+		}
+		case 16:
+			writeLe16(file, (uint16_t)sample);
+			return sample;
+		case 24:
+			// The low byte is below 16 bit precision, so it gets dropped.
+			fputc(0x5a, file);
+			writeLe16(file, (uint16_t)sample);
+			return sample;
+		case 32:
+			if(3 == format->encoding)
+			{
+				union { uint32_t i; float f; } value;
+				value.f = sample / 32768.0f;
+				writeLe32(file, value.i);
+				return sample;
+			}
+			writeLe16(file, 0xa5a5);
+			writeLe16(file, (uint16_t)sample);
+			return sample;
+	}
+	return 0;
+}
+
+/** Write a stereo test file, returning the samples it should decode to (or NULL). */
+static int16_t* writeTestFile(const char* path, const testFormat* format)
+{
+	FILE* file = fopen(path, "wb");
+	int16_t* expected = malloc(sizeof(*expected) * kTestFrames * 2);
+	if(NULL == file || NULL == expected)
+	{
+		if(NULL != file)
+		{
+			fclose(file);
+		}
+		free(expected);
+		return NULL;
+	}
+
+	uint16_t bytesPerFrame = (uint16_t)(2 * format->bitsPerSample / 8);
+	uint32_t dataSize = kTestFrames * bytesPerFrame;
+	fwrite("RIFF", 4, 1, file);
+	writeLe32(file, 36 + dataSize);
+	fwrite("WAVEfmt ", 8, 1, file);
+	writeLe32(file, 16);
+	writeLe16(file, format->encoding);
+	writeLe16(file, 2);
+	writeLe32(file, kTestFrequency);
+	writeLe32(file, kTestFrequency * bytesPerFrame);
+	writeLe16(file, bytesPerFrame);
+	writeLe16(file, format->bitsPerSample);
+	fwrite("data", 4, 1, file);
+	writeLe32(file, dataSize);
+	for(uint32_t frame = 0; frame < kTestFrames; frame++)
+	{
+		for(uint16_t channel = 0; channel < 2; channel++)
+		{
+			expected[frame * 2 + channel] = writeTestSample(file, format, testSample(frame, channel));
+		}
+	}
+
+	if(0 != fclose(file))
+	{
+		free(expected);
+		return NULL;
+	}
+	return expected;
+}
+
+/** Decode a file several times over and print its throughput.
+ *
+ * @param name The name to print.
+ * @param path The file to decode.
+ * @param numPasses How many times to decode it.
+ * @param expected The samples it should decode to, or NULL to not check.
+ * @return 0 if successful.
+ */
+static int benchmarkFile(const char* name, const char* path, unsigned int numPasses, const int16_t* expected)
+{
+	oal_wav_file wav;
+	if(!oal_wav_open(&wav, path))
+	{
+		fprintf(stderr, "%s: could not open\n", path);
+		return 1;
+	}
+
+	uint16_t outChannels = wav.channels < kMaxChannels ? wav.channels : kMaxChannels;
+	int16_t* samples = malloc(sizeof(*samples) * kFramesPerRead * outChannels);
+	double* timings = malloc(sizeof(*timings) * numPasses);
+	if(NULL == samples || NULL == timings)
+	{
+		fprintf(stderr, "%s: out of memory\n", path);
+		free(samples);
+		free(timings);
+		oal_wav_close(&wav);
+		return 1;
+	}
+
+	int result = 0;
+	uint64_t numMismatches = 0;
+	for(unsigned int pass = 0; pass < numPasses && 0 == result; pass++)
+	{
+		if(!oal_wav_seek(&wav, 0))
+		{
+			fprintf(stderr, "%s: could not seek\n", path);
+			result = 1;
+			break;
+		}
+
+		uint64_t numFrames = 0;
+		double startTime = now();
+		for(;;)
+		{
+			uint32_t framesRead = oal_wav_read16(&wav, samples, kFramesPerRead, kMaxChannels);
+			if(0 == framesRead)
+			{
+				break;
+			}
+			// Only check on the first pass, so that the others time decoding alone.
+			if(NULL != expected && 0 == pass)
+			{
+				const int16_t* want = expected + numFrames * outChannels;
+				for(uint32_t i = 0; i < framesRead * outChannels; i++)
+				{
+					if(samples[i] != want[i] && numMismatches++ < 5)
+					{
+						fprintf(stderr, "%s: sample %llu decoded as %d, expected %d\n", name,
+								(unsigned long long)(numFrames * outChannels + i), samples[i], want[i]);
+					}
+				}
+			}
+			numFrames += framesRead;
+		}
+		timings[pass] = now() - startTime;
+
+		if(numFrames != wav.numFrames)
+		{
+			fprintf(stderr, "%s: decoded %llu of %llu frames\n", path,
+					(unsigned long long)numFrames, (unsigned long long)wav.numFrames);
+			result = 1;
+		}
+	}
+
+	if(0 == result)
+	{
+		double megabytes = wav.numFrames * wav.bytesPerFrame / 1000000.0;
+		qsort(timings, numPasses, sizeof(*timings), compareDoubles);
+		printf("%-10s %2u ch %2u bit, %7.2f MB: median %8.1f MB/s, slowest %8.1f MB/s\n",
+			   name, wav.channels, wav.bitsPerSample, megabytes,
+			   megabytes / timings[numPasses / 2],
+			   megabytes / timings[numPasses - 1]);
+	}
+	if(numMismatches > 0)
+	{
+		fprintf(stderr, "%s: %llu samples decoded wrongly\n", name, (unsigned long long)numMismatches);
+		result = 1;
+	}
+
+	free(samples);
+	free(timings);
+	oal_wav_close(&wav);
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int numPasses = 20;
+	int firstFile = 1;
+	if(argc > 2 && 0 == strcmp(argv[1], "-passes"))
+	{
+		numPasses = (unsigned int)strtoul(argv[2], NULL, 10);
+		firstFile = 3;
+	}
+	if(0 == numPasses || (argc > 1 && '-' == argv[1][0] && 1 == firstFile))
+	{
+		fprintf(stderr, "Usage: %s [-passes n] [file.wav ...]\n", argv[0]);
+		return 1;
+	}
+
+	int result = 0;
+	if(firstFile < argc)
+	{
+		for(int i = firstFile; i < argc; i++)
+		{
+			const char* name = strrchr(argv[i], '/');
+			result |= benchmarkFile(NULL != name ? name + 1 : argv[i], argv[i], numPasses, NULL);
+		}
+		return result;
+	}
+
+	const char* directory = getenv("TMPDIR");
+	if(NULL == directory || 0 == *directory)
+	{
+		directory = "/tmp";
+	}
+	for(unsigned int i = 0; i < kNumTestFormats; i++)
+	{
+		char path[1024];
+		snprintf(path, sizeof(path), "%s/oalwavbench-%d-%s.wav", directory, (int)getpid(), testFormats[i].name);
+		int16_t* expected = writeTestFile(path, &testFormats[i]);
+		if(NULL == expected)
+		{
+			fprintf(stderr, "%s: could not write\n", path);
+			remove(path);
+			result = 1;
+			continue;
+		}
+		result |= benchmarkFile(testFormats[i].name, path, numPasses, expected);
+		free(expected);
+		remove(path);
+	}
+	return result;
+}
@@ -0,0 +1,165 @@
+//
+//  OALAudioStream.h
+//  ObjectAL
+//
+//
+// Copyright 2010 Karl Stenerud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <Foundation/Foundation.h>
+#import "ALSource.h"
+#import "OALAudioDecoder.h"
+
+
+#pragma mark OALAudioStream
+
+/**
+ * Plays a long sound file through an ALSource without decoding the whole file up front. <br>
+ *
+ * The file is decoded in chunks into a small ring of OpenAL buffers, which are queued on the
+ * source and refilled by a background thread as they finish playing. Memory use is bounded by
+ * chunkSize * prefetchDepth regardless of the file's length, and playback starts as soon as the
+ * first chunk has been decoded. <br>
+ *
+ * If the background thread fails to refill the queue in time (an underrun), the source stops.
+ * The stream notices this, restarts the source once more data is queued, and counts the event
+ * in "underruns". Increase chunkSize or prefetchDepth if this happens regularly. <br>
+ *
+ * The background thread holds a reference to the stream while it is playing, so a looping
+ * stream will keep playing until you call "stop".
+ *
+ * The file is decoded by whichever decoder OALAudioDecoderRegistry selects for it.
+ */
+@interface OALAudioStream : NSObject
+{
+	NSURL* url;
+	ALSource* source;
+	NSUInteger chunkSize;
+	NSUInteger prefetchDepth;
+	bool looping;
+	bool paused;
+	NSUInteger underruns;
+
+	/** Decodes the file being streamed. */
+	id<OALAudioDecoder> decoder;
+
+	/** Scratch memory that each chunk is decoded into before being handed to OpenAL. */
+	void* chunkData;
+	/** The OpenAL buffers making up the ring. */
+	ALuint* bufferIds;
+	/** Buffers from the ring that are not currently queued on the source. */
+	ALuint* freeBufferIds;
+	/** The number of entries in freeBufferIds. */
+	NSUInteger numFreeBuffers;
+
+	/** If true, the end of the file has been reached (and we're not looping). */
+	bool endOfStream;
+	/** If true, the background thread should keep servicing the source (guarded by condition). */
+	bool streaming;
+	/** If true, the background thread has not exited yet (guarded by condition). */
+	bool threadRunning;
+	/** Used to wake up and wait for the background thread. */
+	NSCondition* condition;
+	/** How long the background thread sleeps between checks, in seconds. */
+	NSTimeInterval pollInterval;
+}
+
+
+#pragma mark Properties
+
+/** The URL of the file being streamed. */
+@property(readonly) NSURL* url;
+
+/** The source the stream is played through.
+ * You may change its gain, pitch, position etc, but leave its buffers alone.
+ */
+@property(readonly) ALSource* source;
+
+/** The size, in bytes, of each decoded chunk. */
+@property(readonly) NSUInteger chunkSize;
+
+/** The number of chunks that are decoded ahead of the play position. */
+@property(readonly) NSUInteger prefetchDepth;
+
+/** If true, the stream is currently playing (this is also true when paused). */
+@property(readonly) bool playing;
+
+/** Pauses or resumes playback. */
+@property(readwrite,assign) bool paused;
+
+/** The number of times playback ran out of decoded data and had to be restarted. */
+@property(readonly) NSUInteger underruns;
+
+
+#pragma mark Object Management
+
+/** Create a stream for a file, using the default chunk size (16 KB) and prefetch depth (4).
+ *
+ * @param filePath The path of the file to stream.
+ * @return A new stream, or nil if the file could not be opened.
+ */
++ (id) streamWithFile:(NSString*) filePath;
+
+/** Create a stream for a URL, using the default chunk size (16 KB) and prefetch depth (4).
+ *
+ * @param url The URL of the file to stream.
+ * @return A new stream, or nil if the file could not be opened.
+ */
++ (id) streamWithUrl:(NSURL*) url;
+
+/** Create a stream for a URL.
+ *
+ * @param url The URL of the file to stream.
+ * @param chunkSize The size, in bytes, of each decoded chunk.
+ * @param prefetchDepth The number of chunks to keep queued ahead of the play position (minimum 2).
+ * @return A new stream, or nil if the file could not be opened.
+ */
++ (id) streamWithUrl:(NSURL*) url chunkSize:(NSUInteger) chunkSize prefetchDepth:(NSUInteger) prefetchDepth;
+
+/** Initialize a stream for a URL.
+ *
+ * @param url The URL of the file to stream.
+ * @param chunkSize The size, in bytes, of each decoded chunk.
+ * @param prefetchDepth The number of chunks to keep queued ahead of the play position (minimum 2).
+ * @return The initialized stream, or nil if the file could not be opened.
+ */
+- (id) initWithUrl:(NSURL*) url chunkSize:(NSUInteger) chunkSize prefetchDepth:(NSUInteger) prefetchDepth;
+
+
+#pragma mark Playback
+
+/** Play the stream from the beginning.
+ *
+ * @return TRUE if playback started.
+ */
+- (bool) play;
+
+/** Play the stream from the beginning.
+ *
+ * @param loop If TRUE, the stream will loop until you call "stop".
+ * @return TRUE if playback started.
+ */
+- (bool) play:(bool) loop;
+
+/** Stop playback and halt the background thread.
+ */
+- (void) stop;
+
+@end
@@ -0,0 +1,388 @@
+//
+//  OALAudioStream.m
+//  ObjectAL
+//
+//
+// Copyright 2010 Karl Stenerud
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALAudioStream.h"
+#import "ObjectALMacros.h"
+#import "ALWrapper.h"
+#import "OALAudioSupport.h"
+
+
+#define kDefaultChunkSize 16384
+#define kDefaultPrefetchDepth 4
+
+
+#pragma mark -
+#pragma mark Private Methods
+
+/**
+ * (INTERNAL USE) Private methods for OALAudioStream.
+ */
+@interface OALAudioStream (Private)
+
+/** (INTERNAL USE) Decode the next chunk into a buffer.
+ * If looping, decoding wraps around to the start of the file.
+ *
+ * @param bufferId The buffer to fill.
+ * @return TRUE if the buffer was filled with data.
+ */
+- (bool) fillBuffer:(ALuint) bufferId;
+
+/** (INTERNAL USE) Fill and queue as many free buffers as possible.
+ */
+- (void) fillFreeBuffers;
+
+/** (INTERNAL USE) Reclaim processed buffers, refill them, and restart the source if
+ * it ran dry. Called periodically from the background thread.
+ */
+- (void) service;
+
+/** (INTERNAL USE) Background thread entry point.
+ */
+- (void) streamThread;
+
+@end
+
+
+#pragma mark -
+#pragma mark OALAudioStream
+
+@implementation OALAudioStream
+
+#pragma mark Object Management
+
++ (id) streamWithFile:(NSString*) filePath
+{
+	return [self streamWithUrl:[OALAudioSupport urlForPath:filePath]];
+}
+
++ (id) streamWithUrl:(NSURL*) url
+{
+	return [self streamWithUrl:url chunkSize:kDefaultChunkSize prefetchDepth:kDefaultPrefetchDepth];
+}
+
++ (id) streamWithUrl:(NSURL*) url chunkSize:(NSUInteger) chunkSize prefetchDepth:(NSUInteger) prefetchDepth
+{
+	return [[[self alloc] initWithUrl:url chunkSize:chunkSize prefetchDepth:prefetchDepth] autorelease];
+}
+
+- (id) initWithUrl:(NSURL*) urlIn chunkSize:(NSUInteger) chunkSizeIn prefetchDepth:(NSUInteger) prefetchDepthIn
+{
+	if(nil != (self = [super init]))
+	{
+		url = [urlIn retain];
+		chunkSize = chunkSizeIn;
+		prefetchDepth = prefetchDepthIn < 2 ? 2 : prefetchDepthIn;
+		condition = [[NSCondition alloc] init];
+
+		decoder = [[OALAudioDecoderRegistry decoderForUrl:url] retain];
+		if(nil == decoder)
+		{
+			[self release];
+			return nil;
+		}
+
+		// Keep chunks aligned to whole frames.
+		uint32_t bytesPerFrame = decoder.bytesPerFrame;
+		chunkSize -= chunkSize % bytesPerFrame;
+		if(0 == chunkSize)
+		{
+			chunkSize = bytesPerFrame;
+		}
+		pollInterval = (double)chunkSize / ((double)decoder.frequency * bytesPerFrame) / 2;
+
+		chunkData = malloc(chunkSize);
+		bufferIds = malloc(sizeof(*bufferIds) * prefetchDepth);
+		freeBufferIds = malloc(sizeof(*freeBufferIds) * prefetchDepth);
+		if(nil == chunkData || nil == bufferIds || nil == freeBufferIds
+		   || ![ALWrapper genBuffers:bufferIds numBuffers:(ALsizei)prefetchDepth])
+		{
+			OAL_LOG_ERROR(@"Could not allocate %d buffers of %d bytes for url %@", prefetchDepth, chunkSize, url);
+			free(bufferIds);
+			bufferIds = nil;
+			[self release];
+			return nil;
+		}
+		memcpy(freeBufferIds, bufferIds, sizeof(*bufferIds) * prefetchDepth);
+		numFreeBuffers = prefetchDepth;
+
+		source = [[ALSource source] retain];
+	}
+	return self;
+}
+
+- (void) dealloc
+{
+	if(nil != source)
+	{
+		[self stop];
+	}
+	[source release];
+	if(nil != bufferIds)
+	{
+		[ALWrapper deleteBuffers:bufferIds numBuffers:(ALsizei)prefetchDepth];
+	}
+	free(bufferIds);
+	free(freeBufferIds);
+	free(chunkData);
+	[decoder release];
+	[condition release];
+	[url release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+@synthesize url;
+@synthesize source;
+@synthesize chunkSize;
+@synthesize prefetchDepth;
+
+- (bool) playing
+{
+	[condition lock];
+	bool result = streaming;
+	[condition unlock];
+	return result;
+}
+
+- (bool) paused
+{
+	@synchronized(self)
+	{
+		return paused;
+	}
+}
+
+- (void) setPaused:(bool) value
+{
+	@synchronized(self)
+	{
+		if(value != paused && self.playing)
+		{
+			paused = value;
+			source.paused = value;
+		}
+	}
+}
+
+- (NSUInteger) underruns
+{
+	@synchronized(self)
+	{
+		return underruns;
+	}
+}
+
+
+#pragma mark Playback
+
+- (bool) play
+{
+	return [self play:NO];
+}
+
+- (bool) play:(bool) loop
+{
+	[self stop];
+
+	@synchronized(self)
+	{
+		if(![decoder seekToFrame:0])
+		{
+			return NO;
+		}
+		looping = loop;
+		paused = NO;
+		endOfStream = NO;
+
+		// Start playing as soon as the first chunk is ready.
+		// The background thread takes care of the rest of the ring.
+		ALuint bufferId = freeBufferIds[--numFreeBuffers];
+		if(![self fillBuffer:bufferId])
+		{
+			freeBufferIds[numFreeBuffers++] = bufferId;
+			return NO;
+		}
+		[ALWrapper sourceQueueBuffers:source.sourceId numBuffers:1 bufferIds:&bufferId];
+		[source play];
+
+		[condition lock];
+		streaming = YES;
+		threadRunning = YES;
+		[condition unlock];
+		[NSThread detachNewThreadSelector:@selector(streamThread) toTarget:self withObject:nil];
+	}
+	return YES;
+}
+
+- (void) stop
+{
+	[condition lock];
+	streaming = NO;
+	[condition broadcast];
+	while(threadRunning)
+	{
+		[condition wait];
+	}
+	[condition unlock];
+
+	@synchronized(self)
+	{
+		paused = NO;
+		[source stop];
+
+		// Once stopped, every queued buffer counts as processed.
+		ALint numQueued = [ALWrapper getSourcei:source.sourceId parameter:AL_BUFFERS_QUEUED];
+		if(numQueued > 0)
+		{
+			[ALWrapper sourceUnqueueBuffers:source.sourceId
+								 numBuffers:numQueued
+								  bufferIds:freeBufferIds + numFreeBuffers];
+			numFreeBuffers += (NSUInteger)numQueued;
+		}
+	}
+}
+
+
+#pragma mark Internal Use
+
+- (bool) fillBuffer:(ALuint) bufferId
+{
+	if(endOfStream)
+	{
+		return NO;
+	}
+
+	uint32_t bytesPerFrame = decoder.bytesPerFrame;
+	uint32_t numFramesWanted = (uint32_t)(chunkSize / bytesPerFrame);
+	uint32_t numFramesRead = 0;
+	bool rewound = NO;
+
+	while(numFramesRead < numFramesWanted)
+	{
+		uint32_t numFrames = [decoder readFrames:numFramesWanted - numFramesRead
+											into:(char*)chunkData + numFramesRead * bytesPerFrame];
+		if(numFrames > 0)
+		{
+			numFramesRead += numFrames;
+			rewound = NO;
+			continue;
+		}
+
+		// End of file. Wrap around if looping (but don't spin on an empty file).
+		if(!looping || rewound || ![decoder seekToFrame:0])
+		{
+			endOfStream = YES;
+			break;
+		}
+		rewound = YES;
+	}
+
+	if(0 == numFramesRead)
+	{
+		return NO;
+	}
+	return [ALWrapper bufferData:bufferId
+						  format:decoder.format
+							data:chunkData
+							size:(ALsizei)(numFramesRead * bytesPerFrame)
+					   frequency:decoder.frequency];
+}
+
+- (void) fillFreeBuffers
+{
+	while(numFreeBuffers > 0 && !endOfStream)
+	{
+		ALuint bufferId = freeBufferIds[numFreeBuffers - 1];
+		if(![self fillBuffer:bufferId])
+		{
+			break;
+		}
+		numFreeBuffers--;
+		[ALWrapper sourceQueueBuffers:source.sourceId numBuffers:1 bufferIds:&bufferId];
+	}
+}
+
+- (void) service
+{
+	@synchronized(self)
+	{
+		ALuint sourceId = source.sourceId;
+		ALint numProcessed = [ALWrapper getSourcei:sourceId parameter:AL_BUFFERS_PROCESSED];
+		if(numProcessed > 0)
+		{
+			[ALWrapper sourceUnqueueBuffers:sourceId
+								 numBuffers:numProcessed
+								  bufferIds:freeBufferIds + numFreeBuffers];
+			numFreeBuffers += (NSUInteger)numProcessed;
+		}
+
+		[self fillFreeBuffers];
+
+		if(numFreeBuffers == prefetchDepth)
+		{
+			// Nothing left to play.
+			[condition lock];
+			streaming = NO;
+			[condition unlock];
+			return;
+		}
+
+		if(!paused && AL_PLAYING != [ALWrapper getSourcei:sourceId parameter:AL_SOURCE_STATE])
+		{
+			OAL_LOG_WARNING(@"Stream underrun for url %@", url);
+			underruns++;
+			// ALSource play would stop the source first if its shadow state still says playing.
+			[ALWrapper sourcePlay:sourceId];
+			[source notifyBatchState:AL_PLAYING];
+		}
+	}
+}
+
+- (void) streamThread
+{
+	NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+	[NSThread setThreadPriority:0.8];
+
+	[condition lock];
+	while(streaming)
+	{
+		[condition unlock];
+		[self service];
+		[condition lock];
+		if(streaming)
+		{
+			[condition waitUntilDate:[NSDate dateWithTimeIntervalSinceNow:pollInterval]];
+		}
+	}
+	threadRunning = NO;
+	[condition broadcast];
+	[condition unlock];
+
+	[pool release];
+}
+
+@end
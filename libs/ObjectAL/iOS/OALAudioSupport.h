@@ -28,13 +28,17 @@
 #import <AVFoundation/AVFoundation.h>
 #import "SynthesizeSingleton.h"
 #import "ALBuffer.h"
+#import "OALDecodedAudioCache.h"
 
 
 #pragma mark OALAudioSupport
 
 /**
  * Provides iOS-specific audio support, including audio file loading, session management and
- * interrupt handling.
+ * interrupt handling. <br>
+ *
+ * Audio files are decoded by whichever decoder OALAudioDecoderRegistry selects for the file's
+ * extension.
  *
  * <strong>Note:</strong> OpenAL is only able to play PCM (uncompressed) 8 bit or 16 bit (little
  * endian) audio files.  As such, the buffer loading routines will attempt to convert incompatible
@@ -79,6 +83,8 @@
 	
 	/** The time that the application was last activated. */
 	NSDate* lastActivated;
+
+	OALDecodedAudioCache* decodedAudioCache;
 }
 
 
@@ -169,6 +175,12 @@
  */
 @property(readonly) NSString* audioRoute;
 
+/** If set, buffers loaded via bufferFromUrl: and friends are stored in and loaded from this
+ * cache of decoded audio, skipping the decode step on subsequent loads.
+ * Default value: nil (no caching)
+ */
+@property(readwrite,retain) OALDecodedAudioCache* decodedAudioCache;
+
 #pragma mark Object Management
 
 /** Singleton implementation providing "sharedInstance" and "purgeSharedInstance" methods.
@@ -194,7 +206,10 @@ SYNTHESIZE_SINGLETON_FOR_CLASS_HEADER(OALAudioSupport);
 /** Load an OpenAL buffer with the contents of an audio file.
  * The buffer's name will be the fully qualified URL.
  *
- * See the class description note regarding sound file formats.
+ * See the class description note regarding sound file formats. <br>
+ *
+ * The entire file is decoded into memory before this method returns. For long sounds such as
+ * ambient loops, use OALAudioStream instead.
  *
  * @param url The URL of the file containing the audio data.
  * @return An ALBuffer containing the audio data.
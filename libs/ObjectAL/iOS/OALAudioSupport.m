@@ -28,6 +28,7 @@
 #import "ObjectALMacros.h"
 #import <AudioToolbox/AudioToolbox.h>
 #import "OALAudioTracks.h"
+#import "OALAudioDecoder.h"
 #import "OpenALManager.h"
 #import <UIKit/UIKit.h>
 
@@ -198,6 +199,7 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALAudioSupport);
 	[extAudioErrorCodes release];
 	extAudioErrorCodes = nil;
 	[overrideAudioSessionCategory release];
+	[decodedAudioCache release];
 	[super dealloc];
 }
 
@@ -317,6 +319,8 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALAudioSupport);
 	return [[self audioRoute] isEqualToString:@""];
 }
 
+@synthesize decodedAudioCache;
+
 
 #pragma mark Buffers
 
@@ -327,155 +331,60 @@ SYNTHESIZE_SINGLETON_FOR_CLASS(OALAudioSupport);
 
 - (ALBuffer*) bufferFromUrl:(NSURL*) url
 {
-	if(nil == url)
+	OALDecodedAudioCache* cache = self.decodedAudioCache;
+	ALBuffer* cachedBuffer = [cache bufferForUrl:url];
+	if(nil != cachedBuffer)
 	{
-		OAL_LOG_ERROR(@"Cannot open NULL file / url");
-		return nil;
+		return cachedBuffer;
 	}
 	
-	// Holds any errors that occur.
-	OSStatus error;
-	
-	// Handle to the file we'll be reading from.
-	ExtAudioFileRef fileHandle = nil;
-	
-	// This will hold the data we'll be passing to the OpenAL buffer.
-	void* streamData = nil;
-	
-	// This is the buffer object we'll be returning to the caller.
-	ALBuffer* alBuffer = nil;
-	
-	// Local variables that will be used later on.
-	// They need to be pre-declared so that the compiler doesn't throw a hissy fit
-	// over the goto statements if you compile as Objective-C++.
-	SInt64 numFrames;
-	UInt32 numFramesSize = sizeof(numFrames);
-	
-	AudioStreamBasicDescription audioStreamDescription;
-	UInt32 descriptionSize = sizeof(audioStreamDescription);
-	
-	UInt32 streamSizeInBytes;
-	AudioBufferList bufferList;
-	UInt32 numFramesToRead;
-	ALenum audioFormat;
-	
-	
-	// Open the file
-	if(noErr != (error = ExtAudioFileOpenURL((CFURLRef)url, &fileHandle)))
+	id<OALAudioDecoder> decoder = [OALAudioDecoderRegistry decoderForUrl:url];
+	if(nil == decoder)
 	{
-		REPORT_EXTAUDIO_CALL(error, @"Could not open url %@", url);
-		goto done;
-	}
-	
-	// Find out how many frames there are
-	if(noErr != (error = ExtAudioFileGetProperty(fileHandle,
-												 kExtAudioFileProperty_FileLengthFrames,
-												 &numFramesSize,
-												 &numFrames)))
-	{
-		REPORT_EXTAUDIO_CALL(error, @"Could not get frame count for url %@", url);
-		goto done;
-	}
-	
-	// Get the audio format
-	if(noErr != (error = ExtAudioFileGetProperty(fileHandle,
-												 kExtAudioFileProperty_FileDataFormat,
-												 &descriptionSize,
-												 &audioStreamDescription)))
-	{
-		REPORT_EXTAUDIO_CALL(error, @"Could not get audio format for url %@", url);
-		goto done;
-	}
-	
-	// Specify the new audio format (anything not changed remains the same)
-	audioStreamDescription.mFormatID = kAudioFormatLinearPCM;
-	audioStreamDescription.mFormatFlags = kAudioFormatFlagsNativeEndian |
-	kAudioFormatFlagIsSignedInteger |
-	kAudioFormatFlagIsPacked;
-	audioStreamDescription.mBitsPerChannel = 16;
-	if(audioStreamDescription.mChannelsPerFrame > 2)
-	{
-		// Don't allow more than 2 channels (stereo)
-		OAL_LOG_WARNING(@"Audio stream for url %@ contains %d channels. Capping at 2.", url, audioStreamDescription.mChannelsPerFrame);
-		audioStreamDescription.mChannelsPerFrame = 2;
-	}
-	audioStreamDescription.mBytesPerFrame = audioStreamDescription.mChannelsPerFrame * audioStreamDescription.mBitsPerChannel / 8;
-	audioStreamDescription.mFramesPerPacket = 1;
-	audioStreamDescription.mBytesPerPacket = audioStreamDescription.mBytesPerFrame * audioStreamDescription.mFramesPerPacket;
-	
-	// Set the new audio format
-	if(noErr != (error = ExtAudioFileSetProperty(fileHandle,
-												 kExtAudioFileProperty_ClientDataFormat,
-												 descriptionSize,
-												 &audioStreamDescription)))
-	{
-		REPORT_EXTAUDIO_CALL(error, @"Could not set new audio format for url %@", url);
-		goto done;
+		return nil;
 	}
 	
 	// Allocate some memory to hold the data
-	streamSizeInBytes = audioStreamDescription.mBytesPerFrame * (SInt32)numFrames;
-	streamData = malloc(streamSizeInBytes);
+	uint32_t numFrames = (uint32_t)decoder.totalFrames;
+	uint32_t streamSizeInBytes = decoder.bytesPerFrame * numFrames;
+	void* streamData = malloc(streamSizeInBytes);
 	if(nil == streamData)
 	{
 		OAL_LOG_ERROR(@"Could not allocate %d bytes for url %@", streamSizeInBytes, url);
-		goto done;
-	}
-	
-	// Read the data from the file to our buffer, in the new format
-	bufferList.mNumberBuffers = 1;
-	bufferList.mBuffers[0].mNumberChannels = audioStreamDescription.mChannelsPerFrame;
-	bufferList.mBuffers[0].mDataByteSize = streamSizeInBytes;
-	bufferList.mBuffers[0].mData = streamData;
-	
-	numFramesToRead = (UInt32)numFrames;
-	if(noErr != (error = ExtAudioFileRead(fileHandle, &numFramesToRead, &bufferList)))
-	{
-		REPORT_EXTAUDIO_CALL(error, @"Could not read audio data from url %@", url);
-		goto done;
+		return nil;
 	}
 	
-	if(1 == audioStreamDescription.mChannelsPerFrame)
+	// Read the data from the file to our buffer, in the decoder's output format
+	uint32_t numFramesRead = 0;
+	while(numFramesRead < numFrames)
 	{
-		if(8 == audioStreamDescription.mBitsPerChannel)
+		uint32_t numFramesThisRead = [decoder readFrames:numFrames - numFramesRead
+													into:(char*)streamData + numFramesRead * decoder.bytesPerFrame];
+		if(0 == numFramesThisRead)
 		{
-			audioFormat = AL_FORMAT_MONO8;
-		}
-		else
-		{
-			audioFormat = AL_FORMAT_MONO16;
+			break;
 		}
+		numFramesRead += numFramesThisRead;
 	}
-	else
+	if(0 == numFramesRead)
 	{
-		if(8 == audioStreamDescription.mBitsPerChannel)
-		{
-			audioFormat = AL_FORMAT_STEREO8;
-		}
-		else
-		{
-			audioFormat = AL_FORMAT_STEREO16;
-		}
+		OAL_LOG_ERROR(@"Could not read audio data from url %@", url);
+		free(streamData);
+		return nil;
 	}
 	
-	alBuffer = [ALBuffer bufferWithName:[url absoluteString]
-								   data:streamData
-								   size:streamSizeInBytes
-								 format:audioFormat
-							  frequency:(ALsizei)audioStreamDescription.mSampleRate];
-	// ALBuffer is maintaining this memory now.  Make sure we don't free() it.
-	streamData = nil;
+	[cache storeData:streamData
+				size:(ALsizei)(numFramesRead * decoder.bytesPerFrame)
+			  format:decoder.format
+		   frequency:decoder.frequency
+			  forUrl:url];
 	
-done:
-	if(nil != fileHandle)
-	{
-		REPORT_EXTAUDIO_CALL(ExtAudioFileDispose(fileHandle), @"Error closing audio file");
-	}
-	if(nil != streamData)
-	{
-		free(streamData);
-	}
-	return alBuffer;
+	// ALBuffer maintains this memory from here on.
+	return [ALBuffer bufferWithName:[url absoluteString]
+							   data:streamData
+							   size:(ALsizei)(numFramesRead * decoder.bytesPerFrame)
+							 format:decoder.format
+						  frequency:decoder.frequency];
 }
 
 - (NSString*) bufferAsyncFromFile:(NSString*) filePath target:(id) target selector:(SEL) selector
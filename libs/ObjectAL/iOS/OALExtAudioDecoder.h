@@ -0,0 +1,44 @@
+//
+//  OALExtAudioDecoder.h
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import <AudioToolbox/AudioToolbox.h>
+#import "OALAudioDecoder.h"
+
+
+#pragma mark OALExtAudioDecoder
+
+/**
+ * Decodes any format supported by Core Audio's ExtAudioFile API (caf, aiff, mp3, aac, ...).
+ * This is the default decoder on iOS.
+ */
+@interface OALExtAudioDecoder : NSObject <OALAudioDecoder>
+{
+	/** The URL being decoded (for error reporting). */
+	NSURL* url;
+	/** Handle to the file being decoded. */
+	ExtAudioFileRef fileHandle;
+	/** The format data gets decoded to. */
+	AudioStreamBasicDescription streamDescription;
+	int64_t totalFrames;
+}
+
+@end
@@ -0,0 +1,172 @@
+//
+//  OALExtAudioDecoder.m
+//  ObjectAL
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Note: You are NOT required to make the license available from within your
+// iOS application. Including it in your project is sufficient.
+//
+// Attribution is not required, but appreciated :)
+//
+
+#import "OALExtAudioDecoder.h"
+#import "ObjectALMacros.h"
+#import "OALAudioSupport.h"
+
+
+@implementation OALExtAudioDecoder
+
+#pragma mark Object Management
+
++ (id) decoderWithUrl:(NSURL*) url
+{
+	return [[[self alloc] initWithUrl:url] autorelease];
+}
+
+- (id) initWithUrl:(NSURL*) urlIn
+{
+	if(nil != (self = [super init]))
+	{
+		url = [urlIn retain];
+
+		// Holds any errors that occur.
+		OSStatus error;
+		SInt64 numFrames;
+		UInt32 numFramesSize = sizeof(numFrames);
+		UInt32 descriptionSize = sizeof(streamDescription);
+
+		// Open the file
+		if(noErr != (error = ExtAudioFileOpenURL((CFURLRef)url, &fileHandle)))
+		{
+			REPORT_EXTAUDIO_CALL(error, @"Could not open url %@", url);
+			goto fail;
+		}
+
+		// Find out how many frames there are
+		if(noErr != (error = ExtAudioFileGetProperty(fileHandle,
+													 kExtAudioFileProperty_FileLengthFrames,
+													 &numFramesSize,
+													 &numFrames)))
+		{
+			REPORT_EXTAUDIO_CALL(error, @"Could not get frame count for url %@", url);
+			goto fail;
+		}
+		totalFrames = numFrames;
+
+		// Get the audio format
+		if(noErr != (error = ExtAudioFileGetProperty(fileHandle,
+													 kExtAudioFileProperty_FileDataFormat,
+													 &descriptionSize,
+													 &streamDescription)))
+		{
+			REPORT_EXTAUDIO_CALL(error, @"Could not get audio format for url %@", url);
+			goto fail;
+		}
+
+		// Specify the new audio format (anything not changed remains the same)
+		streamDescription.mFormatID = kAudioFormatLinearPCM;
+		streamDescription.mFormatFlags = kAudioFormatFlagsNativeEndian |
+		kAudioFormatFlagIsSignedInteger |
+		kAudioFormatFlagIsPacked;
+		streamDescription.mBitsPerChannel = 16;
+		if(streamDescription.mChannelsPerFrame > 2)
+		{
+			// Don't allow more than 2 channels (stereo)
+			OAL_LOG_WARNING(@"Audio stream for url %@ contains %d channels. Capping at 2.", url, streamDescription.mChannelsPerFrame);
+			streamDescription.mChannelsPerFrame = 2;
+		}
+		streamDescription.mBytesPerFrame = streamDescription.mChannelsPerFrame * streamDescription.mBitsPerChannel / 8;
+		streamDescription.mFramesPerPacket = 1;
+		streamDescription.mBytesPerPacket = streamDescription.mBytesPerFrame * streamDescription.mFramesPerPacket;
+
+		// Set the new audio format
+		if(noErr != (error = ExtAudioFileSetProperty(fileHandle,
+													 kExtAudioFileProperty_ClientDataFormat,
+													 descriptionSize,
+													 &streamDescription)))
+		{
+			REPORT_EXTAUDIO_CALL(error, @"Could not set new audio format for url %@", url);
+			goto fail;
+		}
+	}
+	return self;
+
+fail:
+	[self release];
+	return nil;
+}
+
+- (void) dealloc
+{
+	if(nil != fileHandle)
+	{
+		REPORT_EXTAUDIO_CALL(ExtAudioFileDispose(fileHandle), @"Error closing audio file");
+	}
+	[url release];
+	[super dealloc];
+}
+
+
+#pragma mark Properties
+
+- (ALenum) format
+{
+	return 1 == streamDescription.mChannelsPerFrame ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+}
+
+- (ALsizei) frequency
+{
+	return (ALsizei)streamDescription.mSampleRate;
+}
+
+- (uint32_t) bytesPerFrame
+{
+	return streamDescription.mBytesPerFrame;
+}
+
+@synthesize totalFrames;
+
+
+#pragma mark Decoding
+
+- (uint32_t) readFrames:(uint32_t) numFrames into:(void*) buffer
+{
+	OSStatus error;
+	AudioBufferList bufferList;
+	bufferList.mNumberBuffers = 1;
+	bufferList.mBuffers[0].mNumberChannels = streamDescription.mChannelsPerFrame;
+	bufferList.mBuffers[0].mDataByteSize = numFrames * streamDescription.mBytesPerFrame;
+	bufferList.mBuffers[0].mData = buffer;
+
+	UInt32 numFramesRead = numFrames;
+	if(noErr != (error = ExtAudioFileRead(fileHandle, &numFramesRead, &bufferList)))
+	{
+		REPORT_EXTAUDIO_CALL(error, @"Could not read audio data from url %@", url);
+		return 0;
+	}
+	return numFramesRead;
+}
+
+- (bool) seekToFrame:(int64_t) frame
+{
+	OSStatus error;
+	if(noErr != (error = ExtAudioFileSeek(fileHandle, frame)))
+	{
+		REPORT_EXTAUDIO_CALL(error, @"Could not seek to frame %lld in url %@", frame, url);
+		return NO;
+	}
+	return YES;
+}
+
+@end